@@ -59,6 +59,7 @@
 from ctypes import *
 import platform
 import argparse
+import asyncio
 import sys
 
 if platform.system() == "Darwin":
@@ -69,7 +70,7 @@ if platform.system() == "Darwin":
 
 # CAN API V3 - Python Wrapper
 #
-CAN_API_V3_PYTHON = {'major': 0, 'minor': 3, 'patch': 1}
+CAN_API_V3_PYTHON = {'major': 0, 'minor': 6, 'patch': 0}
 
 # CAN Identifier Ranges
 #
@@ -221,6 +222,11 @@ CANWAIT_INFINITE = 65535  # infinite time-out (blocking operation)
 CANREAD_INFINITE = CANWAIT_INFINITE
 CANWRITE_INFINITE = CANWAIT_INFINITE
 
+# Asyncio Support
+#
+CANASYNC_BATCH_SIZE = 64     # number of messages read at once (in batches)
+CANASYNC_POLL_TIME = 0.001   # polling interval without event file descriptor (in [s])
+
 # CAN Status-register
 #
 class StatusBits(LittleEndianStructure):
@@ -401,12 +407,44 @@ class Message(LittleEndianStructure):
     ]
 
 
+# CAN Frame (compact, CAN 2.0 only)
+#
+class FrameFlags(LittleEndianStructure):
+    """
+      CAN Frame Flags
+    """
+    _fields_ = [
+        ('xtd', c_uint8, 1),
+        ('rtr', c_uint8, 1),
+        ('_unused', c_uint8, 5),
+        ('sts', c_uint8, 1)
+    ]
+
+
+class Frame(LittleEndianStructure):
+    """
+      CAN Frame (compact layout of 24 bytes with time-stamp in nanoseconds)
+    """
+    _fields_ = [
+        ('id', c_uint32),
+        ('flags', FrameFlags),
+        ('dlc', c_uint8),
+        ('_reserved', c_uint8 * 2),
+        ('data', c_uint8 * 8),
+        ('timestamp', c_uint64)
+    ]
+
+
 # CAN API V3 for generic CAN Interfaces
 #
 class CANAPI:
     """
       CAN API V3 class implementation
     """
+    # vendor-specific property to get a file descriptor that is readable
+    # when messages were received (None: not supported, polling is used)
+    _event_property = None
+
     def __init__(self, library):
         #
         # constructor: loads the given CAN API V3 driver library
@@ -422,6 +460,9 @@ class CANAPI:
             print('+++ exception: {}'.format(e))
             raise
         self.__m_handle = -1
+        self.__m_rx_batch = (Message * CANASYNC_BATCH_SIZE)()
+        self.__m_rx_count = 0
+        self.__m_rx_index = 0
 
     def __exit__(self):
         #
@@ -491,6 +532,7 @@ class CANAPI:
         """
         try:
             result = self.__m_library.can_exit(self.__m_handle)
+            self.__m_rx_count = self.__m_rx_index = 0  # discard the last batch
             return int(result)
         except Exception as e:
             print('+++ exception: {}'.format(e))
@@ -540,6 +582,7 @@ class CANAPI:
         """
         try:
             result = self.__m_library.can_reset(self.__m_handle)
+            self.__m_rx_count = self.__m_rx_index = 0  # discard the last batch
             return int(result)
         except Exception as e:
             print('+++ exception: {}'.format(e))
@@ -593,6 +636,495 @@ class CANAPI:
             print('+++ exception: {}'.format(e))
             raise
 
+    def write_n(self, messages, count=None, timeout=None):
+        """
+          transmits several messages over the CAN bus in one call. The CAN controller must be
+          in operation state 'running'. The transmission stops at the first message that
+          could not be sent.
+
+          :param messages: the messages to be sent: an array of Message (ctypes), a list of
+                           Message, or any object supporting the buffer protocol with items
+                           of the Message layout (e.g. a numpy array of dtype message_dtype())
+          :param count: number of messages to be sent (default: all messages of the buffer)
+          :param timeout: time to wait for the transmission of each message:
+                            0 means the function returns immediately,
+                            65535 means blocking write, and any other
+                            value means the time to wait in milliseconds
+          :return: result, count
+            result: 0 if successful, or a negative value on error
+            count: the number of messages sent
+        """
+        try:
+            if isinstance(messages, (list, tuple)):
+                messages = (Message * len(messages))(*messages)
+            __messages, __count = CANAPI.__message_array(messages, count, False, Message)
+            if __count == 0:
+                return CANERR_NOERROR, 0
+            if timeout is not None:
+                result = self.__m_library.can_write_n(self.__m_handle, __messages, c_size_t(__count), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_write_n(self.__m_handle, __messages, c_size_t(__count), c_uint16(0))
+            if result > 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), 0
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def read_n(self, buffer, count=None, timeout=None):
+        """
+          read up to n messages from the message queue of the CAN interface into a buffer
+          provided by the caller, if any message was received (no copy of the messages is
+          made in Python). The CAN controller must be in operation state 'running'.
+
+          :param buffer: the messages read: an array of Message (ctypes), or any writable
+                         object supporting the buffer protocol with items of the Message
+                         layout (e.g. a numpy array of dtype message_dtype())
+          :param count: maximum number of messages to be read (default: size of the buffer)
+          :param timeout: time to wait for the reception of the first message:
+                            0 means the function returns immediately,
+                            65535 means blocking read, and any other
+                            value means the time to wait in milliseconds
+          :return: result, count
+            result: 0 if successful, or a negative value on error
+            count: the number of messages read into the buffer
+        """
+        try:
+            __messages, __count = CANAPI.__message_array(buffer, count, True, Message)
+            if __count == 0:
+                return CANERR_NOERROR, 0
+            if timeout is not None:
+                result = self.__m_library.can_read_n(self.__m_handle, __messages, c_size_t(__count), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_read_n(self.__m_handle, __messages, c_size_t(__count), CANREAD_INFINITE)
+            if result > 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), 0
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def write_frames(self, frames, count=None, timeout=None):
+        """
+          transmits several CAN 2.0 frames in compact layout (24 bytes per frame) over the
+          CAN bus in one call. The CAN controller must be in operation state 'running'.
+
+          :param frames: the frames to be sent: an array of Frame (ctypes), a list of Frame,
+                         or any object supporting the buffer protocol with items of the Frame
+                         layout (e.g. a numpy array of dtype frame_dtype())
+          :param count: number of frames to be sent (default: all frames of the buffer)
+          :param timeout: time to wait for the transmission of each frame:
+                            0 means the function returns immediately,
+                            65535 means blocking write, and any other
+                            value means the time to wait in milliseconds
+          :return: result, count
+            result: 0 if successful, or a negative value on error
+            count: the number of frames sent
+        """
+        try:
+            if isinstance(frames, (list, tuple)):
+                frames = (Frame * len(frames))(*frames)
+            __frames, __count = CANAPI.__message_array(frames, count, False, Frame)
+            if __count == 0:
+                return CANERR_NOERROR, 0
+            if timeout is not None:
+                result = self.__m_library.can_write_frames(self.__m_handle, __frames, c_size_t(__count), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_write_frames(self.__m_handle, __frames, c_size_t(__count), c_uint16(0))
+            if result > 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), 0
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def read_frames(self, buffer, count=None, timeout=None):
+        """
+          read up to n CAN 2.0 frames in compact layout (24 bytes per frame) from the message
+          queue of the CAN interface into a buffer provided by the caller, if any frame was
+          received. The CAN controller must be in operation state 'running'.
+
+          :param buffer: the frames read: an array of Frame (ctypes), or any writable object
+                         supporting the buffer protocol with items of the Frame layout
+                         (e.g. a numpy array of dtype frame_dtype())
+          :param count: maximum number of frames to be read (default: size of the buffer)
+          :param timeout: time to wait for the reception of the first frame:
+                            0 means the function returns immediately,
+                            65535 means blocking read, and any other
+                            value means the time to wait in milliseconds
+          :return: result, count
+            result: 0 if successful, or a negative value on error
+            count: the number of frames read into the buffer
+        """
+        try:
+            __frames, __count = CANAPI.__message_array(buffer, count, True, Frame)
+            if __count == 0:
+                return CANERR_NOERROR, 0
+            if timeout is not None:
+                result = self.__m_library.can_read_frames(self.__m_handle, __frames, c_size_t(__count), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_read_frames(self.__m_handle, __frames, c_size_t(__count), CANREAD_INFINITE)
+            if result > 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), 0
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def subscribe(self, queue_size, filter11=0, filter29=0):
+        """
+          creates a subscriber of the CAN interface that receives a copy of each received
+          message accepted by its filter, with a message queue of its own (fan-out).
+
+          :param queue_size: size of the subscriber queue (number of messages)
+          :param filter11: acceptance filter for 11-bit identifier (code << 32 | mask, 0 = all)
+          :param filter29: acceptance filter for 29-bit identifier (code << 32 | mask, 0 = all)
+          :return: result, subscriber
+            result: 0 if successful, or a negative value on error
+            subscriber: the subscriber number (to be used with read_subscriber)
+        """
+        try:
+            result = self.__m_library.can_subscribe(self.__m_handle, c_uint64(filter11), c_uint64(filter29),
+                                                    c_size_t(queue_size))
+            if result >= 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), None
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def unsubscribe(self, subscriber):
+        """
+          removes a subscriber of the CAN interface.
+
+          :param subscriber: the subscriber number (from subscribe)
+          :return: result
+            result: 0 if successful, or a negative value on error
+        """
+        try:
+            result = self.__m_library.can_unsubscribe(self.__m_handle, c_int(subscriber))
+            return int(result)
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def read_subscriber(self, subscriber, buffer, count=None, timeout=None):
+        """
+          read up to n messages from the message queue of a subscriber into a buffer
+          provided by the caller, if any message was received (same as read_n).
+
+          :param subscriber: the subscriber number (from subscribe)
+          :param buffer: the messages read: an array of Message (ctypes), or any writable
+                         object supporting the buffer protocol with items of the Message layout
+          :param count: maximum number of messages to be read (default: size of the buffer)
+          :param timeout: time to wait for the reception of the first message
+          :return: result, count
+            result: 0 if successful, or a negative value on error
+            count: the number of messages read into the buffer
+        """
+        try:
+            __messages, __count = CANAPI.__message_array(buffer, count, True, Message)
+            if __count == 0:
+                return CANERR_NOERROR, 0
+            if timeout is not None:
+                result = self.__m_library.can_read_subscriber(self.__m_handle, c_int(subscriber), __messages,
+                                                              c_size_t(__count), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_read_subscriber(self.__m_handle, c_int(subscriber), __messages,
+                                                              c_size_t(__count), CANREAD_INFINITE)
+            if result > 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), 0
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def isotp_open(self, param):
+        """
+          opens an ISO-TP channel (ISO 15765-2) on the CAN interface; the transport protocol
+          runs on the reception thread of the interface (vendor-specific, e.g. SerialCAN).
+
+          :param param: channel-specific parameters (e.g. SerialIsoTp)
+          :return: result, channel
+            result: 0 if successful, or a negative value on error
+            channel: the channel number (to be used with isotp_send and isotp_receive)
+        """
+        try:
+            result = self.__m_library.can_isotp_open(self.__m_handle, byref(param))
+            if result >= 0:
+                return CANERR_NOERROR, int(result)
+            else:
+                return int(result), None
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def isotp_close(self, channel):
+        """
+          closes an ISO-TP channel of the CAN interface.
+
+          :param channel: the channel number (from isotp_open)
+          :return: result
+            result: 0 if successful, or a negative value on error
+        """
+        try:
+            result = self.__m_library.can_isotp_close(self.__m_handle, c_int(channel))
+            return int(result)
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def isotp_send(self, channel, data):
+        """
+          transmits a PDU on an ISO-TP channel (segmented and paced as requested by the receiver).
+
+          :param channel: the channel number (from isotp_open)
+          :param data: the PDU (bytes-like object of 1 to 4095 bytes)
+          :return: result
+            result: 0 if successful, or a negative value on error
+        """
+        try:
+            __data = (c_uint8 * len(data)).from_buffer_copy(bytes(data))
+            result = self.__m_library.can_isotp_send(self.__m_handle, c_int(channel), __data, c_size_t(len(data)))
+            return int(result)
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def isotp_receive(self, channel, timeout=None, size=4095):
+        """
+          reads a received PDU from an ISO-TP channel, if any PDU was received.
+
+          :param channel: the channel number (from isotp_open)
+          :param timeout: time to wait for the reception of a PDU
+          :param size: maximum length of the PDU (a longer PDU is truncated)
+          :return: result, data
+            result: 0 if successful, or a negative value on error
+            data: the PDU (bytes) or None
+        """
+        try:
+            __buffer = (c_uint8 * size)()
+            if timeout is not None:
+                result = self.__m_library.can_isotp_receive(self.__m_handle, c_int(channel), __buffer,
+                                                            c_size_t(size), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_isotp_receive(self.__m_handle, c_int(channel), __buffer,
+                                                            c_size_t(size), CANREAD_INFINITE)
+            if result >= 0:
+                return CANERR_NOERROR, bytes(__buffer[:result])
+            else:
+                return int(result), None
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def j1939_init(self, param=None):
+        """
+          initializes the SAE J1939 transport protocol on the CAN interface (reassembly of BAM
+          and RTS/CTS sessions on the reception thread, vendor-specific, e.g. SerialCAN).
+
+          :param param: engine-specific parameters (e.g. SerialJ1939, optional)
+          :return: result
+            result: 0 if successful, or a negative value on error
+        """
+        try:
+            if param is not None:
+                result = self.__m_library.can_j1939_init(self.__m_handle, byref(param))
+            else:
+                result = self.__m_library.can_j1939_init(self.__m_handle, None)
+            return int(result)
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def j1939_claim(self, address, name):
+        """
+          claims an own J1939 address (waits 250ms for contending claims).
+
+          :param address: address to be claimed (0..253, or 254 to release the address)
+          :param name: NAME of the node (64-bit)
+          :return: result
+            result: 0 if successful, or a negative value on error
+        """
+        try:
+            result = self.__m_library.can_j1939_claim(self.__m_handle, c_uint8(address), c_uint64(name))
+            return int(result)
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def j1939_receive(self, timeout=None, size=1785):
+        """
+          reads a reassembled J1939 PDU, if any PDU was received.
+
+          :param timeout: time to wait for the reception of a PDU
+          :param size: maximum length of the PDU (a longer PDU is truncated)
+          :return: result, pgn, src, dst, data
+            result: 0 if successful, or a negative value on error
+            pgn: parameter group number
+            src: source address
+            dst: destination address (255 = global)
+            data: the PDU (bytes) or None
+        """
+        try:
+            __pgn = c_uint32(0)
+            __src = c_uint8(0)
+            __dst = c_uint8(0)
+            __buffer = (c_uint8 * size)()
+            if timeout is not None:
+                result = self.__m_library.can_j1939_receive(self.__m_handle, byref(__pgn), byref(__src), byref(__dst),
+                                                            __buffer, c_size_t(size), c_uint16(timeout))
+            else:
+                result = self.__m_library.can_j1939_receive(self.__m_handle, byref(__pgn), byref(__src), byref(__dst),
+                                                            __buffer, c_size_t(size), CANREAD_INFINITE)
+            if result >= 0:
+                return CANERR_NOERROR, int(__pgn.value), int(__src.value), int(__dst.value), bytes(__buffer[:result])
+            else:
+                return int(result), None, None, None, None
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    def event_fd(self):
+        """
+          retrieves a file descriptor that is readable as long as messages are in the message
+          queue of the CAN interface (vendor-specific, e.g. SerialCAN under Linux and macOS).
+
+          :return: result, fd
+            result: 0 if successful, or a negative value on error
+            fd: the file descriptor (must not be read or closed) or None
+        """
+        try:
+            if self._event_property is None:
+                return CANERR_NOTSUPP, None
+            __fd = c_int32(-1)
+            result = self.__m_library.can_property(self.__m_handle, c_uint16(self._event_property),
+                                                   byref(__fd), c_uint32(sizeof(__fd)))
+            if result < 0:
+                return int(result), None
+            return int(result), int(__fd.value)
+        except Exception as e:
+            print('+++ exception: {}'.format(e))
+            raise
+
+    async def read_async(self, timeout=None):
+        """
+          read one message from the message queue of the CAN interface (asyncio).
+          The coroutine waits for the event file descriptor of the CAN interface in the
+          event loop (loop.add_reader), or polls the message queue if not supported.
+          The messages are taken from the message queue in batches.
+
+          :param timeout: time to wait for the reception of the message:
+                            None or 65535 means waiting until a message was received,
+                            and any other value means the time to wait in milliseconds
+          :return: result, message
+            result: 0 if successful, or a negative value on error
+            message: the message read from the message queue or None
+        """
+        loop = asyncio.get_running_loop()
+        deadline = None
+        if timeout is not None and timeout != CANWAIT_INFINITE:
+            deadline = loop.time() + timeout / 1000.0
+        while True:
+            # take the next message from the last batch, if any
+            if self.__m_rx_index < self.__m_rx_count:
+                __message = Message.from_buffer_copy(self.__m_rx_batch[self.__m_rx_index])
+                self.__m_rx_index += 1
+                return CANERR_NOERROR, __message
+            # read the next batch from the message queue (without waiting)
+            result, count = self.read_n(self.__m_rx_batch, timeout=0)
+            self.__m_rx_index = 0
+            self.__m_rx_count = count
+            if count > 0:
+                continue
+            if result != CANERR_RX_EMPTY:
+                return int(result), None
+            if deadline is not None and loop.time() >= deadline:
+                return CANERR_RX_EMPTY, None
+            # wait until the message queue is not empty (or time-out)
+            await self.__wait_readable(loop, None if deadline is None else deadline - loop.time())
+
+    async def write_async(self, message, timeout=None):
+        """
+          transmits one message over the CAN bus (asyncio). When the transmitter is busy,
+          the coroutine yields to the event loop and retries until the time-out expired.
+
+          :param message: the message to be sent
+          :param timeout: time to wait for the transmission of the message:
+                            0 means one attempt only, None or 65535 means waiting until
+                            the message was sent, and any other value means the time
+                            to wait in milliseconds
+          :return: 0 if successful, or a negative value on error
+        """
+        loop = asyncio.get_running_loop()
+        deadline = None
+        if timeout is not None and timeout != CANWAIT_INFINITE:
+            deadline = loop.time() + timeout / 1000.0
+        while True:
+            result = self.write(message, timeout=0)
+            if result != CANERR_TX_BUSY or (deadline is not None and loop.time() >= deadline):
+                return result
+            await asyncio.sleep(CANASYNC_POLL_TIME)
+
+    async def messages(self):
+        """
+          asynchronous iterator over the received messages (asyncio), e.g.:
+            async for message in can.messages(): ...
+          The iteration ends when the message queue could not be read (e.g. after can.reset()).
+
+          :return: async iterator of messages
+        """
+        while True:
+            result, message = await self.read_async()
+            if result < 0:
+                return
+            yield message
+
+    async def __wait_readable(self, loop, timeout):
+        #
+        # waits until the event file descriptor is readable (or polls the message queue)
+        #
+        result, fd = self.event_fd()
+        if fd is None:
+            await asyncio.sleep(CANASYNC_POLL_TIME if timeout is None else max(min(CANASYNC_POLL_TIME, timeout), 0))
+            return
+        __future = loop.create_future()
+        loop.add_reader(fd, lambda: __future.done() or __future.set_result(None))
+        try:
+            await asyncio.wait_for(__future, timeout)
+        except asyncio.TimeoutError:
+            pass
+        finally:
+            loop.remove_reader(fd)
+
+    @staticmethod
+    def __message_array(buffer, count, writable, item):
+        #
+        # maps a buffer onto an array of Message or Frame (without copying it, if possible)
+        #
+        if isinstance(buffer, Array) and buffer._type_ is item:
+            __messages = buffer
+        else:
+            __view = memoryview(buffer)
+            __length = __view.nbytes // sizeof(item)
+            if __view.nbytes % sizeof(item):
+                raise ValueError('buffer size is not a multiple of the item size ({})'.format(sizeof(item)))
+            if not __view.readonly:
+                __messages = (item * __length).from_buffer(buffer)
+            elif not writable:
+                __messages = (item * __length).from_buffer_copy(buffer)
+            else:
+                raise TypeError('buffer is read-only')
+        if count is None or count > len(__messages):
+            count = len(__messages)
+        return __messages, max(int(count), 0)
+
     def status(self):
         """
           retrieves the status register of the CAN interface.
@@ -784,6 +1316,41 @@ class CANAPI:
         return 'CAN API V3 for generic CAN Interfaces (Python Wrapper {}.{}.{})'.format(
             CAN_API_V3_PYTHON['major'], CAN_API_V3_PYTHON['minor'], CAN_API_V3_PYTHON['patch'])
 
+    @staticmethod
+    def message_dtype():
+        """
+          returns a numpy structured data type with the layout of a CAN message, so that
+          numpy arrays can be used as buffers for read_n and write_n (requires numpy).
+
+          :return: numpy.dtype of a CAN message (fields id, flags, dlc, data, sec, nsec)
+        """
+        import numpy
+        return numpy.dtype({'names': ['id', 'flags', 'dlc', 'data', 'sec', 'nsec'],
+                            'formats': [numpy.uint32, numpy.uint8, numpy.uint8, (numpy.uint8, 64),
+                                        numpy.dtype('i{}'.format(sizeof(c_long))),
+                                        numpy.dtype('i{}'.format(sizeof(c_long)))],
+                            'offsets': [Message.id.offset, Message.flags.offset, Message.dlc.offset,
+                                        Message.data.offset, Message.timestamp.offset,
+                                        Message.timestamp.offset + Timestamp.nsec.offset],
+                            'itemsize': sizeof(Message)})
+
+    @staticmethod
+    def frame_dtype():
+        """
+          returns a numpy structured data type with the compact layout of a CAN 2.0 frame,
+          so that numpy arrays can be used as buffers for read_frames and write_frames
+          (requires numpy).
+
+          :return: numpy.dtype of a CAN frame (fields id, flags, dlc, data, timestamp)
+        """
+        import numpy
+        return numpy.dtype({'names': ['id', 'flags', 'dlc', 'data', 'timestamp'],
+                            'formats': [numpy.uint32, numpy.uint8, numpy.uint8, (numpy.uint8, 8),
+                                        numpy.uint64],
+                            'offsets': [Frame.id.offset, Frame.flags.offset, Frame.dlc.offset,
+                                        Frame.data.offset, Frame.timestamp.offset],
+                            'itemsize': sizeof(Frame)})
+
     @staticmethod
     def dlc2len(dlc):
         """
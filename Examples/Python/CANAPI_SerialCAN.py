@@ -132,3 +132,190 @@ class SerialPort(LittleEndianStructure):
         ('name', c_char_p),
         ('attr', SerialAttr)
     ]
+
+
+# SerialCAN vendor-specific properties
+#
+SERIALCAN_PROPERTY_RCV_QUEUE_FILL = 256 + 0x10  # number of messages in the receive queue
+SERIALCAN_PROPERTY_RCV_EVENT_FD = 256 + 0x11    # file descriptor readable when messages received
+SERIALCAN_PROPERTY_RCV_QUEUE_OPTIONS = 256 + 0x13  # memory options of the receive queue
+SERIALCAN_PROPERTY_SET_RCV_QUEUE_SIZE = 512 + 0x12  # set size of the receive queue (in INIT mode)
+SERIALCAN_PROPERTY_SET_RCV_QUEUE_OPTIONS = 512 + 0x13  # set memory options of the receive queue (in INIT mode)
+SERIALCAN_PROPERTY_RCV_QUEUE_POLICY = 256 + 0x14  # overflow policy of the receive queue (uint8)
+SERIALCAN_PROPERTY_RCV_QUEUE_BLOCK_TIME = 256 + 0x15  # max. blocking time on overflow (uint16, in ms)
+SERIALCAN_PROPERTY_RCV_QUEUE_GAPS = 256 + 0x16  # number of loss intervals of the receive queue (uint64)
+SERIALCAN_PROPERTY_SET_RCV_QUEUE_POLICY = 512 + 0x14  # set overflow policy of the receive queue
+SERIALCAN_PROPERTY_SET_RCV_QUEUE_BLOCK_TIME = 512 + 0x15  # set max. blocking time on overflow
+SERIALCAN_PROPERTY_RCV_LANE_SIZE = 256 + 0x17  # size of each priority lane (uint32)
+SERIALCAN_PROPERTY_SET_RCV_LANE_SIZE = 512 + 0x17  # set size of each priority lane (in INIT mode)
+SERIALCAN_PROPERTY_SET_RCV_LANE_CLASS = 512 + 0x18  # assign identifiers to a priority lane (SerialLane, in INIT mode)
+SERIALCAN_PROPERTY_SET_RCV_LANE_RESET = 512 + 0x19  # assign all identifiers to the receive queue (in INIT mode)
+SERIALCAN_PROPERTY_SET_GATEWAY_ROUTES = 512 + 0x1B  # forward received frames to another interface (SerialGateway, in INIT mode)
+SERIALCAN_PROPERTY_GATEWAY_STATUS = 256 + 0x1C  # number of routes and frame counters of the gateway (SerialGatewayStatus)
+SERIALCAN_PROPERTY_J1939_STATUS = 256 + 0x1D  # own address and session counters of the J1939 engine (SerialJ1939Status)
+SERIALCAN_PROPERTY_AUTO_BAUD_DWELL = 256 + 0x1E  # dwell time per candidate of the bit-rate detection (uint16, in ms)
+SERIALCAN_PROPERTY_SET_AUTO_BAUD_DWELL = 512 + 0x1E  # set dwell time per candidate of the bit-rate detection
+SERIALCAN_PROPERTY_AUTO_RETRANSMIT = 256 + 0x1F  # automatic retransmission of CAN frames (uint8, 0 = off, 1 = on)
+SERIALCAN_PROPERTY_SET_AUTO_RETRANSMIT = 512 + 0x1F  # set automatic retransmission (in INIT mode, CANable only)
+SERIALCAN_PROPERTY_STATUS_POLL_TIME = 256 + 0x20  # polling interval of the status flags (uint16, in ms, 0 = off)
+SERIALCAN_PROPERTY_SET_STATUS_POLL_TIME = 512 + 0x20  # set polling interval of the status flags (in INIT mode)
+
+# SerialCAN bit-rate detection (listen-only probing, CANable: in silent mode)
+#
+CANSIO_BITRATE_AUTO = -128      # bit-rate index: detect the bit-rate of the bus (start)
+CANSIO_AUTO_BAUD_DWELL = 50     # default dwell time per candidate (in ms)
+
+# SerialCAN receive queue options
+#
+CANSIO_QUEUE_LAZY_COMMIT = 0x01  # memory is committed when touched (default)
+CANSIO_QUEUE_HUGE_PAGES = 0x02   # memory is backed by huge pages, if available
+CANSIO_QUEUE_SHRINK_IDLE = 0x04  # memory is released when the queue runs empty
+
+# SerialCAN receive queue policies
+#
+CANSIO_QUEUE_DROP_NEWEST = 0     # the received message is dropped (default)
+CANSIO_QUEUE_DROP_OLDEST = 1     # the oldest message is overwritten
+CANSIO_QUEUE_BLOCK_PRODUCER = 2  # the reception waits for free space (bounded)
+
+# SerialCAN receive lanes
+#
+CANSIO_MAX_LANES = 3    # number of priority lanes (1 = lowest, 3 = highest priority)
+CANSIO_LANE_SIZE = 256  # default size of each priority lane
+
+
+class SerialLane(LittleEndianStructure):
+    """
+      SerialCAN priority class: first <= (id & mask) <= last
+    """
+    _fields_ = [
+        ('first', c_uint32),
+        ('last', c_uint32),
+        ('mask', c_uint32),
+        ('xtd', c_uint8),
+        ('lane', c_uint8)
+    ]
+
+
+# SerialCAN gateway
+#
+CANSIO_MAX_ROUTES = 32  # max. number of routes of a gateway
+
+
+class SerialRoute(LittleEndianStructure):
+    """
+      SerialCAN gateway route: (id & mask) == (code & mask), rewritten by idMask/id and dataMask/data
+    """
+    _fields_ = [
+        ('code', c_uint32),
+        ('mask', c_uint32),
+        ('xtd', c_uint8),
+        ('reserved', c_uint8),
+        ('interval', c_uint16),
+        ('id', c_uint32),
+        ('idMask', c_uint32),
+        ('data', c_uint8 * 8),
+        ('dataMask', c_uint8 * 8)
+    ]
+
+
+class SerialGateway(Structure):
+    """
+      SerialCAN gateway: handle of the target interface and an array of routes
+    """
+    _fields_ = [
+        ('target', c_int32),
+        ('count', c_uint32),
+        ('routes', POINTER(SerialRoute))
+    ]
+
+
+class SerialGatewayStatus(LittleEndianStructure):
+    """
+      SerialCAN gateway status: number of routes and frame counters
+    """
+    _fields_ = [
+        ('routes', c_uint32),
+        ('target', c_int32),
+        ('forwarded', c_uint64),
+        ('limited', c_uint64),
+        ('failed', c_uint64)
+    ]
+
+
+# SerialCAN ISO-TP channels (ISO 15765-2)
+#
+CANSIO_ISOTP_NORMAL = 0     # normal addressing (identifier only)
+CANSIO_ISOTP_EXTENDED = 1   # extended addressing (target address in data[0])
+CANSIO_ISOTP_MIXED = 2      # mixed addressing (address extension in data[0])
+CANSIO_ISOTP_MAX_PDU = 4095  # max. length of a PDU (classical CAN)
+CANSIO_ISOTP_CHANNELS = 8   # max. number of ISO-TP channels per interface
+
+
+class SerialIsoTp(LittleEndianStructure):
+    """
+      SerialCAN ISO-TP channel: identifiers, addressing mode and flow control parameters
+    """
+    _fields_ = [
+        ('txId', c_uint32),
+        ('rxId', c_uint32),
+        ('xtd', c_uint8),
+        ('mode', c_uint8),
+        ('txAddr', c_uint8),
+        ('rxAddr', c_uint8),
+        ('blockSize', c_uint8),
+        ('stMin', c_uint8),
+        ('padding', c_uint8),
+        ('padByte', c_uint8),
+        ('timeout', c_uint16)
+    ]
+
+
+# SerialCAN J1939 transport protocol (BAM/CMDT)
+#
+CANSIO_J1939_SINGLE_FRAMES = 0x01   # deliver single-frame PGNs as PDUs too
+CANSIO_J1939_CONSUME_FRAMES = 0x02  # TP.CM and TP.DT frames are not put into the receive queue
+CANSIO_J1939_MAX_PDU = 1785         # max. length of a PDU (255 packets of 7 bytes)
+CANSIO_J1939_MAX_SESSIONS = 4096    # max. number of concurrent sessions
+CANSIO_J1939_NULL_ADDR = 0xFE       # null address (no address claimed)
+
+
+class SerialJ1939(LittleEndianStructure):
+    """
+      SerialCAN J1939 engine: options, number of concurrent sessions and queued PDUs (0 = default)
+    """
+    _fields_ = [
+        ('options', c_uint8),
+        ('reserved', c_uint8),
+        ('sessions', c_uint16),
+        ('queueSize', c_uint16)
+    ]
+
+
+class SerialJ1939Status(LittleEndianStructure):
+    """
+      SerialCAN J1939 engine status: own address and session counters
+    """
+    _fields_ = [
+        ('address', c_uint8),
+        ('reserved', c_uint8 * 3),
+        ('active', c_uint32),
+        ('completed', c_uint64),
+        ('aborted', c_uint64),
+        ('expired', c_uint64)
+    ]
+
+
+# SerialCAN status messages (flag 'sts' set, identifier = code)
+#
+CANSIO_STS_QUEUE_OVERFLOW = 1    # messages lost: data[0:4] = number, data[4:8] = interval in ms (little endian)
+CANSIO_STS_CONTROLLER = 2        # status flags changed: data[0] = status flags of the device (error frames mode)
+CANSIO_STS_DISCONNECTED = 3      # serial line disconnected: data[0] = last status flags (error frames mode)
+CANSIO_STATUS_POLL_TIME = 100    # default polling interval of the status flags (in ms)
+
+
+class SerialCAN(CANAPI):
+    """
+      CAN API V3 class for CAN-over-Serial-Line Interfaces
+      (with an event file descriptor for asyncio under Linux and macOS)
+    """
+    _event_property = SERIALCAN_PROPERTY_RCV_EVENT_FD
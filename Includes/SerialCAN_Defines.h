@@ -0,0 +1,425 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for CAN-over-Serial-Line Interfaces)
+ *
+ *  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  This file is part of SerialCAN.
+ *
+ *  SerialCAN is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version). You can
+ *  choose between one of them if you use SerialCAN in whole or in part.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  SerialCAN IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF SerialCAN, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  SerialCAN is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SerialCAN is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with SerialCAN.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        SerialCAN_Defines.h
+ *
+ *  @brief       CAN API V3 for generic CAN Interfaces - Definitions and Options
+ *
+ *  @author      $Author: eris $
+ *
+ *  @version     $Rev: 1398 $
+ *
+ *  @addtogroup  can_api
+ *  @{
+ */
+#ifndef CANAPI_SERIALCAN_H_INCLUDED
+#define CANAPI_SERIALCAN_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*  -----------  includes  ------------------------------------------------
+ */
+
+#include <stdint.h>                     /* C99 header for sized integer types */
+#include <stdbool.h>                    /* C99 header for boolean type */
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+/** @name  Compiler Switches
+ *  @brief Options for conditional compilation.
+ *  @{ */
+/** @note  Set define OPTION_CAN_2_0_ONLY to a non-zero value to compile
+ *         with CAN 2.0 frame format only (e.g. in the build environment).
+ */
+#ifndef OPTION_DISABLED
+#define OPTION_DISABLED  0  /**< if a define is not defined, it is automatically set to 0 */
+#endif
+/** @} */
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  CAN API Interfaces
+ *  @brief Serial line interfaces
+ *  @{ */
+#define CANSIO_BOARDS               0  /**< number of serial line interfaces */
+/** @} */
+
+/** @name  Protocol option
+ *  @brief SLCAN protocol option
+ *  @{ */
+#define CANSIO_LAWICEL           0x00U  /**< Lawicel SLCAN protocol */
+#define CANSIO_CANABLE           0x01U  /**< CANable SLCAN protocol */
+#define CANSIO_WEACT             0x08U  /**< WeAct SLCAN protocol (CANable + ACK) */
+#define CANSIO_SHARED            0x10U  /**< shared access through the SerialCAN daemon (POSIX only) */
+#define CANSIO_AUTO              0xFFU  /**< auto detect (not realized yet) */
+#define CANSIO_SLCAN    CANSIO_LAWICEL  /**< Lawicel SLCAN protocol (default) */
+ /** @} */
+
+ /** @name  Baud rate option
+  *  @brief Baud rate in bits per second
+  *  @note  CBAUDEX compatible (e.g. Linux)
+  *  @{ */
+#define CANSIO_BD57600          57600U  /**< 57.6 kBd */
+#define CANSIO_BD115200        115200U  /**< 115.2 kBd */
+#define CANSIO_BD230400        230400U  /**< 230.4 kBd */
+#define CANSIO_BD460800        460800U  /**< 460.8 kBd */
+#define CANSIO_BD500000        500000U  /**< 500.0 kBd */
+#define CANSIO_BD576000        576000U  /**< 576.0 kBd */
+#define CANSIO_BD921600        921600U  /**< 921.6 kBd */
+#define CANSIO_BD1000000      1000000U  /**< 1.000 MBd */
+#define CANSIO_BD1152000      1152000U  /**< 1.152 MBd */
+#define CANSIO_BD1500000      1500000U  /**< 1.500 MBd */
+#define CANSIO_BD2000000      2000000U  /**< 2.000 MBd */
+#define CANSIO_BD2500000      2500000U  /**< 2.500 MBd */
+#define CANSIO_BD3000000      3000000U  /**< 3.000 MBd */
+/** @} */
+
+/** @name  Data size option
+ *  @brief Number of data bits (5, 6, 7, 8)
+ *  @{ */
+#define CANSIO_5DATABITS            5U  /**< 5 bits per data byte */
+#define CANSIO_6DATABITS            6U  /**< 6 bits per data byte */
+#define CANSIO_7DATABITS            7U  /**< 7 bits per data byte */
+#define CANSIO_8DATABITS            8U  /**< 8 bits per data byte */
+/** @} */
+
+/** @name  Parity option
+ *  @brief Parity bit (None, Even, Odd)
+ *  @{ */
+#define CANSIO_NOPARITY             0U  /**< no parity */
+#define CANSIO_ODDPARITY            1U  /**< odd parity */
+#define CANSIO_EVENPARITY           2U  /**< even parity */
+/** @} */
+
+/** @name  Stop bit option
+ *  @brief Number of stop bits (1 or 2)
+ *  @{ */
+#define CANSIO_1STOPBIT             1U  /**< 1 stop bit */
+#define CANSIO_2STOPBITS            2U  /**< 2 stop bits */
+/** @} */
+
+/** @name  CAN API Property Value
+ *  @brief SLCAN parameter to be read or written
+ *  @{ */
+#define SLCAN_DEVICE_ID          0x00U  /**< device id number */
+#define SLCAN_SERIAL_NUMBER      0x01U  /**< device serial number */
+#define SLCAN_HARDWARE_VERSION   0x02U  /**< device hardware version */
+#define SLCAN_FIRMWARE_VERSION   0x03U  /**< device firmware version */
+#define SLCAN_CLOCK_FREQUENCY    0x05U  /**< CAN clock frequency (in [Hz]) */
+#define SLCAN_RCV_QUEUE_FILL     0x10U  /**< number of messages in the receive queue */
+#define SLCAN_RCV_EVENT_FD       0x11U  /**< file descriptor readable when messages received (POSIX) */
+#define SLCAN_RCV_QUEUE_SIZE     0x12U  /**< size of the receive queue (number of messages, set in INIT mode) */
+#define SLCAN_RCV_QUEUE_OPTIONS  0x13U  /**< memory options of the receive queue (set in INIT mode) */
+#define SLCAN_RCV_QUEUE_POLICY   0x14U  /**< overflow policy of the receive queue (uint8_t) */
+#define SLCAN_RCV_QUEUE_BLOCK_TIME 0x15U /**< max. blocking time of the reception on overflow (uint16_t, in [ms]) */
+#define SLCAN_RCV_QUEUE_GAPS     0x16U  /**< number of loss intervals of the receive queue (uint64_t) */
+#define SLCAN_RCV_LANE_SIZE      0x17U  /**< size of each priority lane (uint32_t, set in INIT mode, 0 = no lanes) */
+#define SLCAN_RCV_LANE_CLASS     0x18U  /**< assign identifiers to a priority lane (can_sio_lane_t, set in INIT mode) */
+#define SLCAN_RCV_LANE_RESET     0x19U  /**< assign all identifiers to the receive queue (NULL, set in INIT mode) */
+#define SLCAN_SHARED_INFO        0x1AU  /**< status of the SerialCAN daemon (can_sio_shared_t, CANSIO_SHARED only) */
+#define SLCAN_GATEWAY_ROUTES     0x1BU  /**< forward received frames to another interface (can_sio_gateway_t, set in INIT mode) */
+#define SLCAN_GATEWAY_STATUS     0x1CU  /**< number of routes and frame counters of the gateway (can_sio_gateway_status_t) */
+#define SLCAN_J1939_STATUS       0x1DU  /**< own address and session counters of the J1939 engine (can_sio_j1939_status_t) */
+#define SLCAN_AUTO_BAUD_DWELL    0x1EU  /**< dwell time per candidate of the bit-rate detection (uint16_t, in [ms]) */
+#define SLCAN_AUTO_RETRANSMIT    0x1FU  /**< automatic retransmission of CAN frames (uint8_t, 0 = off, 1 = on, set in INIT mode, CANable only) */
+#define SLCAN_STATUS_POLL_TIME   0x20U  /**< polling interval of the status flags (uint16_t, in [ms], 0 = off, set in INIT mode) */
+// TODO: define more or all parameters
+// ...
+/** @} */
+
+/** @name  Receive queue option
+ *  @brief Memory options of the receive queue (SLCAN_RCV_QUEUE_OPTIONS)
+ *  @{ */
+#define CANSIO_QUEUE_LAZY_COMMIT 0x01U  /**< memory is committed when touched (default) */
+#define CANSIO_QUEUE_HUGE_PAGES  0x02U  /**< memory is backed by huge pages, if available */
+#define CANSIO_QUEUE_SHRINK_IDLE 0x04U  /**< memory is released when the queue runs empty */
+/** @} */
+
+/** @name  Receive queue policy
+ *  @brief Overflow policies of the receive queue (SLCAN_RCV_QUEUE_POLICY)
+ *  @{ */
+#define CANSIO_QUEUE_DROP_NEWEST    0U  /**< the received message is dropped (default) */
+#define CANSIO_QUEUE_DROP_OLDEST    1U  /**< the oldest message is overwritten */
+#define CANSIO_QUEUE_BLOCK_PRODUCER 2U  /**< the reception waits for free space (SLCAN_RCV_QUEUE_BLOCK_TIME) */
+/** @} */
+
+/** @name  Receive lanes
+ *  @brief Priority lanes in front of the receive queue (SLCAN_RCV_LANE_CLASS)
+ *  @{ */
+#define CANSIO_MAX_LANES            3U  /**< number of priority lanes (1 = lowest, 3 = highest priority) */
+#define CANSIO_LANE_SIZE          256U  /**< default size of each priority lane (number of messages) */
+/** @} */
+
+/** @name  Bit-rate detection
+ *  @brief Automatic bit-rate detection by listen-only probing (can_start)
+ *  @{ */
+#define CANSIO_BITRATE_AUTO      (-128) /**< bit-rate index: detect the bit-rate of the bus (CANable: in silent mode) */
+#define CANSIO_AUTO_BAUD_DWELL     50U  /**< default dwell time per candidate (in [ms], SLCAN_AUTO_BAUD_DWELL) */
+/** @} */
+
+/** @name  Status messages
+ *  @brief In-band status messages in the receive queue (flag 'sts' set, identifier = code)
+ *  @{ */
+#define CANSIO_STS_QUEUE_OVERFLOW   1U  /**< messages lost: data[0..3] = number, data[4..7] = interval in [ms] (little endian) */
+#define CANSIO_STS_CONTROLLER       2U  /**< status flags changed: data[0] = status flags of the device (CANMODE_ERR only) */
+#define CANSIO_STS_DISCONNECTED     3U  /**< serial line disconnected: data[0] = last status flags (CANMODE_ERR only) */
+#define CANSIO_STATUS_POLL_TIME   100U  /**< default polling interval of the status flags (in [ms], SLCAN_STATUS_POLL_TIME) */
+/** @} */
+
+/** @name  Gateway
+ *  @brief CAN-to-CAN gateway between two interfaces (SLCAN_GATEWAY_ROUTES)
+ *  @{ */
+#define CANSIO_MAX_ROUTES          32U  /**< max. number of routes of a gateway */
+/** @} */
+
+/** @name  Shared access
+ *  @brief Shared-memory rings of the SerialCAN daemon (CANSIO_SHARED)
+ *  @{ */
+#define CANSIO_SHM_PREFIX     "slcan"   /**< prefix of the shared-memory object name (e.g. '/slcan.dev.ttyUSB0') */
+#define CANSIO_SHM_RING_SIZE    4096U   /**< default size of the receive ring (number of messages) */
+#define CANSIO_SHM_POST_SIZE     256U   /**< default size of the transmit ring (number of messages) */
+/** @} */
+
+/** @name  ISO-TP
+ *  @brief ISO-TP transport protocol (ISO 15765-2) channels (can_isotp_open)
+ *  @{ */
+#define CANSIO_ISOTP_NORMAL         0U  /**< normal addressing (identifier only) */
+#define CANSIO_ISOTP_EXTENDED       1U  /**< extended addressing (target address in data[0]) */
+#define CANSIO_ISOTP_MIXED          2U  /**< mixed addressing (address extension in data[0]) */
+#define CANSIO_ISOTP_MAX_PDU     4095U  /**< max. length of a PDU (classical CAN) */
+#define CANSIO_ISOTP_CHANNELS       8U  /**< max. number of ISO-TP channels per interface */
+/** @} */
+
+/** @name  J1939
+ *  @brief SAE J1939 transport protocol (BAM/CMDT) reassembly (can_j1939_init)
+ *  @{ */
+#define CANSIO_J1939_SINGLE_FRAMES  0x01U  /**< deliver single-frame PGNs as PDUs too */
+#define CANSIO_J1939_CONSUME_FRAMES 0x02U  /**< TP.CM and TP.DT frames are not put into the receive queue */
+#define CANSIO_J1939_MAX_PDU     1785U  /**< max. length of a PDU (255 packets of 7 bytes) */
+#define CANSIO_J1939_MAX_SESSIONS 4096U /**< max. number of concurrent sessions */
+#define CANSIO_J1939_NULL_ADDR   0xFEU  /**< null address (no address claimed) */
+/** @} */
+
+/** @name  CAN API Library ID
+ *  @brief Library ID and dynamic library names
+ *  @{ */
+#define SLCAN_LIB_ID             900    /**< library ID (CAN/COP API V1 compatible) */
+#if defined(_WIN32) || defined (_WIN64)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "u3canslc.dll"
+#elif defined(__linux__)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "libuvcanslc.so"
+#elif defined(__APPLE__)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "libUVCANSLC.dylib"
+#elif defined(__CYGWIN__)
+#define SLCAN_LIB_DRIVER        "(driverless)"
+#define SLCAN_LIB_WRAPPER       "libuvcanslc.so"
+#else
+#error Platform not supported
+#endif
+ /** @} */
+
+ /** @name  Miscellaneous
+  *  @brief More or less useful stuff
+  *  @{ */
+#define SLCAN_LIB_VENDOR        "(unknown)"
+#define SLCAN_LIB_WEBSITE       "http://info.cern.ch/hypertext/WWW/TheProject.html"
+#define SLCAN_LIB_HAZARD_NOTE   "If you connect your CAN device to a real CAN network when using this library,\n" \
+                                "you might damage your application."
+  /** @} */
+
+  /*  -----------  types  --------------------------------------------------
+ */
+
+/** @brief SerialCAN port attributes
+ */
+typedef struct can_sio_attr_t_ {        /* serial port attributes: */
+    uint32_t baudrate;                  /**<  baud rate (in [bps]) */
+    uint8_t  bytesize;                  /**<  number fo data bits (5, 6, 7, 8) */
+    uint8_t  parity;                    /**<  parity bit (None, Even, Odd) */
+    uint8_t  stopbits;                  /**<  number of stop bits (1 or 2) */
+    uint8_t  protocol;                  /**<  protocol (defaul: Lawicel) */
+} can_sio_attr_t;
+
+/** @brief SerialCAN port parameters
+ */
+typedef struct can_sio_param_t_ {       /* device parameters: */
+    char* name;                         /**< name of the serial port device */
+    can_sio_attr_t attr;                /**< serial communication attributes*/
+} can_sio_param_t;
+
+/** @brief SerialCAN priority class (identifiers assigned to a receive lane)
+ *
+ *  @remarks An identifier belongs to the class if: first <= (id & mask) <= last
+ *           (i.e. first = last for code and mask, mask = all ones for a range).
+ */
+typedef struct can_sio_lane_t_ {        /* priority class: */
+    uint32_t first;                     /**< first identifier (or code) */
+    uint32_t last;                      /**< last identifier (or code) */
+    uint32_t mask;                      /**< identifier mask */
+    uint8_t  xtd;                       /**< 11-bit (0) or 29-bit (1) identifier */
+    uint8_t  lane;                      /**< receive lane (0 = queue, 1..CANSIO_MAX_LANES) */
+} can_sio_lane_t;
+
+/** @brief SerialCAN gateway route (rule for forwarding received frames)
+ *
+ *  @remarks A frame matches the route if: (id & mask) == (code & mask), for
+ *           the selected identifier format (mask 0 = all identifiers).
+ *
+ *  @remarks The forwarded frame is rewritten: id = (id & ~idMask) | (route.id
+ *           & idMask), and the same for each data byte with dataMask and data
+ *           (zeros = unchanged).
+ */
+typedef struct can_sio_route_t_ {       /* gateway route: */
+    uint32_t code;                      /**< identifier code */
+    uint32_t mask;                      /**< identifier mask (0 = all identifiers) */
+    uint8_t  xtd;                       /**< 11-bit (0) or 29-bit (1) identifier */
+    uint8_t  reserved;                  /**< (reserved) */
+    uint16_t interval;                  /**< min. interval between two forwarded frames in [ms] (0 = no rate limit) */
+    uint32_t id;                        /**< new identifier bits (see idMask) */
+    uint32_t idMask;                    /**< identifier bits taken from 'id' */
+    uint8_t  data[8];                   /**< new payload bits (see dataMask) */
+    uint8_t  dataMask[8];               /**< payload bits taken from 'data' */
+} can_sio_route_t;
+
+/** @brief SerialCAN gateway (forwarding to another interface)
+ *
+ *  @remarks The routes are compiled into a lookup table, the first matching
+ *           route applies (count = 0 removes the gateway).
+ */
+typedef struct can_sio_gateway_t_ {     /* gateway: */
+    int32_t  target;                    /**< handle of the interface to forward to */
+    uint32_t count;                     /**< number of routes (0..CANSIO_MAX_ROUTES) */
+    const can_sio_route_t *routes;      /**< array of routes */
+} can_sio_gateway_t;
+
+/** @brief SerialCAN gateway status
+ */
+typedef struct can_sio_gateway_status_t_ { /* gateway status: */
+    uint32_t routes;                    /**< number of routes (0 = no gateway) */
+    int32_t  target;                    /**< handle of the interface to forward to (-1 = none) */
+    uint64_t forwarded;                 /**< number of forwarded frames */
+    uint64_t limited;                   /**< number of frames dropped by rate limit */
+    uint64_t failed;                    /**< number of frames not transmitted */
+} can_sio_gateway_status_t;
+
+/** @brief SerialCAN daemon status (published in the shared-memory object)
+ */
+typedef struct can_sio_shared_t_ {      /* daemon status: */
+    int32_t  pid;                       /**< process id of the daemon */
+    uint16_t btr0btr1;                  /**< bit-rate settings (SJA1000 BTR0/BTR1) */
+    uint8_t  status;                    /**< CAN status register of the device */
+    uint8_t  protocol;                  /**< SLCAN protocol of the device */
+    uint64_t tx;                        /**< number of transmitted CAN frames */
+    uint64_t rx;                        /**< number of received CAN frames */
+    uint64_t err;                       /**< number of received error frames */
+    uint64_t failed;                    /**< number of posted CAN frames not transmitted */
+} can_sio_shared_t;
+
+/** @brief SerialCAN ISO-TP channel (parameters of can_isotp_open)
+ *
+ *  @remarks The engine answers First Frames with Flow Control frames (blockSize,
+ *           stMin) and paces the transmission of Consecutive Frames as requested
+ *           by the receiver (STmin 0 = CFs are written in batches).
+ */
+typedef struct can_sio_isotp_t_ {       /* ISO-TP channel: */
+    uint32_t txId;                      /**< identifier of transmitted frames */
+    uint32_t rxId;                      /**< identifier of received frames */
+    uint8_t  xtd;                       /**< 11-bit (0) or 29-bit (1) identifiers */
+    uint8_t  mode;                      /**< addressing mode (CANSIO_ISOTP_NORMAL, _EXTENDED, _MIXED) */
+    uint8_t  txAddr;                    /**< address byte of transmitted frames (extended and mixed mode) */
+    uint8_t  rxAddr;                    /**< address byte of received frames (extended and mixed mode) */
+    uint8_t  blockSize;                 /**< block size sent in Flow Control frames (0 = no limit) */
+    uint8_t  stMin;                     /**< separation time sent in Flow Control frames (ISO 15765-2 coding) */
+    uint8_t  padding;                   /**< pad frames to 8 data bytes (0 = no padding) */
+    uint8_t  padByte;                   /**< value of the padding bytes */
+    uint16_t timeout;                   /**< time-out N_Bs and N_Cr in [ms] (0 = 1000ms) */
+} can_sio_isotp_t;
+
+/** @brief SerialCAN J1939 engine (parameters of can_j1939_init)
+ *
+ *  @remarks The engine reassembles the PDUs of all BAM and RTS/CTS sessions on
+ *           the bus; with an own address claimed it answers RTS frames to this
+ *           address (CTS and End of Message Acknowledge).
+ */
+typedef struct can_sio_j1939_t_ {       /* J1939 engine: */
+    uint8_t  options;                   /**< engine options (CANSIO_J1939_SINGLE_FRAMES, _CONSUME_FRAMES) */
+    uint8_t  reserved;                  /**< (reserved) */
+    uint16_t sessions;                  /**< number of concurrent sessions (0 = 256) */
+    uint16_t queueSize;                 /**< number of queued PDUs (0 = 64) */
+} can_sio_j1939_t;
+
+/** @brief SerialCAN J1939 engine status
+ */
+typedef struct can_sio_j1939_status_t_ { /* J1939 status: */
+    uint8_t  address;                   /**< own address (0xFE = none) */
+    uint8_t  reserved[3];               /**< (reserved) */
+    uint32_t active;                    /**< number of active sessions */
+    uint64_t completed;                 /**< number of reassembled PDUs */
+    uint64_t aborted;                   /**< number of aborted sessions */
+    uint64_t expired;                   /**< number of sessions timed out */
+} can_sio_j1939_status_t;
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CANAPI_SERIALCAN_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de, Homepage: https://www.uv-software.de/
+ */
@@ -0,0 +1,883 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (generic)
+ *
+ *  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  This file is part of CAN API V3.
+ *
+ *  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this file.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  CAN API V3 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CAN API V3 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        can_api.h
+ *
+ *  @brief       CAN API V3 for generic CAN Interfaces
+ *
+ *  @author      $Author: quaoar $
+ *
+ *  @version     $Rev: 1286 $
+ *
+ *  @defgroup    can_api CAN Interface API, Version 3
+ *  @{
+ */
+#ifndef CAN_API_H_INCLUDED
+#define CAN_API_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "CANAPI_Types.h"               /* CAN API data types and defines */
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+/** @name  Compiler Switches
+ *  @brief Options for conditional compilation.
+ *  @{ */
+/** @note  Set define OPTION_CANAPI_LIBRARY to a non-zero value to compile
+ *         the CAN API V3 loader library (e.g. in the build environment). Or
+ *         optionally set define OPTION_CANAPI_DRIVER to a non-zero value
+ *         to compile a CAN API V3 driver/wrapper library (default).
+ */
+/** @note  Set define OPTION_CANAPI_RETVALS to a non-zero value to compile
+ *         with CAN API V2 return values (e.g. in the build environment).
+ *         This should be the default for the C interface. Unfortunately
+ *         the logic is swapped.
+ */
+/** @note  Set define OPTION_CANAPI_DLLEXPORT to a non-zero value to compile
+ *         as a dynamic link library (e.g. in the build environment).
+ *         In your project set define OPTION_CANAPI_DLLIMPORT to a non-zero
+ *         value to load the dynamic link library at run-time. Or set it to
+ *         zero to compile your program with the CAN API source files or to
+ *         link your program with the static library at compile-time.
+ */
+#ifndef OPTION_DISABLED
+#define OPTION_DISABLED  0  /**< if a define is not defined, it is automatically set to 0 */
+#endif
+#if (CAN_API_SPEC != 0x300)
+#error Requires version 3.0 of CANAPI_Types.h
+#endif
+#if (OPTION_CANAPI_LIBRARY == 0)
+#if  (OPTION_CANAPI_DRIVER == 0)
+#define OPTION_CANAPI_DRIVER  1
+#endif
+#endif
+#if (OPTION_CANAPI_DLLEXPORT != 0)
+#define CANAPI  __declspec(dllexport)
+#elif (OPTION_CANAPI_DLLIMPORT != 0)
+#define CANAPI  __declspec(dllimport)
+#else
+#define CANAPI  extern
+#endif
+/** @} */
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Aliases
+ *  @brief Alternative names
+ *  @{ */
+typedef int                             can_handle_t;
+#define CANAPI_HANDLE                   (can_handle_t)(-1)
+#define CANBRD_AVAILABLE                CANBRD_PRESENT
+#define CANBRD_UNAVAILABLE              CANBRD_NOT_PRESENT
+#define CANBRD_INTESTABLE               CANBRD_NOT_TESTABLE
+#define CANEXIT_ALL                     CANKILL_ALL
+#define CAN_MAX_EXT_ID                  CAN_MAX_XTD_ID
+/** @} */
+
+/** @name  Legacy Stuff
+ *  @brief For compatibility reasons with CAN API V1 and V2
+ *  @{ */
+#define can_transmit(hnd, msg)          can_write(hnd, msg, 0U)
+#define can_receive(hnd, msg)           can_read(hnd, msg, 0U)
+#define can_software(hnd)               can_firmware(hnd)
+#define can_msg_t                       can_message_t
+/** @} */
+
+#if (OPTION_CANAPI_LIBRARY != 0)
+#define CAN_BOARD(lib ,brd)             lib, brd
+#elif (OPTION_CANAPI_DRIVER != 0)
+#define CAN_BOARD(lib, brd)             brd
+#else
+#error Remove the unneeded definition(s)
+#endif
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+#if (OPTION_CANAPI_LIBRARY != 0)
+/** @brief       CAN Board Vendor
+ *  @note        A CAN library from a board vendor is identified by its library id.
+ *  @remarks     Deprecated: This variable should not be used anymore!
+ *               Use the properties 'CANPROP_GET_VENDOR_ID' and
+ *               'CANPROP_GET_VENDOR_NAME' in conjunction with
+ *               'CANPROP_SET_FIRST_VENDOR' and 'CANPROP_SET_NEXT_VENDOR'.
+ */
+typedef struct can_vendor_t_ {
+    int32_t library;                   /**< library id. */
+    char   *name;                      /**< vendor name */
+} can_vendor_t;
+#endif
+/** @brief       CAN Interface Board
+ *  @note        A CAN interface board is identified by its channel no.
+ *  @remarks     Deprecated: This variable should not be used anymore!
+ *               Use the properties 'CANPROP_GET_CHANNEL_NO' and
+ *               'CANPROP_GET_CHANNEL_NAME' in conjunction with
+ *               'CANPROP_SET_FIRST_CHANNEL' and 'CANPROP_SET_NEXT_CHANNEL'.
+ */
+typedef struct can_board_t_ {
+#if (OPTION_CANAPI_LIBRARY != 0)
+    int32_t library;                    /**< library id. */
+#endif
+    int32_t type;                       /**< channel no. */
+    char   *name;                       /**< channel name */
+} can_board_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+#if (OPTION_CANAPI_LIBRARY != 0)
+CANAPI can_vendor_t can_vendors[];      /**< list of CAN board vendors */
+#endif
+CANAPI can_board_t can_boards[];        /**< list of CAN interface boards */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#if (OPTION_CANAPI_LIBRARY != 0)
+/** @brief       sets the search path for readings library informations from
+ *               JSON files.
+ *
+ *  @note        The search path can only be set once, either by ths function
+ *                or by the non-default constructor with a path argument.
+ *
+ *  @param[in]   pathname - path name, or NULL for current working directory
+ *
+ *  @returns     true if the search path has been successfully set, or
+ *               false on error.
+ *
+ *  @retval      CANERR_YETINIT   - search path already set
+ */
+CANAPI int can_path(const char* pathname);
+#endif
+
+/** @brief       probes if the CAN interface (hardware and driver) given by
+ *               the argument [ 'library' and ] 'channel' is present, and
+ *               if the requested operation mode is supported by the CAN
+ *               controller.
+ *
+ *  @note        When a requested operation mode is not supported by the
+ *               CAN controller, error CANERR_ILLPARA will be returned.
+ *
+ *  @remarks     Any loaded DLL will be released when not referenced
+ *               by another initialized CAN interface.
+ *
+ *  @param[in]   library - library id of the CAN interface
+ *  @param[in]   channel - channel number of the CAN interface
+ *  @param[in]   mode    - operation mode to be checked
+ *  @param[in]   param   - pointer to interface-specific parameters
+ *  @param[out]  result  - result of the channel test:
+ *                             < 0 - channel is not present,
+ *                             = 0 - channel is present,
+ *                             > 0 - channel is present, but in use
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_LIBRARY   - library could not be found
+ *  @retval      CANERR_ILLPARA   - illegal parameter value
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+#if (OPTION_CANAPI_LIBRARY != 0)
+CANAPI int can_test(int32_t library, int32_t channel, uint8_t mode, const void *param, int *result);
+#else
+CANAPI int can_test(int32_t channel, uint8_t mode, const void *param, int *result);
+#endif
+
+/** @brief       initializes the CAN interface (hardware and driver) by loading
+ *               and starting the appropriate DLL for the specified CAN controller
+ *               board given by the argument [ 'library' and ] 'channel'.
+ *               The operation state of the CAN controller is set to 'stopped';
+ *               no communication is possible in this state.
+ *
+ *  @param[in]   library - library id of the CAN interface
+ *  @param[in]   channel - channel number of the CAN interface
+ *  @param[in]   mode    - operation mode of the CAN controller
+ *  @param[in]   param   - pointer to board-specific parameters
+ *
+ *  @returns     handle of the CAN interface if successful,
+ *               or a negative value on error.
+ *
+ *  @retval      CANERR_LIBRARY   - library could not be found
+ *  @retval      CANERR_YETINIT   - interface already in use
+ *  @retval      CANERR_HANDLE    - no free handle found
+ *  @retval      others           - vendor-specific
+ */
+#if (OPTION_CANAPI_LIBRARY != 0)
+CANAPI int can_init(int32_t library, int32_t channel, uint8_t mode, const void *param);
+#else
+CANAPI int can_init(int32_t channel, uint8_t mode, const void *param);
+#endif
+
+
+/** @brief       stops any operation of the CAN interface and sets the operation
+ *               state of the CAN controller to 'offline'.
+ *
+ *  @note        The handle is invalid after this operation and could be assigned
+ *               to a different CAN controller board in a multy-board application.
+ *
+ *  @remarks     Afterwards the loaded DLL will be released when not referenced
+ *               by another initialized CAN interface.
+ *
+ *  @param[in]   handle  - handle of the CAN interface, or (-1) to shutdown all
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_exit(int handle);
+
+
+/** @brief       signals a waiting event object of the CAN interface. This can
+ *               be used to terminate a blocking read operation in progress
+ *               (e.g. by means of a Ctrl-C handler or similar).
+ *
+ *  @remarks     Some drivers are using waitable objects to realize blocking
+ *               operations by a call to WaitForSingleObject (Windows) or
+ *               pthread_cond_wait (POSIX), but these waitable objects are
+ *               no cancellation points. This means that they cannot be
+ *               terminated by Ctrl-C (SIGINT).
+ *
+ *  @note        SIGINT is not supported for any Win32 application. [MSVC Docs]
+ *
+ *  @param[in]   handle  - handle of the CAN interface, or (-1) to signal all
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_kill(int handle);
+
+
+/** @brief       initializes the operation mode and the bit-rate settings of the
+ *               CAN interface and sets the operation state of the CAN controller
+ *               to 'running'.
+ *
+ *  @note        All statistical counters (tx/rx/err) will be reset by this.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   bitrate - bit-rate as btr register or baud rate index
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_BAUDRATE  - illegal bit-rate settings
+ *  @retval      CANERR_ONLINE    - interface already started
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_start(int handle, const can_bitrate_t *bitrate);
+
+
+/** @brief       stops any operation of the CAN interface and sets the operation
+ *               state of the CAN controller to 'stopped'; no communication is
+ *               possible in this state.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_OFFLINE   - interface already stopped
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_reset(int handle);
+
+
+/** @brief       transmits a message over the CAN bus. The CAN controller must be
+ *               in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   message - pointer to the message to send
+ *  @param[in]   timeout - time to wait for the transmission of a message:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      CANERR_QUE_OVR - transmit queue overrun
+  *  @retval      others           - vendor-specific
+ */
+CANAPI int can_write(int handle, const can_message_t *message, uint16_t timeout);
+
+
+/** @brief       read one message from the message queue of the CAN interface, if
+ *               any message was received. The CAN controller must be in operation
+ *               state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  message - pointer to a message buffer
+ *  @param[in]   timeout - time to wait for the reception of a message:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      CANERR_QUE_OVR - reveive queue overrun
+ *  @retval      CANERR_ERR_FRAME - error frame received
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read(int handle, can_message_t *message, uint16_t timeout);
+
+
+/** @brief       transmits several messages over the CAN bus. The CAN controller
+ *               must be in operation state 'running'.
+ *
+ *  @remarks     The messages are sent one after the other, the transmission
+ *               stops at the first message that could not be sent.
+ *
+ *  @remarks     On a serial port, the messages are written in batches and the
+ *               acknowledgments of the device are not awaited: a message that
+ *               is rejected by the device (NACK) is not reported.
+ *
+ *  @param[in]   handle   - handle of the CAN interface
+ *  @param[in]   messages - pointer to an array of messages to send
+ *  @param[in]   count    - number of messages in the array
+ *  @param[in]   timeout  - time to wait for the transmission of a message:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking write, and any other
+ *                               value means the time to wait in milliseconds
+ *
+ *  @returns     the number of messages sent if successful, or a negative value
+ *               on error (when the first message could not be sent).
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_write_n(int handle, const can_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       read up to n messages from the message queue of the CAN interface,
+ *               if any message was received. The CAN controller must be in
+ *               operation state 'running'.
+ *
+ *  @remarks     The function waits for the first message only, the following
+ *               messages are taken from the message queue if already received.
+ *
+ *  @param[in]   handle   - handle of the CAN interface
+ *  @param[out]  messages - pointer to an array of message buffers
+ *  @param[in]   count    - maximum number of messages to be read
+ *  @param[in]   timeout  - time to wait for the reception of a message:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait in milliseconds
+ *
+ *  @returns     the number of messages read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_n(int handle, can_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       transmits n CAN 2.0 frames (compact layout) over the CAN bus.
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @remarks     Same as can_write_n, but with the compact frame layout of
+ *               24 bytes per frame (CAN 2.0 only, no CAN FD payload).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   frames  - pointer to an array of frames to send
+ *  @param[in]   count   - number of frames to send
+ *  @param[in]   timeout - time to wait for the transmission of each frame:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking write, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the number of frames sent if successful, or a negative value
+ *               on error (if the first frame could not be sent).
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_write_frames(int handle, const can_frame_t *frames, size_t count, uint16_t timeout);
+
+
+/** @brief       read up to n CAN 2.0 frames (compact layout) from the message
+ *               queue of the CAN interface, if any frame was received.
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @remarks     Same as can_read_n, but with the compact frame layout of
+ *               24 bytes per frame (CAN 2.0 only, no CAN FD payload).
+ *
+ *  @remarks     SLCAN devices do not time-stamp the frames, the field
+ *               'timestamp' is set to 0.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  frames  - pointer to an array of frame buffers
+ *  @param[in]   count   - maximum number of frames to be read
+ *  @param[in]   timeout - time to wait for the reception of a frame:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the number of frames read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_frames(int handle, can_frame_t *frames, size_t count, uint16_t timeout);
+
+
+/** @brief       creates a subscriber of the CAN interface that receives a copy
+ *               of each received message accepted by its filter (fan-out).
+ *
+ *  @remarks     Each subscriber has a message queue of its own and is read by
+ *               can_read_subscriber, independently from can_read and from other
+ *               subscribers. A full subscriber queue drops the messages of this
+ *               subscriber only (reported by a status message).
+ *
+ *  @remarks     The filters are coded as for the properties CANPROP_SET_FILTER_11BIT
+ *               and CANPROP_SET_FILTER_29BIT (code in bits 32..63, mask in bits
+ *               0..31; 0 accepts all identifiers).
+ *
+ *  @param[in]   handle    - handle of the CAN interface
+ *  @param[in]   filter11  - acceptance filter for 11-bit identifier
+ *  @param[in]   filter29  - acceptance filter for 29-bit identifier
+ *  @param[in]   queueSize - size of the subscriber queue (number of messages)
+ *
+ *  @returns     the subscriber number if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid queue size
+ *  @retval      CANERR_RESOURCE  - no more subscribers or out of memory
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_subscribe(int handle, uint64_t filter11, uint64_t filter29, size_t queueSize);
+
+
+/** @brief       removes a subscriber of the CAN interface.
+ *
+ *  @param[in]   handle     - handle of the CAN interface
+ *  @param[in]   subscriber - subscriber number (from can_subscribe)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid subscriber
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_unsubscribe(int handle, int subscriber);
+
+
+/** @brief       read up to n messages from the message queue of a subscriber,
+ *               if any message was received. The CAN controller must be in
+ *               operation state 'running'.
+ *
+ *  @remarks     The function waits for the first message only, the following
+ *               messages are taken from the message queue if already received.
+ *
+ *  @param[in]   handle     - handle of the CAN interface
+ *  @param[in]   subscriber - subscriber number (from can_subscribe)
+ *  @param[out]  messages   - pointer to an array of message buffers
+ *  @param[in]   count      - maximum number of messages to be read
+ *  @param[in]   timeout    - time to wait for the reception of a message:
+ *                                 0 means the function returns immediately,
+ *                                 65535 means blocking read, and any other
+ *                                 value means the time to wait in milliseconds
+ *
+ *  @returns     the number of messages read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid subscriber
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_subscriber(int handle, int subscriber, can_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       opens an ISO-TP channel (ISO 15765-2) on the CAN interface.
+ *
+ *  @remarks     The transport protocol runs on the reception thread of the
+ *               interface: frames of an open channel are consumed by the
+ *               engine (not queued), First Frames are answered immediately
+ *               by a Flow Control frame.
+ *
+ *  @note        The parameters of an ISO-TP channel are vendor-specific
+ *               (e.g. can_sio_isotp_t for SerialCAN interfaces).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   param   - pointer to the channel parameters
+ *
+ *  @returns     the channel number if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid channel parameters
+ *  @retval      CANERR_RESOURCE  - no more channels or out of memory
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_open(int handle, const void *param);
+
+
+/** @brief       closes an ISO-TP channel of the CAN interface.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   channel - channel number (from can_isotp_open)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid channel
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_close(int handle, int channel);
+
+
+/** @brief       transmits a PDU on an ISO-TP channel (segmented if required).
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @remarks     The function returns when the last frame of the PDU has been
+ *               written; it waits for the Flow Control frames of the receiver.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   channel - channel number (from can_isotp_open)
+ *  @param[in]   data    - pointer to the PDU
+ *  @param[in]   length  - length of the PDU (1 to 4095 bytes)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid channel or length
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TIMEOUT   - no Flow Control frame received (N_Bs)
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_send(int handle, int channel, const uint8_t *data, size_t length);
+
+
+/** @brief       reads a received PDU from an ISO-TP channel, if any PDU was
+ *               received. The CAN controller must be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   channel - channel number (from can_isotp_open)
+ *  @param[out]  buffer  - pointer to a buffer for the PDU
+ *  @param[in]   size    - size of the buffer (a longer PDU is discarded)
+ *  @param[in]   timeout - time to wait for the reception of a PDU:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the length of the PDU if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid channel, or buffer too small for the PDU
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - no PDU received
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_receive(int handle, int channel, uint8_t *buffer, size_t size, uint16_t timeout);
+
+
+/** @brief       initializes the SAE J1939 transport protocol on the CAN interface
+ *               (reassembly of BAM and RTS/CTS sessions).
+ *
+ *  @remarks     The engine runs on the reception thread of the interface; the
+ *               reassembled PDUs are read by can_j1939_receive. It is released
+ *               by can_exit.
+ *
+ *  @note        The parameters of the engine are vendor-specific (e.g.
+ *               can_sio_j1939_t for SerialCAN interfaces, NULL = defaults).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   param   - pointer to the engine parameters (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_YETINIT   - already initialized
+ *  @retval      CANERR_ILLPARA   - invalid engine parameters
+ *  @retval      CANERR_RESOURCE  - out of memory
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_j1939_init(int handle, const void *param);
+
+
+/** @brief       claims an own J1939 address (address claim procedure). The CAN
+ *               controller must be in operation state 'running'.
+ *
+ *  @remarks     The function waits 250ms for contending claims; the NAME with
+ *               the lower value wins. Address 254 releases the own address.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   address - address to be claimed (0..253, or 254)
+ *  @param[in]   name    - NAME of the node (64-bit)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid address (or J1939 not initialized)
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific (e.g. address lost)
+ */
+CANAPI int can_j1939_claim(int handle, uint8_t address, uint64_t name);
+
+
+/** @brief       reads a reassembled J1939 PDU, if any PDU was received. The CAN
+ *               controller must be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  pgn     - parameter group number (optional)
+ *  @param[out]  src     - source address (optional)
+ *  @param[out]  dst     - destination address, 255 = global (optional)
+ *  @param[out]  data    - pointer to a buffer for the PDU
+ *  @param[in]   size    - size of the buffer (a longer PDU is discarded)
+ *  @param[in]   timeout - time to wait for the reception of a PDU:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the length of the PDU if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - J1939 not initialized, or buffer too small for the PDU
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - no PDU received
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_j1939_receive(int handle, uint32_t *pgn, uint8_t *src, uint8_t *dst, uint8_t *data, size_t size, uint16_t timeout);
+
+
+/** @brief       retrieves the status register of the CAN interface.
+ *
+ *  @param[in]   handle  - handle of the CAN interface.
+ *  @param[out]  status  - 8-bit status register.
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_status(int handle, uint8_t *status);
+
+
+/** @brief       retrieves the bus-load (in percent) of the CAN interface.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  load    - bus-load in [percent]
+ *  @param[out]  status  - 8-bit status register
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_busload(int handle, uint8_t *load, uint8_t *status);
+
+
+/** @brief       retrieves the bit-rate setting of the CAN interface. The
+ *               CAN controller must be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  bitrate - bit-rate setting
+ *  @param[out]  speed   - transmission rate
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_BAUDRATE  - invalid bit-rate settings
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed);
+
+
+/** @brief       retrieves or modifies a property value of the CAN interface.
+ *
+ *  @note        To read or to write a property value of the CAN API V3 DLL,
+ *               -1 can be given as handle.
+ *
+ *  @note        It is also possibel to give the library id of a CAN interface
+ *               DLL as argument, to read or to write a property value of that
+ *               CAN interface DLL.
+ *
+ *  @param[in]   handle   - handle or library id of the CAN interface, or (-1)
+ *  @param[in]   param    - property id to be read or to be written
+ *  @param[in,out]  value    - pointer to a buffer for the value to be read or  with the value to be written
+ *  @param[in]   nbyte   -  size of the given buffer in byte
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal parameter, value or nbyte
+ *  @retval      CANERR_...       - tbd.
+ *  @retval      CANERR_NOTSUPP   - property or function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_property(int handle, uint16_t param, void *value, uint32_t nbyte);
+
+
+/** @brief       retrieves the hardware version of the CAN controller
+ *               board as a zero-terminated string.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *
+ *  @returns     pointer to a zero-terminated string, or NULL on error.
+ */
+CANAPI char *can_hardware(int handle);
+
+
+/** @brief       retrieves the firmware version of the CAN controller
+ *               board as a zero-terminated string.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *
+ *  @returns     pointer to a zero-terminated string, or NULL on error.
+ */
+CANAPI char *can_firmware(int handle);
+
+
+#if (OPTION_CANAPI_LIBRARY != 0)
+/** @brief       retrieves version information of the CAN interface
+ *               (wrapper library) as a zero-terminated string.
+ *
+ *  @note        Instead of a valid handle, the library id of a
+ *               CAN interface DLL can be given as argument.
+ *
+ *  @param[in]   handle   - handle or library id of the CAN interface
+ *
+ *  @returns     pointer to a zero-terminated string, or NULL on error.
+ */
+CANAPI char *can_library(int handle);
+#endif
+
+
+/** @brief       retrieves version information of the CAN API V3 DLL
+ *               as a zero-terminated string.
+ *
+ *  @returns     pointer to a zero-terminated string, or NULL on error.
+ */
+CANAPI char* can_version(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAN_API_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -1,6 +1,6 @@
 // ControlCAN.cpp
 // Wrapper for ZLG ControlCAN.dll -> CAN API V3 (SerialCAN)
-// C++20, no WinAPI (only std C/C++), unbuffered logging, clean style.
+// C++20, no WinAPI (only std C/C++), asynchronous logging, clean style.
 // Exported API matches exactly the ZLG ControlCAN interface.
 //
 // Implemented functions:
@@ -26,14 +26,22 @@
 #endif
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <cctype>
+#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
-#include <format>
+#include <thread>
 
 // ZLG ControlCAN header
 #include "ControlCAN.h"
@@ -45,26 +53,72 @@
 #include "CANAPI_Defines.h"
 #include "SerialCAN_Defines.h"
 
+// printf conversions of DWORD (unsigned long on Windows, unsigned int elsewhere)
+#if defined(_WIN32)
+#define PRIuDW  "lu"
+#define PRIXDW  "lX"
+#else
+#define PRIuDW  "u"
+#define PRIXDW  "X"
+#endif
+
 // -----------------------------------------------------------------------------
 // Environment variables
+//   CONTROLCAN_SLCAN_PORT[_<DeviceInd>_<CANInd>]      serial port of a CAN channel
+//   CONTROLCAN_SLCAN_PROTOCOL[_<DeviceInd>_<CANInd>]  "lawicel", "canable" or "weact" (default)
+//   CONTROLCAN_SLCAN_BAUDRATE[_<DeviceInd>_<CANInd>]  serial baudrate (default 57600)
+//   A setting with suffix applies to that CAN channel only, a setting without
+//   suffix to all channels (the serial port to channel 0 of device 0 only).
 // -----------------------------------------------------------------------------
 
-static constexpr const char* ENV_CONTROLCAN_LOG {"CONTROLCAN_LOG"};
-static constexpr const char* ENV_SLCAN_PORT     {"CONTROLCAN_SLCAN_PORT"};
+static constexpr const char* ENV_CONTROLCAN_LOG  {"CONTROLCAN_LOG"};
+static constexpr const char* ENV_SLCAN_PORT      {"CONTROLCAN_SLCAN_PORT"};
+static constexpr const char* ENV_SLCAN_PROTOCOL  {"CONTROLCAN_SLCAN_PROTOCOL"};
+static constexpr const char* ENV_SLCAN_BAUDRATE  {"CONTROLCAN_SLCAN_BAUDRATE"};
 
 // -----------------------------------------------------------------------------
 // Logging system
+//   CONTROLCAN_LOG=<level> enables logging into "ControlCAN.log":
+//     1 - API calls and errors
+//     2 - API calls, errors and every transmitted/received CAN frame
+//   Records are queued by the caller and written by a background thread
+//   (buffered file I/O), so that logging does not stall VCI_Transmit or
+//   VCI_Receive. When the queue is full the record is dropped and counted.
 // -----------------------------------------------------------------------------
 
-static std::FILE* g_logFile   = nullptr;
-static bool       g_logEnabled = false;
-static std::mutex g_logMutex;
+enum LogLevel : int {
+    LOG_OFF    = 0,
+    LOG_CALLS  = 1,
+    LOG_FRAMES = 2
+};
+
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    const char*                           prefix;   // frame record, or nullptr
+    VCI_CAN_OBJ                           frame;
+    std::string                           text;     // text record
+};
+
+static constexpr std::size_t LOG_QUEUE_SIZE = 8192U;
+
+static std::FILE*              g_logFile  = nullptr;
+static std::atomic<int>        g_logLevel {LOG_OFF};
+static std::mutex              g_logMutex;
+static std::condition_variable g_logCond;
+static std::deque<LogRecord>   g_logQueue;
+static std::thread             g_logThread;
+static bool                    g_logStop    = false;
+static unsigned long           g_logDropped = 0UL;
+
+static inline bool LogEnabled(int level)
+{
+    return g_logLevel.load(std::memory_order_relaxed) >= level;
+}
 
-static std::string FormatTimestamp()
+static std::string FormatTimestamp(std::chrono::system_clock::time_point now)
 {
     using namespace std::chrono;
 
-    const auto now = system_clock::now();
     const auto ms  = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
 
     const std::time_t t = system_clock::to_time_t(now);
@@ -76,118 +130,309 @@ static std::string FormatTimestamp()
     localtime_r(&t, &tm);
 #endif
 
-    return std::format(
-        "{:02}:{:02}:{:02}.{:03}",
+    char buffer[16];
+    std::snprintf(
+        buffer, sizeof(buffer),
+        "%02d:%02d:%02d.%03d",
         tm.tm_hour,
         tm.tm_min,
         tm.tm_sec,
         static_cast<int>(ms.count())
     );
+    return buffer;
 }
 
-static void Log(const char* fmt, ...)
+static void WriteRecord(const LogRecord& r)
 {
-    if (!g_logEnabled || !g_logFile)
+    std::fprintf(g_logFile, "%s  ", FormatTimestamp(r.time).c_str());
+
+    if (!r.prefix) {
+        std::fprintf(g_logFile, "%s\n", r.text.c_str());
         return;
+    }
+    const VCI_CAN_OBJ& f = r.frame;
+    std::fprintf(
+        g_logFile,
+        "%s ID=0x%08X %s %s DLC=%u DATA:",
+        r.prefix,
+        f.ID,
+        f.ExternFlag ? "EXT" : "STD",
+        f.RemoteFlag ? "RTR" : "DATA",
+        f.DataLen
+    );
+    for (unsigned i = 0; i < f.DataLen && i < 8; ++i)
+        std::fprintf(g_logFile, " %02X", f.Data[i]);
+
+    std::fprintf(g_logFile, "\n");
+}
+
+// Logger thread: takes all queued records at once and writes them out,
+// the file is flushed whenever the queue runs empty
+static void LogWriter()
+{
+    std::deque<LogRecord> records;
+    std::unique_lock lock(g_logMutex);
+
+    for (;;) {
+        g_logCond.wait(lock, [] { return g_logStop || !g_logQueue.empty(); });
+        if (g_logQueue.empty() && g_logStop)
+            break;
+
+        records.swap(g_logQueue);
+        const unsigned long dropped = g_logDropped;
+        g_logDropped = 0UL;
+        lock.unlock();
+
+        for (const LogRecord& r : records)
+            WriteRecord(r);
+        if (dropped)
+            std::fprintf(g_logFile, "%s  (%lu log record(s) dropped)\n",
+                FormatTimestamp(std::chrono::system_clock::now()).c_str(), dropped);
+        records.clear();
+
+        lock.lock();
+        if (g_logQueue.empty()) {
+            lock.unlock();
+            std::fflush(g_logFile);
+            lock.lock();
+        }
+    }
+}
+
+// Enqueue one record (the caller holds g_logMutex)
+static inline void PushRecord(LogRecord&& r)
+{
+    if (g_logQueue.size() >= LOG_QUEUE_SIZE) {
+        ++g_logDropped;
+        return;
+    }
+    g_logQueue.push_back(std::move(r));
+}
 
-    std::lock_guard lock(g_logMutex);
+static void Log(const char* fmt, ...)
+{
+    if (!LogEnabled(LOG_CALLS))
+        return;
 
-    std::fprintf(g_logFile, "%s  ", FormatTimestamp().c_str());
+    LogRecord r{std::chrono::system_clock::now(), nullptr, {}, {}};
 
+    char buffer[512];
     va_list args;
     va_start(args, fmt);
-    std::vfprintf(g_logFile, fmt, args);
+    const int n = std::vsnprintf(buffer, sizeof(buffer), fmt, args);
     va_end(args);
+    r.text.assign(buffer, (n < 0) ? 0U : std::min<std::size_t>(n, sizeof(buffer) - 1U));
 
-    std::fprintf(g_logFile, "\n");
-    std::fflush(g_logFile);
+    {
+        std::lock_guard lock(g_logMutex);
+        PushRecord(std::move(r));
+    }
+    g_logCond.notify_one();
+}
+
+// Log a batch of CAN frames with one lock operation (level 2 only)
+static void LogCANFrames(const char* prefix, const VCI_CAN_OBJ* frames, std::size_t count)
+{
+    if (!LogEnabled(LOG_FRAMES) || !count)
+        return;
+
+    const auto now = std::chrono::system_clock::now();
+    {
+        std::lock_guard lock(g_logMutex);
+        for (std::size_t i = 0; i < count; ++i)
+            PushRecord(LogRecord{now, prefix, frames[i], {}});
+    }
+    g_logCond.notify_one();
 }
 
 static void InitLog()
 {
-    if (g_logEnabled) {
+    if (g_logFile) {
         return;
     }
 
     const char* env = std::getenv(ENV_CONTROLCAN_LOG);
-    if (!env || std::strcmp(env, "1") != 0) {
-        g_logEnabled = false;
+    const int level = env ? std::atoi(env) : LOG_OFF;
+    if (level <= LOG_OFF) {
         return;
     }
 
     g_logFile = std::fopen("ControlCAN.log", "w");
     if (!g_logFile) {
-        g_logEnabled = false;
         return;
     }
 
-    // Disable stdio buffering for the log file (unbuffered logging)
-    setvbuf(g_logFile, nullptr, _IONBF, 0);
-    g_logEnabled = true;
+    g_logStop    = false;
+    g_logDropped = 0UL;
+    g_logThread  = std::thread(LogWriter);
+    g_logLevel.store(std::min<int>(level, LOG_FRAMES));
 
-    Log("Logging enabled");
+    Log("Logging enabled (level %d)", g_logLevel.load());
 }
 
-static void LogCANFrame(const char* prefix, const VCI_CAN_OBJ& f)
+// Write out all pending records and stop the logger thread
+static void ExitLog()
 {
-    if (!g_logEnabled || !g_logFile)
+    if (!g_logFile) {
         return;
+    }
 
-    std::lock_guard lock(g_logMutex);
-
-    std::fprintf(
-        g_logFile,
-        "%s  %s ID=0x%08X %s %s DLC=%u DATA:",
-        FormatTimestamp().c_str(),
-        prefix,
-        f.ID,
-        f.ExternFlag ? "EXT" : "STD",
-        f.RemoteFlag ? "RTR" : "DATA",
-        f.DataLen
-    );
-
-    for (unsigned i = 0; i < f.DataLen && i < 8; ++i)
-        std::fprintf(g_logFile, " %02X", f.Data[i]);
+    g_logLevel.store(LOG_OFF);
+    {
+        std::lock_guard lock(g_logMutex);
+        g_logStop = true;
+    }
+    g_logCond.notify_one();
+    if (g_logThread.joinable())
+        g_logThread.join();
 
-    std::fprintf(g_logFile, "\n");
-    std::fflush(g_logFile);
+    std::fclose(g_logFile);
+    g_logFile = nullptr;
 }
 
+// -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 // CAN globals
+//   Every (DeviceType, DeviceInd) opened by VCI_OpenDevice is an entry in
+//   the device map, each of its CAN channels (CANInd) is a SerialCAN device
+//   on its own serial port with its own CAN API handle and RX lock.
+//   VCI_CloseDevice removes the entry from the map, the device itself lives
+//   on as long as a ChannelLock refers to it. The CAN API handle is only
+//   used under the (shared) API lock of its channel; configuration writes
+//   (VCI_InitCAN) and VCI_CloseDevice (to call can_exit) take it exclusively.
 // -----------------------------------------------------------------------------
 
-// Single CAN handle (one device)
-static int           g_canHandle  = CANAPI_HANDLE;
+// Max. number of CAN channels per device (CANInd)
+static constexpr DWORD MAX_CHANNELS = 8U;
+
+struct Channel {
+    std::atomic<int> handle {CANAPI_HANDLE};  // CAN API handle
+    can_bitrate_t    bitrate {};              // last used bitrate (for restart in ClearBuffer)
+    uint8_t          protocol = CANSIO_WEACT; // SLCAN device serial protocol
+    std::atomic<bool> started {false};        // can_start has been called
+    std::mutex       rxMutex;                 // serializes VCI_Receive on this channel
+    std::shared_mutex apiMutex;               // held across each CAN API call on the handle
+};
 
-// Last used bitrate (for potential restart in ClearBuffer)
-static can_bitrate_t g_lastBitrate{};
+struct Device {
+    bool    open = false;
+    Channel channels[MAX_CHANNELS];
+};
 
-// SLCAN device serial protocol
-static uint8_t       g_slcanProtocol = CANSIO_WEACT;
+// API lock of a channel, together with a reference to its device
+template<typename Lock>
+struct ChannelGuard {
+    std::shared_ptr<Device> device;  // keeps the channel alive
+    Lock lock;                       // released before the device
+};
 
-// Indicates that can_start has been called
-static bool          g_canStarted = false;
+using ChannelLock = ChannelGuard<std::shared_lock<std::shared_mutex>>;
+using ChannelWriteLock = ChannelGuard<std::unique_lock<std::shared_mutex>>;
 
-// Mutex to serialize VCI_Receive access (CAN API is usually thread-safe,
-// ale aplikace ControlCAN to typicky volá z jednoho threadu – i tak ochráníme)
-static std::mutex    g_rxMutex;
+using DeviceKey = std::pair<DWORD, DWORD>;  // (DeviceType, DeviceInd)
+
+static std::map<DeviceKey, std::shared_ptr<Device>> g_devices;
+static std::shared_mutex                            g_devMutex;
 
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
 
-// Get serial port from CONTROLCAN_SLCAN_PORT, default "\\.\COM1"
-static std::string GetSerialPort()
+// Get a configuration value from the environment: <name>_<DeviceInd>_<CANInd>
+// first, then <name> (if fallback is set)
+static const char* GetConfig(const char* name, DWORD DeviceInd, DWORD CANInd, bool fallback)
+{
+    char key[64];
+    std::snprintf(key, sizeof(key), "%s_%" PRIuDW "_%" PRIuDW, name, DeviceInd, CANInd);
+
+    const char* env = std::getenv(key);
+    if (env && *env)
+        return env;
+    if (fallback && (env = std::getenv(name)) && *env)
+        return env;
+    return nullptr;
+}
+
+// Get serial port of a CAN channel, default "\\.\COM1" resp. "/dev/ttyUSB0"
+// for the first channel of the first device, none for all others
+static std::string GetSerialPort(DWORD DeviceInd, DWORD CANInd)
 {
-    if (const char* env = std::getenv(ENV_SLCAN_PORT)) {
-        if (*env)
+    const bool first = (DeviceInd == 0 && CANInd == 0);
+
+    if (const char* env = GetConfig(ENV_SLCAN_PORT, DeviceInd, CANInd, first)) {
+#if defined(_WIN32)
+        if (std::strncmp(env, R"(\\)", 2) != 0)
             return std::string(R"(\\.\)") + env;
+#endif
+        return env;
     }
+    if (!first)
+        return {};
+#if defined(_WIN32)
     return R"(\\.\COM1)";
+#else
+    return "/dev/ttyUSB0";
+#endif
 }
 
-static void ConvertToCANAPI(const VCI_CAN_OBJ& in, can_message_t& out)
+// Get SLCAN protocol of a CAN channel ("lawicel", "canable" or "weact")
+static uint8_t GetProtocol(DWORD DeviceInd, DWORD CANInd)
+{
+    if (const char* env = GetConfig(ENV_SLCAN_PROTOCOL, DeviceInd, CANInd, true)) {
+        std::string s(env);
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (s == "lawicel")
+            return CANSIO_LAWICEL;
+        if (s == "canable")
+            return CANSIO_CANABLE;
+    }
+    return CANSIO_WEACT;
+}
+
+// Get serial baudrate of a CAN channel
+static uint32_t GetBaudrate(DWORD DeviceInd, DWORD CANInd)
+{
+    if (const char* env = GetConfig(ENV_SLCAN_BAUDRATE, DeviceInd, CANInd, true)) {
+        const unsigned long baudrate = std::strtoul(env, nullptr, 10);
+        if (baudrate)
+            return static_cast<uint32_t>(baudrate);
+    }
+    return CANSIO_BD57600;   // typical SLCAN UART speed (WeAct cangaroo sets CANSIO_BD1000000)
+}
+
+// Find a device opened by VCI_OpenDevice
+static std::shared_ptr<Device> FindDevice(DWORD DeviceType, DWORD DeviceInd)
+{
+    std::shared_lock lock(g_devMutex);
+
+    const auto it = g_devices.find({DeviceType, DeviceInd});
+    if (it == g_devices.end() || !it->second->open)
+        return nullptr;
+    return it->second;
+}
+
+// Find an opened CAN channel of a device opened by VCI_OpenDevice and lock
+// it against VCI_CloseDevice: <handle> stays valid as long as <guard> is held
+template<typename Lock>
+static Channel* FindChannel(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd, ChannelGuard<Lock>& guard, int& handle)
+{
+    if (CANInd >= MAX_CHANNELS)
+        return nullptr;
+
+    guard.device = FindDevice(DeviceType, DeviceInd);
+    if (!guard.device)
+        return nullptr;
+
+    Channel& ch = guard.device->channels[CANInd];
+    guard.lock = Lock(ch.apiMutex);
+    if ((handle = ch.handle.load()) < 0) {
+        guard.lock.unlock();
+        return nullptr;
+    }
+    return &ch;
+}
+
+static void ConvertToCANAPI(const VCI_CAN_OBJ& in, can_frame_t& out)
 {
     std::memset(&out, 0, sizeof(out));
 
@@ -200,7 +445,7 @@ static void ConvertToCANAPI(const VCI_CAN_OBJ& in, can_message_t& out)
     std::memcpy(out.data, in.Data, out.dlc);
 }
 
-static void ConvertFromCANAPI(const can_message_t& in, VCI_CAN_OBJ& out)
+static void ConvertFromCANAPI(const can_frame_t& in, VCI_CAN_OBJ& out)
 {
     std::memset(&out, 0, sizeof(out));
 
@@ -214,6 +459,44 @@ static void ConvertFromCANAPI(const can_message_t& in, VCI_CAN_OBJ& out)
     std::memcpy(out.Data, in.data, out.DataLen);
 }
 
+// Number of frames converted and passed to the CAN API at once
+static constexpr DWORD BATCH_SIZE = 64U;
+
+// Max. number of retries (with yield) when the transmitter is busy
+static constexpr int TX_BUSY_RETRIES = 4;
+
+// Read up to <count> messages: the first read waits up to <timeout>, then
+// the reception queue is drained without waiting. Returns the number of
+// messages read and the result of can_read_frames in <result>.
+static DWORD ReadBatch(int handle, can_frame_t* msgs, DWORD count, uint16_t timeout, int& result)
+{
+    result = can_read_frames(handle, msgs, count, timeout);
+    return (result > 0) ? static_cast<DWORD>(result) : 0;
+}
+
+// Write up to <count> messages, a busy transmitter is retried a few times
+// (yielding in between). Returns the number of messages written and the
+// result of the last can_write_frames call in <result>.
+static DWORD WriteBatch(int handle, const can_frame_t* msgs, DWORD count, int& result)
+{
+    DWORD n = 0;
+    int retries = 0;
+
+    result = CANERR_NOERROR;
+    while (n < count) {
+        result = can_write_frames(handle, &msgs[n], count - n, 0U);
+        if (result > 0) {
+            n += static_cast<DWORD>(result);
+            retries = 0;
+        } else if (result != CANERR_TX_BUSY || ++retries > TX_BUSY_RETRIES) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return n;
+}
+
 static const char* BitrateIndex2String(btr_index_t idx)
 {
     switch (idx) {
@@ -230,6 +513,7 @@ static const char* BitrateIndex2String(btr_index_t idx)
     }
 }
 
+// -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 // Exported C API
 // -----------------------------------------------------------------------------
@@ -238,48 +522,70 @@ extern "C" {
 
 // -------------------------------------------------------------------------
 // VCI_OpenDevice
+//   Open all CAN channels of the device with a configured serial port.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_OpenDevice(DWORD DeviceType, DWORD DeviceInd, DWORD Reserved)
 {
     (void)Reserved;
 
     InitLog();
-    Log("VCI_OpenDevice: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd);
+    Log("VCI_OpenDevice: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW, DeviceType, DeviceInd);
 
-    if (g_canHandle >= 0) {
-        Log("  Device already open, handle=%d", g_canHandle);
-        return STATUS_OK;
-    }
+    std::unique_lock lock(g_devMutex);
 
-    const std::string port = GetSerialPort();
-    Log("  Serial port = %s", port.c_str());
+    auto& entry = g_devices[{DeviceType, DeviceInd}];
+    if (!entry)
+        entry = std::make_shared<Device>();
+    Device& dev = *entry;
 
-    can_sio_param_t param{};
-    param.name          = const_cast<char*>(port.c_str());
-    param.attr.protocol = g_slcanProtocol;
-    param.attr.baudrate = CANSIO_BD57600;   // typical SLCAN UART speed (WeAct cangaroo sets CANSIO_BD1000000)
-    param.attr.bytesize = CANSIO_8DATABITS;
-    param.attr.parity   = CANSIO_NOPARITY;
-    param.attr.stopbits = CANSIO_1STOPBIT;
-
-    const int h = can_init(
-        CAN_BOARD(CANLIB_SERIALCAN, CANDEV_SERIAL),
-        CANMODE_DEFAULT,
-        &param
-    );
-
-    Log("  can_init() -> %d", h);
+    if (dev.open) {
+        Log("  Device already open");
+        return STATUS_OK;
+    }
 
-    if (h < 0) {
-        return STATUS_ERR;
+    DWORD opened = 0;
+
+    for (DWORD can = 0; can < MAX_CHANNELS; ++can) {
+        const std::string port = GetSerialPort(DeviceInd, can);
+        if (port.empty())
+            continue;
+
+        Channel& ch = dev.channels[can];
+        ch.protocol = GetProtocol(DeviceInd, can);
+        Log("  CANInd=%" PRIuDW "  Serial port = %s", can, port.c_str());
+
+        can_sio_param_t param{};
+        param.name          = const_cast<char*>(port.c_str());
+        param.attr.protocol = ch.protocol;
+        param.attr.baudrate = GetBaudrate(DeviceInd, can);
+        param.attr.bytesize = CANSIO_8DATABITS;
+        param.attr.parity   = CANSIO_NOPARITY;
+        param.attr.stopbits = CANSIO_1STOPBIT;
+
+        const int h = can_init(
+            CAN_BOARD(CANLIB_SERIALCAN, CANDEV_SERIAL),
+            CANMODE_DEFAULT,
+            &param
+        );
+
+        Log("  can_init() -> %d", h);
+
+        if (h < 0)
+            continue;
+
+        ch.bitrate = {};
+        ch.bitrate.index = CANBTR_INDEX_250K; // default, will be overridden by VCI_InitCAN
+        ch.started = false;
+        ch.handle.store(h);
+        ++opened;
     }
 
-    g_canHandle  = h;
-    g_lastBitrate = {};
-    g_lastBitrate.index = CANBTR_INDEX_250K; // default, will be overridden by VCI_InitCAN
+    if (!opened)
+        return STATUS_ERR;
 
+    dev.open = true;
     return STATUS_OK;
 }
 
@@ -287,18 +593,48 @@ DWORD __stdcall VCI_OpenDevice(DWORD DeviceType, DWORD DeviceInd, DWORD Reserved
 // VCI_CloseDevice
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_CloseDevice(DWORD DeviceType, DWORD DeviceInd)
 {
-    Log("VCI_CloseDevice: DeviceType=%lu  DeviceIndex=%lu", DeviceType, DeviceInd);
-
-    if (g_canHandle >= 0) {
-        const int r = can_exit(g_canHandle);
-        Log("  can_exit(handle=%d) -> %d", g_canHandle, r);
+    Log("VCI_CloseDevice: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW, DeviceType, DeviceInd);
+
+    std::shared_ptr<Device> dev;
+    bool last = true;
+    {
+        std::unique_lock lock(g_devMutex);
+
+        // note: the device is taken out of the map, so that it is closed
+        //       without blocking the API calls on the other devices
+        const auto it = g_devices.find({DeviceType, DeviceInd});
+        if (it != g_devices.end() && it->second->open) {
+            dev = std::move(it->second);
+            g_devices.erase(it);
+        }
+        for (const auto& other : g_devices)
+            if (other.second->open)
+                last = false;
+    }
+    if (dev) {
+        for (Channel& ch : dev->channels) {
+            // note: no new API calls from here, pending ones are waited for
+            //       (a VCI_Receive waiting for a frame is woken up until then)
+            const int h = ch.handle.exchange(CANAPI_HANDLE);
+            if (h >= 0) {
+                std::unique_lock chLock(ch.apiMutex, std::defer_lock);
+                while (!chLock.try_lock()) {
+                    (void)can_kill(h);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                const int r = can_exit(h);
+                Log("  can_exit(handle=%d) -> %d", h, r);
+            }
+            ch.started = false;
+        }
     }
 
-    g_canHandle  = CANAPI_HANDLE;
-    g_canStarted = false;
+    // stop logging when the last device has been closed
+    if (last)
+        ExitLog();
     return STATUS_OK;
 }
 
@@ -308,7 +644,7 @@ DWORD __stdcall VCI_CloseDevice(DWORD DeviceType, DWORD DeviceInd)
 //   If no matching index is found, return STATUS_ERR.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_InitCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                             PVCI_INIT_CONFIG cfg)
 {
@@ -317,9 +653,17 @@ DWORD __stdcall VCI_InitCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
         return STATUS_ERR;
     }
 
-    Log("VCI_InitCAN: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu  AccCode=0x%08lX  AccMask=0x%08lX  Filter=%u  Timing0=0x%02X  Timing1=0x%02X  Mode=%u",
+    Log("VCI_InitCAN: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW "  AccCode=0x%08" PRIXDW "  AccMask=0x%08" PRIXDW "  Filter=%u  Timing0=0x%02X  Timing1=0x%02X  Mode=%u",
         DeviceType, DeviceInd, CANInd, cfg->AccCode, cfg->AccMask, cfg->Filter, cfg->Timing0, cfg->Timing1, cfg->Mode);
 
+    ChannelWriteLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch) {
+        Log("  No CAN handle (channel not open)");
+        return STATUS_ERR;
+    }
+
     // Build SJA1000 BTR register from Timing0/1
     const uint16_t btr0btr1 =
         static_cast<uint16_t>(cfg->Timing0) << 8 |
@@ -343,8 +687,8 @@ DWORD __stdcall VCI_InitCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
         return STATUS_ERR;
     }
 
-    g_lastBitrate = {};
-    g_lastBitrate.index = brIndex;
+    ch->bitrate = {};
+    ch->bitrate.index = brIndex;
 
     Log("  BTR matched index=%d (%s)", brIndex, BitrateIndex2String(brIndex));
 
@@ -355,24 +699,27 @@ DWORD __stdcall VCI_InitCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
 // VCI_StartCAN
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_StartCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 {
-    Log("VCI_StartCAN: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd, CANInd);
+    Log("VCI_StartCAN: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW, DeviceType, DeviceInd, CANInd);
 
-    if (g_canHandle < 0) {
-        Log("  No CAN handle (device not open)");
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch) {
+        Log("  No CAN handle (channel not open)");
         return STATUS_ERR;
     }
 
-    const int r = can_start(g_canHandle, &g_lastBitrate);
+    const int r = can_start(h, &ch->bitrate);
     Log("  can_start(handle=%d, index=%d) -> %d",
-        g_canHandle, g_lastBitrate.index, r);
+        h, ch->bitrate.index, r);
 
     if (r < 0)
         return STATUS_ERR;
 
-    g_canStarted = true;
+    ch->started = true;
     return STATUS_OK;
 }
 
@@ -381,21 +728,24 @@ DWORD __stdcall VCI_StartCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 //   Stop controller (maps to can_reset).
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_ResetCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 {
-    Log("VCI_ResetCAN: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd, CANInd);
+    Log("VCI_ResetCAN: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW, DeviceType, DeviceInd, CANInd);
 
-    if (g_canHandle < 0)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch)
         return STATUS_ERR;
 
-    const int r = can_reset(g_canHandle);
-    Log("  can_reset(handle=%d) -> %d", g_canHandle, r);
+    const int r = can_reset(h);
+    Log("  can_reset(handle=%d) -> %d", h, r);
 
     if (r < 0 && r != CANERR_OFFLINE)
         return STATUS_ERR;
 
-    g_canStarted = false;
+    ch->started = false;
     return STATUS_OK;
 }
 
@@ -403,35 +753,36 @@ DWORD __stdcall VCI_ResetCAN(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 // VCI_Transmit
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_Transmit(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                              PVCI_CAN_OBJ frames, DWORD count)
 {
-    Log("VCI_Transmit: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu  sending %lu frame(s)", DeviceType, DeviceInd, CANInd, count);
+    Log("VCI_Transmit: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW "  sending %" PRIuDW " frame(s)", DeviceType, DeviceInd, CANInd, count);
 
-    if (g_canHandle < 0 || !frames || count == 0)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch || !frames || count == 0)
         return 0;
 
+    can_frame_t msgs[BATCH_SIZE];  // compact layout (CAN 2.0)
     DWORD sent = 0;
 
-    for (DWORD i = 0; i < count; ++i) {
-        LogCANFrame("  TX:", frames[i]);
+    while (sent < count) {
+        const DWORD chunk = std::min<DWORD>(count - sent, BATCH_SIZE);
 
-        can_message_t msg{};
-        ConvertToCANAPI(frames[i], msg);
+        for (DWORD i = 0; i < chunk; ++i)
+            ConvertToCANAPI(frames[sent + i], msgs[i]);
 
         int r;
-        int retries = 0;
-        do {
-            r = can_write(g_canHandle, &msg, 0);
-        } while (r == CANERR_TX_BUSY && ++retries <= 4);
+        const DWORD n = WriteBatch(h, msgs, chunk, r);
+        LogCANFrames("  TX:", &frames[sent], n);
+        sent += n;
 
-        if (r < CANERR_NOERROR) {
-            Log("  can_write failed at frame %lu, r=%d", i, r);
+        if (n < chunk) {
+            Log("  can_write failed at frame %" PRIuDW ", r=%d", sent, r);
             break;
         }
-
-        ++sent;
     }
 
     return sent;
@@ -439,43 +790,61 @@ DWORD __stdcall VCI_Transmit(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
 
 // -------------------------------------------------------------------------
 // VCI_Receive
+//   Waits up to waitTime for the first frame only, then takes all frames
+//   already queued (up to maxCount) without waiting.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_Receive(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                             PVCI_CAN_OBJ out, DWORD maxCount, INT waitTime)
 {
-    Log("VCI_Receive: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu  request %lu frame(s), waitTime=%d", DeviceType, DeviceInd, CANInd, maxCount, waitTime);
+    Log("VCI_Receive: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW "  request %" PRIuDW " frame(s), waitTime=%d", DeviceType, DeviceInd, CANInd, maxCount, waitTime);
 
-    if (g_canHandle < 0 || !out || maxCount == 0)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch || !out || maxCount == 0)
         return 0;
 
+    uint16_t timeout = // [msec]
+        (waitTime < 0) ? CANWAIT_INFINITE :
+        (waitTime == 0) ? 0U :
+        static_cast<uint16_t>(std::min<INT>(waitTime, CANWAIT_INFINITE - 1));
 
+    can_frame_t msgs[BATCH_SIZE];  // compact layout (CAN 2.0)
     DWORD received = 0;
-    std::lock_guard lock(g_rxMutex);
-
-    for (DWORD i = 0; i < maxCount; ++i) {
-        can_message_t msg{};
-        const uint16_t timeout = // [msec]
-            (waitTime < 0) ? CANWAIT_INFINITE :
-            (waitTime == 0) ? 0U :
-            static_cast<uint16_t>(waitTime);
-
-        const int r = can_read(g_canHandle, &msg, timeout);
-
-        if (r == CANERR_RX_EMPTY) {
-            break;
-        }
-        if (r < CANERR_NOERROR) {
-            Log("  can_read error r=%d", r);
-            break;
+    int r = CANERR_NOERROR;
+
+    {
+        std::lock_guard lock(ch->rxMutex);
+
+        while (received < maxCount) {
+            const DWORD chunk = std::min<DWORD>(maxCount - received, BATCH_SIZE);
+            const DWORD n = ReadBatch(h, msgs, chunk, timeout, r);
+
+            DWORD k = 0;
+            for (DWORD i = 0; i < n; ++i) {
+                if (msgs[i].sts) {  // status message (e.g. lost frames)
+                    const unsigned long lost = static_cast<unsigned long>(msgs[i].data[0]) |
+                        (static_cast<unsigned long>(msgs[i].data[1]) << 8) |
+                        (static_cast<unsigned long>(msgs[i].data[2]) << 16) |
+                        (static_cast<unsigned long>(msgs[i].data[3]) << 24);
+                    Log("  RX: status 0x%lx (%lu frame(s) lost)", static_cast<unsigned long>(msgs[i].id), lost);
+                    continue;
+                }
+                ConvertFromCANAPI(msgs[i], out[received + k++]);
+            }
+            received += k;
+
+            if (n < chunk)
+                break;
+            timeout = 0U;  // wait for the first frame only
         }
-
-        ConvertFromCANAPI(msg, out[received]);
-        LogCANFrame("  RX:", out[received]);
-        ++received;
     }
+    if (r < CANERR_NOERROR && r != CANERR_RX_EMPTY)
+        Log("  can_read error r=%d", r);
 
+    LogCANFrames("  RX:", out, received);
     return received;
 }
 
@@ -484,21 +853,24 @@ DWORD __stdcall VCI_Receive(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
 //   Reset controller and optionally restart with last bitrate.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_ClearBuffer(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 {
-    Log("VCI_ClearBuffer: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd, CANInd);
+    Log("VCI_ClearBuffer: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW, DeviceType, DeviceInd, CANInd);
 
-    if (g_canHandle < 0)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch)
         return STATUS_ERR;
 
-    if (g_canStarted) {
-        const int r1 = can_reset(g_canHandle);
-        Log("  can_reset(handle=%d) -> %d", g_canHandle, r1);
+    if (ch->started) {
+        const int r1 = can_reset(h);
+        Log("  can_reset(handle=%d) -> %d", h, r1);
 
-        const int r2 = can_start(g_canHandle, &g_lastBitrate);
+        const int r2 = can_start(h, &ch->bitrate);
         Log("  can_start(handle=%d, index=%d) -> %d",
-            g_canHandle, g_lastBitrate.index, r2);
+            h, ch->bitrate.index, r2);
 
         if (r1 < 0 || r2 < 0)
             return STATUS_ERR;
@@ -513,24 +885,27 @@ DWORD __stdcall VCI_ClearBuffer(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 //   NOTE: assumes 4-byte values (DWORD) for most RefTypes.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_SetReference(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                                  DWORD RefType, PVOID data)
 {
-    Log("VCI_SetReference: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu  RefType=%lu", DeviceType, DeviceInd, CANInd, RefType);
+    Log("VCI_SetReference: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW "  RefType=%" PRIuDW, DeviceType, DeviceInd, CANInd, RefType);
 
-    if (g_canHandle < 0 || !data)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch || !data)
         return STATUS_ERR;
 
     // We don't know size; many ZLG refs are DWORD, thus defaults to 4 bytes.
     const int r = can_property(
-        g_canHandle,
+        h,
         static_cast<uint16_t>(RefType),
         data,
         4U
     );
 
-    Log("  can_property(SET, RefType=%lu) -> %d", RefType, r);
+    Log("  can_property(SET, RefType=%" PRIuDW ") -> %d", RefType, r);
 
     return (r < 0) ? STATUS_ERR : STATUS_OK;
 }
@@ -541,23 +916,26 @@ DWORD __stdcall VCI_SetReference(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd
 //   NOTE: assumes 4-byte values (DWORD) for most RefTypes.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_GetReference(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                                  DWORD RefType, PVOID data)
 {
-    Log("VCI_GetReference: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu  RefType=%lu", DeviceType, DeviceInd, CANInd, RefType);
+    Log("VCI_GetReference: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW "  RefType=%" PRIuDW, DeviceType, DeviceInd, CANInd, RefType);
 
-    if (g_canHandle < 0 || !data)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch || !data)
         return STATUS_ERR;
 
     const int r = can_property(
-        g_canHandle,
+        h,
         static_cast<uint16_t>(RefType),
         data,
         4U
     );
 
-    Log("  can_property(GET, RefType=%lu) -> %d", RefType, r);
+    Log("  can_property(GET, RefType=%" PRIuDW ") -> %d", RefType, r);
 
     return (r < 0) ? STATUS_ERR : STATUS_OK;
 }
@@ -567,21 +945,24 @@ DWORD __stdcall VCI_GetReference(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd
 //   Map basic error status bits from CAN API to ZLG error code.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_ReadErrInfo(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                                 PVCI_ERR_INFO out)
 {
-    Log("VCI_ReadErrInfo: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd, CANInd);
+    Log("VCI_ReadErrInfo: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW, DeviceType, DeviceInd, CANInd);
 
-    if (g_canHandle < 0 || !out)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch || !out)
         return STATUS_ERR;
 
     std::memset(out, 0, sizeof(VCI_ERR_INFO));
 
     uint8_t status = 0;
-    if (g_slcanProtocol != CANSIO_CANABLE && g_slcanProtocol != CANSIO_WEACT) {
-        const int r = can_status(g_canHandle, &status);
-        Log("  can_status(handle=%d) -> %d, status=0x%02X", g_canHandle, r, status);
+    if (ch->protocol != CANSIO_CANABLE && ch->protocol != CANSIO_WEACT) {
+        const int r = can_status(h, &status);
+        Log("  can_status(handle=%d) -> %d, status=0x%02X", h, r, status);
 
         if (r < 0)
             return STATUS_ERR;
@@ -609,21 +990,36 @@ DWORD __stdcall VCI_ReadErrInfo(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
 //   Detailed mapping depends on available CAN API properties.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_ReadBoardInfo(DWORD DeviceType, DWORD DeviceInd,
                                   PVCI_BOARD_INFO info)
 {
-    Log("VCI_ReadBoardInfo: DeviceType=%lu  DeviceIndex=%lu", DeviceType, DeviceInd);
+    Log("VCI_ReadBoardInfo: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW, DeviceType, DeviceInd);
 
-    if (g_canHandle < 0 || !info)
+    const std::shared_ptr<Device> dev = FindDevice(DeviceType, DeviceInd);
+    if (!dev || !info)
         return STATUS_ERR;
 
     std::memset(info, 0, sizeof(VCI_BOARD_INFO));
 
+    // Number of opened CAN channels, the first one describes the board
+    Channel* first = nullptr;
+    for (Channel& ch : dev->channels) {
+        if (ch.handle.load() < 0)
+            continue;
+        if (!first)
+            first = &ch;
+        info->can_Num++;
+    }
+
     // We try to get device name via CAN API properties if available.
-    char name[40] = {};
-    if (can_property(g_canHandle, CANPROP_GET_DEVICE_NAME, name, sizeof(name)) >= 0) {
-        std::strncpy(info->str_hw_Type, name, sizeof(info->str_hw_Type) - 1);
+    char name[CANPROP_MAX_BUFFER_SIZE] = {};
+    std::shared_lock<std::shared_mutex> chLock;
+    if (first)
+        chLock = std::shared_lock(first->apiMutex);
+    const int h = first ? first->handle.load() : CANAPI_HANDLE;
+    if (h >= 0 && can_property(h, CANPROP_GET_DEVICE_NAME, name, sizeof(name)) >= 0) {
+        std::snprintf(info->str_hw_Type, sizeof(info->str_hw_Type), "%s", name);
     } else {
         std::strncpy(info->str_hw_Type, "SerialCAN", sizeof(info->str_hw_Type) - 1);
     }
@@ -631,7 +1027,6 @@ DWORD __stdcall VCI_ReadBoardInfo(DWORD DeviceType, DWORD DeviceInd,
 
     std::strncpy(info->str_Serial_Num, "N/A", sizeof(info->str_Serial_Num) - 1);
 
-    info->can_Num = 1;
     return STATUS_OK;
 }
 
@@ -640,21 +1035,24 @@ DWORD __stdcall VCI_ReadBoardInfo(DWORD DeviceType, DWORD DeviceInd,
 //   Return basic controller status. We only map the main status byte.
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_ReadCANStatus(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd,
                                   PVCI_CAN_STATUS status)
 {
-    Log("VCI_ReadCANStatus: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd, CANInd);
+    Log("VCI_ReadCANStatus: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW, DeviceType, DeviceInd, CANInd);
 
-    if (g_canHandle < 0 || !status)
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch || !status)
         return STATUS_ERR;
 
     std::memset(status, 0, sizeof(VCI_CAN_STATUS));
 
     uint8_t st = 0;
-    if (g_slcanProtocol != CANSIO_CANABLE && g_slcanProtocol != CANSIO_WEACT) {
-        const int r = can_status(g_canHandle, &st);
-        Log("  can_status(handle=%d) -> %d, status=0x%02X", g_canHandle, r, st);
+    if (ch->protocol != CANSIO_CANABLE && ch->protocol != CANSIO_WEACT) {
+        const int r = can_status(h, &st);
+        Log("  can_status(handle=%d) -> %d, status=0x%02X", h, r, st);
 
         if (r < 0)
             return STATUS_ERR;
@@ -669,21 +1067,35 @@ DWORD __stdcall VCI_ReadCANStatus(DWORD DeviceType, DWORD DeviceInd, DWORD CANIn
 
 // -------------------------------------------------------------------------
 // VCI_GetReceiveNum
-//   Try to use CAN API property for RX queue level if available.
-//   If not supported, fall back to 0 (no information).
+//   Number of frames waiting in the reception queue (fill level of the
+//   SerialCAN receive queue, taken without waiting).
 // -------------------------------------------------------------------------
 
-__declspec(dllexport)
+VCI_EXPORT
 DWORD __stdcall VCI_GetReceiveNum(DWORD DeviceType, DWORD DeviceInd, DWORD CANInd)
 {
-    Log("VCI_GetReceiveNum: DeviceType=%lu  DeviceIndex=%lu  CANInd=%lu", DeviceType, DeviceInd, CANInd);
+    Log("VCI_GetReceiveNum: DeviceType=%" PRIuDW "  DeviceIndex=%" PRIuDW "  CANInd=%" PRIuDW, DeviceType, DeviceInd, CANInd);
+
+    ChannelLock chLock;
+    int h;
+    Channel* ch = FindChannel(DeviceType, DeviceInd, CANInd, chLock, h);
+    if (!ch)
+        return 0;
 
-    if (g_canHandle < 0)
+    uint32_t fill = 0U;
+    const int r = can_property(
+        h,
+        static_cast<uint16_t>(CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_FILL),
+        &fill,
+        sizeof(fill)
+    );
+    if (r < 0) {
+        Log("  can_property(RCV_QUEUE_FILL) -> %d, returning 0", r);
         return 0;
+    }
 
-    // Fallback: return 0 if not supported.
-    Log("  Receive queue level not supported, returning 0");
-    return 0;
+    Log("  %u frame(s) in the receive queue", fill);
+    return static_cast<DWORD>(fill);
 }
 
 } // extern "C"
@@ -92,7 +92,11 @@
 #define CMD_GET_GPS                 9
 #define CMD_GET_GPS_NUM             10 // Number of GPS entries
 
+#if defined(_WIN32)
 typedef unsigned long       DWORD, ULONG;
+#else
+typedef unsigned int        DWORD, ULONG;  // 32-bit as on Windows (long is 64-bit on LP64)
+#endif
 typedef int                 INT;
 typedef void*               HANDLE;
 typedef unsigned char       BYTE;
@@ -232,11 +236,18 @@ typedef struct _VCI_CANDTU_GPS_DATA
     ULONG          nGPSDataCnt; // Number of GPS data entries the buffer can hold
 }VCI_CANDTU_GPS_DATA, *PVCI_CANDTU_GPS_DATA;
 
+#if defined(_WIN32)
+#define VCI_EXPORT __declspec(dllexport)
+#else
+#define VCI_EXPORT __attribute__((visibility("default")))
+#define __stdcall
+#endif
+
 #ifdef __cplusplus
-#define EXTERNC extern "C" __declspec(dllexport)
+#define EXTERNC extern "C" VCI_EXPORT
 #define DEF(a) = a
 #else
-#define EXTERNC __declspec(dllexport)
+#define EXTERNC VCI_EXPORT
 #define DEF(a)
 #endif
 
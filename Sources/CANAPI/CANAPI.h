@@ -130,6 +130,10 @@ typedef can_timestamp_t CANAPI_Timestamp_t;
 //
 typedef can_message_t CANAPI_Message_t;
 
+/// \brief  CAN Frame (compact, CAN 2.0 only)
+//
+typedef can_frame_t CANAPI_Frame_t;
+
 /// \brief  CAN Device handle (internally)
 //
 typedef int CANAPI_Handle_t;
@@ -609,6 +609,24 @@ typedef struct can_message_t_ {
     can_timestamp_t timestamp;          /**< time-stamp { sec, nsec } */
 } can_message_t;
 
+/** @brief       CAN Frame (compact, CAN 2.0 only):
+ *               24 bytes per frame with room for a time-stamp in nanoseconds
+ *               (0 if the device does not provide time-stamps).
+ */
+typedef struct can_frame_t_ {
+    uint32_t id;                        /**< CAN identifier */
+    struct {
+        uint8_t xtd : 1;                /**< flag: extended format */
+        uint8_t rtr : 1;                /**< flag: remote frame */
+        uint8_t : 5;
+        uint8_t sts : 1;                /**< flag: status message */
+    };
+    uint8_t dlc;                        /**< data length code (0 .. 8) */
+    uint8_t reserved[2];                /**< (reserved) */
+    uint8_t data[CAN_MAX_LEN];          /**< payload (CAN 2.0: 0 .. 8) */
+    uint64_t timestamp;                 /**< time-stamp in [nsec] (or 0) */
+} can_frame_t;
+
 
 #ifdef __cplusplus
 }
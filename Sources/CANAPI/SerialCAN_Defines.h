@@ -99,6 +99,7 @@ extern "C" {
 #define CANSIO_LAWICEL           0x00U  /**< Lawicel SLCAN protocol */
 #define CANSIO_CANABLE           0x01U  /**< CANable SLCAN protocol */
 #define CANSIO_WEACT             0x08U  /**< WeAct SLCAN protocol (CANable + ACK) */
+#define CANSIO_SHARED            0x10U  /**< shared access through the SerialCAN daemon (POSIX only) */
 #define CANSIO_AUTO              0xFFU  /**< auto detect (not realized yet) */
 #define CANSIO_SLCAN    CANSIO_LAWICEL  /**< Lawicel SLCAN protocol (default) */
  /** @} */
@@ -154,10 +155,100 @@ extern "C" {
 #define SLCAN_HARDWARE_VERSION   0x02U  /**< device hardware version */
 #define SLCAN_FIRMWARE_VERSION   0x03U  /**< device firmware version */
 #define SLCAN_CLOCK_FREQUENCY    0x05U  /**< CAN clock frequency (in [Hz]) */
+#define SLCAN_RCV_QUEUE_FILL     0x10U  /**< number of messages in the receive queue */
+#define SLCAN_RCV_EVENT_FD       0x11U  /**< file descriptor readable when messages received (POSIX) */
+#define SLCAN_RCV_QUEUE_SIZE     0x12U  /**< size of the receive queue (number of messages, set in INIT mode) */
+#define SLCAN_RCV_QUEUE_OPTIONS  0x13U  /**< memory options of the receive queue (set in INIT mode) */
+#define SLCAN_RCV_QUEUE_POLICY   0x14U  /**< overflow policy of the receive queue (uint8_t) */
+#define SLCAN_RCV_QUEUE_BLOCK_TIME 0x15U /**< max. blocking time of the reception on overflow (uint16_t, in [ms]) */
+#define SLCAN_RCV_QUEUE_GAPS     0x16U  /**< number of loss intervals of the receive queue (uint64_t) */
+#define SLCAN_RCV_LANE_SIZE      0x17U  /**< size of each priority lane (uint32_t, set in INIT mode, 0 = no lanes) */
+#define SLCAN_RCV_LANE_CLASS     0x18U  /**< assign identifiers to a priority lane (can_sio_lane_t, set in INIT mode) */
+#define SLCAN_RCV_LANE_RESET     0x19U  /**< assign all identifiers to the receive queue (NULL, set in INIT mode) */
+#define SLCAN_SHARED_INFO        0x1AU  /**< status of the SerialCAN daemon (can_sio_shared_t, CANSIO_SHARED only) */
+#define SLCAN_GATEWAY_ROUTES     0x1BU  /**< forward received frames to another interface (can_sio_gateway_t, set in INIT mode) */
+#define SLCAN_GATEWAY_STATUS     0x1CU  /**< number of routes and frame counters of the gateway (can_sio_gateway_status_t) */
+#define SLCAN_J1939_STATUS       0x1DU  /**< own address and session counters of the J1939 engine (can_sio_j1939_status_t) */
+#define SLCAN_AUTO_BAUD_DWELL    0x1EU  /**< dwell time per candidate of the bit-rate detection (uint16_t, in [ms]) */
+#define SLCAN_AUTO_RETRANSMIT    0x1FU  /**< automatic retransmission of CAN frames (uint8_t, 0 = off, 1 = on, set in INIT mode, CANable only) */
+#define SLCAN_STATUS_POLL_TIME   0x20U  /**< polling interval of the status flags (uint16_t, in [ms], 0 = off, set in INIT mode) */
 // TODO: define more or all parameters
 // ...
 /** @} */
 
+/** @name  Receive queue option
+ *  @brief Memory options of the receive queue (SLCAN_RCV_QUEUE_OPTIONS)
+ *  @{ */
+#define CANSIO_QUEUE_LAZY_COMMIT 0x01U  /**< memory is committed when touched (default) */
+#define CANSIO_QUEUE_HUGE_PAGES  0x02U  /**< memory is backed by huge pages, if available */
+#define CANSIO_QUEUE_SHRINK_IDLE 0x04U  /**< memory is released when the queue runs empty */
+/** @} */
+
+/** @name  Receive queue policy
+ *  @brief Overflow policies of the receive queue (SLCAN_RCV_QUEUE_POLICY)
+ *  @{ */
+#define CANSIO_QUEUE_DROP_NEWEST    0U  /**< the received message is dropped (default) */
+#define CANSIO_QUEUE_DROP_OLDEST    1U  /**< the oldest message is overwritten */
+#define CANSIO_QUEUE_BLOCK_PRODUCER 2U  /**< the reception waits for free space (SLCAN_RCV_QUEUE_BLOCK_TIME) */
+/** @} */
+
+/** @name  Receive lanes
+ *  @brief Priority lanes in front of the receive queue (SLCAN_RCV_LANE_CLASS)
+ *  @{ */
+#define CANSIO_MAX_LANES            3U  /**< number of priority lanes (1 = lowest, 3 = highest priority) */
+#define CANSIO_LANE_SIZE          256U  /**< default size of each priority lane (number of messages) */
+/** @} */
+
+/** @name  Bit-rate detection
+ *  @brief Automatic bit-rate detection by listen-only probing (can_start)
+ *  @{ */
+#define CANSIO_BITRATE_AUTO      (-128) /**< bit-rate index: detect the bit-rate of the bus (CANable: in silent mode) */
+#define CANSIO_AUTO_BAUD_DWELL     50U  /**< default dwell time per candidate (in [ms], SLCAN_AUTO_BAUD_DWELL) */
+/** @} */
+
+/** @name  Status messages
+ *  @brief In-band status messages in the receive queue (flag 'sts' set, identifier = code)
+ *  @{ */
+#define CANSIO_STS_QUEUE_OVERFLOW   1U  /**< messages lost: data[0..3] = number, data[4..7] = interval in [ms] (little endian) */
+#define CANSIO_STS_CONTROLLER       2U  /**< status flags changed: data[0] = status flags of the device (CANMODE_ERR only) */
+#define CANSIO_STS_DISCONNECTED     3U  /**< serial line disconnected: data[0] = last status flags (CANMODE_ERR only) */
+#define CANSIO_STATUS_POLL_TIME   100U  /**< default polling interval of the status flags (in [ms], SLCAN_STATUS_POLL_TIME) */
+/** @} */
+
+/** @name  Gateway
+ *  @brief CAN-to-CAN gateway between two interfaces (SLCAN_GATEWAY_ROUTES)
+ *  @{ */
+#define CANSIO_MAX_ROUTES          32U  /**< max. number of routes of a gateway */
+/** @} */
+
+/** @name  Shared access
+ *  @brief Shared-memory rings of the SerialCAN daemon (CANSIO_SHARED)
+ *  @{ */
+#define CANSIO_SHM_PREFIX     "slcan"   /**< prefix of the shared-memory object name (e.g. '/slcan.dev.ttyUSB0') */
+#define CANSIO_SHM_RING_SIZE    4096U   /**< default size of the receive ring (number of messages) */
+#define CANSIO_SHM_POST_SIZE     256U   /**< default size of the transmit ring (number of messages) */
+/** @} */
+
+/** @name  ISO-TP
+ *  @brief ISO-TP transport protocol (ISO 15765-2) channels (can_isotp_open)
+ *  @{ */
+#define CANSIO_ISOTP_NORMAL         0U  /**< normal addressing (identifier only) */
+#define CANSIO_ISOTP_EXTENDED       1U  /**< extended addressing (target address in data[0]) */
+#define CANSIO_ISOTP_MIXED          2U  /**< mixed addressing (address extension in data[0]) */
+#define CANSIO_ISOTP_MAX_PDU     4095U  /**< max. length of a PDU (classical CAN) */
+#define CANSIO_ISOTP_CHANNELS       8U  /**< max. number of ISO-TP channels per interface */
+/** @} */
+
+/** @name  J1939
+ *  @brief SAE J1939 transport protocol (BAM/CMDT) reassembly (can_j1939_init)
+ *  @{ */
+#define CANSIO_J1939_SINGLE_FRAMES  0x01U  /**< deliver single-frame PGNs as PDUs too */
+#define CANSIO_J1939_CONSUME_FRAMES 0x02U  /**< TP.CM and TP.DT frames are not put into the receive queue */
+#define CANSIO_J1939_MAX_PDU     1785U  /**< max. length of a PDU (255 packets of 7 bytes) */
+#define CANSIO_J1939_MAX_SESSIONS 4096U /**< max. number of concurrent sessions */
+#define CANSIO_J1939_NULL_ADDR   0xFEU  /**< null address (no address claimed) */
+/** @} */
+
 /** @name  CAN API Library ID
  *  @brief Library ID and dynamic library names
  *  @{ */
@@ -208,6 +299,118 @@ typedef struct can_sio_param_t_ {       /* device parameters: */
     can_sio_attr_t attr;                /**< serial communication attributes*/
 } can_sio_param_t;
 
+/** @brief SerialCAN priority class (identifiers assigned to a receive lane)
+ *
+ *  @remarks An identifier belongs to the class if: first <= (id & mask) <= last
+ *           (i.e. first = last for code and mask, mask = all ones for a range).
+ */
+typedef struct can_sio_lane_t_ {        /* priority class: */
+    uint32_t first;                     /**< first identifier (or code) */
+    uint32_t last;                      /**< last identifier (or code) */
+    uint32_t mask;                      /**< identifier mask */
+    uint8_t  xtd;                       /**< 11-bit (0) or 29-bit (1) identifier */
+    uint8_t  lane;                      /**< receive lane (0 = queue, 1..CANSIO_MAX_LANES) */
+} can_sio_lane_t;
+
+/** @brief SerialCAN gateway route (rule for forwarding received frames)
+ *
+ *  @remarks A frame matches the route if: (id & mask) == (code & mask), for
+ *           the selected identifier format (mask 0 = all identifiers).
+ *
+ *  @remarks The forwarded frame is rewritten: id = (id & ~idMask) | (route.id
+ *           & idMask), and the same for each data byte with dataMask and data
+ *           (zeros = unchanged).
+ */
+typedef struct can_sio_route_t_ {       /* gateway route: */
+    uint32_t code;                      /**< identifier code */
+    uint32_t mask;                      /**< identifier mask (0 = all identifiers) */
+    uint8_t  xtd;                       /**< 11-bit (0) or 29-bit (1) identifier */
+    uint8_t  reserved;                  /**< (reserved) */
+    uint16_t interval;                  /**< min. interval between two forwarded frames in [ms] (0 = no rate limit) */
+    uint32_t id;                        /**< new identifier bits (see idMask) */
+    uint32_t idMask;                    /**< identifier bits taken from 'id' */
+    uint8_t  data[8];                   /**< new payload bits (see dataMask) */
+    uint8_t  dataMask[8];               /**< payload bits taken from 'data' */
+} can_sio_route_t;
+
+/** @brief SerialCAN gateway (forwarding to another interface)
+ *
+ *  @remarks The routes are compiled into a lookup table, the first matching
+ *           route applies (count = 0 removes the gateway).
+ */
+typedef struct can_sio_gateway_t_ {     /* gateway: */
+    int32_t  target;                    /**< handle of the interface to forward to */
+    uint32_t count;                     /**< number of routes (0..CANSIO_MAX_ROUTES) */
+    const can_sio_route_t *routes;      /**< array of routes */
+} can_sio_gateway_t;
+
+/** @brief SerialCAN gateway status
+ */
+typedef struct can_sio_gateway_status_t_ { /* gateway status: */
+    uint32_t routes;                    /**< number of routes (0 = no gateway) */
+    int32_t  target;                    /**< handle of the interface to forward to (-1 = none) */
+    uint64_t forwarded;                 /**< number of forwarded frames */
+    uint64_t limited;                   /**< number of frames dropped by rate limit */
+    uint64_t failed;                    /**< number of frames not transmitted */
+} can_sio_gateway_status_t;
+
+/** @brief SerialCAN daemon status (published in the shared-memory object)
+ */
+typedef struct can_sio_shared_t_ {      /* daemon status: */
+    int32_t  pid;                       /**< process id of the daemon */
+    uint16_t btr0btr1;                  /**< bit-rate settings (SJA1000 BTR0/BTR1) */
+    uint8_t  status;                    /**< CAN status register of the device */
+    uint8_t  protocol;                  /**< SLCAN protocol of the device */
+    uint64_t tx;                        /**< number of transmitted CAN frames */
+    uint64_t rx;                        /**< number of received CAN frames */
+    uint64_t err;                       /**< number of received error frames */
+    uint64_t failed;                    /**< number of posted CAN frames not transmitted */
+} can_sio_shared_t;
+
+/** @brief SerialCAN ISO-TP channel (parameters of can_isotp_open)
+ *
+ *  @remarks The engine answers First Frames with Flow Control frames (blockSize,
+ *           stMin) and paces the transmission of Consecutive Frames as requested
+ *           by the receiver (STmin 0 = CFs are written in batches).
+ */
+typedef struct can_sio_isotp_t_ {       /* ISO-TP channel: */
+    uint32_t txId;                      /**< identifier of transmitted frames */
+    uint32_t rxId;                      /**< identifier of received frames */
+    uint8_t  xtd;                       /**< 11-bit (0) or 29-bit (1) identifiers */
+    uint8_t  mode;                      /**< addressing mode (CANSIO_ISOTP_NORMAL, _EXTENDED, _MIXED) */
+    uint8_t  txAddr;                    /**< address byte of transmitted frames (extended and mixed mode) */
+    uint8_t  rxAddr;                    /**< address byte of received frames (extended and mixed mode) */
+    uint8_t  blockSize;                 /**< block size sent in Flow Control frames (0 = no limit) */
+    uint8_t  stMin;                     /**< separation time sent in Flow Control frames (ISO 15765-2 coding) */
+    uint8_t  padding;                   /**< pad frames to 8 data bytes (0 = no padding) */
+    uint8_t  padByte;                   /**< value of the padding bytes */
+    uint16_t timeout;                   /**< time-out N_Bs and N_Cr in [ms] (0 = 1000ms) */
+} can_sio_isotp_t;
+
+/** @brief SerialCAN J1939 engine (parameters of can_j1939_init)
+ *
+ *  @remarks The engine reassembles the PDUs of all BAM and RTS/CTS sessions on
+ *           the bus; with an own address claimed it answers RTS frames to this
+ *           address (CTS and End of Message Acknowledge).
+ */
+typedef struct can_sio_j1939_t_ {       /* J1939 engine: */
+    uint8_t  options;                   /**< engine options (CANSIO_J1939_SINGLE_FRAMES, _CONSUME_FRAMES) */
+    uint8_t  reserved;                  /**< (reserved) */
+    uint16_t sessions;                  /**< number of concurrent sessions (0 = 256) */
+    uint16_t queueSize;                 /**< number of queued PDUs (0 = 64) */
+} can_sio_j1939_t;
+
+/** @brief SerialCAN J1939 engine status
+ */
+typedef struct can_sio_j1939_status_t_ { /* J1939 status: */
+    uint8_t  address;                   /**< own address (0xFE = none) */
+    uint8_t  reserved[3];               /**< (reserved) */
+    uint32_t active;                    /**< number of active sessions */
+    uint64_t completed;                 /**< number of reassembled PDUs */
+    uint64_t aborted;                   /**< number of aborted sessions */
+    uint64_t expired;                   /**< number of sessions timed out */
+} can_sio_j1939_status_t;
+
 
 #ifdef __cplusplus
 }
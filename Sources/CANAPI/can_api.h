@@ -393,6 +393,365 @@ CANAPI int can_write(int handle, const can_message_t *message, uint16_t timeout)
 CANAPI int can_read(int handle, can_message_t *message, uint16_t timeout);
 
 
+/** @brief       transmits several messages over the CAN bus. The CAN controller
+ *               must be in operation state 'running'.
+ *
+ *  @remarks     The messages are sent one after the other, the transmission
+ *               stops at the first message that could not be sent.
+ *
+ *  @remarks     On a serial port, the messages are written in batches and the
+ *               acknowledgments of the device are not awaited: a message that
+ *               is rejected by the device (NACK) is not reported.
+ *
+ *  @param[in]   handle   - handle of the CAN interface
+ *  @param[in]   messages - pointer to an array of messages to send
+ *  @param[in]   count    - number of messages in the array
+ *  @param[in]   timeout  - time to wait for the transmission of a message:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking write, and any other
+ *                               value means the time to wait in milliseconds
+ *
+ *  @returns     the number of messages sent if successful, or a negative value
+ *               on error (when the first message could not be sent).
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_write_n(int handle, const can_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       read up to n messages from the message queue of the CAN interface,
+ *               if any message was received. The CAN controller must be in
+ *               operation state 'running'.
+ *
+ *  @remarks     The function waits for the first message only, the following
+ *               messages are taken from the message queue if already received.
+ *
+ *  @param[in]   handle   - handle of the CAN interface
+ *  @param[out]  messages - pointer to an array of message buffers
+ *  @param[in]   count    - maximum number of messages to be read
+ *  @param[in]   timeout  - time to wait for the reception of a message:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait in milliseconds
+ *
+ *  @returns     the number of messages read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_n(int handle, can_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       transmits n CAN 2.0 frames (compact layout) over the CAN bus.
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @remarks     Same as can_write_n, but with the compact frame layout of
+ *               24 bytes per frame (CAN 2.0 only, no CAN FD payload).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   frames  - pointer to an array of frames to send
+ *  @param[in]   count   - number of frames to send
+ *  @param[in]   timeout - time to wait for the transmission of each frame:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking write, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the number of frames sent if successful, or a negative value
+ *               on error (if the first frame could not be sent).
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal data length code
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_write_frames(int handle, const can_frame_t *frames, size_t count, uint16_t timeout);
+
+
+/** @brief       read up to n CAN 2.0 frames (compact layout) from the message
+ *               queue of the CAN interface, if any frame was received.
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @remarks     Same as can_read_n, but with the compact frame layout of
+ *               24 bytes per frame (CAN 2.0 only, no CAN FD payload).
+ *
+ *  @remarks     SLCAN devices do not time-stamp the frames, the field
+ *               'timestamp' is set to 0.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  frames  - pointer to an array of frame buffers
+ *  @param[in]   count   - maximum number of frames to be read
+ *  @param[in]   timeout - time to wait for the reception of a frame:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the number of frames read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_frames(int handle, can_frame_t *frames, size_t count, uint16_t timeout);
+
+
+/** @brief       creates a subscriber of the CAN interface that receives a copy
+ *               of each received message accepted by its filter (fan-out).
+ *
+ *  @remarks     Each subscriber has a message queue of its own and is read by
+ *               can_read_subscriber, independently from can_read and from other
+ *               subscribers. A full subscriber queue drops the messages of this
+ *               subscriber only (reported by a status message).
+ *
+ *  @remarks     The filters are coded as for the properties CANPROP_SET_FILTER_11BIT
+ *               and CANPROP_SET_FILTER_29BIT (code in bits 32..63, mask in bits
+ *               0..31; 0 accepts all identifiers).
+ *
+ *  @param[in]   handle    - handle of the CAN interface
+ *  @param[in]   filter11  - acceptance filter for 11-bit identifier
+ *  @param[in]   filter29  - acceptance filter for 29-bit identifier
+ *  @param[in]   queueSize - size of the subscriber queue (number of messages)
+ *
+ *  @returns     the subscriber number if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid queue size
+ *  @retval      CANERR_RESOURCE  - no more subscribers or out of memory
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_subscribe(int handle, uint64_t filter11, uint64_t filter29, size_t queueSize);
+
+
+/** @brief       removes a subscriber of the CAN interface.
+ *
+ *  @param[in]   handle     - handle of the CAN interface
+ *  @param[in]   subscriber - subscriber number (from can_subscribe)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid subscriber
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_unsubscribe(int handle, int subscriber);
+
+
+/** @brief       read up to n messages from the message queue of a subscriber,
+ *               if any message was received. The CAN controller must be in
+ *               operation state 'running'.
+ *
+ *  @remarks     The function waits for the first message only, the following
+ *               messages are taken from the message queue if already received.
+ *
+ *  @param[in]   handle     - handle of the CAN interface
+ *  @param[in]   subscriber - subscriber number (from can_subscribe)
+ *  @param[out]  messages   - pointer to an array of message buffers
+ *  @param[in]   count      - maximum number of messages to be read
+ *  @param[in]   timeout    - time to wait for the reception of a message:
+ *                                 0 means the function returns immediately,
+ *                                 65535 means blocking read, and any other
+ *                                 value means the time to wait in milliseconds
+ *
+ *  @returns     the number of messages read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid subscriber
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_subscriber(int handle, int subscriber, can_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       opens an ISO-TP channel (ISO 15765-2) on the CAN interface.
+ *
+ *  @remarks     The transport protocol runs on the reception thread of the
+ *               interface: frames of an open channel are consumed by the
+ *               engine (not queued), First Frames are answered immediately
+ *               by a Flow Control frame.
+ *
+ *  @note        The parameters of an ISO-TP channel are vendor-specific
+ *               (e.g. can_sio_isotp_t for SerialCAN interfaces).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   param   - pointer to the channel parameters
+ *
+ *  @returns     the channel number if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid channel parameters
+ *  @retval      CANERR_RESOURCE  - no more channels or out of memory
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_open(int handle, const void *param);
+
+
+/** @brief       closes an ISO-TP channel of the CAN interface.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   channel - channel number (from can_isotp_open)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid channel
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_close(int handle, int channel);
+
+
+/** @brief       transmits a PDU on an ISO-TP channel (segmented if required).
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @remarks     The function returns when the last frame of the PDU has been
+ *               written; it waits for the Flow Control frames of the receiver.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   channel - channel number (from can_isotp_open)
+ *  @param[in]   data    - pointer to the PDU
+ *  @param[in]   length  - length of the PDU (1 to 4095 bytes)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid channel or length
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TIMEOUT   - no Flow Control frame received (N_Bs)
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_send(int handle, int channel, const uint8_t *data, size_t length);
+
+
+/** @brief       reads a received PDU from an ISO-TP channel, if any PDU was
+ *               received. The CAN controller must be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   channel - channel number (from can_isotp_open)
+ *  @param[out]  buffer  - pointer to a buffer for the PDU
+ *  @param[in]   size    - size of the buffer (a longer PDU is discarded)
+ *  @param[in]   timeout - time to wait for the reception of a PDU:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the length of the PDU if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - invalid channel, or buffer too small for the PDU
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - no PDU received
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_isotp_receive(int handle, int channel, uint8_t *buffer, size_t size, uint16_t timeout);
+
+
+/** @brief       initializes the SAE J1939 transport protocol on the CAN interface
+ *               (reassembly of BAM and RTS/CTS sessions).
+ *
+ *  @remarks     The engine runs on the reception thread of the interface; the
+ *               reassembled PDUs are read by can_j1939_receive. It is released
+ *               by can_exit.
+ *
+ *  @note        The parameters of the engine are vendor-specific (e.g.
+ *               can_sio_j1939_t for SerialCAN interfaces, NULL = defaults).
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   param   - pointer to the engine parameters (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_YETINIT   - already initialized
+ *  @retval      CANERR_ILLPARA   - invalid engine parameters
+ *  @retval      CANERR_RESOURCE  - out of memory
+ *  @retval      CANERR_NOTSUPP   - function not supported
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_j1939_init(int handle, const void *param);
+
+
+/** @brief       claims an own J1939 address (address claim procedure). The CAN
+ *               controller must be in operation state 'running'.
+ *
+ *  @remarks     The function waits 250ms for contending claims; the NAME with
+ *               the lower value wins. Address 254 releases the own address.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   address - address to be claimed (0..253, or 254)
+ *  @param[in]   name    - NAME of the node (64-bit)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_ILLPARA   - invalid address (or J1939 not initialized)
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy
+ *  @retval      others           - vendor-specific (e.g. address lost)
+ */
+CANAPI int can_j1939_claim(int handle, uint8_t address, uint64_t name);
+
+
+/** @brief       reads a reassembled J1939 PDU, if any PDU was received. The CAN
+ *               controller must be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  pgn     - parameter group number (optional)
+ *  @param[out]  src     - source address (optional)
+ *  @param[out]  dst     - destination address, 255 = global (optional)
+ *  @param[out]  data    - pointer to a buffer for the PDU
+ *  @param[in]   size    - size of the buffer (a longer PDU is discarded)
+ *  @param[in]   timeout - time to wait for the reception of a PDU:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     the length of the PDU if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - J1939 not initialized, or buffer too small for the PDU
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - no PDU received
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_j1939_receive(int handle, uint32_t *pgn, uint8_t *src, uint8_t *dst, uint8_t *data, size_t size, uint16_t timeout);
+
+
 /** @brief       retrieves the status register of the CAN interface.
  *
  *  @param[in]   handle  - handle of the CAN interface.
@@ -100,49 +100,52 @@
                     ((x) > 12U) ? 0xAU : \
                     ((x) > 8U) ?  0x9U : (x)
 #endif
+#if !defined(_WIN32) && !defined(_WIN64)
+#define GMTIME(t,tm)     (void)gmtime_r(t,tm)
+#define LOCALTIME(t,tm)  (void)localtime_r(t,tm)
+#else
+#define GMTIME(t,tm)     (void)gmtime_s(tm,t)
+#define LOCALTIME(t,tm)  (void)localtime_s(tm,t)
+#endif
 
 
 /*  -----------  types  --------------------------------------------------
  */
 
+typedef struct msg_cursor_t_ {          /* output cursor: */
+    char *start;                        /*   start of the output buffer */
+    char *ptr;                          /*   current write position */
+    char *end;                          /*   last position (for the '\0') */
+} msg_cursor_t;
+
 
 /*  -----------  prototypes  ---------------------------------------------
  */
 
-static void format_time(char *string, const msg_message_t *message);
-static void format_id(char *string, const msg_message_t *message);
-static void format_dlc(char *string, const msg_message_t *message);
-static void format_data(char *string, const msg_message_t *message, int ascii, int indent);
-static void format_ascii(char *string, const msg_message_t *message);
-static void format_data_byte(char *string, unsigned char data);
-static void format_data_ascii(char *string, unsigned char data);
-static void format_fill_byte(char *string);
+static void format_message(msg_cursor_t *cursor, msg_formatter_t *formatter, const msg_message_t *message,
+                           msg_direction_t direction, msg_counter_t counter, msg_channel_t channel);
+static void format_time(msg_cursor_t *cursor, msg_formatter_t *formatter, const msg_message_t *message);
+static void format_id(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message);
+static void format_flags(msg_cursor_t *cursor, const msg_message_t *message);
+static void format_dlc(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message);
+static void format_data(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message, int ascii, int indent);
+static void format_ascii(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message);
+static void format_data_byte(msg_cursor_t *cursor, const msg_fmt_options_t *option, unsigned char data);
+static void format_data_ascii(msg_cursor_t *cursor, const msg_fmt_options_t *option, unsigned char data);
+static void format_fill_byte(msg_cursor_t *cursor, const msg_fmt_options_t *option);
+
+static void update_formatter(msg_formatter_t *formatter);
+
+static void cursor_init(msg_cursor_t *cursor, char *buffer, size_t size);
+static void put_char(msg_cursor_t *cursor, char c);
+static void put_string(msg_cursor_t *cursor, const char *string);
+static void put_number(msg_cursor_t *cursor, uint64_t value, int base, int width, char pad);
 
 
 /*  -----------  variables  ----------------------------------------------
  */
 
-static struct {                         /* format option: */
-    msg_fmt_timestamp_t  time_stamp;    /*   time-stamp {ZERO, ABS, REL} */
-    msg_fmt_option_t     time_usec;     /*   time-stamp in usec {OFF, ON} */
-    msg_fmt_time_t       time_format;   /*   time format {TIME, SEC, DJD} */
-    msg_fmt_number_t     id;            /*   identifier {HEX, DEC, OCT, BIN} */
-    msg_fmt_option_t     id_xtd;        /*   extended identifier {OFF, ON} */
-    msg_fmt_number_t     dlc;           /*   DLC/length {HEX, DEC, OCT, BIN} */
-    msg_fmt_canfd_t      dlc_format;    /*   CAN FD format {DLC, LENGTH} */
-    int                  dlc_brackets;  /*   DLC in brackets {'\0', '(', '['} */
-    msg_fmt_option_t     flags;         /*   message flags {ON, OFF} */
-    msg_fmt_number_t     data;          /*   message data {HEX, DEC, OCT, BIN} */
-    msg_fmt_option_t     ascii;         /*   data as ASCII {ON, OFF} */
-    int                  ascii_subst;   /*   substitute for non-printables */
-    msg_fmt_option_t     channel;       /*   message source {OFF, ON} */
-    msg_fmt_option_t     counter;       /*   message counter {ON, OFF} */
-    msg_fmt_separator_t  separator;     /*   separator {SPACES, TABS} */
-    msg_fmt_wraparound_t wraparound;    /*   wraparound {NO, 8, 16, 32, 64} */
-    msg_fmt_option_t     end_of_line;   /*   end-of-line character {ON, OFF} */
-    char                 rx_prompt[6+1];/*   prompt for received messages */
-    char                 tx_prompt[6+1];/*   prompt for sent messages */
-}   msg_option = {
+static msg_fmt_options_t msg_option = { /* format option: */
                         .time_stamp = MSG_FMT_TIMESTAMP_ZERO,
                         .time_usec = MSG_FMT_OPTION_OFF,
                         .time_format = MSG_FMT_TIME_SEC,
@@ -164,10 +167,18 @@ static struct {                         /* format option: */
                         .tx_prompt = ""
 };
 static msg_format_t msg_format = MSG_FORMAT_DEFAULT;
+static msg_formatter_t msg_formatter = { .first = 1 };  /* context of the non-reentrant functions */
 static char msg_string[MSG_STRING_LENGTH] = "";
 static const unsigned char dlc_table[16] = {
     0U,1U,2U,3U,4U,5U,6U,7U,8U,12U,16U,20U,24U,32U,48U,64U
 };
+static const char hex_digits[16+1] = "0123456789ABCDEF";
+static const char dec_digits[200+1] =   /* two decimal digits for 00 .. 99 */
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
 
 /*  -----------  functions  ----------------------------------------------
@@ -176,160 +187,112 @@ static const unsigned char dlc_table[16] = {
 char *msg_format_message(const msg_message_t *message, msg_direction_t direction,
                                msg_counter_t counter, msg_channel_t channel)
 {
-    char tmp_string[MSG_STRING_LENGTH];
+    msg_cursor_t cursor;
 
-    memset(msg_string, 0, sizeof(msg_string));
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
-        /* prompt (optional) */
-        if (strlen(msg_option.tx_prompt) && (direction == MSG_TX_MESSAGE)) {
-            strcat(msg_string, msg_option.tx_prompt);
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : " ");
-        }
-        else if (strlen(msg_option.rx_prompt)) { /* defaults to MSG_DIRECTION_RX_MSG */
-            strcat(msg_string, msg_option.rx_prompt);
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : " ");
-        }
-        /* counter (optional) */
-        if ((msg_option.counter != MSG_FMT_OPTION_OFF) && ((msg_option.separator == MSG_FMT_SEPARATOR_TABS))) {
-            sprintf(tmp_string, "%" PRIu64 "\t", counter);
-            strcat(msg_string, tmp_string);
-        }
-        else if (msg_option.counter != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
-            sprintf(tmp_string, "%-7" PRIu64 "  ", counter);
-            strcat(msg_string, tmp_string);
-        }
-        /* time-stamp (abs/rel/zero) (hhmmss/sec/DJD).(msec/usec) */
-        format_time(tmp_string, message);
-        strcat(msg_string, tmp_string);
-        strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : "  ");
-
-        /* channel (optional) */
-        if ((msg_option.channel != MSG_FMT_OPTION_OFF) && (msg_option.separator == MSG_FMT_SEPARATOR_TABS)) {
-            sprintf(tmp_string, "%i\t", channel);
-            strcat(msg_string, tmp_string);
-        }
-        else if (msg_option.channel != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
-            sprintf(tmp_string, "%-2i  ", channel);
-            strcat(msg_string, tmp_string);
-        }
-        /* identifier (hex/dec/oct) */
-        format_id(tmp_string, message);
-        strcat(msg_string, tmp_string);
-        strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : "  ");
-
-        /* flags (optional) */
-        if (msg_option.flags != MSG_FMT_OPTION_OFF) {
-#if (OPTION_CAN_2_0_ONLY == 0)
-            if (!message->sts) {
-                strcat(msg_string, message->xtd ? "X" : "S");
-                strcat(msg_string, message->fdf ? "F" : "-");
-                strcat(msg_string, message->brs ? "B" : "-");
-                strcat(msg_string, message->esi ? "E" : "-");
-                strcat(msg_string, message->rtr ? "R" : "-");
-            }
-            else {
-                strcat(msg_string, "Error");
-            }
-#else
-            if (!message->sts) {
-                strcat(msg_string, message->xtd ? "X" : "S");
-                strcat(msg_string, message->rtr ? "R" : "-");
-            }
-            else {
-                strcat(msg_string, "E!");
-            }
-#endif
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : " ");  /* only one space! */
-        }
-        /* dlc/length (hex/dec/oct) */
-        format_dlc(tmp_string, message);
-        strcat(msg_string, tmp_string);
-
-        /* data (hex/dec/oct) plus ascii (optional) */
-        if (message->dlc && !message->rtr) {
-            strcat(msg_string, (msg_option.separator == MSG_FMT_SEPARATOR_TABS) ? "\t" : "  ");
-            format_data(tmp_string, message, (msg_option.ascii == MSG_FMT_OPTION_OFF) ? 0 : 1, (int)strlen(msg_string));
-            strcat(msg_string, tmp_string);
-        }
-        /* end-of-line (optional) */
-        if (msg_option.end_of_line) {
-            strcat(msg_string, "\n");
-        }
+        update_formatter(&msg_formatter);
+        format_message(&cursor, &msg_formatter, message, direction, counter, channel);
+        *cursor.ptr = '\0';
     }
     return msg_string;
 }
 
+void msg_init_formatter(msg_formatter_t *formatter)
+{
+    if (formatter) {
+        memset(formatter, 0, sizeof(msg_formatter_t));
+        memcpy(&formatter->option, &msg_option, sizeof(msg_fmt_options_t));
+        formatter->first = 1;
+    }
+}
+
+size_t msg_format_message_r(msg_formatter_t *formatter, const msg_message_t *message,
+                            msg_direction_t direction, msg_counter_t counter,
+                            msg_channel_t channel, char *buffer, size_t size)
+{
+    msg_cursor_t cursor;
+
+    if (!buffer || !size)
+        return 0;
+    cursor_init(&cursor, buffer, size);
+
+    if (formatter && message) {
+        update_formatter(formatter);
+        format_message(&cursor, formatter, message, direction, counter, channel);
+        *cursor.ptr = '\0';
+    }
+    return (size_t)(cursor.ptr - cursor.start);
+}
+
 char *msg_format_time(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    msg_cursor_t cursor;
+
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
         /* time-stamp (abs/rel/zero) (hhmmss/sec/DJD).(msec/usec) */
-        format_time(msg_string, message);
+        update_formatter(&msg_formatter);
+        format_time(&cursor, &msg_formatter, message);
+        *cursor.ptr = '\0';
     }
     return msg_string;
 }
 
 char *msg_format_id(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    msg_cursor_t cursor;
+
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
         /* identifier (hex/dec/oct) */
-        format_id(msg_string, message);
+        format_id(&cursor, &msg_option, message);
+        *cursor.ptr = '\0';
     }
     return msg_string;
 }
 
 char *msg_format_flags(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    msg_cursor_t cursor;
+
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
-#if (OPTION_CAN_2_0_ONLY == 0)
-        if (!message->sts) {
-            strcat(msg_string, message->xtd ? "X" : "S");
-            strcat(msg_string, message->fdf ? "F" : "-");
-            strcat(msg_string, message->brs ? "B" : "-");
-            strcat(msg_string, message->esi ? "E" : "-");
-            strcat(msg_string, message->rtr ? "R" : "-");
-        }
-        else {
-            strcat(msg_string, "Error");
-        }
-#else
-        if (!message->sts) {
-            strcat(msg_string, message->xtd ? "X" : "S");
-            strcat(msg_string, message->rtr ? "R" : "-");
-        }
-        else {
-            strcat(msg_string, "E!");
-        }
-#endif
+        format_flags(&cursor, message);
+        *cursor.ptr = '\0';
     }
     return msg_string;
 }
 
 char *msg_format_dlc(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    msg_cursor_t cursor;
+
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
         /* dlc/length (hex/dec/oct) */
-        format_dlc(msg_string, message);
+        format_dlc(&cursor, &msg_option, message);
+        *cursor.ptr = '\0';
     }
     return msg_string;
 }
 
 char *msg_format_data(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    msg_cursor_t cursor;
+
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
         /* data (hex/dec/oct) */
         if (message->dlc) {
-            format_data(msg_string, message, 0, 0);
+            format_data(&cursor, &msg_option, message, 0, 0);
+            *cursor.ptr = '\0';
         }
     }
     return msg_string;
@@ -337,18 +300,20 @@ char *msg_format_data(const msg_message_t *message)
 
 char *msg_format_ascii(const msg_message_t *message)
 {
-    memset(msg_string, 0, sizeof(msg_string));
+    msg_cursor_t cursor;
+
+    cursor_init(&cursor, msg_string, sizeof(msg_string));
 
     if (message) {
         /* data (hex/dec/oct) */
         if (message->dlc) {
-            format_ascii(msg_string, message);
+            format_ascii(&cursor, &msg_option, message);
+            *cursor.ptr = '\0';
         }
     }
     return msg_string;
 }
 
-
 /* message output format {DEFAULT, ...} */
 int msg_set_format(msg_format_t format)
 {
@@ -683,32 +648,100 @@ int msg_set_fmt_tx_prompt(const char *option)
     return rc;
 }
 
+
 /*  -----------  local functions  ----------------------------------------
  */
 
-static void format_time(char *string, const msg_message_t *message)
+static void format_message(msg_cursor_t *cursor, msg_formatter_t *formatter, const msg_message_t *message,
+                           msg_direction_t direction, msg_counter_t counter, msg_channel_t channel)
 {
-    static msg_timestamp_t laststamp = { 0, 0 };
-    static int first = 1;
+    assert(cursor);
+    assert(formatter);
+    assert(message);
 
+    const msg_fmt_options_t *option = &formatter->option;
+    int tabs = (option->separator == MSG_FMT_SEPARATOR_TABS) ? 1 : 0;
+
+    /* prompt (optional) */
+    if (option->tx_prompt[0] && (direction == MSG_TX_MESSAGE)) {
+        put_string(cursor, option->tx_prompt);
+        put_char(cursor, tabs ? '\t' : ' ');
+    }
+    else if (option->rx_prompt[0]) { /* defaults to MSG_DIRECTION_RX_MSG */
+        put_string(cursor, option->rx_prompt);
+        put_char(cursor, tabs ? '\t' : ' ');
+    }
+    /* counter (optional) */
+    if ((option->counter != MSG_FMT_OPTION_OFF) && tabs) {
+        put_number(cursor, (uint64_t)counter, 10, 0, ' ');
+        put_char(cursor, '\t');
+    }
+    else if (option->counter != MSG_FMT_OPTION_OFF) { /* defaults to MSG_FMT_SEPARATOR_SPACES */
+        put_number(cursor, (uint64_t)counter, 10, 7, '-');
+        put_string(cursor, "  ");
+    }
+    /* time-stamp (abs/rel/zero) (hhmmss/sec/DJD).(msec/usec) */
+    format_time(cursor, formatter, message);
+    put_string(cursor, tabs ? "\t" : "  ");
+
+    /* channel (optional) */
+    if (option->channel != MSG_FMT_OPTION_OFF) {
+        if (channel < 0) {
+            put_char(cursor, '-');
+            put_number(cursor, (uint64_t)(-(int64_t)channel), 10, tabs ? 0 : 1, '-');
+        }
+        else
+            put_number(cursor, (uint64_t)channel, 10, tabs ? 0 : 2, '-');
+        put_string(cursor, tabs ? "\t" : "  ");
+    }
+    /* identifier (hex/dec/oct) */
+    format_id(cursor, option, message);
+    put_string(cursor, tabs ? "\t" : "  ");
+
+    /* flags (optional) */
+    if (option->flags != MSG_FMT_OPTION_OFF) {
+        format_flags(cursor, message);
+        put_char(cursor, tabs ? '\t' : ' ');  /* only one space! */
+    }
+    /* dlc/length (hex/dec/oct) */
+    format_dlc(cursor, option, message);
+
+    /* data (hex/dec/oct) plus ascii (optional) */
+    if (message->dlc && !message->rtr) {
+        put_string(cursor, tabs ? "\t" : "  ");
+        format_data(cursor, option, message, (option->ascii == MSG_FMT_OPTION_OFF) ? 0 : 1,
+                    (int)(cursor->ptr - cursor->start));
+    }
+    /* end-of-line (optional) */
+    if (option->end_of_line) {
+        put_char(cursor, '\n');
+    }
+}
+
+static void format_time(msg_cursor_t *cursor, msg_formatter_t *formatter, const msg_message_t *message)
+{
+    const msg_fmt_options_t *option;
     struct timespec difftime;
     struct tm tm; time_t t;
-    char   timestring[25];
+    char   timestring[32];
+    msg_cursor_t prefix;
     double djd;
 
-    assert(string);
+    assert(cursor);
+    assert(formatter);
     assert(message);
 
-    switch (msg_option.time_stamp) {
+    option = &formatter->option;
+    switch (option->time_stamp) {
     case MSG_FMT_TIMESTAMP_RELATIVE:
     case MSG_FMT_TIMESTAMP_ZERO:
-        if (first) { /* first time-stamp received */
-            first = 0;
-            laststamp.tv_sec = message->timestamp.tv_sec;
-            laststamp.tv_nsec = message->timestamp.tv_nsec;
+        if (formatter->first) { /* first time-stamp received */
+            formatter->first = 0;
+            formatter->laststamp.tv_sec = message->timestamp.tv_sec;
+            formatter->laststamp.tv_nsec = message->timestamp.tv_nsec;
         }
-        difftime.tv_sec = message->timestamp.tv_sec - laststamp.tv_sec;
-        difftime.tv_nsec = message->timestamp.tv_nsec - laststamp.tv_nsec;
+        difftime.tv_sec = message->timestamp.tv_sec - formatter->laststamp.tv_sec;
+        difftime.tv_nsec = message->timestamp.tv_nsec - formatter->laststamp.tv_nsec;
         if (difftime.tv_nsec < 0) {
             difftime.tv_sec -= 1;
             difftime.tv_nsec += 1000000000;
@@ -717,165 +750,187 @@ static void format_time(char *string, const msg_message_t *message)
             difftime.tv_sec = 0;
             difftime.tv_nsec = 0;
         }
-        if (msg_option.time_stamp == MSG_FMT_TIMESTAMP_RELATIVE) { /* update for delta calculation */
-            laststamp.tv_sec = message->timestamp.tv_sec;
-            laststamp.tv_nsec = message->timestamp.tv_nsec;
+        if (option->time_stamp == MSG_FMT_TIMESTAMP_RELATIVE) { /* update for delta calculation */
+            formatter->laststamp.tv_sec = message->timestamp.tv_sec;
+            formatter->laststamp.tv_nsec = message->timestamp.tv_nsec;
         }
-        t = (time_t)difftime.tv_sec;
-        tm = *gmtime(&t);
         break;
     case MSG_FMT_TIMESTAMP_ABSOLUTE:
     default:
         difftime.tv_sec = message->timestamp.tv_sec;
         difftime.tv_nsec = message->timestamp.tv_nsec;
-        t = (time_t)message->timestamp.tv_sec;
-        tm = *localtime(&t);
         break;
     }
-    switch (msg_option.time_format) {
-    case MSG_FMT_TIME_HHMMSS:
-        strftime(timestring, 24, "%H:%M:%S", &tm); // TODO: tm > 24h (?)
-        if (msg_option.time_usec)
-            sprintf(string, "%s.%06li", timestring, (long)difftime.tv_nsec / 1000L);
-        else/* resolution is 0.1 milliseconds! */
-            sprintf(string, "%s.%04li", timestring, (long)difftime.tv_nsec / 100000L);
-        break;
+    switch (option->time_format) {
     case MSG_FMT_TIME_DJD:
-        if (!msg_option.time_usec)  /* round to milliseconds resolution */
+        if (!option->time_usec)  /* round to milliseconds resolution */
             difftime.tv_nsec = ((difftime.tv_nsec + 500000L) / 1000000L) * 1000000L;
         djd = (double)difftime.tv_sec / (double)86400;
         djd += (double)difftime.tv_nsec / (double)86400000000000;
-        if (msg_option.time_usec)
-            sprintf(string, "%1.12lf", djd);
+        if (option->time_usec)
+            snprintf(timestring, sizeof(timestring), "%1.12lf", djd);
         else
-            sprintf(string, "%1.9lf", djd);
+            snprintf(timestring, sizeof(timestring), "%1.9lf", djd);
+        put_string(cursor, timestring);
         break;
+    case MSG_FMT_TIME_HHMMSS:
     case MSG_FMT_TIME_SEC:
     default:
-        if (msg_option.time_usec)
-            sprintf(string, "%3li.%06li", (long)difftime.tv_sec, (long)difftime.tv_nsec / 1000L);
+        /* the time prefix <hh:mm:ss> resp. <sec> changes once per second */
+        if (!formatter->time.valid || (formatter->time.second != (int64_t)difftime.tv_sec)) {
+            cursor_init(&prefix, formatter->time.prefix, sizeof(formatter->time.prefix));
+            if (option->time_format == MSG_FMT_TIME_HHMMSS) {
+                t = (time_t)difftime.tv_sec;
+                if (option->time_stamp == MSG_FMT_TIMESTAMP_ABSOLUTE)
+                    LOCALTIME(&t, &tm);
+                else
+                    GMTIME(&t, &tm);
+                strftime(timestring, 24, "%H:%M:%S", &tm); // TODO: tm > 24h (?)
+                put_string(&prefix, timestring);
+            }
+            else
+                put_number(&prefix, (uint64_t)difftime.tv_sec, 10, 3, ' ');
+            *prefix.ptr = '\0';
+            formatter->time.length = (size_t)(prefix.ptr - prefix.start);
+            formatter->time.second = (int64_t)difftime.tv_sec;
+            formatter->time.valid = 1;
+        }
+        put_string(cursor, formatter->time.prefix);
+        put_char(cursor, '.');
+        if (option->time_usec)
+            put_number(cursor, (uint64_t)difftime.tv_nsec / 1000U, 10, 6, '0');
         else/* resolution is 0.1 milliseconds! */
-            sprintf(string, "%3li.%04li", (long)difftime.tv_sec, (long)difftime.tv_nsec / 100000L);
+            put_number(cursor, (uint64_t)difftime.tv_nsec / 100000U, 10, 4, '0');
         break;
     }
 }
 
-static void format_id(char *string, const msg_message_t *message)
+static void format_id(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message)
 {
-    assert(string);
+    assert(cursor);
+    assert(option);
     assert(message);
 
-    string[0] = '\0';
-    switch (msg_option.id) {
+    switch (option->id) {
     case MSG_FMT_NUMBER_DEC:
-        if (!msg_option.id_xtd)
-            sprintf(string, "%-4" PRIu32, message->id);
-        else
-            sprintf(string, "%-9" PRIu32, message->id);
+        put_number(cursor, (uint64_t)message->id, 10, !option->id_xtd ? 4 : 9, '-');
         break;
     case MSG_FMT_NUMBER_OCT:
-        if (!msg_option.id_xtd)
-            sprintf(string, "%04" PRIo32, message->id);
-        else
-            sprintf(string, "%010" PRIo32, message->id);
+        put_number(cursor, (uint64_t)message->id, 8, !option->id_xtd ? 4 : 10, '0');
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        if (!msg_option.id_xtd)
-            sprintf(string, "%03" PRIX32, message->id);
-        else
-            sprintf(string, "%08" PRIX32, message->id);
+        put_number(cursor, (uint64_t)message->id, 16, !option->id_xtd ? 3 : 8, '0');
         break;
     }
 }
 
-static void format_dlc(char *string, const msg_message_t *message)
+static void format_flags(msg_cursor_t *cursor, const msg_message_t *message)
 {
-    assert(string);
+    assert(cursor);
     assert(message);
 
-    unsigned char length = (msg_option.dlc_format == MSG_FMT_CANFD_DLC) ? message->dlc : DLC2LEN(message->dlc);
+#if (OPTION_CAN_2_0_ONLY == 0)
+    if (!message->sts) {
+        put_char(cursor, message->xtd ? 'X' : 'S');
+        put_char(cursor, message->fdf ? 'F' : '-');
+        put_char(cursor, message->brs ? 'B' : '-');
+        put_char(cursor, message->esi ? 'E' : '-');
+        put_char(cursor, message->rtr ? 'R' : '-');
+    }
+    else {
+        put_string(cursor, "Error");
+    }
+#else
+    if (!message->sts) {
+        put_char(cursor, message->xtd ? 'X' : 'S');
+        put_char(cursor, message->rtr ? 'R' : '-');
+    }
+    else {
+        put_string(cursor, "E!");
+    }
+#endif
+}
+
+static void format_dlc(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message)
+{
+    assert(cursor);
+    assert(option);
+    assert(message);
+
+    unsigned char length = (option->dlc_format == MSG_FMT_CANFD_DLC) ? message->dlc : DLC2LEN(message->dlc);
     char pre = '\0', post = '\0';
     int blank = 0;
 
-    string[0] = '\0';
-    switch (msg_option.dlc_brackets) {
+    switch (option->dlc_brackets) {
     case '(': pre = '('; post = ')'; break;
     case '[': pre = '['; post = ']'; break;
     default: break;
     }
-    switch (msg_option.dlc) {
+    if (pre)
+        put_char(cursor, pre);
+    switch (option->dlc) {
     case MSG_FMT_NUMBER_DEC:
-        if (pre && post)
-            sprintf(string, "%c%u%c", pre, length, post);
-        else
-            sprintf(string, "%u", length);
+        put_number(cursor, (uint64_t)length, 10, 0, ' ');
         blank = length >= 10 ? 0 : 1;
         break;
     case MSG_FMT_NUMBER_OCT:
-        if (pre && post)
-            sprintf(string, "%c%02o%c", pre, length, post);
-        else
-            sprintf(string, "%02o", length);
+        put_number(cursor, (uint64_t)length, 8, 2, '0');
         blank = length >= 64 ? 0 : 1;
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        if (pre && post)
-            sprintf(string, "%c%X%c", pre, length, post);
-        else
-            sprintf(string, "%X", length);
+        put_number(cursor, (uint64_t)length, 16, 0, ' ');
         break;
     }
+    if (post)
+        put_char(cursor, post);
 #if (OPTION_CAN_2_0_ONLY == 0)
     if (message->fdf && blank)
-        strcat(string, " ");
+        put_char(cursor, ' ');
 #else
     (void)blank;  /* to avoid compiler warnings */
 #endif
 }
 
-static void format_data(char *string, const msg_message_t *message, int ascii, int indent)
+static void format_data(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message, int ascii, int indent)
 {
-    assert(string);
+    assert(cursor);
+    assert(option);
     assert(message);
 
     int length = DLC2LEN(message->dlc);
+    int tabs = (option->separator == MSG_FMT_SEPARATOR_TABS) ? 1 : 0;
     int i, j, col, wraparound;
-    char datastring[8];
 
-    string[0] = '\0';
 #if (OPTION_CAN_2_0_ONLY == 0)
-    if (msg_option.wraparound == MSG_FMT_WRAPAROUND_NO)
+    if (option->wraparound == MSG_FMT_WRAPAROUND_NO)
         wraparound = message->fdf ? (int)MSG_FMT_WRAPAROUND_64 : (int)MSG_FMT_WRAPAROUND_8;
     else
-        wraparound = (int)msg_option.wraparound;
+        wraparound = (int)option->wraparound;
 #else
     wraparound = (int)MSG_FMT_WRAPAROUND_8;
 #endif
     for (i = 0, j = 0, col = 0; i < length; i++) {
-        format_data_byte(datastring, message->data[i]);
-        strcat(string, datastring);
+        format_data_byte(cursor, option, message->data[i]);
         if ((i + 1) < length) {
             if ((col + 1) == wraparound) {
                 if (ascii) {
-                    strcat(string, msg_option.separator == MSG_FMT_SEPARATOR_TABS ? "\t" : "  ");
-                    for (col = 0; col < (int)msg_option.wraparound; j++, col++) {
-                        format_data_ascii(datastring, message->data[j]);
-                        strcat(string, datastring);
-                    }
+                    put_string(cursor, tabs ? "\t" : "  ");
+                    for (col = 0; col < (int)option->wraparound; j++, col++)
+                        format_data_ascii(cursor, option, message->data[j]);
                 }
-                strcat(string, "\n");
-                if (msg_option.separator != MSG_FMT_SEPARATOR_TABS) {
+                put_char(cursor, '\n');
+                if (!tabs) {
                     for (col = 0; col < indent; col++)
-                        strcat(string, " ");
+                        put_char(cursor, ' ');
                 }
                 else
-                    strcat(string, "\t");
+                    put_char(cursor, '\t');
                 col = 0;
             }
             else {
-                strcat(string, " ");
+                put_char(cursor, ' ');
                 col++;
             }
         }
@@ -884,97 +939,182 @@ static void format_data(char *string, const msg_message_t *message, int ascii, i
     }
     if (ascii) {
         if ((col < wraparound) && (i != 0)) {
-            strcat(string, " ");
+            put_char(cursor, ' ');
             for (; col < wraparound; col++) {
-                format_fill_byte(datastring);
-                strcat(string, datastring);
+                format_fill_byte(cursor, option);
                 if ((col + 1) != wraparound)
-                    strcat(string, " ");
+                    put_char(cursor, ' ');
             }
         }
-        strcat(string, msg_option.separator == MSG_FMT_SEPARATOR_TABS ? "\t" : "  ");
-        for (; j < length; j++) {
-            format_data_ascii(datastring, message->data[j]);
-            strcat(string, datastring);
-        }
+        put_string(cursor, tabs ? "\t" : "  ");
+        for (; j < length; j++)
+            format_data_ascii(cursor, option, message->data[j]);
     }
 }
 
-static void format_ascii(char *string, const msg_message_t *message)
+static void format_ascii(msg_cursor_t *cursor, const msg_fmt_options_t *option, const msg_message_t *message)
 {
-    assert(string);
+    assert(cursor);
+    assert(option);
     assert(message);
 
     int length = DLC2LEN(message->dlc);
     int i, col, wraparound;
-    char datastring[8];
 
-    string[0] = '\0';
 #if (OPTION_CAN_2_0_ONLY == 0)
-    if (msg_option.wraparound == MSG_FMT_WRAPAROUND_NO)
+    if (option->wraparound == MSG_FMT_WRAPAROUND_NO)
         wraparound = message->fdf ? (int)MSG_FMT_WRAPAROUND_64 : (int)MSG_FMT_WRAPAROUND_8;
     else
-        wraparound = (int)msg_option.wraparound;
+        wraparound = (int)option->wraparound;
 #else
     wraparound = (int)MSG_FMT_WRAPAROUND_8;
 #endif
     for (i = 0, col = 0; i < length; i++) {
-        format_data_ascii(datastring, message->data[i]);
-        strcat(string, datastring);
+        format_data_ascii(cursor, option, message->data[i]);
         if ((i + 1) < length) {
             if ((col + 1) == wraparound) {
-                strcat(string, "\n");
+                put_char(cursor, '\n');
                 col = 0;
             }
             else {
-                strcat(string, " ");
+                put_char(cursor, ' ');
                 col++;
             }
         }
     }
 }
 
-static void format_data_byte(char *string, unsigned char data)
+static void format_data_byte(msg_cursor_t *cursor, const msg_fmt_options_t *option, unsigned char data)
 {
-    assert(string);
+    assert(cursor);
+    assert(option);
 
-    switch (msg_option.data) {
+    switch (option->data) {
     case MSG_FMT_NUMBER_DEC:
-        sprintf(string, "%-3u", data);
+        put_number(cursor, (uint64_t)data, 10, 3, '-');
         break;
     case MSG_FMT_NUMBER_OCT:
-        sprintf(string, "%03o", data);
+        put_number(cursor, (uint64_t)data, 8, 3, '0');
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        sprintf(string, "%02X", data);
+        put_char(cursor, hex_digits[data >> 4]);
+        put_char(cursor, hex_digits[data & 0xFU]);
         break;
     }
 }
 
-static void format_fill_byte(char *string)
+static void format_fill_byte(msg_cursor_t *cursor, const msg_fmt_options_t *option)
 {
-    assert(string);
+    assert(cursor);
+    assert(option);
 
-    switch (msg_option.data) {
+    switch (option->data) {
     case MSG_FMT_NUMBER_DEC:
-        sprintf(string, "   ");
+        put_string(cursor, "   ");
         break;
     case MSG_FMT_NUMBER_OCT:
-        sprintf(string, "   ");
+        put_string(cursor, "   ");
         break;
     case MSG_FMT_NUMBER_HEX:
     default:
-        sprintf(string, "  ");
+        put_string(cursor, "  ");
         break;
     }
 }
 
-static void format_data_ascii(char *string, unsigned char data)
+static void format_data_ascii(msg_cursor_t *cursor, const msg_fmt_options_t *option, unsigned char data)
+{
+    assert(cursor);
+    assert(option);
+
+    put_char(cursor, isprint((int)data) ? (char)data : (char)option->ascii_subst);
+}
+
+/* takes over changed options into the context of the non-reentrant functions */
+static void update_formatter(msg_formatter_t *formatter)
+{
+    assert(formatter);
+
+    if (memcmp(&formatter->option, &msg_option, sizeof(msg_fmt_options_t)) != 0) {
+        memcpy(&formatter->option, &msg_option, sizeof(msg_fmt_options_t));
+        formatter->time.valid = 0;
+    }
+}
+
+/* the cursor always leaves room for the terminating zero */
+static void cursor_init(msg_cursor_t *cursor, char *buffer, size_t size)
+{
+    assert(cursor);
+    assert(buffer);
+    assert(size);
+
+    cursor->start = buffer;
+    cursor->ptr = buffer;
+    cursor->end = buffer + (size - 1U);
+    *cursor->ptr = '\0';
+}
+
+static void put_char(msg_cursor_t *cursor, char c)
 {
-    assert(string);
+    if (cursor->ptr < cursor->end)
+        *cursor->ptr++ = c;
+}
+
+static void put_string(msg_cursor_t *cursor, const char *string)
+{
+    while (*string && (cursor->ptr < cursor->end))
+        *cursor->ptr++ = *string++;
+}
 
-    sprintf(string, "%c", isprint((int)data) ? (char)data : (char)msg_option.ascii_subst);
+/* pad: '0' or ' ' = right-aligned with leading zeros resp. spaces, '-' = left-aligned */
+static void put_number(msg_cursor_t *cursor, uint64_t value, int base, int width, char pad)
+{
+    char digits[24];  /* up to 22 octal digits (64-bit) */
+    unsigned int r;
+    int n = 0;
+
+    switch (base) {
+    case 16:
+        do {
+            digits[n++] = hex_digits[value & 0xFU];
+            value >>= 4;
+        } while (value);
+        break;
+    case 8:
+        do {
+            digits[n++] = (char)('0' + (value & 0x7U));
+            value >>= 3;
+        } while (value);
+        break;
+    case 10:
+    default:
+        while (value >= 100U) {
+            r = (unsigned int)(value % 100U) << 1;
+            value /= 100U;
+            digits[n++] = dec_digits[r + 1U];
+            digits[n++] = dec_digits[r];
+        }
+        if (value >= 10U) {
+            r = (unsigned int)value << 1;
+            digits[n++] = dec_digits[r + 1U];
+            digits[n++] = dec_digits[r];
+        }
+        else
+            digits[n++] = (char)('0' + value);
+        break;
+    }
+    width -= n;
+    if (pad != '-') {
+        for (; width > 0; width--)
+            put_char(cursor, pad);
+    }
+    while (n > 0)
+        put_char(cursor, digits[--n]);
+    if (pad == '-') {
+        for (; width > 0; width--)
+            put_char(cursor, ' ');
+    }
 }
 
 /** @}
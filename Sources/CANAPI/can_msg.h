@@ -74,6 +74,7 @@ extern "C" {
 #include <stdbool.h>                    /*   C99 header for boolean type */
 #include <time.h>                       /*   for structure 'timespec' */
 #endif
+#include <stddef.h>                     /* for type 'size_t' */
 
 /*  -----------  options  ------------------------------------------------
  */
@@ -280,6 +281,49 @@ typedef enum msg_direction_t_ {
     MSG_TX_MESSAGE = 1
 } msg_direction_t;
 
+/** @brief       Formatter Options (all settings of the message formatter)
+ */
+typedef struct msg_fmt_options_t_ {
+    msg_fmt_timestamp_t  time_stamp;    /**< time-stamp {ZERO, ABS, REL} */
+    msg_fmt_option_t     time_usec;     /**< time-stamp in usec {OFF, ON} */
+    msg_fmt_time_t       time_format;   /**< time format {TIME, SEC, DJD} */
+    msg_fmt_number_t     id;            /**< identifier {HEX, DEC, OCT, BIN} */
+    msg_fmt_option_t     id_xtd;        /**< extended identifier {OFF, ON} */
+    msg_fmt_number_t     dlc;           /**< DLC/length {HEX, DEC, OCT, BIN} */
+    msg_fmt_canfd_t      dlc_format;    /**< CAN FD format {DLC, LENGTH} */
+    int                  dlc_brackets;  /**< DLC in brackets {'\0', '(', '['} */
+    msg_fmt_option_t     flags;         /**< message flags {ON, OFF} */
+    msg_fmt_number_t     data;          /**< message data {HEX, DEC, OCT, BIN} */
+    msg_fmt_option_t     ascii;         /**< data as ASCII {ON, OFF} */
+    int                  ascii_subst;   /**< substitute for non-printables */
+    msg_fmt_option_t     channel;       /**< message source {OFF, ON} */
+    msg_fmt_option_t     counter;       /**< message counter {ON, OFF} */
+    msg_fmt_separator_t  separator;     /**< separator {SPACES, TABS} */
+    msg_fmt_wraparound_t wraparound;    /**< wraparound {NO, 8, 16, 32, 64} */
+    msg_fmt_option_t     end_of_line;   /**< end-of-line character {ON, OFF} */
+    char                 rx_prompt[6+1];/**< prompt for received messages */
+    char                 tx_prompt[6+1];/**< prompt for sent messages */
+} msg_fmt_options_t;
+
+/** @brief       Formatter Context (for reentrant formatting)
+ *
+ *  @note        A context holds a copy of the formatter options and the
+ *               time-stamp reference of the messages formatted with it.
+ *               Changed options are taken over on the next message.
+ *               Each thread must use its own context.
+ */
+typedef struct msg_formatter_t_ {
+    msg_fmt_options_t option;           /**< formatter options (copy) */
+    msg_timestamp_t laststamp;          /**< time-stamp reference (ZERO, REL) */
+    int first;                          /**< flag: no message formatted so far */
+    struct {                            /**< rendered time prefix (cache): */
+        int64_t second;                 /**<   second it was rendered for */
+        int valid;                      /**<   flag: cache is valid */
+        size_t length;                  /**<   length of the prefix */
+        char prefix[24];                /**<   <hh:mm:ss> or <sec> */
+    } time;
+} msg_formatter_t;
+
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -297,6 +341,32 @@ typedef enum msg_direction_t_ {
 char *msg_format_message(const msg_message_t *message, msg_direction_t direction,
                                msg_counter_t counter, msg_channel_t channel);
 
+/** @brief       initializes a formatter context with the current formatter
+ *               options (see msg_set_fmt_*) and resets its time-stamp reference.
+ *
+ *  @param[out]  formatter - pointer to a formatter context
+ */
+void msg_init_formatter(msg_formatter_t *formatter);
+
+/** @brief       formats a CAN message into a caller-supplied buffer
+ *               (reentrant variant of msg_format_message) with the current
+ *               formatter options (see msg_set_fmt_*).
+ *
+ *  @param[in]   formatter - pointer to a formatter context (see msg_init_formatter)
+ *  @param[in]   message   - pointer to the CAN message to be formatted
+ *  @param[in]   direction - message direction (RX or TX)
+ *  @param[in]   counter   - message counter
+ *  @param[in]   channel   - message source (channel)
+ *  @param[out]  buffer    - buffer for the zero-terminated string
+ *  @param[in]   size      - size of the buffer (in bytes)
+ *
+ *  @returns     length of the string (without terminating zero), or 0 on error.
+ *               The string is truncated if the buffer is too small.
+ */
+size_t msg_format_message_r(msg_formatter_t *formatter, const msg_message_t *message,
+                            msg_direction_t direction, msg_counter_t counter,
+                            msg_channel_t channel, char *buffer, size_t size);
+
 /** @brief       ...
  *
  *  @param[in]   message - ...
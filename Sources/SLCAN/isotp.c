@@ -0,0 +1,654 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'ISO-TP'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        isotp.c
+ *
+ *  @brief       ISO-TP transport protocol (ISO 15765-2) on top of SLCAN.
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @addtogroup  isotp
+ *  @{
+ */
+#ifdef _MSC_VER
+//no Microsoft extensions please!
+#ifndef _CRT_SECURE_NO_WARNINGS
+#define _CRT_SECURE_NO_WARNINGS 1
+#endif
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+#include "isotp.h"
+#include "queue.h"
+#include "buffer.h"
+#include "timer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+#if ((OPTION_SLCAN_DYLIB != 0) || (OPTION_SLCAN_SO != 0))
+#define EXPORT  __attribute__((visibility("default")))
+#else
+#define EXPORT
+#endif
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define PCI_SF  0x00U                   /* Single Frame */
+#define PCI_FF  0x10U                   /* First Frame */
+#define PCI_CF  0x20U                   /* Consecutive Frame */
+#define PCI_FC  0x30U                   /* Flow Control frame */
+
+#define FS_CTS    0x00U                 /* flow status: continue to send */
+#define FS_WAIT   0x01U                 /* flow status: wait */
+#define FS_OVFLW  0x02U                 /* flow status: overflow */
+
+#define MAX_BATCH  64U                  /* max. number of CFs written at once */
+
+#if defined(_WIN32) || defined(_WIN64)
+#define LOCK_INIT(lck)  InitializeCriticalSection(&(lck))
+#define LOCK_DESTROY(lck)  DeleteCriticalSection(&(lck))
+#define ENTER_LOCK(lck)  EnterCriticalSection(&(lck))
+#define LEAVE_LOCK(lck)  LeaveCriticalSection(&(lck))
+#else
+#define LOCK_INIT(lck)  (void)pthread_mutex_init(&(lck), NULL)
+#define LOCK_DESTROY(lck)  (void)pthread_mutex_destroy(&(lck))
+#define ENTER_LOCK(lck)  (void)pthread_mutex_lock(&(lck))
+#define LEAVE_LOCK(lck)  (void)pthread_mutex_unlock(&(lck))
+#endif
+#define DRAIN_DELAY  TIMER_MSEC(1)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+#if defined(_WIN32) || defined(_WIN64)
+typedef CRITICAL_SECTION lock_t;
+#else
+typedef pthread_mutex_t lock_t;
+#endif
+
+typedef struct pdu_t_ {                 /* received PDU (queue element): */
+    uint16_t length;                    /* - length of the PDU */
+    uint8_t data[ISOTP_MAX_PDU];        /* - data of the PDU */
+} pdu_t;
+
+typedef struct channel_t_ {             /* ISO-TP channel: */
+    volatile bool open;                 /* - channel open (reception thread) */
+    isotp_param_t param;                /* - channel parameters */
+    size_t offset;                      /* - offset of the PCI (address byte) */
+    queue_t pdus;                       /* - queue of received PDUs */
+    buffer_t flow;                      /* - received Flow Control frame (sender) */
+    struct receiver_t {                 /* - reception of a segmented PDU: */
+        bool active;                    /*   reception in progress */
+        uint8_t sn;                     /*   expected sequence number */
+        uint8_t count;                  /*   CFs received in the current block */
+        size_t index;                   /*   number of bytes received */
+        timer_obj_t timer;              /*   time-out N_Cr */
+        pdu_t pdu;                      /*   PDU being reassembled */
+    } rx;
+} channel_t;
+
+typedef struct isotp_engine_t_ {        /* ISO-TP engine: */
+    slcan_port_t port;                  /* - SLCAN port */
+    lock_t lock;                        /* - lock of the callers count */
+    size_t callers;                     /* - number of threads in send or receive */
+    bool closing;                       /* - engine being destroyed */
+    channel_t channels[ISOTP_MAX_CHANNELS];
+} isotp_engine_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static bool enter_call(isotp_engine_t *engine);
+static void leave_call(isotp_engine_t *engine);
+static int send_pdu(isotp_engine_t *engine, channel_t *ch, const uint8_t *data, size_t length);
+static bool reception_hook(const slcan_message_t *message, void *param);
+static void receive_frame(isotp_engine_t *engine, channel_t *channel, const slcan_message_t *message);
+static int send_flow_control(isotp_engine_t *engine, channel_t *channel, uint8_t status);
+static int wait_flow_control(channel_t *channel, uint8_t *blockSize, timer_val_t *stMin);
+static void init_frame(const channel_t *channel, slcan_message_t *frame);
+static void pad_frame(const channel_t *channel, slcan_message_t *frame, size_t length);
+static timer_val_t separation_time(uint8_t stMin);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+EXPORT
+isotp_t isotp_create(slcan_port_t port) {
+    isotp_engine_t *engine = (isotp_engine_t*)NULL;
+
+    /* sanity check */
+    errno = 0;
+    if (!port) {
+        errno = ENODEV;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((engine = (isotp_engine_t*)malloc(sizeof(isotp_engine_t))) == NULL)
+        return NULL;
+    (void)memset(engine, 0x00, sizeof(isotp_engine_t));
+    engine->port = port;
+    LOCK_INIT(engine->lock);
+    /* install the engine as reception hook of the port */
+    if (slcan_set_hook(port, reception_hook, (void*)engine) < 0) {
+        /* errno set */
+        LOCK_DESTROY(engine->lock);
+        free(engine);
+        return NULL;
+    }
+    return (isotp_t)engine;
+}
+
+EXPORT
+int isotp_destroy(isotp_t isotp) {
+    isotp_engine_t *engine = (isotp_engine_t*)isotp;
+    int i;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* remove the reception hook */
+    (void)slcan_set_hook(engine->port, NULL, (void*)engine);
+    /* close all channels and refuse new calls */
+    ENTER_LOCK(engine->lock);
+    engine->closing = true;
+    for (i = 0; i < (int)ISOTP_MAX_CHANNELS; i++)
+        engine->channels[i].open = false;
+    /* wake up the waiting senders and receivers until the last one has left */
+    while (engine->callers > 0U) {
+        for (i = 0; i < (int)ISOTP_MAX_CHANNELS; i++) {
+            if (engine->channels[i].pdus)
+                (void)queue_signal(engine->channels[i].pdus);
+            if (engine->channels[i].flow)
+                (void)buffer_signal(engine->channels[i].flow);
+        }
+        LEAVE_LOCK(engine->lock);
+        (void)timer_delay(DRAIN_DELAY);
+        ENTER_LOCK(engine->lock);
+    }
+    LEAVE_LOCK(engine->lock);
+    /* destroy the queues and buffers of all channels */
+    for (i = 0; i < (int)ISOTP_MAX_CHANNELS; i++) {
+        if (engine->channels[i].pdus)
+            (void)queue_destroy(engine->channels[i].pdus);
+        if (engine->channels[i].flow)
+            (void)buffer_destroy(engine->channels[i].flow);
+    }
+    /* C language destructor */
+    LOCK_DESTROY(engine->lock);
+    free(engine);
+    return 0;
+}
+
+EXPORT
+int isotp_open(isotp_t isotp, const isotp_param_t *param) {
+    isotp_engine_t *engine = (isotp_engine_t*)isotp;
+    channel_t *channel = NULL;
+    int i, n = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!param || (param->mode > ISOTP_MIXED) ||
+        ((param->txId & ~CAN_XTD_FRAME) > ((param->txId & CAN_XTD_FRAME) ? CAN_XTD_MASK : CAN_STD_MASK)) ||
+        ((param->rxId & ~CAN_XTD_FRAME) > ((param->rxId & CAN_XTD_FRAME) ? CAN_XTD_MASK : CAN_STD_MASK))) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* find a free channel (the receive address must be unique) */
+    for (i = 0; i < (int)ISOTP_MAX_CHANNELS; i++) {
+        if (engine->channels[i].open) {
+            if ((engine->channels[i].param.rxId == param->rxId) &&
+                ((param->mode == ISOTP_NORMAL) || (engine->channels[i].param.mode == ISOTP_NORMAL) ||
+                 (engine->channels[i].param.rxAddr == param->rxAddr))) {
+                errno = EEXIST;
+                return -1;
+            }
+        }
+        else if (n < 0)
+            n = i;
+    }
+    if (n < 0) {
+        errno = ENOSPC;
+        return -1;
+    }
+    channel = &engine->channels[n];
+    /* create the queue and the buffer on first use (they are kept when closed) */
+    if (!channel->pdus && ((channel->pdus = queue_create(ISOTP_QUEUE_SIZE, sizeof(pdu_t))) == NULL))
+        return -1;
+    if (!channel->flow && ((channel->flow = buffer_create(CAN_LEN_MAX)) == NULL))
+        return -1;
+    (void)queue_clear(channel->pdus);
+    (void)buffer_clear(channel->flow);
+    channel->param = *param;
+    if (!channel->param.timeout)
+        channel->param.timeout = ISOTP_TIMEOUT;
+    channel->offset = (param->mode != ISOTP_NORMAL) ? 1U : 0U;
+    channel->rx.active = false;
+    /* note: the reception thread takes the channel from now on */
+    channel->open = true;
+    return n;
+}
+
+EXPORT
+int isotp_close(isotp_t isotp, int channel) {
+    isotp_engine_t *engine = (isotp_engine_t*)isotp;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if ((channel < 0) || (channel >= (int)ISOTP_MAX_CHANNELS) || !engine->channels[channel].open) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* release the channel (a waiting sender or receiver is woken up) */
+    engine->channels[channel].open = false;
+    (void)buffer_signal(engine->channels[channel].flow);
+    (void)queue_signal(engine->channels[channel].pdus);
+    return 0;
+}
+
+EXPORT
+int isotp_send(isotp_t isotp, int channel, const uint8_t *data, size_t length) {
+    isotp_engine_t *engine = (isotp_engine_t*)isotp;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if ((channel < 0) || (channel >= (int)ISOTP_MAX_CHANNELS) || !engine->channels[channel].open ||
+        !data || !length || (length > ISOTP_MAX_PDU)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* the channel is not destroyed as long as there are callers */
+    if (!enter_call(engine)) {
+        errno = EINVAL;
+        return -1;
+    }
+    res = send_pdu(engine, &engine->channels[channel], data, length);
+    leave_call(engine);
+    return res;
+}
+
+EXPORT
+int isotp_receive(isotp_t isotp, int channel, uint8_t *buffer, size_t size, uint16_t timeout) {
+    isotp_engine_t *engine = (isotp_engine_t*)isotp;
+    pdu_t *pdu;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if ((channel < 0) || (channel >= (int)ISOTP_MAX_CHANNELS) || !engine->channels[channel].open ||
+        !buffer || !size) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((pdu = (pdu_t*)malloc(sizeof(pdu_t))) == NULL)
+        return -1;
+    /* the channel is not destroyed as long as there are callers */
+    if (!enter_call(engine)) {
+        free(pdu);
+        errno = EINVAL;
+        return -1;
+    }
+    /* get the next received PDU from the queue, if any */
+    res = queue_dequeue(engine->channels[channel].pdus, (void*)pdu, sizeof(pdu_t), timeout);
+    leave_call(engine);
+    if (res > 0) {
+        if ((size_t)pdu->length <= size) {
+            res = (int)pdu->length;
+            memcpy(buffer, pdu->data, (size_t)res);
+        } else {
+            /* buffer too small: the PDU is discarded (not truncated) */
+            errno = EMSGSIZE;
+            res = -1;
+        }
+    }
+    else if (res == 0) {
+        errno = ENOMSG;
+        res = -30;
+    }
+    free(pdu);
+    return res;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static bool enter_call(isotp_engine_t *engine) {
+    bool res = false;
+
+    ENTER_LOCK(engine->lock);
+    if (!engine->closing) {
+        engine->callers += 1U;
+        res = true;
+    }
+    LEAVE_LOCK(engine->lock);
+    return res;
+}
+
+static void leave_call(isotp_engine_t *engine) {
+    ENTER_LOCK(engine->lock);
+    engine->callers -= 1U;
+    LEAVE_LOCK(engine->lock);
+}
+
+static int send_pdu(isotp_engine_t *engine, channel_t *ch, const uint8_t *data, size_t length) {
+    slcan_message_t frames[MAX_BATCH];
+    size_t index, offset, chunk, n;
+    uint8_t blockSize, sn = 1U;
+    timer_val_t stMin;
+    timer_obj_t timer = 0U;
+    unsigned int cf;
+
+    offset = ch->offset;
+    /* (1) Single Frame: PDU of up to 7 bytes (6 with address byte) */
+    if (length <= (CAN_LEN_MAX - 1U - offset)) {
+        init_frame(ch, &frames[0]);
+        frames[0].data[offset] = (uint8_t)(PCI_SF | length);
+        memcpy(&frames[0].data[offset + 1U], data, length);
+        pad_frame(ch, &frames[0], offset + 1U + length);
+        return (slcan_write_messages(engine->port, frames, 1U) == 1) ? 0 : -1;
+    }
+    /* (2) First Frame: PDU length and the first 6 bytes (5 with address byte) */
+    (void)buffer_clear(ch->flow);
+    init_frame(ch, &frames[0]);
+    frames[0].data[offset] = (uint8_t)(PCI_FF | ((length >> 8) & 0x0FU));
+    frames[0].data[offset + 1U] = (uint8_t)(length & 0xFFU);
+    index = CAN_LEN_MAX - 2U - offset;
+    memcpy(&frames[0].data[offset + 2U], data, index);
+    frames[0].can_dlc = (uint8_t)CAN_LEN_MAX;
+    if (slcan_write_messages(engine->port, frames, 1U) != 1)
+        return -1;
+    /* (3) Consecutive Frames: block by block, as requested by the receiver */
+    while (index < length) {
+        if (wait_flow_control(ch, &blockSize, &stMin) < 0)
+            return -1;
+        cf = 0U;
+        while ((index < length) && (!blockSize || (cf < blockSize))) {
+            /* note: without separation time a block is written in batches,
+             *       otherwise each CF is paced by an absolute deadline */
+            for (n = 0U; (n < MAX_BATCH) && (index < length) && (!blockSize || (cf < blockSize)); n++, cf++) {
+                init_frame(ch, &frames[n]);
+                frames[n].data[offset] = (uint8_t)(PCI_CF | sn);
+                chunk = CAN_LEN_MAX - 1U - offset;
+                if (chunk > (length - index))
+                    chunk = length - index;
+                memcpy(&frames[n].data[offset + 1U], &data[index], chunk);
+                pad_frame(ch, &frames[n], offset + 1U + chunk);
+                index += chunk;
+                sn = (sn + 1U) & 0x0FU;
+                if (stMin) {
+                    n++; cf++;
+                    break;
+                }
+            }
+            if (stMin) {
+                (void)timer_wait(&timer);
+                (void)timer_advance(&timer, stMin);
+            }
+            if (slcan_write_messages(engine->port, frames, n) != (int)n) {
+                if (!errno)
+                    errno = EBUSY;
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static bool reception_hook(const slcan_message_t *message, void *param) {
+    isotp_engine_t *engine = (isotp_engine_t*)param;
+    channel_t *channel;
+    int i;
+
+    assert(engine);
+    assert(message);
+
+    if (message->can_id & (CAN_RTR_FRAME | CAN_ERR_FRAME))
+        return false;
+    /* find the channel of the message (by identifier and address byte) */
+    for (i = 0; i < (int)ISOTP_MAX_CHANNELS; i++) {
+        channel = &engine->channels[i];
+        if (!channel->open || (channel->param.rxId != message->can_id))
+            continue;
+        if (channel->offset && ((message->can_dlc < 1U) || (message->data[0] != channel->param.rxAddr)))
+            continue;
+        /* note: the frame is consumed, even if it is invalid */
+        receive_frame(engine, channel, message);
+        return true;
+    }
+    return false;
+}
+
+static void receive_frame(isotp_engine_t *engine, channel_t *channel, const slcan_message_t *message) {
+    struct receiver_t *rx = &channel->rx;
+    size_t offset = channel->offset;
+    size_t dlc = (message->can_dlc < CAN_LEN_MAX) ? message->can_dlc : CAN_LEN_MAX;
+    size_t length, chunk;
+
+    if (dlc <= offset)
+        return;
+    switch (message->data[offset] & 0xF0U) {
+    case PCI_SF:  /* Single Frame: the PDU is complete (a reception in progress is aborted) */
+        length = message->data[offset] & 0x0FU;
+        if (!length || ((offset + 1U + length) > dlc))
+            return;
+        rx->active = false;
+        rx->pdu.length = (uint16_t)length;
+        memcpy(rx->pdu.data, &message->data[offset + 1U], length);
+        (void)queue_enqueue(channel->pdus, &rx->pdu, offsetof(pdu_t, data) + length);
+        break;
+    case PCI_FF:  /* First Frame: start of a segmented PDU, answered by a Flow Control frame */
+        if (dlc < CAN_LEN_MAX)
+            return;
+        length = ((size_t)(message->data[offset] & 0x0FU) << 8) | (size_t)message->data[offset + 1U];
+        if (length <= (CAN_LEN_MAX - 1U - offset))
+            return;
+        rx->active = true;
+        rx->pdu.length = (uint16_t)length;
+        rx->index = CAN_LEN_MAX - 2U - offset;
+        memcpy(rx->pdu.data, &message->data[offset + 2U], rx->index);
+        rx->sn = 1U;
+        rx->count = 0U;
+        (void)send_flow_control(engine, channel, FS_CTS);
+        break;
+    case PCI_CF:  /* Consecutive Frame: next segment, a Flow Control frame after each block */
+        if (!rx->active)
+            return;
+        if (((message->data[offset] & 0x0FU) != rx->sn) || timer_timeout(&rx->timer)) {
+            rx->active = false;  /* wrong sequence number or time-out N_Cr */
+            return;
+        }
+        chunk = (size_t)rx->pdu.length - rx->index;
+        if (chunk > (dlc - offset - 1U))
+            chunk = dlc - offset - 1U;
+        memcpy(&rx->pdu.data[rx->index], &message->data[offset + 1U], chunk);
+        rx->index += chunk;
+        rx->sn = (rx->sn + 1U) & 0x0FU;
+        if (rx->index >= (size_t)rx->pdu.length) {
+            rx->active = false;
+            (void)queue_enqueue(channel->pdus, &rx->pdu, offsetof(pdu_t, data) + (size_t)rx->pdu.length);
+        }
+        else if (channel->param.blockSize && (++rx->count >= channel->param.blockSize)) {
+            rx->count = 0U;
+            (void)send_flow_control(engine, channel, FS_CTS);
+        }
+        else
+            (void)timer_restart(&rx->timer, TIMER_MSEC(channel->param.timeout));
+        break;
+    case PCI_FC:  /* Flow Control frame: handed over to the sender */
+        if (dlc < (offset + 3U))
+            return;
+        (void)buffer_put(channel->flow, &message->data[offset], 3U);
+        break;
+    default:
+        break;
+    }
+}
+
+static int send_flow_control(isotp_engine_t *engine, channel_t *channel, uint8_t status) {
+    slcan_message_t frame;
+
+    init_frame(channel, &frame);
+    frame.data[channel->offset + 0U] = (uint8_t)(PCI_FC | status);
+    frame.data[channel->offset + 1U] = channel->param.blockSize;
+    frame.data[channel->offset + 2U] = channel->param.stMin;
+    pad_frame(channel, &frame, channel->offset + 3U);
+    (void)timer_restart(&channel->rx.timer, TIMER_MSEC(channel->param.timeout));
+    return slcan_write_messages(engine->port, &frame, 1U);
+}
+
+static int wait_flow_control(channel_t *channel, uint8_t *blockSize, timer_val_t *stMin) {
+    uint8_t flow[CAN_LEN_MAX];
+    int waits = 0;
+
+    /* wait for a Flow Control frame (time-out N_Bs), FC.WAIT restarts the time-out */
+    for (;;) {
+        if (buffer_get(channel->flow, flow, sizeof(flow), channel->param.timeout) < 3) {
+            if (!channel->open)
+                errno = EINVAL;
+            else
+                errno = ETIMEDOUT;
+            return -1;
+        }
+        switch (flow[0] & 0x0FU) {
+        case FS_CTS:
+            *blockSize = flow[1];
+            *stMin = separation_time(flow[2]);
+            return 0;
+        case FS_WAIT:
+            if (++waits <= (int)ISOTP_MAX_WAIT)
+                continue;
+            errno = EBADMSG;
+            return -1;
+        case FS_OVFLW:
+            errno = EMSGSIZE;
+            return -1;
+        default:
+            errno = EBADMSG;
+            return -1;
+        }
+    }
+}
+
+static void init_frame(const channel_t *channel, slcan_message_t *frame) {
+    (void)memset(frame, 0x00, sizeof(slcan_message_t));
+    frame->can_id = channel->param.txId;
+    if (channel->offset)
+        frame->data[0] = channel->param.txAddr;
+}
+
+static void pad_frame(const channel_t *channel, slcan_message_t *frame, size_t length) {
+    size_t i;
+
+    if (channel->param.padding) {
+        for (i = length; i < CAN_LEN_MAX; i++)
+            frame->data[i] = channel->param.padByte;
+        frame->can_dlc = (uint8_t)CAN_LEN_MAX;
+    } else
+        frame->can_dlc = (uint8_t)length;
+}
+
+static timer_val_t separation_time(uint8_t stMin) {
+    /* STmin: 0x00..0x7F = 0..127 ms, 0xF1..0xF9 = 100..900 us, reserved = 127 ms */
+    if (stMin <= 0x7FU)
+        return TIMER_MSEC(stMin);
+    if ((0xF1U <= stMin) && (stMin <= 0xF9U))
+        return TIMER_USEC((timer_val_t)(stMin - 0xF0U) * 100U);
+    return TIMER_MSEC(0x7FU);
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,271 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'ISO-TP'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        isotp.h
+ *
+ *  @brief       ISO-TP transport protocol (ISO 15765-2) on top of SLCAN.
+ *
+ *  @remarks     The protocol engine is driven by the reception thread of the
+ *               SLCAN port (reception hook): it reassembles the received PDUs
+ *               and answers First Frames and blocks of Consecutive Frames with
+ *               Flow Control frames without application latency. The sender
+ *               transmits the Consecutive Frames of a block by batched serial
+ *               writes when STmin is zero, otherwise it paces them with
+ *               absolute deadlines.
+ *
+ *  @remarks     Classical CAN only (8 data bytes), PDUs of up to 4095 bytes.
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @defgroup    isotp ISO-TP Transport Protocol
+ *  @{
+ */
+#ifndef ISOTP_H_INCLUDED
+#define ISOTP_H_INCLUDED
+
+#include "slcan.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Addressing Modes
+ *  @brief ISO-TP addressing formats
+ *  @{ */
+#define ISOTP_NORMAL        0U          /**< normal addressing (identifier only) */
+#define ISOTP_EXTENDED      1U          /**< extended addressing (target address in data[0]) */
+#define ISOTP_MIXED         2U          /**< mixed addressing (address extension in data[0]) */
+/** @} */
+
+#define ISOTP_MAX_PDU       4095U       /**< max. length of a PDU (classical CAN) */
+#define ISOTP_MAX_CHANNELS  8U          /**< max. number of channels per SLCAN port */
+#define ISOTP_QUEUE_SIZE    4U          /**< number of received PDUs queued per channel */
+#define ISOTP_TIMEOUT       1000U       /**< default time-out N_Bs and N_Cr (in [ms]) */
+#define ISOTP_MAX_WAIT      16U         /**< max. number of FC.WAIT frames (N_WFTmax) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *isotp_t;                  /**< ISO-TP engine (opaque data type) */
+
+/** @brief  ISO-TP channel parameters
+ */
+typedef struct isotp_param_t_ {         /* ISO-TP channel: */
+    uint32_t txId;                      /**< identifier of transmitted frames (incl. CAN_XTD_FRAME) */
+    uint32_t rxId;                      /**< identifier of received frames (incl. CAN_XTD_FRAME) */
+    uint8_t mode;                       /**< addressing mode (ISOTP_NORMAL, _EXTENDED or _MIXED) */
+    uint8_t txAddr;                     /**< address in data[0] of transmitted frames (extended/mixed) */
+    uint8_t rxAddr;                     /**< address in data[0] of received frames (extended/mixed) */
+    uint8_t blockSize;                  /**< block size (BS) of the own Flow Control frames */
+    uint8_t stMin;                      /**< separation time (STmin) of the own Flow Control frames */
+    bool padding;                       /**< frames are padded to 8 bytes with 'padByte' */
+    uint8_t padByte;                    /**< padding byte (e.g. 0xCC) */
+    uint16_t timeout;                   /**< time-out N_Bs and N_Cr (in [ms], 0 = default) */
+} isotp_param_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       creates an ISO-TP engine for a SLCAN port and installs it as
+ *               reception hook of the port (constructor).
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *
+ *  @returns     a pointer to an ISO-TP engine if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EBUSY   - the port has already a reception hook
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI isotp_t isotp_create(slcan_port_t port);
+
+
+/** @brief       removes the reception hook and destroys the ISO-TP engine
+ *               (destructor).
+ *
+ *  @remarks     The SLCAN port shall be disconnected before (no reception).
+ *  @remarks     Threads waiting in isotp_send or isotp_receive are woken up,
+ *               the engine is destroyed after they have left.
+ *
+ *  @param[in]   isotp  - pointer to an ISO-TP engine
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ */
+SLCANAPI int isotp_destroy(isotp_t isotp);
+
+
+/** @brief       opens an ISO-TP channel with the given identifiers and
+ *               addressing mode.
+ *
+ *  @remarks     Received frames of an open channel are consumed by the engine
+ *               (they are not put into the message queue of the port).
+ *
+ *  @param[in]   isotp  - pointer to an ISO-TP engine
+ *  @param[in]   param  - pointer to the channel parameters
+ *
+ *  @returns     the channel number (0..ISOTP_MAX_CHANNELS-1) if successful, or
+ *               a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ *  @retval      EINVAL  - invalid argument (param)
+ *  @retval      EEXIST  - a channel with this receive address is already open
+ *  @retval      ENOSPC  - no space left (ISOTP_MAX_CHANNELS reached)
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI int isotp_open(isotp_t isotp, const isotp_param_t *param);
+
+
+/** @brief       closes an ISO-TP channel.
+ *
+ *  @remarks     A PDU being received is discarded, the received PDUs in the
+ *               queue of the channel are dropped.
+ *
+ *  @param[in]   isotp    - pointer to an ISO-TP engine
+ *  @param[in]   channel  - channel number
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ *  @retval      EINVAL  - invalid argument (channel)
+ */
+SLCANAPI int isotp_close(isotp_t isotp, int channel);
+
+
+/** @brief       sends a PDU over an ISO-TP channel (blocking).
+ *
+ *  @remarks     A PDU of up to 7 (6) bytes is sent as Single Frame, a longer
+ *               one is segmented into a First Frame and Consecutive Frames,
+ *               paced by the Flow Control frames of the receiver.
+ *
+ *  @remarks     Only one PDU at a time shall be sent over a channel.
+ *
+ *  @param[in]   isotp    - pointer to an ISO-TP engine
+ *  @param[in]   channel  - channel number
+ *  @param[in]   data     - pointer to the PDU
+ *  @param[in]   length   - length of the PDU (1..ISOTP_MAX_PDU)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT     - bad address (invalid engine instance)
+ *  @retval      EINVAL     - invalid argument (channel, data or length)
+ *  @retval      ETIMEDOUT  - timed out (N_Bs, no Flow Control frame)
+ *  @retval      EMSGSIZE   - PDU too long for the receiver (FC.OVFLW)
+ *  @retval      EBADMSG    - invalid Flow Control frame (or too many FC.WAIT)
+ *  @retval      EBUSY      - device / resource busy (disturbance)
+ */
+SLCANAPI int isotp_send(isotp_t isotp, int channel, const uint8_t *data, size_t length);
+
+
+/** @brief       receives a PDU from an ISO-TP channel, if any.
+ *
+ *  @param[in]   isotp    - pointer to an ISO-TP engine
+ *  @param[in]   channel  - channel number
+ *  @param[out]  buffer   - pointer to a buffer for the PDU
+ *  @param[in]   size     - size of the buffer (a longer PDU is discarded)
+ *  @param[in]   timeout  - time to wait for the reception of a PDU:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait in milliseconds
+ *
+ *  @returns     the length of the PDU if successful, or a negative value on
+ *               error.
+ *
+ *  @retval      -30  - when no PDU has been received (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ *  @retval      EINVAL  - invalid argument (channel, buffer or size)
+ *  @retval      ENOMSG  - no data available (queue empty)
+ *  @retval      ENOSPC  - no space left (PDUs lost in front of this PDU)
+ *  @retval      EMSGSIZE - message too long (the PDU does not fit into the buffer)
+ */
+SLCANAPI int isotp_receive(isotp_t isotp, int channel, uint8_t *buffer, size_t size, uint16_t timeout);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ISOTP_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
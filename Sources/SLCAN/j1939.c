@@ -0,0 +1,693 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'J1939'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        j1939.c
+ *
+ *  @brief       SAE J1939 transport protocol (BAM/CMDT) on top of SLCAN.
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @addtogroup  j1939
+ *  @{
+ */
+#ifdef _MSC_VER
+//no Microsoft extensions please!
+#ifndef _CRT_SECURE_NO_WARNINGS
+#define _CRT_SECURE_NO_WARNINGS 1
+#endif
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+#include "j1939.h"
+#include "queue.h"
+#include "timer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+#if ((OPTION_SLCAN_DYLIB != 0) || (OPTION_SLCAN_SO != 0))
+#define EXPORT  __attribute__((visibility("default")))
+#else
+#define EXPORT
+#endif
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define TP_RTS    16U                   /* Request To Send */
+#define TP_CTS    17U                   /* Clear To Send */
+#define TP_EOMA   19U                   /* End of Message Acknowledge */
+#define TP_BAM    32U                   /* Broadcast Announce Message */
+#define TP_ABORT  255U                  /* Connection Abort */
+
+#define ABORT_RESOURCES  2U             /* abort reason: lack of resources */
+
+#define SESSION_FREE  0U                /* session not in use */
+#define SESSION_BAM   1U                /* broadcast session (BAM) */
+#define SESSION_CMDT  2U                /* connection mode session (RTS/CTS) */
+
+#define NUM_SLOTS  0x10000U             /* lookup table: source address x destination address */
+#define KEY(src,dst)  (uint16_t)(((uint16_t)(src) << 8) | (uint16_t)(dst))
+
+#define CLAIM_IDLE     0                /* no address claimed */
+#define CLAIM_SUCCESS  1                /* address claimed */
+#define CLAIM_LOST     (-1)             /* address lost to a higher priority NAME */
+
+#if defined(_WIN32) || defined(_WIN64)
+#define LOCK_INIT(lck)  InitializeCriticalSection(&(lck))
+#define LOCK_DESTROY(lck)  DeleteCriticalSection(&(lck))
+#define ENTER_LOCK(lck)  EnterCriticalSection(&(lck))
+#define LEAVE_LOCK(lck)  LeaveCriticalSection(&(lck))
+#else
+#define LOCK_INIT(lck)  (void)pthread_mutex_init(&(lck), NULL)
+#define LOCK_DESTROY(lck)  (void)pthread_mutex_destroy(&(lck))
+#define ENTER_LOCK(lck)  (void)pthread_mutex_lock(&(lck))
+#define LEAVE_LOCK(lck)  (void)pthread_mutex_unlock(&(lck))
+#endif
+#define DRAIN_DELAY  TIMER_MSEC(1)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+#if defined(_WIN32) || defined(_WIN64)
+typedef CRITICAL_SECTION lock_t;
+#else
+typedef pthread_mutex_t lock_t;
+#endif
+
+typedef struct session_t_ {             /* transport session: */
+    uint8_t mode;                       /* - BAM or CMDT (or free) */
+    bool responder;                     /* - CMDT to the own address (CTS/EOMA sent) */
+    uint8_t packets;                    /* - number of packets of the PDU */
+    uint8_t next;                       /* - expected sequence number */
+    uint8_t window;                     /* - packets left until the next CTS (responder) */
+    uint8_t maxPerCts;                  /* - max. number of packets per CTS (responder) */
+    uint16_t key;                       /* - key of the lookup table (source, destination) */
+    timer_obj_t timer;                  /* - time-out T1/T2 */
+    j1939_pdu_t pdu;                    /* - PDU being reassembled */
+} session_t;
+
+typedef struct j1939_engine_t_ {        /* J1939 engine: */
+    slcan_port_t port;                  /* - SLCAN port */
+    uint8_t options;                    /* - engine options */
+    queue_t pdus;                       /* - queue of received PDUs */
+    lock_t lock;                        /* - lock of the callers count */
+    size_t callers;                     /* - number of threads in claim or receive */
+    bool closing;                       /* - engine being destroyed */
+    uint16_t *slots;                    /* - lookup table: key -> session index + 1 (0 = none) */
+    session_t *sessions;                /* - pool of sessions */
+    uint16_t *free;                     /* - stack of free sessions */
+    size_t numSessions;                 /* - number of sessions in the pool */
+    size_t numFree;                     /* - number of free sessions */
+    size_t sweep;                       /* - next session to be checked for time-out */
+    volatile uint8_t address;           /* - own address (0xFE = none) */
+    volatile int claim;                 /* - state of the address claim */
+    uint64_t name;                      /* - own NAME */
+    uint64_t completed;                 /* - number of reassembled PDUs */
+    uint64_t aborted;                   /* - number of aborted sessions */
+    uint64_t expired;                   /* - number of sessions timed out */
+} j1939_engine_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static bool enter_call(j1939_engine_t *engine);
+static void leave_call(j1939_engine_t *engine);
+static bool reception_hook(const slcan_message_t *message, void *param);
+static void connection_management(j1939_engine_t *engine, const slcan_message_t *message);
+static void data_transfer(j1939_engine_t *engine, const slcan_message_t *message);
+static void address_claimed(j1939_engine_t *engine, const slcan_message_t *message);
+static void request(j1939_engine_t *engine, const slcan_message_t *message);
+static void single_frame(j1939_engine_t *engine, const slcan_message_t *message);
+static session_t *open_session(j1939_engine_t *engine, uint16_t key);
+static session_t *find_session(j1939_engine_t *engine, uint16_t key);
+static void close_session(j1939_engine_t *engine, session_t *session);
+static void sweep_sessions(j1939_engine_t *engine);
+static int send_frame(j1939_engine_t *engine, uint8_t priority, uint32_t pgn, uint8_t dst, uint8_t src, const uint8_t *data);
+static int send_control(j1939_engine_t *engine, const session_t *session, uint8_t control);
+static int send_claim(j1939_engine_t *engine, uint8_t src);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+EXPORT
+j1939_t j1939_create(slcan_port_t port, const j1939_param_t *param) {
+    j1939_engine_t *engine = (j1939_engine_t*)NULL;
+    size_t sessions = J1939_SESSIONS;
+    size_t queueSize = J1939_QUEUE_SIZE;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!port) {
+        errno = ENODEV;
+        return NULL;
+    }
+    if (param) {
+        if (param->sessions > J1939_MAX_SESSIONS) {
+            errno = EINVAL;
+            return NULL;
+        }
+        sessions = param->sessions ? (size_t)param->sessions : sessions;
+        queueSize = param->queueSize ? (size_t)param->queueSize : queueSize;
+    }
+    /* C language constructor */
+    if ((engine = (j1939_engine_t*)malloc(sizeof(j1939_engine_t))) == NULL)
+        return NULL;
+    (void)memset(engine, 0x00, sizeof(j1939_engine_t));
+    engine->port = port;
+    engine->options = param ? param->options : 0x00U;
+    engine->address = J1939_NULL_ADDR;
+    engine->claim = CLAIM_IDLE;
+    /* lookup table, pool of sessions and queue of PDUs */
+    if (((engine->slots = (uint16_t*)calloc(NUM_SLOTS, sizeof(uint16_t))) == NULL) ||
+        ((engine->sessions = (session_t*)calloc(sessions, sizeof(session_t))) == NULL) ||
+        ((engine->free = (uint16_t*)calloc(sessions, sizeof(uint16_t))) == NULL) ||
+        ((engine->pdus = queue_create(queueSize, sizeof(j1939_pdu_t))) == NULL))
+        goto err_create;
+    for (i = 0U; i < sessions; i++)
+        engine->free[i] = (uint16_t)(sessions - 1U - i);
+    engine->numSessions = engine->numFree = sessions;
+    LOCK_INIT(engine->lock);
+    /* install the engine as reception hook of the port */
+    if (slcan_set_hook(port, reception_hook, (void*)engine) < 0) {
+        LOCK_DESTROY(engine->lock);
+        goto err_create;
+    }
+    return (j1939_t)engine;
+err_create:
+    /* errno set */
+    if (engine->pdus)
+        (void)queue_destroy(engine->pdus);
+    free(engine->free);
+    free(engine->sessions);
+    free(engine->slots);
+    free(engine);
+    return NULL;
+}
+
+EXPORT
+int j1939_destroy(j1939_t j1939) {
+    j1939_engine_t *engine = (j1939_engine_t*)j1939;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* remove the reception hook */
+    (void)slcan_set_hook(engine->port, NULL, (void*)engine);
+    /* refuse new calls and wake up the receivers until the last one has left */
+    ENTER_LOCK(engine->lock);
+    engine->closing = true;
+    while (engine->callers > 0U) {
+        (void)queue_signal(engine->pdus);
+        LEAVE_LOCK(engine->lock);
+        (void)timer_delay(DRAIN_DELAY);
+        ENTER_LOCK(engine->lock);
+    }
+    LEAVE_LOCK(engine->lock);
+    /* C language destructor */
+    LOCK_DESTROY(engine->lock);
+    (void)queue_destroy(engine->pdus);
+    free(engine->free);
+    free(engine->sessions);
+    free(engine->slots);
+    free(engine);
+    return 0;
+}
+
+EXPORT
+int j1939_claim(j1939_t j1939, uint8_t address, uint64_t name) {
+    j1939_engine_t *engine = (j1939_engine_t*)j1939;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (address == J1939_GLOBAL_ADDR) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* release the own address */
+    if (address == J1939_NULL_ADDR) {
+        engine->address = J1939_NULL_ADDR;
+        engine->claim = CLAIM_IDLE;
+        return 0;
+    }
+    /* the engine is not destroyed as long as there are callers */
+    if (!enter_call(engine)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* send the Address Claimed message and wait for contending claims */
+    engine->name = name;
+    engine->claim = CLAIM_SUCCESS;
+    engine->address = address;
+    if (send_claim(engine, address) < 0) {
+        engine->address = J1939_NULL_ADDR;
+        engine->claim = CLAIM_IDLE;
+        leave_call(engine);
+        errno = EBUSY;
+        return -1;
+    }
+    (void)timer_delay(TIMER_MSEC(J1939_CLAIM_TIME));
+    /* note: the reception thread releases the address when the claim is lost */
+    res = (engine->claim == CLAIM_SUCCESS) ? 0 : -1;
+    leave_call(engine);
+    if (res < 0)
+        errno = EADDRINUSE;
+    return res;
+}
+
+EXPORT
+int j1939_receive(j1939_t j1939, j1939_pdu_t *pdu, uint16_t timeout) {
+    j1939_engine_t *engine = (j1939_engine_t*)j1939;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!pdu) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* the queue is not destroyed as long as there are callers */
+    if (!enter_call(engine)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* get the next received PDU from the queue, if any */
+    res = queue_dequeue(engine->pdus, (void*)pdu, sizeof(j1939_pdu_t), timeout);
+    leave_call(engine);
+    if (res > 0)
+        res = (int)pdu->length;
+    else if (res == 0) {
+        errno = ENOMSG;
+        res = -30;
+    }
+    return res;
+}
+
+EXPORT
+int j1939_status(j1939_t j1939, j1939_status_t *status) {
+    j1939_engine_t *engine = (j1939_engine_t*)j1939;
+
+    /* sanity check */
+    errno = 0;
+    if (!engine) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!status) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: the counters are updated by the reception thread */
+    status->address = engine->address;
+    status->active = (uint32_t)(engine->numSessions - engine->numFree);
+    status->completed = engine->completed;
+    status->aborted = engine->aborted;
+    status->expired = engine->expired;
+    return 0;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static bool enter_call(j1939_engine_t *engine) {
+    bool res = false;
+
+    ENTER_LOCK(engine->lock);
+    if (!engine->closing) {
+        engine->callers += 1U;
+        res = true;
+    }
+    LEAVE_LOCK(engine->lock);
+    return res;
+}
+
+static void leave_call(j1939_engine_t *engine) {
+    ENTER_LOCK(engine->lock);
+    engine->callers -= 1U;
+    LEAVE_LOCK(engine->lock);
+}
+
+static bool reception_hook(const slcan_message_t *message, void *param) {
+    j1939_engine_t *engine = (j1939_engine_t*)param;
+
+    assert(engine);
+    assert(message);
+
+    if (!(message->can_id & CAN_XTD_FRAME) || (message->can_id & (CAN_RTR_FRAME | CAN_ERR_FRAME)))
+        return false;
+    /* expire one stale session per frame (constant work) */
+    sweep_sessions(engine);
+    switch (J1939_PGN(message->can_id & CAN_XTD_MASK)) {
+    case J1939_PGN_TP_CM:
+        connection_management(engine, message);
+        return (engine->options & J1939_CONSUME_FRAMES) ? true : false;
+    case J1939_PGN_TP_DT:
+        data_transfer(engine, message);
+        return (engine->options & J1939_CONSUME_FRAMES) ? true : false;
+    case J1939_PGN_ADDR_CLAIM:
+        address_claimed(engine, message);
+        break;
+    case J1939_PGN_REQUEST:
+        request(engine, message);
+        break;
+    default:
+        if (engine->options & J1939_SINGLE_FRAMES)
+            single_frame(engine, message);
+        break;
+    }
+    return false;
+}
+
+static void connection_management(j1939_engine_t *engine, const slcan_message_t *message) {
+    uint32_t id = message->can_id & CAN_XTD_MASK;
+    uint8_t src = J1939_SOURCE(id);
+    uint8_t dst = J1939_DESTINATION(id);
+    const uint8_t *data = message->data;
+    session_t *session;
+    size_t length;
+
+    if (message->can_dlc < CAN_LEN_MAX)
+        return;
+    switch (data[0]) {
+    case TP_RTS:  /* Request To Send: start of a connection mode session */
+    case TP_BAM:  /* Broadcast Announce Message: start of a broadcast session */
+        if ((data[0] == TP_RTS) == (dst == J1939_GLOBAL_ADDR))
+            return;
+        length = (size_t)data[1] | ((size_t)data[2] << 8);
+        if ((length <= CAN_LEN_MAX) || (length > J1939_MAX_PDU) || (data[3] != (uint8_t)((length + 6U) / 7U)))
+            return;
+        /* note: a new announcement replaces a running session of the same nodes */
+        if ((session = find_session(engine, KEY(src, dst))) != NULL) {
+            engine->aborted++;
+            close_session(engine, session);
+        }
+        if ((session = open_session(engine, KEY(src, dst))) == NULL) {
+            engine->aborted++;
+            if ((data[0] == TP_RTS) && (dst == engine->address)) {
+                uint8_t abort[CAN_LEN_MAX] = { TP_ABORT, ABORT_RESOURCES, 0xFF, 0xFF, 0xFF, data[5], data[6], data[7] };
+                (void)send_frame(engine, 7U, J1939_PGN_TP_CM, src, dst, abort);
+            }
+            return;
+        }
+        session->mode = (data[0] == TP_RTS) ? SESSION_CMDT : SESSION_BAM;
+        session->packets = data[3];
+        session->next = 1U;
+        session->pdu.pgn = (uint32_t)data[5] | ((uint32_t)data[6] << 8) | ((uint32_t)data[7] << 16);
+        session->pdu.src = src;
+        session->pdu.dst = dst;
+        session->pdu.priority = J1939_PRIORITY(id);
+        session->pdu.length = (uint16_t)length;
+        session->responder = (data[0] == TP_RTS) && (dst == engine->address);
+        (void)timer_restart(&session->timer, TIMER_MSEC((session->mode == SESSION_BAM) ? J1939_T1 : J1939_T2));
+        if (session->responder) {
+            session->maxPerCts = data[4] ? data[4] : 0xFFU;
+            session->window = (session->packets < session->maxPerCts) ? session->packets : session->maxPerCts;
+            (void)send_control(engine, session, TP_CTS);
+        }
+        break;
+    case TP_CTS:  /* Clear To Send: sent by the receiver (next packet may be a retransmission) */
+        if ((session = find_session(engine, KEY(dst, src))) != NULL) {
+            if (data[1] && data[2] && (data[2] <= session->packets))
+                session->next = data[2];
+            (void)timer_restart(&session->timer, TIMER_MSEC(J1939_T2));
+        }
+        break;
+    case TP_EOMA: /* End of Message Acknowledge: the receiver got the PDU (missed frames here) */
+        if ((session = find_session(engine, KEY(dst, src))) != NULL) {
+            engine->aborted++;
+            close_session(engine, session);
+        }
+        break;
+    case TP_ABORT:  /* Connection Abort: sent by the originator or by the receiver */
+        if (((session = find_session(engine, KEY(src, dst))) != NULL) ||
+            ((session = find_session(engine, KEY(dst, src))) != NULL)) {
+            engine->aborted++;
+            close_session(engine, session);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void data_transfer(j1939_engine_t *engine, const slcan_message_t *message) {
+    uint32_t id = message->can_id & CAN_XTD_MASK;
+    session_t *session;
+    size_t offset, chunk;
+
+    if ((message->can_dlc < CAN_LEN_MAX) ||
+        ((session = find_session(engine, KEY(J1939_SOURCE(id), J1939_DESTINATION(id)))) == NULL))
+        return;
+    /* time-out T1 or wrong sequence number: the session is aborted */
+    if (timer_timeout(&session->timer)) {
+        engine->expired++;
+        close_session(engine, session);
+        return;
+    }
+    if (message->data[0] != session->next) {
+        engine->aborted++;
+        close_session(engine, session);
+        return;
+    }
+    offset = (size_t)(session->next - 1U) * 7U;
+    chunk = (size_t)session->pdu.length - offset;
+    if (chunk > 7U)
+        chunk = 7U;
+    memcpy(&session->pdu.data[offset], &message->data[1], chunk);
+    /* last packet: the PDU is complete */
+    if (session->next++ == session->packets) {
+        (void)queue_enqueue(engine->pdus, &session->pdu, offsetof(j1939_pdu_t, data) + (size_t)session->pdu.length);
+        if (session->responder)
+            (void)send_control(engine, session, TP_EOMA);
+        engine->completed++;
+        close_session(engine, session);
+        return;
+    }
+    (void)timer_restart(&session->timer, TIMER_MSEC(J1939_T1));
+    /* end of a block: the responder clears the next packets */
+    if (session->responder && (--session->window == 0U)) {
+        uint8_t left = (uint8_t)(session->packets - session->next + 1U);
+        session->window = (left < session->maxPerCts) ? left : session->maxPerCts;
+        (void)send_control(engine, session, TP_CTS);
+    }
+}
+
+static void address_claimed(j1939_engine_t *engine, const slcan_message_t *message) {
+    uint8_t address = engine->address;
+    uint64_t name = 0U;
+    int i;
+
+    if ((address == J1939_NULL_ADDR) || (J1939_SOURCE(message->can_id) != address) || (message->can_dlc < CAN_LEN_MAX))
+        return;
+    /* contending claim: the NAME with the lower value wins */
+    for (i = (int)CAN_LEN_MAX - 1; i >= 0; i--)
+        name = (name << 8) | (uint64_t)message->data[i];
+    if (engine->name < name)
+        (void)send_claim(engine, address);
+    else {
+        engine->address = J1939_NULL_ADDR;
+        engine->claim = CLAIM_LOST;
+        (void)send_claim(engine, J1939_NULL_ADDR);
+    }
+}
+
+static void request(j1939_engine_t *engine, const slcan_message_t *message) {
+    uint8_t dst = J1939_DESTINATION(message->can_id & CAN_XTD_MASK);
+    uint8_t address = engine->address;
+
+    if ((message->can_dlc < 3U) || (message->data[0] != 0x00U) ||
+        (message->data[1] != 0xEEU) || (message->data[2] != 0x00U))
+        return;
+    /* Request for Address Claimed: answered with the own claim (or Cannot Claim) */
+    if ((address != J1939_NULL_ADDR) && ((dst == J1939_GLOBAL_ADDR) || (dst == address)))
+        (void)send_claim(engine, address);
+    else if ((engine->claim == CLAIM_LOST) && (dst == J1939_GLOBAL_ADDR))
+        (void)send_claim(engine, J1939_NULL_ADDR);
+}
+
+static void single_frame(j1939_engine_t *engine, const slcan_message_t *message) {
+    uint32_t id = message->can_id & CAN_XTD_MASK;
+    j1939_pdu_t pdu;
+
+    pdu.pgn = J1939_PGN(id);
+    pdu.src = J1939_SOURCE(id);
+    pdu.dst = J1939_DESTINATION(id);
+    pdu.priority = J1939_PRIORITY(id);
+    pdu.length = (uint16_t)((message->can_dlc < CAN_LEN_MAX) ? message->can_dlc : CAN_LEN_MAX);
+    memcpy(pdu.data, message->data, (size_t)pdu.length);
+    (void)queue_enqueue(engine->pdus, &pdu, offsetof(j1939_pdu_t, data) + (size_t)pdu.length);
+}
+
+static session_t *open_session(j1939_engine_t *engine, uint16_t key) {
+    session_t *session;
+    uint16_t index;
+
+    if (!engine->numFree)
+        return NULL;
+    index = engine->free[--engine->numFree];
+    session = &engine->sessions[index];
+    session->key = key;
+    engine->slots[key] = (uint16_t)(index + 1U);
+    return session;
+}
+
+static session_t *find_session(j1939_engine_t *engine, uint16_t key) {
+    uint16_t index = engine->slots[key];
+
+    return index ? &engine->sessions[index - 1U] : NULL;
+}
+
+static void close_session(j1939_engine_t *engine, session_t *session) {
+    uint16_t index = engine->slots[session->key];
+
+    assert(index && (&engine->sessions[index - 1U] == session));
+    engine->slots[session->key] = 0U;
+    engine->free[engine->numFree++] = (uint16_t)(index - 1U);
+    session->mode = SESSION_FREE;
+}
+
+static void sweep_sessions(j1939_engine_t *engine) {
+    session_t *session = &engine->sessions[engine->sweep];
+
+    if (++engine->sweep >= engine->numSessions)
+        engine->sweep = 0U;
+    if ((session->mode != SESSION_FREE) && timer_timeout(&session->timer)) {
+        engine->expired++;
+        close_session(engine, session);
+    }
+}
+
+static int send_frame(j1939_engine_t *engine, uint8_t priority, uint32_t pgn, uint8_t dst, uint8_t src, const uint8_t *data) {
+    slcan_message_t frame;
+
+    (void)memset(&frame, 0x00, sizeof(slcan_message_t));
+    frame.can_id = CAN_XTD_FRAME | ((uint32_t)(priority & 0x7U) << 26) | (uint32_t)src;
+    if ((pgn & 0xFF00U) < 0xF000U)
+        frame.can_id |= ((pgn & 0x3FF00U) | (uint32_t)dst) << 8;
+    else
+        frame.can_id |= (pgn & 0x3FFFFU) << 8;
+    frame.can_dlc = (uint8_t)CAN_LEN_MAX;
+    memcpy(frame.data, data, CAN_LEN_MAX);
+    return slcan_write_messages(engine->port, &frame, 1U);
+}
+
+static int send_control(j1939_engine_t *engine, const session_t *session, uint8_t control) {
+    uint8_t data[CAN_LEN_MAX];
+
+    data[0] = control;
+    if (control == TP_CTS) {
+        data[1] = session->window;
+        data[2] = session->next;
+        data[3] = data[4] = 0xFFU;
+    } else {
+        data[1] = (uint8_t)(session->pdu.length & 0xFFU);
+        data[2] = (uint8_t)(session->pdu.length >> 8);
+        data[3] = session->packets;
+        data[4] = 0xFFU;
+    }
+    data[5] = (uint8_t)(session->pdu.pgn & 0xFFU);
+    data[6] = (uint8_t)((session->pdu.pgn >> 8) & 0xFFU);
+    data[7] = (uint8_t)((session->pdu.pgn >> 16) & 0xFFU);
+    /* note: connection management is sent to the originator of the session */
+    return send_frame(engine, 7U, J1939_PGN_TP_CM, session->pdu.src, session->pdu.dst, data);
+}
+
+static int send_claim(j1939_engine_t *engine, uint8_t src) {
+    uint8_t data[CAN_LEN_MAX];
+    uint64_t name = engine->name;
+    int i;
+
+    /* Address Claimed (or Cannot Claim from the null address), NAME in little endian */
+    for (i = 0; i < (int)CAN_LEN_MAX; i++, name >>= 8)
+        data[i] = (uint8_t)(name & 0xFFU);
+    return send_frame(engine, 6U, J1939_PGN_ADDR_CLAIM, J1939_GLOBAL_ADDR, src, data);
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,285 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'J1939'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        j1939.h
+ *
+ *  @brief       SAE J1939 transport protocol (BAM/CMDT) on top of SLCAN.
+ *
+ *  @remarks     The protocol engine is driven by the reception thread of the
+ *               SLCAN port (reception hook): it reassembles the PDUs of all
+ *               concurrent transport sessions on the bus (BAM and RTS/CTS)
+ *               and queues the complete PDUs. Sessions are found by a direct
+ *               lookup table keyed by source and destination address (TP.DT
+ *               frames carry no PGN), so the work per frame is constant.
+ *               Stale sessions are expired by a sweep of one session per
+ *               received frame.
+ *
+ *  @remarks     With an own address claimed (address claim procedure) the
+ *               engine answers RTS frames to this address with CTS frames and
+ *               acknowledges the complete PDU (End of Message Acknowledge).
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @defgroup    j1939 SAE J1939 Transport Protocol
+ *  @{
+ */
+#ifndef J1939_H_INCLUDED
+#define J1939_H_INCLUDED
+
+#include "slcan.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Engine Options
+ *  @brief Options of the J1939 engine (bit mask)
+ *  @{ */
+#define J1939_SINGLE_FRAMES   0x01U     /**< queue single-frame PGNs as PDUs too */
+#define J1939_CONSUME_FRAMES  0x02U     /**< consume the TP.CM and TP.DT frames (not queued by the port) */
+/** @} */
+
+/** @name  Parameter Group Numbers
+ *  @brief PGNs of the network management and the transport protocol
+ *  @{ */
+#define J1939_PGN_REQUEST     0x0EA00U  /**< Request */
+#define J1939_PGN_TP_DT       0x0EB00U  /**< Transport Protocol - Data Transfer */
+#define J1939_PGN_TP_CM       0x0EC00U  /**< Transport Protocol - Connection Management */
+#define J1939_PGN_ADDR_CLAIM  0x0EE00U  /**< Address Claimed / Cannot Claim */
+/** @} */
+
+/** @name  Addresses
+ *  @brief Special source and destination addresses
+ *  @{ */
+#define J1939_NULL_ADDR       0xFEU     /**< null address (no address claimed) */
+#define J1939_GLOBAL_ADDR     0xFFU     /**< global address (broadcast) */
+/** @} */
+
+#define J1939_MAX_PDU         1785U     /**< max. length of a PDU (255 packets of 7 bytes) */
+#define J1939_MAX_SESSIONS    4096U     /**< max. number of concurrent sessions */
+#define J1939_SESSIONS        256U      /**< default number of concurrent sessions */
+#define J1939_QUEUE_SIZE      64U       /**< default number of queued PDUs */
+#define J1939_T1              750U      /**< time-out between two TP.DT frames (in [ms]) */
+#define J1939_T2              1250U     /**< time-out after TP.CM frames (in [ms]) */
+#define J1939_CLAIM_TIME      250U      /**< time to wait for contending claims (in [ms]) */
+
+/** @name  Identifier Decoding
+ *  @brief Fields of a 29-bit identifier (PDU1 format: PF < 240, PS = destination)
+ *  @{ */
+#define J1939_PRIORITY(id)    (uint8_t)(((id) >> 26) & 0x7U)
+#define J1939_SOURCE(id)      (uint8_t)((id) & 0xFFU)
+#define J1939_PDU1(id)        ((((id) >> 16) & 0xFFU) < 240U)
+#define J1939_PGN(id)         (uint32_t)(J1939_PDU1(id) ? (((id) >> 8) & 0x3FF00U) : (((id) >> 8) & 0x3FFFFU))
+#define J1939_DESTINATION(id) (uint8_t)(J1939_PDU1(id) ? (((id) >> 8) & 0xFFU) : J1939_GLOBAL_ADDR)
+/** @} */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *j1939_t;                  /**< J1939 engine (opaque data type) */
+
+/** @brief  J1939 engine parameters
+ */
+typedef struct j1939_param_t_ {         /* J1939 engine: */
+    uint8_t options;                    /**< engine options (bit mask) */
+    uint16_t sessions;                  /**< number of concurrent sessions (0 = default) */
+    uint16_t queueSize;                 /**< number of queued PDUs (0 = default) */
+} j1939_param_t;
+
+/** @brief  J1939 PDU (received parameter group)
+ */
+typedef struct j1939_pdu_t_ {           /* J1939 PDU: */
+    uint32_t pgn;                       /**< parameter group number */
+    uint8_t src;                        /**< source address */
+    uint8_t dst;                        /**< destination address (0xFF = global) */
+    uint8_t priority;                   /**< priority (of the TP.CM frame) */
+    uint16_t length;                    /**< length of the PDU */
+    uint8_t data[J1939_MAX_PDU];        /**< data of the PDU */
+} j1939_pdu_t;
+
+/** @brief  J1939 engine status
+ */
+typedef struct j1939_status_t_ {        /* J1939 status: */
+    uint8_t address;                    /**< own address (0xFE = none) */
+    uint32_t active;                    /**< number of active sessions */
+    uint64_t completed;                 /**< number of reassembled PDUs */
+    uint64_t aborted;                   /**< number of aborted sessions (abort, sequence error, no resources) */
+    uint64_t expired;                   /**< number of sessions timed out */
+} j1939_status_t;
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       creates a J1939 engine for a SLCAN port and installs it as
+ *               reception hook of the port (constructor).
+ *
+ *  @param[in]   port   - pointer to a SLCAN instance
+ *  @param[in]   param  - pointer to the engine parameters (NULL = defaults)
+ *
+ *  @returns     a pointer to a J1939 engine if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (param)
+ *  @retval      EBUSY   - no more reception hooks of the port
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI j1939_t j1939_create(slcan_port_t port, const j1939_param_t *param);
+
+
+/** @brief       removes the reception hook and destroys the J1939 engine
+ *               (destructor).
+ *
+ *  @remarks     The SLCAN port shall be disconnected before (no reception).
+ *  @remarks     Threads waiting in j1939_claim or j1939_receive are woken up,
+ *               the engine is destroyed after they have left.
+ *
+ *  @param[in]   j1939  - pointer to a J1939 engine
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ */
+SLCANAPI int j1939_destroy(j1939_t j1939);
+
+
+/** @brief       claims an own address (address claim procedure, blocking).
+ *
+ *  @remarks     The Address Claimed message is sent and contending claims
+ *               are awaited for J1939_CLAIM_TIME; the NAME with the lower
+ *               value wins. The claim is repeated on a Request for Address
+ *               Claimed, a lost address is released by a Cannot Claim
+ *               message (no arbitrary address capability).
+ *
+ *  @param[in]   j1939    - pointer to a J1939 engine
+ *  @param[in]   address  - address to be claimed (0..253, 0xFE = release)
+ *  @param[in]   name     - NAME of the node (64-bit)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT      - bad address (invalid engine instance)
+ *  @retval      EINVAL      - invalid argument (address)
+ *  @retval      EADDRINUSE  - address claimed by a node with higher priority
+ *  @retval      EBUSY       - device / resource busy (disturbance)
+ */
+SLCANAPI int j1939_claim(j1939_t j1939, uint8_t address, uint64_t name);
+
+
+/** @brief       receives a PDU from the J1939 engine, if any.
+ *
+ *  @param[in]   j1939    - pointer to a J1939 engine
+ *  @param[out]  pdu      - pointer to a buffer for the PDU
+ *  @param[in]   timeout  - time to wait for the reception of a PDU:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait in milliseconds
+ *
+ *  @returns     the length of the PDU if successful, or a negative value on
+ *               error.
+ *
+ *  @retval      -30  - when no PDU has been received (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ *  @retval      EINVAL  - invalid argument (pdu)
+ *  @retval      ENOMSG  - no data available (queue empty)
+ *  @retval      ENOSPC  - no space left (PDUs lost in front of this PDU)
+ */
+SLCANAPI int j1939_receive(j1939_t j1939, j1939_pdu_t *pdu, uint16_t timeout);
+
+
+/** @brief       retrieves the status of the J1939 engine.
+ *
+ *  @param[in]   j1939   - pointer to a J1939 engine
+ *  @param[out]  status  - pointer to a buffer for the status
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid engine instance)
+ *  @retval      EINVAL  - invalid argument (status)
+ */
+SLCANAPI int j1939_status(j1939_t j1939, j1939_status_t *status);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* J1939_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -78,12 +78,50 @@
 /*  -----------  defines  ------------------------------------------------
  */
 
+/** @name  Memory options
+ *  @brief Allocation of the queue memory
+ *  @{ */
+#define QUEUE_LAZY_COMMIT  0x01U        /**< memory is reserved, pages are committed when touched */
+#define QUEUE_HUGE_PAGES   0x02U        /**< memory is backed by huge pages (if available) */
+#define QUEUE_SHRINK_IDLE  0x04U        /**< memory is released when the queue runs empty */
+#define QUEUE_DEFAULT      QUEUE_LAZY_COMMIT
+/** @} */
+
+/** @name  Overflow policies
+ *  @brief Behavior when an element is enqueued into a full queue
+ *  @{ */
+#define QUEUE_DROP_NEWEST     0U        /**< the new element is dropped (default) */
+#define QUEUE_DROP_OLDEST     1U        /**< the oldest element is overwritten */
+#define QUEUE_BLOCK_PRODUCER  2U        /**< the producer waits for free space (bounded) */
+/** @} */
+
+#define QUEUE_MAX_LANES  3U             /**< maximum number of priority lanes */
+#define QUEUE_MAX_TAPS   8U             /**< maximum number of attached queues (taps) */
 
 /*  -----------  types  --------------------------------------------------
  */
 
 typedef void *queue_t;                  /**< queue (opaque data type) */
 
+/** @brief       callback to fill in a marker element for a loss interval.
+ *
+ *  @param[out]  element  - pointer to the element to be filled in
+ *  @param[in]   nbytes   - size of the element (number of bytes)
+ *  @param[in]   lost     - number of elements lost in the interval
+ *  @param[in]   interval - duration of the loss interval (in milliseconds)
+ */
+typedef void (*queue_marker_t)(void *element, size_t nbytes, uint64_t lost, uint64_t interval);
+
+/** @brief       callback to decide whether an element is published into a tap.
+ *
+ *  @param[in]   element  - pointer to the element to be enqueued
+ *  @param[in]   nbytes   - size of the element (number of bytes)
+ *  @param[in]   param    - parameter given on 'queue_attach'
+ *
+ *  @returns     true if the element shall be published into the tap.
+ */
+typedef bool (*queue_filter_t)(const void *element, size_t nbytes, const void *param);
+
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -96,6 +134,9 @@ extern "C" {
 #endif
 
 /** @brief       creates an instance of a waitable queue (constructor).
+ *
+ *  @remarks     The queue memory is allocated with the default options.
+ *               @see queue_resize
  *
  *  @param[in]   numElem   - maximum number of elements in the queue
  *  @param[in]   elemSize  - size of a queue element (number of bytes)
@@ -128,7 +169,7 @@ extern int queue_destroy(queue_t queue);
 
 
 /** @brief       removes all enqueued elements from the queue and reset the
- *               overflow indicator and the overflow counter.
+ *               overflow indicator, the overflow counter and the high-water mark.
  *
  *  @param[in]   queue  - pointer to a queue instance
  *
@@ -142,6 +183,33 @@ extern int queue_destroy(queue_t queue);
 extern int queue_clear(queue_t queue);
 
 
+/** @brief       changes the capacity and the memory options of the queue.
+ *
+ *  @remarks     The queue memory is reallocated, all enqueued elements are
+ *               removed from the queue (like 'queue_clear').
+ *
+ *  @remarks     With option QUEUE_LAZY_COMMIT only the pages touched by the
+ *               producer become resident, otherwise all pages are committed
+ *               in advance. Option QUEUE_HUGE_PAGES tries huge pages first.
+ *               With option QUEUE_SHRINK_IDLE the pages beyond a small working
+ *               set are returned to the system when the queue runs empty after
+ *               it has been filled deeply.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   numElem  - maximum number of elements in the queue
+ *  @param[in]   options  - memory options (QUEUE_LAZY_COMMIT, etc.)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (numElem)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ */
+extern int queue_resize(queue_t queue, size_t numElem, uint32_t options);
+
+
 /** @brief       enqueues one element of n data bytes into the queue,
  *               if the queue is not full.
  *
@@ -167,6 +235,31 @@ extern int queue_clear(queue_t queue);
 extern int queue_enqueue(queue_t queue, const void *element, size_t nbytes);
 
 
+/** @brief       enqueues one element into a priority lane of the queue.
+ *
+ *  @remarks     Lane 0 is the queue itself, lanes 1 to n are the priority
+ *               lanes set up by 'queue_lanes'. The higher the lane number,
+ *               the higher its priority.  @see queue_lanes
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   lane     - number of the lane (0 = the queue itself)
+ *  @param[in]   element  - pointer to the element to be enqueued
+ *  @param[in]   nbytes   - number of bytes to be copied into the queue
+ *
+ *  @returns     the number of bytes copied into the queue if successful, or
+ *               a negative value on error.
+ *
+ *  @retval      -20  - when the lane is full (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid queue instance)
+ *  @retval      EINVAL  - invalid argument (lane, element or nbytes)
+ *  @retval      ENSPC   - no space left (lane is full)
+ */
+extern int queue_enqueue_lane(queue_t queue, size_t lane, const void *element, size_t nbytes);
+
+
 /** @brief       dequeues one element from the queue, if any.
  *
  *  @param[in]   queue    - pointer to a queue instance
@@ -187,25 +280,216 @@ extern int queue_enqueue(queue_t queue, const void *element, size_t nbytes);
  *  @retval      EFAULT  - bad address (invalid queue instance)
  *  @retval      EINVAL  - invalid argument (element or maxbytes)
  *  @retval      ENOMSG  - no data available (queue empty)
+ *
+ *  @remarks     If an element has been successfully dequeued, the value ENOSPC
+ *               in the system variable 'errno' indicates that elements have
+ *               been lost in front of this element. The value is set only
+ *               once per loss interval (without the need to call 'queue_overflow').
+ *               If a marker callback is registered, the loss interval is
+ *               returned as a marker element.  @see queue_marker
  */
 extern int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t timeout);
 
 
-/** @brief       returns true when an overflow has occurred.
+/** @brief       dequeues up to n elements from the queue, if any.
+ *
+ *  @remarks     The function waits for the first element only, the following
+ *               elements are taken from the queue if already available.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[out]  elements - pointer to an array into which the elements are copied
+ *  @param[in]   count    - maximum number of elements to be copied from the queue
+ *  @param[in]   elemSize - size of an element in the array (number of bytes)
+ *  @param[in]   timeout  - time to wait for elements available in the queue:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait im milliseconds
+ *
+ *  @returns     the number of elements copied from the queue if successful, or
+ *               a negative value on error.
+ *
+ *  @retval      -30  - when the queue is empty (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT  - bad address (invalid queue instance)
+ *  @retval      EINVAL  - invalid argument (elements, count or elemSize)
+ *  @retval      ENOMSG  - no data available (queue empty)
+ *
+ *  @remarks     If elements have been successfully dequeued, the value ENOSPC
+ *               in the system variable 'errno' indicates that elements have
+ *               been lost in front of one of these elements. The value is set
+ *               only once per loss interval (without the need to call 'queue_overflow').
+ *               If a marker callback is registered, the loss intervals are
+ *               returned as marker elements.  @see queue_marker
+ */
+extern int queue_dequeue_n(queue_t queue, void *elements, size_t count, size_t elemSize, uint16_t timeout);
+
+
+/** @brief       sets up priority lanes in front of the queue.
+ *
+ *  @remarks     Each lane is a ring of its own. The dequeue functions take
+ *               the elements from the highest non-empty lane first, and from
+ *               the queue itself when all lanes are empty. A full lane drops
+ *               the new element, or its oldest element with policy
+ *               QUEUE_DROP_OLDEST (a lane never blocks the producer).
+ *
+ *  @remarks     All elements in the lanes are discarded. With 0 lanes the
+ *               priority lanes are removed.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   numLanes - number of priority lanes (0..QUEUE_MAX_LANES)
+ *  @param[in]   numElem  - maximum number of elements in each lane
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (numLanes or numElem)
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ */
+extern int queue_lanes(queue_t queue, size_t numLanes, size_t numElem);
+
+
+/** @brief       attaches a queue (tap) that receives a copy of each element
+ *               enqueued into the queue.
+ *
+ *  @remarks     The elements are published into the tap with its own overflow
+ *               policy and loss accounting, so a full tap does not affect the
+ *               queue or other taps. The tap must not use the policy
+ *               QUEUE_BLOCK_PRODUCER (the queue is locked while publishing).
+ *               Calling this function again for the same tap replaces the
+ *               filter.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   tap      - pointer to the queue to be attached (same element size)
+ *  @param[in]   filter   - filter callback, or NULL for all elements
+ *  @param[in]   param    - parameter passed to the filter callback
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (tap)
+ *  @retval      ENOSPC   - no space left (QUEUE_MAX_TAPS reached)
+ */
+extern int queue_attach(queue_t queue, queue_t tap, queue_filter_t filter, const void *param);
+
+
+/** @brief       detaches a queue (tap) from the queue.
+ *
+ *  @remarks     After return no element is published into the tap anymore,
+ *               so it can be destroyed.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   tap      - pointer to the attached queue
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      ENOENT   - no such entry (tap not attached)
+ */
+extern int queue_detach(queue_t queue, queue_t tap);
+
+
+/** @brief       sets the overflow policy of the queue.
+ *
+ *  @remarks     With policy QUEUE_BLOCK_PRODUCER the producer waits at most
+ *               'timeout' milliseconds for free space, then the new element
+ *               is dropped. A time-out of 0 behaves like QUEUE_DROP_NEWEST.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   policy   - overflow policy (QUEUE_DROP_NEWEST, etc.)
+ *  @param[in]   timeout  - maximum time the producer is blocked (in milliseconds)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      EINVAL   - invalid argument (policy)
+ */
+extern int queue_policy(queue_t queue, uint8_t policy, uint16_t timeout);
+
+
+/** @brief       registers a callback to report loss intervals in-band.
  *
- *  @remarks     The overflow indicator can be reset by a call of 'queue_clear'.
+ *  @remarks     When the consumer reaches the position of a loss interval,
+ *               the callback is invoked (with the queue locked) to fill in a
+ *               marker element, which is returned instead of a queue element.
+ *               Marker elements do not occupy space in the queue.
+ *
+ *  @param[in]   queue    - pointer to a queue instance
+ *  @param[in]   marker   - callback function, or NULL to unregister
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ */
+extern int queue_marker(queue_t queue, queue_marker_t marker);
+
+
+/** @brief       returns true when loss intervals are pending in the queue.
+ *
+ *  @remarks     The overflow counters can be reset by a call of 'queue_clear'.
  *               @see queue_clear
  *
  *  @param[in]   queue    - pointer to a queue instance
- *  @param[out]  counter  - number of overflows (optional)
+ *  @param[out]  counter  - number of lost elements (optional)
+ *  @param[out]  gaps     - number of loss intervals (optional)
+ *
+ *  @returns     0 when no loss is pending, or a none-zero value otherwise.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ */
+extern bool queue_overflow(queue_t queue, uint64_t *counter, uint64_t *gaps);
+
+
+/** @brief       retrieves the fill level and the high-water mark of the queue.
+ *
+ *  @remarks     The high-water mark can be reset by a call of 'queue_clear'.
+ *               @see queue_clear
+ *
+ *  @param[in]   queue  - pointer to a queue instance
+ *  @param[out]  used   - number of elements in the queue and its lanes (optional)
+ *  @param[out]  size   - maximum number of elements in the queue (optional, w/o lanes)
+ *  @param[out]  high   - maximum number of elements the queue has hold (optional)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid queue instance)
+ */
+extern int queue_status(queue_t queue, size_t *used, size_t *size, size_t *high);
+
+
+/** @brief       retrieves a file descriptor that is readable as long as the
+ *               queue is not empty, e.g. to wait for elements by means of
+ *               'select', 'poll' or an event loop.
+ *
+ *  @remarks     The file descriptor is created on the first call and it is
+ *               valid until the queue is destroyed. It must not be read or
+ *               closed by the caller.
+ *
+ *  @param[in]   queue  - pointer to a queue instance
  *
- *  @returns     0 when no overflow has occurred, or a none-zero value otherwise.
+ *  @returns     a file descriptor if successful, or a negative value on error.
  *
  *  @note        System variable 'errno' will be set in case of an error.
  *
  *  @retval      EFAULT   - bad address (invalid queue instance)
+ *  @retval      ENOTSUP  - not supported (e.g. on Windows)
  */
-extern bool queue_overflow(queue_t queue, uint64_t *counter);
+extern int queue_event_fd(queue_t queue);
 
 
 /** @brief       signals waiting objects, if any.
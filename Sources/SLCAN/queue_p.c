@@ -66,8 +66,10 @@
 #include <errno.h>
 #include <assert.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <time.h>
+#include <sys/mman.h>
 
 
 /*  -----------  options  ------------------------------------------------
@@ -79,6 +81,14 @@
 
 #define MIN(x,y)  ((x) < (y) ? (x) : (y))
 
+#define ROUND_UP(n,p)  ((((n) + (p) - 1U) / (p)) * (p))
+
+#define HUGE_PAGE_SIZE  (2U * 1024U * 1024U)
+#define SHRINK_THRESHOLD  (1024U * 1024U)
+#define SHRINK_WORKING_SET  (64U * 1024U)
+
+#define GAP_LIST_SIZE  16U
+
 #define GET_TIME(ts)  do{ clock_gettime(CLOCK_REALTIME, &ts); } while(0)
 #define ADD_TIME(ts,to)  do{ ts.tv_sec += (time_t)(to / 1000U); \
                              ts.tv_nsec += (long)(to % 1000U) * (long)1000000; \
@@ -103,6 +113,7 @@
 typedef struct object_t_ {
     size_t size;
     size_t used;
+    size_t high;
     size_t head;
     size_t tail;
     uint8_t *queueElem;
@@ -111,11 +122,57 @@ typedef struct object_t_ {
         pthread_mutex_t mutex;
         pthread_cond_t cond;
         bool flag;
+        pthread_cond_t space;
+        bool producer;
     } wait;
     struct overflow_t {
         bool flag;
         uint64_t counter;
+        uint64_t gaps;
     } ovfl;
+    struct policy_t {
+        uint8_t mode;
+        uint16_t timeout;
+        queue_marker_t marker;
+    } policy;
+    struct gap_list_t {
+        struct gap_t {
+            uint64_t seq;
+            uint64_t lost;
+            uint64_t first;
+            uint64_t last;
+        } list[GAP_LIST_SIZE];
+        size_t first;
+        size_t count;
+    } gaps;
+    uint64_t seqIn;
+    struct lane_t {
+        uint8_t *elem;
+        size_t size;
+        size_t used;
+        size_t head;
+        size_t tail;
+        uint64_t lost;
+        uint64_t first;
+        uint64_t last;
+    } lanes[QUEUE_MAX_LANES];
+    size_t numLanes;
+    struct tap_t {
+        struct object_t_ *queue;
+        queue_filter_t filter;
+        const void *param;
+    } taps[QUEUE_MAX_TAPS];
+    size_t numTaps;
+    struct event_t {
+        int fd[2];
+        bool flag;
+    } event;
+    struct memory_t {
+        size_t length;
+        size_t page;
+        size_t touched;
+        uint32_t options;
+    } mem;
 } object_t;
 
 
@@ -124,6 +181,26 @@ typedef struct object_t_ {
 
 static bool enqueue_element(object_t *queue, const void *element, size_t nbytes);
 static bool dequeue_element(object_t *queue, void *element, size_t maxbytes);
+static size_t dequeue_elements(object_t *queue, void *elements, size_t count, size_t elemSize);
+static void drop_element(object_t *queue);
+
+static bool enqueue_lane(object_t *queue, struct lane_t *lane, const void *element, size_t nbytes);
+static bool dequeue_lane(object_t *queue, struct lane_t *lane, void *element, size_t maxbytes);
+static bool is_empty(const object_t *queue);
+static void publish_taps(object_t *queue, const void *element, size_t nbytes);
+static size_t clear_lanes(object_t *queue);
+
+static bool gap_ahead(const object_t *queue);
+static void loss_at_head(object_t *queue);
+static void loss_at_tail(object_t *queue);
+static uint64_t time_ms(void);
+
+static void raise_event(object_t *queue);
+static void clear_event(object_t *queue);
+
+static uint8_t *alloc_memory(struct memory_t *mem, size_t nbytes, uint32_t options);
+static void free_memory(uint8_t *addr, const struct memory_t *mem);
+static void shrink_memory(object_t *queue);
 
 
 /*  -----------  variables  ----------------------------------------------
@@ -139,7 +216,7 @@ queue_t queue_create(size_t numElem, size_t elemSize) {
     /* reset errno variable */
     errno = 0;
     /* sanity check */
-    if (!numElem || !elemSize) {
+    if (!numElem || !elemSize || (numElem > (SIZE_MAX / elemSize))) {
         errno = EINVAL;
         return NULL;
     }
@@ -147,7 +224,7 @@ queue_t queue_create(size_t numElem, size_t elemSize) {
     if ((object = (object_t*)malloc(sizeof(object_t))) != NULL) {
         bzero(object, sizeof(object_t));
         /* create a fixed size queue for data exchenage */
-        if ((object->queueElem = malloc(numElem * elemSize)) == NULL) {
+        if ((object->queueElem = alloc_memory(&object->mem, numElem * elemSize, QUEUE_DEFAULT)) == NULL) {
             /* errno set */
             free(object);
             return NULL;
@@ -155,19 +232,28 @@ queue_t queue_create(size_t numElem, size_t elemSize) {
         object->elemSize = elemSize;
         object->size = numElem;
         object->used = 0;
+        object->high = 0;
         object->head = 0;
         object->tail = 0;
         object->ovfl.flag = false;
         object->ovfl.counter = 0U;
+        object->event.fd[0] = -1;
+        object->event.fd[1] = -1;
+        object->event.flag = false;
         /* create a mutex and a waitable condition */
         if ((pthread_mutex_init(&object->wait.mutex, NULL) < 0) ||
-            (pthread_cond_init(&object->wait.cond, NULL)) < 0) {
+            (pthread_cond_init(&object->wait.cond, NULL) < 0) ||
+            (pthread_cond_init(&object->wait.space, NULL) < 0)) {
             /* errno set */
-            free(object->queueElem);
+            free_memory(object->queueElem, &object->mem);
             free(object);
             return NULL;
         }
         object->wait.flag = false;
+        object->wait.producer = false;
+        object->policy.mode = QUEUE_DROP_NEWEST;
+        object->policy.timeout = 0U;
+        object->policy.marker = NULL;
     }
     return (object_t*)object;
 }
@@ -184,9 +270,17 @@ int queue_destroy(queue_t queue) {
     /* destroy mutex and condition */
     (void)pthread_mutex_destroy(&object->wait.mutex);
     (void)pthread_cond_destroy(&object->wait.cond);
-    /* destroy the message queue */
+    (void)pthread_cond_destroy(&object->wait.space);
+    /* close the event pipe, if any */
+    if (object->event.fd[0] != -1)
+        (void)close(object->event.fd[0]);
+    if (object->event.fd[1] != -1)
+        (void)close(object->event.fd[1]);
+    /* destroy the message queue and the priority lanes */
     if (object->queueElem)
-        free(object->queueElem);
+        free_memory(object->queueElem, &object->mem);
+    if (object->lanes[0].elem)
+        free(object->lanes[0].elem);
     /* C language destructor */
     free(object);
     return 0;
@@ -220,20 +314,116 @@ int queue_clear(queue_t queue) {
         errno = EFAULT;
         return -1;
     }
-    /* remove elements from queue, if any */
+    /* remove elements from queue and priority lanes, if any */
     ENTER_CRITICAL_SECTION(object);
-    res = (int)object->used;
+    res = (int)(object->used + clear_lanes(object));
     object->used = 0;
+    object->high = 0;
     object->head = 0;
     object->tail = 0;
     object->ovfl.flag = false;
     object->ovfl.counter = 0U;
+    object->ovfl.gaps = 0U;
+    object->gaps.first = 0U;
+    object->gaps.count = 0U;
+    clear_event(object);
+    if (object->wait.producer)
+        (void)pthread_cond_signal(&object->wait.space);
     LEAVE_CRITICAL_SECTION(object);
     /* return number of elements removed */
     return res;
 }
 
-bool queue_overflow(queue_t queue, uint64_t *counter) {
+int queue_resize(queue_t queue, size_t numElem, uint32_t options) {
+    object_t *object = (object_t*)queue;
+    uint8_t *queueElem = NULL;
+    uint8_t *oldElem = NULL;
+    struct memory_t mem, oldMem;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!numElem || (numElem > (SIZE_MAX / object->elemSize))) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* allocate the new queue memory (outside of the critical section) */
+    bzero(&mem, sizeof(struct memory_t));
+    if ((queueElem = alloc_memory(&mem, numElem * object->elemSize, options)) == NULL) {
+        /* errno set */
+        return -1;
+    }
+    /* exchange the queue memory and remove all elements */
+    ENTER_CRITICAL_SECTION(object);
+    oldElem = object->queueElem;
+    oldMem = object->mem;
+    object->queueElem = queueElem;
+    object->mem = mem;
+    object->size = numElem;
+    (void)clear_lanes(object);
+    object->used = 0;
+    object->high = 0;
+    object->head = 0;
+    object->tail = 0;
+    object->ovfl.flag = false;
+    object->ovfl.counter = 0U;
+    object->ovfl.gaps = 0U;
+    object->gaps.first = 0U;
+    object->gaps.count = 0U;
+    clear_event(object);
+    if (object->wait.producer)
+        (void)pthread_cond_signal(&object->wait.space);
+    LEAVE_CRITICAL_SECTION(object);
+    /* release the old queue memory */
+    free_memory(oldElem, &oldMem);
+    return 0;
+}
+
+int queue_policy(queue_t queue, uint8_t policy, uint16_t timeout) {
+    object_t *object = (object_t*)queue;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (policy > QUEUE_BLOCK_PRODUCER) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* set overflow policy (and release a waiting producer) */
+    ENTER_CRITICAL_SECTION(object);
+    object->policy.mode = policy;
+    object->policy.timeout = timeout;
+    if (object->wait.producer)
+        (void)pthread_cond_signal(&object->wait.space);
+    LEAVE_CRITICAL_SECTION(object);
+    /* return success */
+    return 0;
+}
+
+int queue_marker(queue_t queue, queue_marker_t marker) {
+    object_t *object = (object_t*)queue;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* set callback for in-band loss markers */
+    ENTER_CRITICAL_SECTION(object);
+    object->policy.marker = marker;
+    LEAVE_CRITICAL_SECTION(object);
+    /* return success */
+    return 0;
+}
+
+bool queue_overflow(queue_t queue, uint64_t *counter, uint64_t *gaps) {
     object_t *object = (object_t*)queue;
     bool res = false;
 
@@ -243,19 +433,184 @@ bool queue_overflow(queue_t queue, uint64_t *counter) {
         errno = EFAULT;
         return false;
     }
-    /* get overflow flag from queue */
+    /* get overflow flag from queue (loss not passed by the consumer yet) */
     ENTER_CRITICAL_SECTION(object);
-    res = object->ovfl.flag;
+    res = (object->gaps.count != 0U) ? true : false;
     if (counter)
         *counter = object->ovfl.counter;
+    if (gaps)
+        *gaps = object->ovfl.gaps;
     LEAVE_CRITICAL_SECTION(object);
     /* return overflow flag */
     return res;
 }
 
+int queue_lanes(queue_t queue, size_t numLanes, size_t numElem) {
+    object_t *object = (object_t*)queue;
+    uint8_t *laneElem = NULL;
+    uint8_t *oldElem = NULL;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if ((numLanes > QUEUE_MAX_LANES) || (numLanes && !numElem) ||
+        (numLanes && (numElem > (SIZE_MAX / object->elemSize / numLanes)))) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* allocate the memory of the priority lanes (outside of the critical section) */
+    if (numLanes && ((laneElem = (uint8_t*)malloc(numLanes * numElem * object->elemSize)) == NULL)) {
+        errno = ENOMEM;
+        return -1;
+    }
+    /* exchange the priority lanes and remove their elements */
+    ENTER_CRITICAL_SECTION(object);
+    oldElem = object->lanes[0].elem;
+    (void)clear_lanes(object);
+    for (i = 0U; i < QUEUE_MAX_LANES; i++) {
+        object->lanes[i].elem = (i < numLanes) ? &laneElem[i * numElem * object->elemSize] : NULL;
+        object->lanes[i].size = (i < numLanes) ? numElem : 0U;
+    }
+    object->numLanes = numLanes;
+    LEAVE_CRITICAL_SECTION(object);
+    /* release the old memory */
+    if (oldElem)
+        free(oldElem);
+    return 0;
+}
+
+int queue_attach(queue_t queue, queue_t tap, queue_filter_t filter, const void *param) {
+    object_t *object = (object_t*)queue;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!tap || (tap == queue) || (((object_t*)tap)->elemSize != object->elemSize)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* add the tap to the list of taps */
+    ENTER_CRITICAL_SECTION(object);
+    for (i = 0U; i < object->numTaps; i++) {
+        if (object->taps[i].queue == (object_t*)tap)
+            break;
+    }
+    if (i == QUEUE_MAX_TAPS) {
+        LEAVE_CRITICAL_SECTION(object);
+        errno = ENOSPC;
+        return -1;
+    }
+    object->taps[i].queue = (object_t*)tap;
+    object->taps[i].filter = filter;
+    object->taps[i].param = param;
+    if (i == object->numTaps)
+        object->numTaps += 1U;
+    LEAVE_CRITICAL_SECTION(object);
+    /* return success */
+    return 0;
+}
+
+int queue_detach(queue_t queue, queue_t tap) {
+    object_t *object = (object_t*)queue;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* remove the tap from the list of taps (note: no element is published
+     * into the tap after return, so it can be destroyed safely) */
+    ENTER_CRITICAL_SECTION(object);
+    for (i = 0U; i < object->numTaps; i++) {
+        if (object->taps[i].queue == (object_t*)tap)
+            break;
+    }
+    if (i == object->numTaps) {
+        LEAVE_CRITICAL_SECTION(object);
+        errno = ENOENT;
+        return -1;
+    }
+    for (; (i + 1U) < object->numTaps; i++)
+        object->taps[i] = object->taps[i + 1U];
+    object->numTaps -= 1U;
+    LEAVE_CRITICAL_SECTION(object);
+    /* return success */
+    return 0;
+}
+
+int queue_status(queue_t queue, size_t *used, size_t *size, size_t *high) {
+    object_t *object = (object_t*)queue;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* get fill level and high-water mark from queue */
+    ENTER_CRITICAL_SECTION(object);
+    if (used) {
+        *used = object->used;
+        for (i = 0U; i < object->numLanes; i++)
+            *used += object->lanes[i].used;
+    }
+    if (size)
+        *size = object->size;
+    if (high)
+        *high = object->high;
+    LEAVE_CRITICAL_SECTION(object);
+    /* return success */
+    return 0;
+}
+
+int queue_event_fd(queue_t queue) {
+    object_t *object = (object_t*)queue;
+    int res = -1;
+    int fd[2];
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* create the event pipe on first call (non-blocking) */
+    ENTER_CRITICAL_SECTION(object);
+    if (object->event.fd[0] == -1) {
+        if (pipe(fd) == 0) {
+            (void)fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+            (void)fcntl(fd[1], F_SETFL, fcntl(fd[1], F_GETFL) | O_NONBLOCK);
+            (void)fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+            (void)fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+            object->event.fd[0] = fd[0];
+            object->event.fd[1] = fd[1];
+            object->event.flag = false;
+            if (!is_empty(object))
+                raise_event(object);
+        }
+    }
+    res = object->event.fd[0];
+    LEAVE_CRITICAL_SECTION(object);
+    /* return the read end of the pipe, or negative value on error */
+    return res;
+}
+
 int queue_enqueue(queue_t queue, const void *element, size_t nbytes) {
     object_t *object = (object_t*)queue;
     int res = -1;
+    int waitCond = 0;
+    struct timespec absTime = {0, 0};
 
     /* sanity check */
     errno = 0;
@@ -269,9 +624,65 @@ int queue_enqueue(queue_t queue, const void *element, size_t nbytes) {
     }
     /* enqueue element (with truncation), if queue not full */
     ENTER_CRITICAL_SECTION(object);
+    publish_taps(object, element, nbytes);
+again:
     if (enqueue_element(object, element, nbytes)) {
         res = (int)MIN(object->elemSize, nbytes);
         SIGNAL_WAIT_CONDITION(object, true);
+        raise_event(object);
+    } else if (object->policy.mode == QUEUE_DROP_OLDEST) {
+        /* overwrite the oldest element (the loss is in front of the queue) */
+        drop_element(object);
+        goto again;
+    } else if ((object->policy.mode == QUEUE_BLOCK_PRODUCER) && (object->policy.timeout != 0U)) {
+        if (!absTime.tv_sec && !absTime.tv_nsec) {
+            GET_TIME(absTime);
+            ADD_TIME(absTime, object->policy.timeout);
+        }
+        /* wait for free space in the queue (bounded by the time-out) */
+        object->wait.producer = true;
+        waitCond = pthread_cond_timedwait(&object->wait.space, &object->wait.mutex, &absTime);
+        object->wait.producer = false;
+        if (waitCond == 0)
+            goto again;
+        /* time-out: drop the new element (the loss is at the end of the queue) */
+        loss_at_tail(object);
+        errno = ENOSPC;
+        res = -20;
+    } else {
+        /* drop the new element (the loss is at the end of the queue) */
+        loss_at_tail(object);
+        errno = ENOSPC;
+        res = -20;
+    }
+    LEAVE_CRITICAL_SECTION(object);
+    /* return number of bytes enqueued, or negative value on error */
+    return res;
+}
+
+int queue_enqueue_lane(queue_t queue, size_t lane, const void *element, size_t nbytes) {
+    object_t *object = (object_t*)queue;
+    int res = -1;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!lane)
+        return queue_enqueue(queue, element, nbytes);
+    if (!element || !nbytes || (lane > object->numLanes)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* enqueue element (with truncation) into the priority lane */
+    ENTER_CRITICAL_SECTION(object);
+    publish_taps(object, element, nbytes);
+    if (enqueue_lane(object, &object->lanes[lane - 1U], element, nbytes)) {
+        res = (int)MIN(object->elemSize, nbytes);
+        SIGNAL_WAIT_CONDITION(object, true);
+        raise_event(object);
     } else {
         errno = ENOSPC;
         res = -20;
@@ -285,10 +696,7 @@ int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t timeou
     object_t *object = (object_t*)queue;
     int res = -1;
     int waitCond = 0;
-    struct timespec absTime;
-
-    GET_TIME(absTime);
-    ADD_TIME(absTime, timeout);
+    struct timespec absTime = {0, 0};
 
     /* sanity check */
     errno = 0;
@@ -305,6 +713,10 @@ int queue_dequeue(queue_t queue, void *element, size_t maxbytes, uint16_t timeou
 again:
     if (dequeue_element(object, element, maxbytes)) {
         res = (int)MIN(object->elemSize, maxbytes);
+        if (object->ovfl.flag) {
+            object->ovfl.flag = false;
+            errno = ENOSPC;
+        }
     } else {
         if (timeout == 65535U) {  /* infinite blocking read */
             WAIT_CONDITION_INFINITE(object, waitCond);
@@ -313,6 +725,11 @@ again:
             else
                 errno = ENOMSG;
         } else if (timeout != 0U) {  /* timed blocking read */
+            if (!absTime.tv_sec && !absTime.tv_nsec) {
+                /* note: the time is only taken when waiting is required */
+                GET_TIME(absTime);
+                ADD_TIME(absTime, timeout);
+            }
             WAIT_CONDITION_TIMEOUT(object, absTime, waitCond);
             if ((waitCond == 0) && object->wait.flag)
                 goto again;
@@ -328,6 +745,62 @@ again:
     return res;
 }
 
+int queue_dequeue_n(queue_t queue, void *elements, size_t count, size_t elemSize, uint16_t timeout) {
+    object_t *object = (object_t*)queue;
+    int res = -1;
+    int waitCond = 0;
+    size_t n;
+    struct timespec absTime = {0, 0};
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!elements || !count || !elemSize) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (count > (size_t)INT_MAX)
+        count = (size_t)INT_MAX;
+    /* dequeue up to n elements (with truncation), if queue not empty */
+    ENTER_CRITICAL_SECTION(object);
+again:
+    if ((n = dequeue_elements(object, elements, count, elemSize)) != 0U) {
+        res = (int)n;
+        if (object->ovfl.flag) {
+            object->ovfl.flag = false;
+            errno = ENOSPC;
+        }
+    } else {
+        if (timeout == 65535U) {  /* infinite blocking read */
+            WAIT_CONDITION_INFINITE(object, waitCond);
+            if ((waitCond == 0) && object->wait.flag)
+                goto again;
+            else
+                errno = ENOMSG;
+        } else if (timeout != 0U) {  /* timed blocking read */
+            if (!absTime.tv_sec && !absTime.tv_nsec) {
+                /* note: the time is only taken when waiting is required */
+                GET_TIME(absTime);
+                ADD_TIME(absTime, timeout);
+            }
+            WAIT_CONDITION_TIMEOUT(object, absTime, waitCond);
+            if ((waitCond == 0) && object->wait.flag)
+                goto again;
+            else
+                errno = ETIMEDOUT;
+        } else {  /* polling (timeout == 0) */
+            errno = ENOMSG;
+        }
+        res = -30;
+    }
+    LEAVE_CRITICAL_SECTION(object);
+    /* return number of elements dequeued, or negative value on error */
+    return res;
+}
+
 /*  ---  FIFO  ---
  *
  *  size :  total number of elements
@@ -351,31 +824,371 @@ static bool enqueue_element(object_t *queue, const void *element, size_t nbytes)
         else
             queue->head = queue->tail;  /* to make sure */
         (void)memcpy(&queue->queueElem[(queue->tail * queue->elemSize)], element, MIN(queue->elemSize, nbytes));
+        if (queue->mem.touched < ((queue->tail + 1U) * queue->elemSize))
+            queue->mem.touched = (queue->tail + 1U) * queue->elemSize;
         queue->used += 1U;
+        queue->seqIn += 1U;
+        if (queue->high < queue->used)
+            queue->high = queue->used;
         return true;
-    } else {
-        queue->ovfl.counter += 1U;
-        queue->ovfl.flag = true;
+    } else
         return false;
-    }
 }
 
 static bool dequeue_element(object_t *queue, void *element, size_t maxbytes) {
+    size_t i;
+
     assert(queue);
     assert(element);
     assert(queue->size);
     assert(queue->elemSize);
     assert(queue->queueElem);
 
+    /* the highest non-empty priority lane is served first */
+    for (i = queue->numLanes; i > 0U; i--) {
+        if ((queue->lanes[i - 1U].used > 0U) || (queue->lanes[i - 1U].lost > 0U)) {
+            if (dequeue_lane(queue, &queue->lanes[i - 1U], element, maxbytes))
+                return true;
+        }
+    }
+    if (gap_ahead(queue)) {
+        /* elements have been lost in front of the next element */
+        struct gap_t *gap = &queue->gaps.list[queue->gaps.first];
+        uint64_t lost = gap->lost;
+        uint64_t interval = gap->last - gap->first;
+        queue->gaps.first = (queue->gaps.first + 1U) % GAP_LIST_SIZE;
+        queue->gaps.count -= 1U;
+        queue->ovfl.flag = true;
+        if (queue->policy.marker) {
+            /* note: the loss is reported in-band by a marker element */
+            queue->policy.marker(element, MIN(queue->elemSize, maxbytes), lost, interval);
+            if (is_empty(queue))
+                clear_event(queue);
+            return true;
+        }
+    }
     if (queue->used > 0U) {
         (void)memcpy(element, &queue->queueElem[(queue->head * queue->elemSize)], MIN(queue->elemSize, maxbytes));
         queue->head = (queue->head + 1U) % queue->size;
         queue->used -= 1U;
+        if (queue->wait.producer)
+            (void)pthread_cond_signal(&queue->wait.space);
+        if (queue->used == 0U) {
+            if (is_empty(queue))
+                clear_event(queue);
+            /* note: an empty queue restarts at the beginning of its memory,
+             *       so that only the first pages are touched at low rates */
+            queue->head = 0;
+            queue->tail = 0;
+            if ((queue->mem.options & QUEUE_SHRINK_IDLE) && (queue->mem.touched > SHRINK_THRESHOLD))
+                shrink_memory(queue);
+        }
         return true;
     } else
         return false;
 }
 
+static size_t dequeue_elements(object_t *queue, void *elements, size_t count, size_t elemSize) {
+    size_t n = 0U;
+
+    assert(elements);
+
+    while ((n < count) && dequeue_element(queue, &((uint8_t*)elements)[n * elemSize], elemSize))
+        n++;
+    return n;
+}
+
+static void drop_element(object_t *queue) {
+    assert(queue);
+    assert(queue->used);
+
+    queue->head = (queue->head + 1U) % queue->size;
+    queue->used -= 1U;
+    loss_at_head(queue);
+}
+
+/*  ---  priority lanes  ---
+ *
+ *  Each lane is a small ring of its own. A full lane drops the new element,
+ *  or overwrites its oldest element with policy QUEUE_DROP_OLDEST (a lane
+ *  never blocks the producer). The loss is reported when the lane is served
+ *  next, in front of its remaining elements.
+ */
+static bool enqueue_lane(object_t *queue, struct lane_t *lane, const void *element, size_t nbytes) {
+    uint64_t now;
+
+    assert(queue);
+    assert(lane);
+    assert(lane->elem);
+
+    if (lane->used == lane->size) {
+        now = time_ms();
+        if (!lane->lost) {
+            lane->first = now;
+            queue->ovfl.gaps += 1U;
+        }
+        lane->last = now;
+        lane->lost += 1U;
+        queue->ovfl.counter += 1U;
+        if (queue->policy.mode != QUEUE_DROP_OLDEST)
+            return false;
+        lane->head = (lane->head + 1U) % lane->size;
+        lane->used -= 1U;
+    }
+    (void)memcpy(&lane->elem[(lane->tail * queue->elemSize)], element, MIN(queue->elemSize, nbytes));
+    lane->tail = (lane->tail + 1U) % lane->size;
+    lane->used += 1U;
+    return true;
+}
+
+static bool dequeue_lane(object_t *queue, struct lane_t *lane, void *element, size_t maxbytes) {
+    bool res = false;
+
+    assert(queue);
+    assert(lane);
+
+    if (lane->lost) {
+        /* elements have been lost in this lane */
+        queue->ovfl.flag = true;
+        if (queue->policy.marker) {
+            queue->policy.marker(element, MIN(queue->elemSize, maxbytes), lane->lost, lane->last - lane->first);
+            res = true;
+        }
+        lane->lost = 0U;
+    }
+    if (!res && (lane->used > 0U)) {
+        (void)memcpy(element, &lane->elem[(lane->head * queue->elemSize)], MIN(queue->elemSize, maxbytes));
+        lane->head = (lane->head + 1U) % lane->size;
+        lane->used -= 1U;
+        res = true;
+    }
+    if (is_empty(queue))
+        clear_event(queue);
+    return res;
+}
+
+/*  ---  taps  ---
+ *
+ *  Each element is published into the attached queues (taps) before it is
+ *  enqueued into the queue itself. A full tap drops the element on its own
+ *  (with its own loss accounting), the queue and the other taps are not
+ *  affected. The parent queue is locked while publishing (lock order is
+ *  always: queue, then tap).
+ */
+static void publish_taps(object_t *queue, const void *element, size_t nbytes) {
+    size_t i;
+
+    assert(queue);
+
+    for (i = 0U; i < queue->numTaps; i++) {
+        if (!queue->taps[i].filter || queue->taps[i].filter(element, nbytes, queue->taps[i].param))
+            (void)queue_enqueue((queue_t)queue->taps[i].queue, element, nbytes);
+    }
+    errno = 0;
+}
+
+static bool is_empty(const object_t *queue) {
+    size_t i;
+
+    assert(queue);
+
+    for (i = 0U; i < queue->numLanes; i++) {
+        if ((queue->lanes[i].used > 0U) || (queue->lanes[i].lost > 0U))
+            return false;
+    }
+    return (queue->used == 0U) && !gap_ahead(queue);
+}
+
+static size_t clear_lanes(object_t *queue) {
+    size_t i, n = 0U;
+
+    assert(queue);
+
+    for (i = 0U; i < queue->numLanes; i++) {
+        n += queue->lanes[i].used;
+        queue->lanes[i].used = 0U;
+        queue->lanes[i].head = 0U;
+        queue->lanes[i].tail = 0U;
+        queue->lanes[i].lost = 0U;
+    }
+    return n;
+}
+
+/*  ---  loss intervals  ---
+ *
+ *  Elements are numbered when they are enqueued (seqIn). The sequence number
+ *  of the oldest element is 'seqIn - used'. A gap is recorded in front of the
+ *  element with the given sequence number, consecutive losses are merged into
+ *  one gap. When the list is full, further losses are merged into the nearest
+ *  gap (the position of the gap is then no longer exact).
+ */
+static bool gap_ahead(const object_t *queue) {
+    assert(queue);
+
+    return (queue->gaps.count != 0U) &&
+           (queue->gaps.list[queue->gaps.first].seq == (queue->seqIn - queue->used));
+}
+
+static void loss_at_head(object_t *queue) {
+    struct gap_t *gap = NULL;
+    uint64_t seq = queue->seqIn - queue->used;
+    uint64_t now = time_ms();
+
+    assert(queue);
+
+    queue->ovfl.counter += 1U;
+    if (queue->gaps.count != 0U) {
+        gap = &queue->gaps.list[queue->gaps.first];
+        if ((gap->seq == (seq - 1U)) || (queue->gaps.count == GAP_LIST_SIZE))
+            gap->seq = seq;  /* the dropped element joins the gap */
+        else if (gap->seq != seq)
+            gap = NULL;
+    }
+    if (!gap) {
+        queue->gaps.first = (queue->gaps.first + GAP_LIST_SIZE - 1U) % GAP_LIST_SIZE;
+        queue->gaps.count += 1U;
+        gap = &queue->gaps.list[queue->gaps.first];
+        gap->seq = seq;
+        gap->lost = 0U;
+        gap->first = now;
+        queue->ovfl.gaps += 1U;
+    }
+    gap->lost += 1U;
+    gap->last = now;
+}
+
+static void loss_at_tail(object_t *queue) {
+    struct gap_t *gap = NULL;
+    uint64_t seq = queue->seqIn;
+    uint64_t now = time_ms();
+
+    assert(queue);
+
+    queue->ovfl.counter += 1U;
+    if (queue->gaps.count != 0U) {
+        gap = &queue->gaps.list[(queue->gaps.first + queue->gaps.count - 1U) % GAP_LIST_SIZE];
+        if ((gap->seq != seq) && (queue->gaps.count < GAP_LIST_SIZE))
+            gap = NULL;
+    }
+    if (!gap) {
+        gap = &queue->gaps.list[(queue->gaps.first + queue->gaps.count) % GAP_LIST_SIZE];
+        queue->gaps.count += 1U;
+        gap->seq = seq;
+        gap->lost = 0U;
+        gap->first = now;
+        queue->ovfl.gaps += 1U;
+    }
+    gap->lost += 1U;
+    gap->last = now;
+}
+
+static uint64_t time_ms(void) {
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000U) + ((uint64_t)now.tv_nsec / 1000000U);
+}
+
+/*  ---  event pipe  ---
+ *
+ *  The pipe holds one byte as long as the queue is not empty (level-triggered),
+ *  both functions are called from within the critical section.
+ */
+static void raise_event(object_t *queue) {
+    assert(queue);
+
+    if ((queue->event.fd[1] != -1) && !queue->event.flag) {
+        if (write(queue->event.fd[1], "", 1) == 1)
+            queue->event.flag = true;
+    }
+}
+
+static void clear_event(object_t *queue) {
+    uint8_t byte;
+
+    assert(queue);
+
+    if ((queue->event.fd[0] != -1) && queue->event.flag) {
+        while (read(queue->event.fd[0], &byte, 1) == 1)
+            ;
+        queue->event.flag = false;
+    }
+}
+
+/*  ---  queue memory  ---
+ *
+ *  The queue memory is mapped anonymously. Pages are committed when touched
+ *  (QUEUE_LAZY_COMMIT) or in advance, and the pages beyond a small working set
+ *  can be returned to the system when the queue runs empty (QUEUE_SHRINK_IDLE).
+ */
+static uint8_t *alloc_memory(struct memory_t *mem, size_t nbytes, uint32_t options) {
+    void *addr = MAP_FAILED;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    long page = sysconf(_SC_PAGESIZE);
+
+    assert(mem);
+    assert(nbytes);
+
+    mem->page = (page > 0) ? (size_t)page : (size_t)4096U;
+#if defined(MAP_NORESERVE)
+    if (options & QUEUE_LAZY_COMMIT)
+        flags |= MAP_NORESERVE;
+#endif
+#if defined(MAP_HUGETLB)
+    if (options & QUEUE_HUGE_PAGES) {
+        /* note: explicit huge pages must be provided by the system (vm.nr_hugepages),
+         *       they are reserved by the mapping (without MAP_NORESERVE, otherwise
+         *       a page fault would raise SIGBUS when the huge pages are exhausted) */
+        mem->length = ROUND_UP(nbytes, HUGE_PAGE_SIZE);
+        if ((addr = mmap(NULL, mem->length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)) != MAP_FAILED)
+            mem->page = HUGE_PAGE_SIZE;
+    }
+#endif
+    if (addr == MAP_FAILED) {
+        mem->length = ROUND_UP(nbytes, mem->page);
+        if ((addr = mmap(NULL, mem->length, PROT_READ | PROT_WRITE, flags, -1, 0)) == MAP_FAILED) {
+            /* errno set */
+            return NULL;
+        }
+#if defined(MADV_HUGEPAGE)
+        if (options & QUEUE_HUGE_PAGES)
+            (void)madvise(addr, mem->length, MADV_HUGEPAGE);  /* transparent huge pages */
+#endif
+    }
+    if (!(options & QUEUE_LAZY_COMMIT)) {
+        /* commit all pages in advance (no page faults in the producer) */
+        (void)memset(addr, 0x00, mem->length);
+        mem->touched = mem->length;
+    } else
+        mem->touched = 0U;
+    mem->options = options;
+    return (uint8_t*)addr;
+}
+
+static void free_memory(uint8_t *addr, const struct memory_t *mem) {
+    assert(addr);
+    assert(mem);
+
+    (void)munmap((void*)addr, mem->length);
+}
+
+static void shrink_memory(object_t *queue) {
+    size_t keep, end;
+
+    assert(queue);
+    assert(queue->used == 0U);
+
+    keep = ROUND_UP((size_t)SHRINK_WORKING_SET, queue->mem.page);
+    end = MIN(ROUND_UP(queue->mem.touched, queue->mem.page), queue->mem.length);
+    if (keep < end) {
+#if defined(MADV_DONTNEED)
+        /* note: the queue is empty, so the content of the pages can be discarded */
+        (void)madvise(&queue->queueElem[keep], end - keep, MADV_DONTNEED);
+#endif
+        queue->mem.touched = keep;
+    }
+}
+
 /*  ----------------------------------------------------------------------
  *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
  *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
@@ -86,6 +86,12 @@
 typedef void *sio_port_t;               /**< serial port (opaque data type) */
 
 /** @brief       reception callback function
+ *
+ *  @remarks     The callback is also called periodically with 'nbytes' = 0
+ *               when the serial line is idle (only when an idle interval is
+ *               set by 'sio_set_idle'), and once with 'buffer' = NULL
+ *               when the serial device has been disconnected (e.g. hang-up
+ *               or unplugged); the reception ends with this call.
  *
  *  @param[in]   receiver -  pointer to an instance to handle the received data
  *  @param[in]   buffer   -  data buffer with the received data
@@ -186,6 +192,25 @@ extern int sio_disconnect(sio_port_t port);
 extern int sio_get_attr(sio_port_t port, sio_attr_t* attr);
 
 
+/** @brief       sets the interval of the reception callback when the serial
+ *               line is idle (callback with 'nbytes' = 0).
+ *
+ *  @remarks     Without an idle interval the reception thread is blocked until
+ *               data is received. A new interval takes effect after the next
+ *               reception (or the end of the current interval).
+ *
+ *  @param[in]   port      - pointer to a port instance
+ *  @param[in]   interval  - idle interval (in [ms], 0 = off)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV   - no such device (invalid port instance)
+ */
+extern int sio_set_idle(sio_port_t port, uint16_t interval);
+
+
 /** @brief       transmits n data bytes via a serial communication device.
  *
  *  @remarks     A connection with the serial communication device must be
@@ -120,6 +120,7 @@ typedef struct serial_t_ {
     sio_attr_t attr;
     sio_recv_t callback;
     void *receiver;
+    uint16_t idle;
 } serial_t;
 
 
@@ -210,6 +211,7 @@ sio_port_t sio_create(sio_recv_t callback, void *receiver) {
         serial->attr.stopbits = STOPBITS1;
         serial->callback = callback;
         serial->receiver = receiver;
+        serial->idle = 0U;
     }
     /* return a pointer to the instance */
     return (sio_port_t)serial;
@@ -252,6 +254,20 @@ int sio_get_attr(sio_port_t port, sio_attr_t* attr) {
     return 0;
 }
 
+int sio_set_idle(sio_port_t port, uint16_t interval) {
+    serial_t *serial = (serial_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!serial) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* idle interval of the reception thread */
+    serial->idle = interval;
+    return 0;
+}
+
 int sio_signal(sio_port_t port) {
     serial_t *serial = (serial_t*)port;
 
@@ -404,10 +420,11 @@ static void *reception_loop(void *arg) {
         perror("serial");
         abort();
     }
-    /* blocking read */
+    /* blocking read (with idle timeout, if any) */
     fd_set rdfs;
-    FD_ZERO(&rdfs);
-    FD_SET(serial->fildes, &rdfs);
+    struct timeval idle;
+    uint16_t interval;
+    int ready = 0;
 
     /* thread cancellation */
     assert(pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL) == 0);
@@ -416,6 +433,7 @@ static void *reception_loop(void *arg) {
     /* the torture never stops */
     for (;;) {
         ssize_t nbytes;
+        ssize_t first = -1;
         uint8_t buffer[BUFFER_SIZE];
 
         do {
@@ -423,12 +441,29 @@ static void *reception_loop(void *arg) {
             SERIAL_DEBUG_ASYNC(buffer, nbytes);
             if ((nbytes > 0) && serial->callback)
                 serial->callback(serial->receiver, &buffer[0], (size_t)nbytes);
+            if (first < 0)
+                first = nbytes;
         } while (nbytes > 0);
 
-        if (select(serial->fildes+1, &rdfs, NULL, NULL, NULL) < 0) {
+        /* readable w/o data (hang-up) or I/O error: serial device disconnected */
+        if (((ready > 0) && (first == 0)) ||
+            ((nbytes < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))) {
+            if (serial->callback)
+                serial->callback(serial->receiver, NULL, 0U);
+            return NULL;
+        }
+        FD_ZERO(&rdfs);
+        FD_SET(serial->fildes, &rdfs);
+        interval = serial->idle;
+        idle.tv_sec = (time_t)(interval / 1000U);
+        idle.tv_usec = (suseconds_t)(interval % 1000U) * 1000;
+        if ((ready = select(serial->fildes+1, &rdfs, NULL, NULL, interval ? &idle : NULL)) < 0) {
             perror("serial");
             return NULL;
         }
+        /* no data received: serial line idle */
+        if ((ready == 0) && serial->callback)
+            serial->callback(serial->receiver, &buffer[0], 0U);
     }
     return NULL;
 }
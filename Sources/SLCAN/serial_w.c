@@ -112,6 +112,7 @@ typedef struct serial_t_ {
     sio_attr_t attr;
     sio_recv_t callback;
     void *receiver;
+    uint16_t idle;
     int running;
 } serial_t;
 
@@ -144,6 +145,7 @@ sio_port_t sio_create(sio_recv_t callback, void *receiver) {
         serial->attr.parity = PARITYNONE;
         serial->callback = callback;
         serial->receiver = receiver;
+        serial->idle = 0U;
         serial->running = 0;
     }
     /* return a pointer to the instance */
@@ -187,6 +189,20 @@ int sio_get_attr(sio_port_t port, sio_attr_t* attr) {
     return 0;
 }
 
+int sio_set_idle(sio_port_t port, uint16_t interval) {
+    serial_t *serial = (serial_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!serial) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* idle interval of the reception thread */
+    serial->idle = interval;
+    return 0;
+}
+
 int sio_signal(sio_port_t port) {
     serial_t *serial = (serial_t*)port;
 
@@ -421,11 +437,15 @@ static DWORD WINAPI reception_loop(LPVOID lpParam) {
 
         if (ReadFile(serial->hPort, buffer, 1, &nbytes, NULL)) {
             SERIAL_DEBUG_ASYNC(buffer, nbytes);
-            if ((nbytes > 0) && serial->callback)
+            /* note: no data received means the serial line is idle */
+            if (serial->callback && (nbytes || serial->idle))
                 serial->callback(serial->receiver, &buffer[0], (size_t)nbytes);
         }
-        else {
-            (void)ClearCommError(serial->hPort, &errors, NULL);
+        else if (!ClearCommError(serial->hPort, &errors, NULL)) {
+            /* serial device disconnected (e.g. unplugged) */
+            if (serial->callback)
+                serial->callback(serial->receiver, NULL, 0U);
+            serial->running = 0;
         }
     }
     return 0;
@@ -0,0 +1,383 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'shmem'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        shmem.h
+ *
+ *  @brief       Shared-memory rings for interprocess communication.
+ *
+ *  @remarks     A server process creates a named shared-memory object with
+ *               two rings: a broadcast ring into which the server publishes
+ *               elements for any number of client processes (single producer,
+ *               multiple consumers), and a post ring into which client processes
+ *               put elements for the server (multiple producers, single consumer).
+ *
+ *  @remarks     Each slot of the broadcast ring is guarded by a sequence lock,
+ *               so the server never waits for a client. Every client reads with
+ *               its own cursor; a client that falls behind by more than the ring
+ *               size loses the overwritten elements. Waiting is done by futexes
+ *               (Linux) and only when a ring is empty or full, so no system call
+ *               is made per element while data is flowing.
+ *
+ *  @note        POSIX only (shm_open/mmap). On Windows all functions fail
+ *               with errno set to ENOTSUP.
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @defgroup    shmem Shared-Memory Rings
+ *  @{
+ */
+#ifndef SHMEM_H_INCLUDED
+#define SHMEM_H_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define SHMEM_MAX_NAME   64U            /**< maximum length of an object name (incl. zero) */
+#define SHMEM_INFO_SIZE  64U            /**< size of the info block (number of bytes) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef void *shmem_t;                  /**< shared-memory rings (opaque data type) */
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief       makes the name of a shared-memory object from a device name,
+ *               e.g. '/dev/ttyUSB0' becomes '/slcan.dev.ttyUSB0'.
+ *
+ *  @param[out]  name    - buffer for the object name (SHMEM_MAX_NAME bytes)
+ *  @param[in]   prefix  - prefix of the object name (without a leading slash)
+ *  @param[in]   device  - device name (e.g. path of a TTY)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL        - invalid argument (name, prefix or device)
+ *  @retval      ENAMETOOLONG  - resulting name too long
+ */
+extern int shmem_name(char *name, const char *prefix, const char *device);
+
+
+/** @brief       creates a named shared-memory object with a broadcast ring
+ *               and a post ring (server side).
+ *
+ *  @remarks     The number of elements of both rings is rounded up to a power
+ *               of two. A stale object of a terminated server is replaced.
+ *
+ *  @remarks     By default the object is created with read and write access
+ *               for the owner and the group (0660), subject to the umask. An
+ *               explicit access mode is applied as given.
+ *
+ *  @param[in]   name      - name of the shared-memory object (e.g. '/slcan.tty')
+ *  @param[in]   numElem   - number of elements in the broadcast ring
+ *  @param[in]   numPost   - number of elements in the post ring
+ *  @param[in]   elemSize  - size of an element (number of bytes)
+ *  @param[in]   mode      - access mode of the object (e.g. 0660), or 0 for the default
+ *
+ *  @returns     pointer to a shared-memory instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (name, numElem, numPost, elemSize or mode)
+ *  @retval      EBUSY    - the object is owned by a running server
+ *  @retval      ENOMEM   - out of memory (insufficient storage space)
+ *  @retval      ENOTSUP  - not supported (e.g. on Windows)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'shm_open', 'ftruncate', 'mmap'
+ */
+extern shmem_t shmem_create(const char *name, size_t numElem, size_t numPost, size_t elemSize, unsigned int mode);
+
+
+/** @brief       attaches to a named shared-memory object (client side).
+ *
+ *  @remarks     The cursor of the client is set to the current position of
+ *               the broadcast ring, i.e. only elements published afterwards
+ *               are received.
+ *
+ *  @param[in]   name  - name of the shared-memory object
+ *
+ *  @returns     pointer to a shared-memory instance if successful, or NULL on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EINVAL   - invalid argument (name)
+ *  @retval      ENOENT   - no such object (server not running)
+ *  @retval      EPIPE    - the server has terminated
+ *  @retval      EPROTO   - incompatible object layout
+ *  @retval      ENOTSUP  - not supported (e.g. on Windows)
+ *  @retval      'errno'  - error code from called system functions:
+ *                          'shm_open', 'fstat', 'mmap'
+ */
+extern shmem_t shmem_attach(const char *name);
+
+
+/** @brief       detaches from the shared-memory object. The server removes
+ *               the object, clients waiting for elements get EPIPE.
+ *
+ *  @param[in]   shmem  - pointer to a shared-memory instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ */
+extern int shmem_destroy(shmem_t shmem);
+
+
+/** @brief       publishes n elements into the broadcast ring (server side).
+ *
+ *  @remarks     The function never blocks. Waiting clients are woken up
+ *               once per call, and only if a client is waiting.
+ *
+ *  @param[in]   shmem     - pointer to a shared-memory instance
+ *  @param[in]   elements  - pointer to an array of elements
+ *  @param[in]   count     - number of elements in the array
+ *
+ *  @returns     the number of elements published if successful, or a negative
+ *               value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ *  @retval      EINVAL   - invalid argument (elements)
+ *  @retval      EPERM    - operation not permitted (not the server)
+ */
+extern int shmem_publish(shmem_t shmem, const void *elements, size_t count);
+
+
+/** @brief       receives up to n elements from the broadcast ring (client side).
+ *
+ *  @remarks     The function waits for the first element only.
+ *
+ *  @param[in]   shmem     - pointer to a shared-memory instance
+ *  @param[out]  elements  - pointer to an array into which the elements are copied
+ *  @param[in]   count     - maximum number of elements to be copied
+ *  @param[in]   timeout   - time to wait for elements in the ring:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait im milliseconds
+ *
+ *  @returns     the number of elements copied if successful, or a negative
+ *               value on error.
+ *
+ *  @retval      -30  - when the ring is empty (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ *  @retval      EINVAL   - invalid argument (elements)
+ *  @retval      ENOMSG   - no data available (ring empty)
+ *  @retval      EPIPE    - the server has terminated
+ *
+ *  @remarks     If elements have been successfully copied, the value ENOSPC
+ *               in the system variable 'errno' indicates that elements have
+ *               been overwritten before the client could read them.
+ *               @see shmem_overflow
+ */
+extern int shmem_receive(shmem_t shmem, void *elements, size_t count, uint16_t timeout);
+
+
+/** @brief       skips all elements in the broadcast ring not yet received
+ *               (client side).
+ *
+ *  @param[in]   shmem  - pointer to a shared-memory instance
+ *
+ *  @returns     the number of elements skipped if successful, or a negative
+ *               value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ */
+extern int shmem_rewind(shmem_t shmem);
+
+
+/** @brief       puts one element into the post ring (client side).
+ *
+ *  @remarks     Any number of clients can post concurrently; a slot is
+ *               reserved lock-free and the server is woken up only if
+ *               it waits for elements.
+ *
+ *  @param[in]   shmem    - pointer to a shared-memory instance
+ *  @param[in]   element  - pointer to the element to be posted
+ *  @param[in]   timeout  - time to wait for a free slot in the ring:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking write, and any other
+ *                               value means the time to wait im milliseconds
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      -20  - when the ring is full (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ *  @retval      EINVAL   - invalid argument (element)
+ *  @retval      ENOSPC   - no space left (ring full)
+ *  @retval      EPIPE    - the server has terminated
+ */
+extern int shmem_post(shmem_t shmem, const void *element, uint16_t timeout);
+
+
+/** @brief       takes up to n elements from the post ring (server side).
+ *
+ *  @remarks     The function waits for the first element only.
+ *
+ *  @param[in]   shmem     - pointer to a shared-memory instance
+ *  @param[out]  elements  - pointer to an array into which the elements are copied
+ *  @param[in]   count     - maximum number of elements to be copied
+ *  @param[in]   timeout   - time to wait for elements in the ring (see above)
+ *
+ *  @returns     the number of elements copied if successful, or a negative
+ *               value on error.
+ *
+ *  @retval      -30  - when the ring is empty (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ *  @retval      EINVAL   - invalid argument (elements)
+ *  @retval      ENOMSG   - no data available (ring empty)
+ *  @retval      EPERM    - operation not permitted (not the server)
+ */
+extern int shmem_fetch(shmem_t shmem, void *elements, size_t count, uint16_t timeout);
+
+
+/** @brief       writes the info block of the shared-memory object (server side).
+ *
+ *  @remarks     The info block is a small record (e.g. for status and
+ *               settings of the server), guarded by a sequence lock.
+ *
+ *  @param[in]   shmem   - pointer to a shared-memory instance
+ *  @param[in]   info    - pointer to the data to be written
+ *  @param[in]   nbytes  - number of bytes (at most SHMEM_INFO_SIZE)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ *  @retval      EINVAL   - invalid argument (info or nbytes)
+ *  @retval      EPERM    - operation not permitted (not the server)
+ */
+extern int shmem_info_write(shmem_t shmem, const void *info, size_t nbytes);
+
+
+/** @brief       reads a consistent copy of the info block.
+ *
+ *  @param[in]   shmem   - pointer to a shared-memory instance
+ *  @param[out]  info    - pointer to a buffer for the data
+ *  @param[in]   nbytes  - number of bytes (at most SHMEM_INFO_SIZE)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ *  @retval      EINVAL   - invalid argument (info or nbytes)
+ *  @retval      EPIPE    - the server has terminated
+ */
+extern int shmem_info_read(shmem_t shmem, void *info, size_t nbytes);
+
+
+/** @brief       returns true when elements have been overwritten before the
+ *               client could read them.
+ *
+ *  @param[in]   shmem    - pointer to a shared-memory instance
+ *  @param[out]  counter  - number of lost elements (optional)
+ *
+ *  @returns     0 when no loss occurred, or a none-zero value otherwise.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      EFAULT   - bad address (invalid shared-memory instance)
+ */
+extern bool shmem_overflow(shmem_t shmem, uint64_t *counter);
+
+
+/** @brief       signals waiting objects of the calling process, if any.
+ *
+ *  @param[in]   shmem  - pointer to a shared-memory instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ */
+extern int shmem_signal(shmem_t shmem);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SHMEM_H_INCLUDED */
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,920 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'shmem'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        shmem.c
+ *
+ *  @brief       Shared-memory rings for interprocess communication.
+ *
+ *  @remarks     POSIX compatible variant (e.g. Linux, macOS)
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @addtogroup  shmem
+ *  @{
+ */
+#include "shmem.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <errno.h>
+#include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define SHMEM_MAGIC    0x53434C53U      /* 'SLCS' */
+#define SHMEM_VERSION  1U
+
+#define CACHE_LINE  64U
+
+#define ROUND_UP(n,p)  ((((n) + (p) - 1U) / (p)) * (p))
+
+#define DEFAULT_MODE  (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP)  /* owner and group (0660) */
+
+#define WAIT_SLICE  1000U               /* max. time of a single wait (in [ms]) */
+#define POLL_NSEC  1000000L             /* polling interval w/o futexes (in [ns]) */
+
+#define LOAD(ptr)  __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr)  __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define STORE(ptr,val)  __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define STORE_RELAXED(ptr,val)  __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+#define INCREMENT(ptr)  (void)__atomic_add_fetch(ptr, 1U, __ATOMIC_SEQ_CST)
+#define DECREMENT(ptr)  (void)__atomic_sub_fetch(ptr, 1U, __ATOMIC_SEQ_CST)
+#define LOAD_SEQ_CST(ptr)  __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct header_t_ {              /* layout of the shared memory: */
+    uint32_t magic;                     /*   magic number (written last) */
+    uint32_t version;                   /*   version of the layout */
+    uint64_t length;                    /*   size of the object (in bytes) */
+    uint64_t elemSize;                  /*   size of an element */
+    uint64_t slotSize;                  /*   size of a slot (sequence + element) */
+    uint64_t numElem;                   /*   number of slots in the broadcast ring */
+    uint64_t numPost;                   /*   number of slots in the post ring */
+    int32_t pid;                        /*   process id of the server */
+    uint32_t closed;                    /*   server has terminated */
+    struct info_t {                     /*   info block: */
+        uint32_t seq;                   /*     sequence lock */
+        uint8_t data[SHMEM_INFO_SIZE];  /*     payload */
+    } info;
+    struct broadcast_t {                /*   broadcast ring (single producer): */
+        uint64_t head;                  /*     number of published elements */
+        uint32_t event;                 /*     futex word (incremented on publish) */
+        uint32_t waiters;               /*     number of waiting clients */
+    } elem __attribute__((aligned(CACHE_LINE)));
+    struct post_t {                     /*   post ring (multiple producers): */
+        uint64_t head __attribute__((aligned(CACHE_LINE)));
+        uint64_t tail __attribute__((aligned(CACHE_LINE)));
+        uint32_t event;                 /*     futex word (incremented on post) */
+        uint32_t waiters;               /*     server waiting for elements */
+        uint32_t space;                 /*     futex word (incremented on fetch) */
+        uint32_t blocked;               /*     number of clients waiting for space */
+    } post;
+} header_t;
+
+typedef struct slot_t_ {                /* slot of a ring: */
+    uint64_t seq;                       /*   sequence number */
+    uint8_t data[];                     /*   element */
+} slot_t;
+
+typedef struct object_t_ {
+    header_t *hdr;
+    size_t length;
+    uint8_t *elemSlots;
+    uint8_t *postSlots;
+    size_t slotSize;
+    size_t elemSize;
+    uint64_t elemMask;
+    uint64_t postMask;
+    bool server;
+    char name[SHMEM_MAX_NAME];
+    uint64_t cursor;
+    struct overflow_t {
+        bool flag;
+        uint64_t counter;
+    } ovfl;
+    uint32_t signalled;
+} object_t;
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static size_t copy_elements(object_t *shmem, uint8_t *elements, size_t count);
+static size_t take_elements(object_t *shmem, uint8_t *elements, size_t count);
+static bool reserve_slot(object_t *shmem, uint64_t *pos);
+
+static bool server_alive(const header_t *hdr);
+static bool wait_event(uint32_t *word, uint32_t value, const struct timespec *deadline);
+static void wake_event(uint32_t *word);
+static void get_deadline(struct timespec *deadline, uint16_t timeout);
+
+static uint64_t round_pow2(size_t n);
+static header_t *map_object(int fd, size_t length);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int shmem_name(char *name, const char *prefix, const char *device) {
+    size_t len, i;
+
+    /* sanity check */
+    errno = 0;
+    if (!name || !prefix || !device || !*device) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* note: an object name has a leading slash and no further slashes */
+    len = (size_t)snprintf(name, SHMEM_MAX_NAME, "/%s%s%s", prefix,
+                           (*device != '/') ? "." : "", device);
+    if (len >= SHMEM_MAX_NAME) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    for (i = 1U; i < len; i++) {
+        if ((name[i] == '/') || (name[i] == '\\') || (name[i] == ':'))
+            name[i] = '.';
+    }
+    return 0;
+}
+
+shmem_t shmem_create(const char *name, size_t numElem, size_t numPost, size_t elemSize, unsigned int mode) {
+    object_t *object = (object_t*)NULL;
+    header_t *stale;
+    struct stat st;
+    size_t length;
+    uint64_t i;
+    int fd, retry;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!name || (name[0] != '/') || (strlen(name) >= SHMEM_MAX_NAME) ||
+        !numElem || !numPost || !elemSize || (numElem > (SIZE_MAX >> 2)) || (numPost > (SIZE_MAX >> 2)) ||
+        (mode > 0777U)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)malloc(sizeof(object_t))) == NULL) {
+        /* errno set */
+        return NULL;
+    }
+    bzero(object, sizeof(object_t));
+    object->elemSize = elemSize;
+    object->slotSize = ROUND_UP(sizeof(slot_t) + elemSize, sizeof(uint64_t));
+    object->elemMask = round_pow2(numElem) - 1U;
+    object->postMask = round_pow2(numPost) - 1U;
+    length = ROUND_UP(sizeof(header_t), CACHE_LINE);
+    if (((object->elemMask + 1U) > ((SIZE_MAX - length) / object->slotSize / 2U)) ||
+        ((object->postMask + 1U) > ((SIZE_MAX - length) / object->slotSize / 2U))) {
+        free(object);
+        errno = EINVAL;
+        return NULL;
+    }
+    length += (size_t)(object->elemMask + 1U) * object->slotSize;
+    length += (size_t)(object->postMask + 1U) * object->slotSize;
+    /* create the shared-memory object (replace a stale one) */
+    for (retry = 0; retry < 2; retry++) {
+        if ((fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, (mode_t)(mode ? mode : DEFAULT_MODE))) >= 0)
+            break;
+        if (errno != EEXIST) {
+            /* errno set */
+            free(object);
+            return NULL;
+        }
+        if ((fd = shm_open(name, O_RDWR, 0)) >= 0) {
+            stale = NULL;
+            if ((fstat(fd, &st) == 0) && ((size_t)st.st_size >= sizeof(header_t)))
+                stale = map_object(fd, sizeof(header_t));
+            (void)close(fd);
+            if (stale && (LOAD(&stale->magic) == SHMEM_MAGIC) && server_alive(stale)) {
+                (void)munmap((void*)stale, sizeof(header_t));
+                free(object);
+                errno = EBUSY;
+                return NULL;
+            }
+            if (stale)
+                (void)munmap((void*)stale, sizeof(header_t));
+        }
+        (void)shm_unlink(name);
+        fd = -1;
+    }
+    if (fd < 0) {
+        free(object);
+        errno = EBUSY;
+        return NULL;
+    }
+    /* note: the default mode is subject to the umask, an explicit one is not */
+    if (mode && (fchmod(fd, (mode_t)mode) < 0)) {
+        /* errno set */
+        int err = errno;
+        (void)close(fd);
+        (void)shm_unlink(name);
+        free(object);
+        errno = err;
+        return NULL;
+    }
+    if ((ftruncate(fd, (off_t)length) < 0) ||
+        ((object->hdr = map_object(fd, length)) == NULL)) {
+        /* errno set */
+        int err = errno;
+        (void)close(fd);
+        (void)shm_unlink(name);
+        free(object);
+        errno = err;
+        return NULL;
+    }
+    (void)close(fd);
+    /* initialize the layout (the magic number is written last) */
+    object->length = length;
+    object->elemSlots = (uint8_t*)object->hdr + ROUND_UP(sizeof(header_t), CACHE_LINE);
+    object->postSlots = object->elemSlots + (size_t)(object->elemMask + 1U) * object->slotSize;
+    object->server = true;
+    strncpy(object->name, name, SHMEM_MAX_NAME - 1U);
+    object->hdr->version = SHMEM_VERSION;
+    object->hdr->length = (uint64_t)length;
+    object->hdr->elemSize = (uint64_t)elemSize;
+    object->hdr->slotSize = (uint64_t)object->slotSize;
+    object->hdr->numElem = object->elemMask + 1U;
+    object->hdr->numPost = object->postMask + 1U;
+    object->hdr->pid = (int32_t)getpid();
+    /* note: the slots of the post ring are numbered with their position */
+    for (i = 0U; i <= object->postMask; i++)
+        ((slot_t*)(object->postSlots + (size_t)i * object->slotSize))->seq = i;
+    STORE(&object->hdr->magic, SHMEM_MAGIC);
+    return (shmem_t)object;
+}
+
+shmem_t shmem_attach(const char *name) {
+    object_t *object = (object_t*)NULL;
+    header_t *hdr;
+    struct stat st;
+    int fd, err;
+
+    /* reset errno variable */
+    errno = 0;
+    /* sanity check */
+    if (!name || (name[0] != '/') || (strlen(name) >= SHMEM_MAX_NAME)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* open the shared-memory object of the server */
+    if ((fd = shm_open(name, O_RDWR, 0)) < 0) {
+        /* errno set */
+        return NULL;
+    }
+    if (fstat(fd, &st) < 0) {
+        /* errno set */
+        err = errno;
+        (void)close(fd);
+        errno = err;
+        return NULL;
+    }
+    if (((size_t)st.st_size < sizeof(header_t)) ||
+        ((hdr = map_object(fd, (size_t)st.st_size)) == NULL)) {
+        err = errno ? errno : EPROTO;
+        (void)close(fd);
+        errno = err;
+        return NULL;
+    }
+    (void)close(fd);
+    /* check the layout and the server */
+    if ((LOAD(&hdr->magic) != SHMEM_MAGIC) || (hdr->version != SHMEM_VERSION) ||
+        (hdr->length != (uint64_t)st.st_size) || !hdr->numElem || !hdr->numPost ||
+        (hdr->slotSize < (sizeof(slot_t) + hdr->elemSize)) ||
+        (hdr->length < (ROUND_UP(sizeof(header_t), CACHE_LINE) + (hdr->numElem + hdr->numPost) * hdr->slotSize))) {
+        (void)munmap((void*)hdr, (size_t)st.st_size);
+        errno = EPROTO;
+        return NULL;
+    }
+    if (!server_alive(hdr)) {
+        (void)munmap((void*)hdr, (size_t)st.st_size);
+        errno = EPIPE;
+        return NULL;
+    }
+    /* C language constructor */
+    if ((object = (object_t*)malloc(sizeof(object_t))) == NULL) {
+        /* errno set */
+        err = errno;
+        (void)munmap((void*)hdr, (size_t)st.st_size);
+        errno = err;
+        return NULL;
+    }
+    bzero(object, sizeof(object_t));
+    object->hdr = hdr;
+    object->length = (size_t)st.st_size;
+    object->elemSize = (size_t)hdr->elemSize;
+    object->slotSize = (size_t)hdr->slotSize;
+    object->elemMask = hdr->numElem - 1U;
+    object->postMask = hdr->numPost - 1U;
+    object->elemSlots = (uint8_t*)hdr + ROUND_UP(sizeof(header_t), CACHE_LINE);
+    object->postSlots = object->elemSlots + (size_t)hdr->numElem * object->slotSize;
+    object->server = false;
+    strncpy(object->name, name, SHMEM_MAX_NAME - 1U);
+    /* note: only elements published from now on are received */
+    object->cursor = LOAD(&hdr->elem.head);
+    return (shmem_t)object;
+}
+
+int shmem_destroy(shmem_t shmem) {
+    object_t *object = (object_t*)shmem;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (object->server) {
+        /* wake up all clients, they will find the object closed */
+        STORE(&object->hdr->closed, 1U);
+        INCREMENT(&object->hdr->elem.event);
+        INCREMENT(&object->hdr->post.space);
+        wake_event(&object->hdr->elem.event);
+        wake_event(&object->hdr->post.space);
+        (void)shm_unlink(object->name);
+    }
+    (void)munmap((void*)object->hdr, object->length);
+    /* C language destructor */
+    free(object);
+    return 0;
+}
+
+int shmem_signal(shmem_t shmem) {
+    object_t *object = (object_t*)shmem;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* note: the waiter of this process returns, other waiters wait again */
+    STORE(&object->signalled, 1U);
+    wake_event(object->server ? &object->hdr->post.event : &object->hdr->elem.event);
+    return 0;
+}
+
+int shmem_publish(shmem_t shmem, const void *elements, size_t count) {
+    object_t *object = (object_t*)shmem;
+    const uint8_t *element = (const uint8_t*)elements;
+    slot_t *slot;
+    uint64_t head;
+    size_t n;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!elements) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!object->server) {
+        errno = EPERM;
+        return -1;
+    }
+    if (count > (size_t)INT_MAX)
+        count = (size_t)INT_MAX;
+    /* write the elements with their sequence lock (odd = being written) */
+    head = LOAD_RELAXED(&object->hdr->elem.head);
+    for (n = 0U; n < count; n++, head++) {
+        slot = (slot_t*)(object->elemSlots + (size_t)(head & object->elemMask) * object->slotSize);
+        STORE_RELAXED(&slot->seq, (head << 1) + 1U);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(slot->data, &element[n * object->elemSize], object->elemSize);
+        STORE(&slot->seq, (head << 1) + 2U);
+    }
+    STORE(&object->hdr->elem.head, head);
+    /* wake up waiting clients (no system call when nobody waits) */
+    if (n > 0U) {
+        INCREMENT(&object->hdr->elem.event);
+        if (LOAD_SEQ_CST(&object->hdr->elem.waiters) > 0U)
+            wake_event(&object->hdr->elem.event);
+    }
+    return (int)n;
+}
+
+int shmem_receive(shmem_t shmem, void *elements, size_t count, uint16_t timeout) {
+    object_t *object = (object_t*)shmem;
+    struct timespec deadline;
+    uint32_t event;
+    size_t n;
+    bool waited;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!elements) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (count > (size_t)INT_MAX)
+        count = (size_t)INT_MAX;
+    get_deadline(&deadline, timeout);
+    for (;;) {
+        /* copy the elements published since the last call, if any */
+        if ((n = copy_elements(object, (uint8_t*)elements, count)) > 0U) {
+            if (object->ovfl.flag) {
+                /* note: set ENOSPC only once per loss */
+                object->ovfl.flag = false;
+                errno = ENOSPC;
+            }
+            return (int)n;
+        }
+        if (LOAD(&object->hdr->closed)) {
+            errno = EPIPE;
+            return -1;
+        }
+        if ((timeout == 0U) || __atomic_exchange_n(&object->signalled, 0U, __ATOMIC_ACQ_REL))
+            break;
+        if (!server_alive(object->hdr)) {
+            errno = EPIPE;
+            return -1;
+        }
+        /* wait until an element is published (re-check after registration) */
+        event = LOAD_SEQ_CST(&object->hdr->elem.event);
+        INCREMENT(&object->hdr->elem.waiters);
+        waited = true;
+        if (LOAD_SEQ_CST(&object->hdr->elem.head) == object->cursor)
+            waited = wait_event(&object->hdr->elem.event, event, (timeout != UINT16_MAX) ? &deadline : NULL);
+        DECREMENT(&object->hdr->elem.waiters);
+        if (!waited)
+            break;
+    }
+    errno = ENOMSG;
+    return -30;
+}
+
+int shmem_rewind(shmem_t shmem) {
+    object_t *object = (object_t*)shmem;
+    uint64_t head;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    /* skip the elements not yet received */
+    head = LOAD(&object->hdr->elem.head);
+    head -= object->cursor;
+    object->cursor += head;
+    object->ovfl.flag = false;
+    return (head < (uint64_t)INT_MAX) ? (int)head : INT_MAX;
+}
+
+int shmem_post(shmem_t shmem, const void *element, uint16_t timeout) {
+    object_t *object = (object_t*)shmem;
+    struct timespec deadline;
+    slot_t *slot;
+    uint64_t pos;
+    uint32_t event;
+    bool waited;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!element) {
+        errno = EINVAL;
+        return -1;
+    }
+    get_deadline(&deadline, timeout);
+    for (;;) {
+        if (LOAD(&object->hdr->closed)) {
+            errno = EPIPE;
+            return -1;
+        }
+        /* reserve a slot in the post ring, if not full */
+        if (reserve_slot(object, &pos))
+            break;
+        if ((timeout == 0U) || __atomic_exchange_n(&object->signalled, 0U, __ATOMIC_ACQ_REL)) {
+            errno = ENOSPC;
+            return -20;
+        }
+        if (!server_alive(object->hdr)) {
+            errno = EPIPE;
+            return -1;
+        }
+        /* wait until the server has fetched elements (re-check after registration) */
+        event = LOAD_SEQ_CST(&object->hdr->post.space);
+        INCREMENT(&object->hdr->post.blocked);
+        waited = true;
+        pos = LOAD_SEQ_CST(&object->hdr->post.head);
+        slot = (slot_t*)(object->postSlots + (size_t)(pos & object->postMask) * object->slotSize);
+        if (LOAD_SEQ_CST(&slot->seq) != pos)
+            waited = wait_event(&object->hdr->post.space, event, (timeout != UINT16_MAX) ? &deadline : NULL);
+        DECREMENT(&object->hdr->post.blocked);
+        if (!waited) {
+            errno = ENOSPC;
+            return -20;
+        }
+    }
+    /* fill the slot and hand it over to the server */
+    slot = (slot_t*)(object->postSlots + (size_t)(pos & object->postMask) * object->slotSize);
+    memcpy(slot->data, element, object->elemSize);
+    STORE(&slot->seq, pos + 1U);
+    INCREMENT(&object->hdr->post.event);
+    if (LOAD_SEQ_CST(&object->hdr->post.waiters) > 0U)
+        wake_event(&object->hdr->post.event);
+    return 0;
+}
+
+int shmem_fetch(shmem_t shmem, void *elements, size_t count, uint16_t timeout) {
+    object_t *object = (object_t*)shmem;
+    struct timespec deadline;
+    slot_t *slot;
+    uint64_t tail;
+    uint32_t event;
+    size_t n;
+    bool waited;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!elements) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!object->server) {
+        errno = EPERM;
+        return -1;
+    }
+    if (count > (size_t)INT_MAX)
+        count = (size_t)INT_MAX;
+    get_deadline(&deadline, timeout);
+    for (;;) {
+        /* take the elements posted by the clients, if any */
+        if ((n = take_elements(object, (uint8_t*)elements, count)) > 0U)
+            return (int)n;
+        if ((timeout == 0U) || __atomic_exchange_n(&object->signalled, 0U, __ATOMIC_ACQ_REL))
+            break;
+        /* wait until an element is posted (re-check after registration) */
+        event = LOAD_SEQ_CST(&object->hdr->post.event);
+        INCREMENT(&object->hdr->post.waiters);
+        waited = true;
+        tail = LOAD_RELAXED(&object->hdr->post.tail);
+        slot = (slot_t*)(object->postSlots + (size_t)(tail & object->postMask) * object->slotSize);
+        if (LOAD_SEQ_CST(&slot->seq) != (tail + 1U))
+            waited = wait_event(&object->hdr->post.event, event, (timeout != UINT16_MAX) ? &deadline : NULL);
+        DECREMENT(&object->hdr->post.waiters);
+        if (!waited)
+            break;
+    }
+    errno = ENOMSG;
+    return -30;
+}
+
+int shmem_info_write(shmem_t shmem, const void *info, size_t nbytes) {
+    object_t *object = (object_t*)shmem;
+    uint32_t seq;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!info || (nbytes > SHMEM_INFO_SIZE)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!object->server) {
+        errno = EPERM;
+        return -1;
+    }
+    /* write the info block with its sequence lock (odd = being written) */
+    seq = LOAD_RELAXED(&object->hdr->info.seq);
+    STORE_RELAXED(&object->hdr->info.seq, seq + 1U);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(object->hdr->info.data, info, nbytes);
+    STORE(&object->hdr->info.seq, seq + 2U);
+    return 0;
+}
+
+int shmem_info_read(shmem_t shmem, void *info, size_t nbytes) {
+    object_t *object = (object_t*)shmem;
+    uint32_t seq;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (!info || (nbytes > SHMEM_INFO_SIZE)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* read until a consistent copy has been made */
+    do {
+        while ((seq = LOAD(&object->hdr->info.seq)) & 1U)
+            ;
+        memcpy(info, object->hdr->info.data, nbytes);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (LOAD_RELAXED(&object->hdr->info.seq) != seq);
+    if (!server_alive(object->hdr)) {
+        errno = EPIPE;
+        return -1;
+    }
+    return 0;
+}
+
+bool shmem_overflow(shmem_t shmem, uint64_t *counter) {
+    object_t *object = (object_t*)shmem;
+
+    /* sanity check */
+    errno = 0;
+    if (!object) {
+        errno = EFAULT;
+        return false;
+    }
+    if (counter)
+        *counter = object->ovfl.counter;
+    return (object->ovfl.counter > 0U) ? true : false;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+/*  ---  broadcast ring  ---
+ *
+ *  Slot i of the ring holds element n (i = n mod size) when its sequence
+ *  number is 2n+2; it is 2n+1 while the server writes the element. A client
+ *  copies the element and checks afterwards that the sequence number has not
+ *  changed, otherwise the element was overwritten and the client resumes at
+ *  the oldest element still in the ring.
+ */
+static size_t copy_elements(object_t *shmem, uint8_t *elements, size_t count) {
+    slot_t *slot;
+    uint64_t head, seq;
+    size_t n = 0U;
+
+    assert(shmem);
+    assert(elements);
+
+    head = LOAD(&shmem->hdr->elem.head);
+    while ((n < count) && (shmem->cursor != head)) {
+        /* resume at the oldest element when the client has been overtaken */
+        if ((head - shmem->cursor) > shmem->elemMask) {
+            shmem->ovfl.counter += (head - shmem->cursor) - shmem->elemMask;
+            shmem->ovfl.flag = true;
+            shmem->cursor = head - shmem->elemMask;
+        }
+        slot = (slot_t*)(shmem->elemSlots + (size_t)(shmem->cursor & shmem->elemMask) * shmem->slotSize);
+        seq = LOAD(&slot->seq);
+        if (seq == ((shmem->cursor << 1) + 2U)) {
+            memcpy(&elements[n * shmem->elemSize], slot->data, shmem->elemSize);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (LOAD_RELAXED(&slot->seq) == seq) {
+                shmem->cursor++;
+                n++;
+                continue;
+            }
+        }
+        /* note: the element has been overwritten meanwhile */
+        head = LOAD(&shmem->hdr->elem.head);
+        if ((head - shmem->cursor) <= shmem->elemMask) {
+            shmem->ovfl.counter += 1U;
+            shmem->ovfl.flag = true;
+            shmem->cursor += 1U;
+        }
+    }
+    return n;
+}
+
+/*  ---  post ring  ---
+ *
+ *  Slot i of the ring is free for position p when its sequence number is p,
+ *  and it holds the element of position p when its sequence number is p+1.
+ *  The clients reserve positions by an atomic compare-and-swap of the head,
+ *  the server hands the slot back with sequence number p+size.
+ */
+static bool reserve_slot(object_t *shmem, uint64_t *pos) {
+    slot_t *slot;
+    uint64_t seq;
+    int64_t diff;
+
+    assert(shmem);
+    assert(pos);
+
+    *pos = LOAD_RELAXED(&shmem->hdr->post.head);
+    for (;;) {
+        slot = (slot_t*)(shmem->postSlots + (size_t)(*pos & shmem->postMask) * shmem->slotSize);
+        seq = LOAD(&slot->seq);
+        diff = (int64_t)(seq - *pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&shmem->hdr->post.head, pos, *pos + 1U, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                return true;
+        }
+        else if (diff < 0)
+            return false;               /* ring is full */
+        else
+            *pos = LOAD_RELAXED(&shmem->hdr->post.head);
+    }
+}
+
+static size_t take_elements(object_t *shmem, uint8_t *elements, size_t count) {
+    slot_t *slot;
+    uint64_t tail;
+    size_t n = 0U;
+
+    assert(shmem);
+    assert(elements);
+
+    tail = LOAD_RELAXED(&shmem->hdr->post.tail);
+    while (n < count) {
+        slot = (slot_t*)(shmem->postSlots + (size_t)(tail & shmem->postMask) * shmem->slotSize);
+        if (LOAD(&slot->seq) != (tail + 1U))
+            break;
+        memcpy(&elements[n * shmem->elemSize], slot->data, shmem->elemSize);
+        STORE(&slot->seq, tail + shmem->postMask + 1U);
+        tail++;
+        n++;
+    }
+    if (n > 0U) {
+        STORE(&shmem->hdr->post.tail, tail);
+        /* wake up blocked clients (no system call when nobody waits) */
+        INCREMENT(&shmem->hdr->post.space);
+        if (LOAD_SEQ_CST(&shmem->hdr->post.blocked) > 0U)
+            wake_event(&shmem->hdr->post.space);
+    }
+    return n;
+}
+
+/*  ---  waiting  ---
+ */
+static bool server_alive(const header_t *hdr) {
+    assert(hdr);
+
+    if (LOAD(&hdr->closed))
+        return false;
+    /* note: a crashed server leaves the object behind */
+    if ((kill((pid_t)hdr->pid, 0) < 0) && (errno == ESRCH))
+        return false;
+    errno = 0;
+    return true;
+}
+
+static bool wait_event(uint32_t *word, uint32_t value, const struct timespec *deadline) {
+    struct timespec now, wait;
+    long long msec;
+
+    assert(word);
+
+    /* note: waits are sliced to notice a crashed server */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    msec = WAIT_SLICE;
+    if (deadline) {
+        msec = ((long long)(deadline->tv_sec - now.tv_sec) * 1000LL) +
+               ((long long)(deadline->tv_nsec - now.tv_nsec) / 1000000LL);
+        if (msec <= 0LL)
+            return false;
+        if (msec > (long long)WAIT_SLICE)
+            msec = (long long)WAIT_SLICE;
+    }
+    wait.tv_sec = (time_t)(msec / 1000LL);
+    wait.tv_nsec = (long)(msec % 1000LL) * 1000000L;
+#if defined(__linux__)
+    /* note: the futex is shared between processes (no FUTEX_PRIVATE_FLAG) */
+    (void)syscall(SYS_futex, word, FUTEX_WAIT, value, &wait, NULL, 0);
+#else
+    /* note: without futexes the event word is polled */
+    if ((wait.tv_sec > 0) || (wait.tv_nsec > POLL_NSEC)) {
+        wait.tv_sec = 0;
+        wait.tv_nsec = POLL_NSEC;
+    }
+    if (LOAD(word) == value)
+        (void)nanosleep(&wait, NULL);
+#endif
+    errno = 0;
+    return true;
+}
+
+static void wake_event(uint32_t *word) {
+    assert(word);
+#if defined(__linux__)
+    (void)syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+static void get_deadline(struct timespec *deadline, uint16_t timeout) {
+    assert(deadline);
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += (time_t)(timeout / 1000U);
+    deadline->tv_nsec += (long)(timeout % 1000U) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_nsec -= 1000000000L;
+        deadline->tv_sec += (time_t)1;
+    }
+}
+
+/*  ---  memory  ---
+ */
+static uint64_t round_pow2(size_t n) {
+    uint64_t pow2 = 1U;
+
+    while (pow2 < (uint64_t)n)
+        pow2 <<= 1;
+    return pow2;
+}
+
+static header_t *map_object(int fd, size_t length) {
+    void *addr;
+
+    addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+        return NULL;                    /* errno set */
+    return (header_t*)addr;
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
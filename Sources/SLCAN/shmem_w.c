@@ -0,0 +1,166 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later */
+/*
+ *  Software for Industrial Communication, Motion Control and Automation
+ *
+ *  Copyright (c) 2002-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+ *  All rights reserved.
+ *
+ *  Module 'shmem'
+ *
+ *  This module is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v3.0 (or any later version).
+ *  You can choose between one of them if you use this module.
+ *
+ *  BSD 2-Clause "Simplified" License:
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  THIS MODULE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS MODULE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  GNU General Public License v3.0 or later:
+ *  This module is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This module is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this module.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        shmem.c
+ *
+ *  @brief       Shared-memory rings for interprocess communication.
+ *
+ *  @remarks     Windows compatible variant (_WIN32 and _WIN64)
+ *
+ *  @note        Not realized yet, all functions fail with errno ENOTSUP.
+ *
+ *  @author      $Author$
+ *
+ *  @version     $Rev$
+ *
+ *  @addtogroup  shmem
+ *  @{
+ */
+#include "shmem.h"
+
+#include <string.h>
+#include <errno.h>
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int shmem_name(char *name, const char *prefix, const char *device) {
+    (void)name;
+    (void)prefix;
+    (void)device;
+    errno = ENOTSUP;
+    return -1;
+}
+
+shmem_t shmem_create(const char *name, size_t numElem, size_t numPost, size_t elemSize, unsigned int mode) {
+    (void)name;
+    (void)numElem;
+    (void)numPost;
+    (void)elemSize;
+    (void)mode;
+    errno = ENOTSUP;
+    return NULL;
+}
+
+shmem_t shmem_attach(const char *name) {
+    (void)name;
+    errno = ENOTSUP;
+    return NULL;
+}
+
+int shmem_destroy(shmem_t shmem) {
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_signal(shmem_t shmem) {
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_publish(shmem_t shmem, const void *elements, size_t count) {
+    (void)elements;
+    (void)count;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_receive(shmem_t shmem, void *elements, size_t count, uint16_t timeout) {
+    (void)elements;
+    (void)count;
+    (void)timeout;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_rewind(shmem_t shmem) {
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_post(shmem_t shmem, const void *element, uint16_t timeout) {
+    (void)element;
+    (void)timeout;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_fetch(shmem_t shmem, void *elements, size_t count, uint16_t timeout) {
+    (void)elements;
+    (void)count;
+    (void)timeout;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_info_write(shmem_t shmem, const void *info, size_t nbytes) {
+    (void)info;
+    (void)nbytes;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+int shmem_info_read(shmem_t shmem, void *info, size_t nbytes) {
+    (void)info;
+    (void)nbytes;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return -1;
+}
+
+bool shmem_overflow(shmem_t shmem, uint64_t *counter) {
+    if (counter)
+        *counter = 0U;
+    errno = !shmem ? EFAULT : ENOTSUP;
+    return false;
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -96,8 +96,14 @@ static const char version[] = "SLCAN Protocol (Serial-Line CAN), Version %i.%i.%
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <errno.h>
 #include <assert.h>
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 
 /*  -----------  options  ------------------------------------------------
@@ -155,16 +161,38 @@ static void _finalizer() {
 #define MAX_DLC(l)  (((l) < CAN_LEN_MAX) ? (l) : (CAN_DLC_MAX))
 
 #define BUFFER_SIZE 128U
+#define BATCH_SIZE 1024U  /* transmit buffer for batched writes (gateway, write_messages) */
+#define MESSAGE_SIZE 27U  /* max. length of an encoded message (29-bit, 8 bytes, CR) */
+#define MAX_POLLS 2U  /* max. number of pending polls of the status flags */
 #define RESPONSE_TIMEOUT  100U
 #define TRANSMIT_TIMEOUT  1000U
 
 #define PROTOCOL_LAWICEL  "Lawicel"
 #define PROTOCOL_CANABLE  "CANable"
 
+#if defined(_WIN32) || defined(_WIN64)
+#define LOCK_INIT(lck)  InitializeCriticalSection(&(lck))
+#define LOCK_DESTROY(lck)  DeleteCriticalSection(&(lck))
+#define ENTER_LOCK(lck)  EnterCriticalSection(&(lck))
+#define LEAVE_LOCK(lck)  LeaveCriticalSection(&(lck))
+#else
+#define LOCK_INIT(lck)  (void)pthread_mutex_init(&(lck), NULL)
+#define LOCK_DESTROY(lck)  (void)pthread_mutex_destroy(&(lck))
+#define ENTER_LOCK(lck)  (void)pthread_mutex_lock(&(lck))
+#define LEAVE_LOCK(lck)  (void)pthread_mutex_unlock(&(lck))
+#endif
+#define DRAIN_DELAY  TIMER_MSEC(1)
+
 
 /*  -----------  types  --------------------------------------------------
  */
 
+#if defined(_WIN32) || defined(_WIN64)
+typedef CRITICAL_SECTION lock_t;
+#else
+typedef pthread_mutex_t lock_t;
+#endif
+
 typedef struct slcan_t_ {               /* SLCAN communication instance: */
     sio_port_t port;                    /* - serial communication port */
     buffer_t response;                  /* - buffer for command response */
@@ -172,6 +200,66 @@ typedef struct slcan_t_ {               /* SLCAN communication instance: */
     uint8_t buffer[BUFFER_SIZE];        /* - receive buffer (reception loop) */
     size_t index;                       /* - write index of the receive buffer */
     bool ack;                           /* - ACK/NACK feedback enabled/disabled */
+    lock_t cmd_lock;                    /* - lock of the command/response channel */
+    lock_t tx_lock;                     /* - lock of the transmitter and the replies */
+    struct replies_t {                  /* - replies of the device (one per request): */
+        size_t ahead;                   /*   owed replies before the awaited one */
+        size_t behind;                  /*   owed replies after the awaited one */
+        bool awaited;                   /*   a reply is awaited by a command */
+        timer_obj_t timer;              /*   time-out of the owed replies */
+    } replies;
+    struct lane_map_t {                 /* - identifier-to-lane map: */
+        uint8_t std[CAN_STD_MASK + 1U]; /*   lane of each 11-bit identifier */
+        struct lane_class_t {           /*   classes of 29-bit identifier: */
+            uint32_t first;             /*   - first identifier (or code) */
+            uint32_t last;              /*   - last identifier (or code) */
+            uint32_t mask;              /*   - identifier mask */
+            uint8_t lane;               /*   - lane number */
+        } xtd[SLCAN_MAX_XTD_CLASSES];
+        size_t nxtd;                    /*   number of classes (29-bit) */
+        size_t size;                    /*   size of each lane (0 = no lanes) */
+    } lanes;
+    lock_t subs_lock;                   /* - lock of the subscriber table */
+    struct subscriber_t {               /* - subscribers (fan-out): */
+        queue_t queue;                  /*   message queue of the subscriber */
+        size_t readers;                 /*   number of threads reading the queue */
+        bool closing;                   /*   unsubscribe in progress */
+        struct sub_filter_t {           /*   acceptance filter: */
+            uint32_t stdCode;           /*   - code for 11-bit identifier */
+            uint32_t stdMask;           /*   - mask for 11-bit identifier */
+            uint32_t xtdCode;           /*   - code for 29-bit identifier */
+            uint32_t xtdMask;           /*   - mask for 29-bit identifier */
+        } filter;
+    } subs[SLCAN_MAX_SUBSCRIBERS];
+    struct gateway_t {                  /* - gateway (CAN-to-CAN): */
+        lock_t lock;                    /*   lock of the gateway (reception thread) */
+        struct slcan_t_ *target;        /*   port to forward to (NULL = none) */
+        uint8_t std[CAN_STD_MASK + 1U]; /*   route of each 11-bit identifier (0 = none) */
+        uint8_t xtd[SLCAN_MAX_ROUTES];  /*   routes for 29-bit identifier (in order) */
+        size_t nxtd;                    /*   number of routes (29-bit) */
+        struct gateway_route_t {        /*   routes: */
+            slcan_route_t route;        /*   - rule of the route */
+            timer_obj_t timer;          /*   - rate limit (time of the next message) */
+        } routes[SLCAN_MAX_ROUTES];
+        size_t count;                   /*   number of routes */
+        uint8_t buffer[BATCH_SIZE];     /*   transmit buffer (encoded messages) */
+        size_t index;                   /*   write index of the transmit buffer */
+        size_t pending;                 /*   number of messages in the transmit buffer */
+        uint64_t forwarded;             /*   number of forwarded messages */
+        uint64_t limited;               /*   number of messages dropped by rate limit */
+        uint64_t failed;                /*   number of messages not transmitted */
+    } gateway;
+    struct hook_t {                     /* - reception hooks: */
+        slcan_hook_t func;              /*   hook function (NULL = none) */
+        void *param;                    /*   parameter of the hook function */
+    } hooks[SLCAN_MAX_HOOKS];
+    struct status_t {                   /* - in-band status messages: */
+        bool events;                    /*   status messages enabled */
+        uint8_t flags;                  /*   last reported status flags */
+        uint16_t interval;              /*   polling interval (in [ms], 0 = off) */
+        timer_obj_t timer;              /*   time of the next poll */
+        size_t polls;                   /*   number of pending polls */
+    } status;
 } slcan_t;
 
 
@@ -180,9 +268,21 @@ typedef struct slcan_t_ {               /* SLCAN communication instance: */
 
 static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
                         uint8_t *response, size_t maxbytes, uint16_t timeout);
+static int send_request(slcan_t *slcan, const uint8_t *request, size_t nbytes, size_t replies);
+static void take_reply(slcan_t *slcan);
 static bool encode_message(const slcan_message_t *message, uint8_t *buffer, size_t *nbytes);
 static bool decode_message(slcan_message_t *message, const uint8_t *buffer, size_t nbytes);
 static void reception_loop(const void *port, const uint8_t *buffer, size_t nbytes);
+static void overflow_marker(void *element, size_t nbytes, uint64_t lost, uint64_t interval);
+static inline size_t lane_of(const slcan_t *slcan, uint32_t can_id);
+static bool accept_message(const void *element, size_t nbytes, const void *param);
+static void forward_message(slcan_t *slcan, const slcan_message_t *message);
+static bool consumed_message(slcan_t *slcan, const slcan_message_t *message);
+static int open_channel(slcan_t *slcan, uint8_t command);
+static int short_command(slcan_t *slcan, uint8_t *request, int length);
+static void status_message(slcan_t *slcan, uint32_t code, uint8_t flags);
+static void poll_status(slcan_t *slcan);
+static void flush_gateway(slcan_t *slcan);
 
 static int wait_for_bytes_sent(slcan_t *slcan, int nbytes);  // for CANable devices only
 
@@ -221,10 +321,12 @@ slcan_port_t slcan_create(size_t queueSize) {
     /* C language constructor */
     if ((slcan = (slcan_t*)malloc(sizeof(slcan_t))) != NULL) {
         (void)memset(slcan, 0x00, sizeof(slcan_t));
+        LOCK_INIT(slcan->subs_lock);
         /* create a serial port instance */
         slcan->port = sio_create(reception_loop, (void*)slcan);
         if (!slcan->port) {
             /* errno set */
+            LOCK_DESTROY(slcan->subs_lock);
             free(slcan);
             return NULL;
         }
@@ -233,6 +335,7 @@ slcan_port_t slcan_create(size_t queueSize) {
         if (!slcan->response) {
             /* errno set */
             (void)sio_destroy(slcan->port);
+            LOCK_DESTROY(slcan->subs_lock);
             free(slcan);
             return NULL;
         }
@@ -242,9 +345,16 @@ slcan_port_t slcan_create(size_t queueSize) {
             /* errno set */
             (void)buffer_destroy(slcan->response);
             (void)sio_destroy(slcan->port);
+            LOCK_DESTROY(slcan->subs_lock);
             free(slcan);
             return NULL;
         }
+        /* report lost messages in-band by status messages */
+        (void)queue_marker(slcan->messages, overflow_marker);
+        /* initialize the locks of the transmitter and the gateway */
+        LOCK_INIT(slcan->cmd_lock);
+        LOCK_INIT(slcan->tx_lock);
+        LOCK_INIT(slcan->gateway.lock);
         /* initialize reception buffer */
         slcan->index = 0U;
         /* enable ACK/NACK feedback */
@@ -258,6 +368,7 @@ slcan_port_t slcan_create(size_t queueSize) {
 EXPORT
 int slcan_destroy(slcan_port_t port) {
     slcan_t *slcan = (slcan_t*)port;
+    int i;
 
     /* sanity check */
     errno = 0;
@@ -272,8 +383,14 @@ int slcan_destroy(slcan_port_t port) {
         (void)sio_destroy(slcan->port);
     if (slcan->response)
         (void)buffer_destroy(slcan->response);
+    for (i = 0; i < (int)SLCAN_MAX_SUBSCRIBERS; i++)
+        (void)slcan_unsubscribe(port, i);
     if (slcan->messages)
         (void)queue_destroy(slcan->messages);
+    LOCK_DESTROY(slcan->subs_lock);
+    LOCK_DESTROY(slcan->cmd_lock);
+    LOCK_DESTROY(slcan->tx_lock);
+    LOCK_DESTROY(slcan->gateway.lock);
     /* C language destructor */
     free(slcan);
     return 0;
@@ -425,7 +542,7 @@ int slcan_setup_bitrate(slcan_port_t port, uint8_t index) {
         }
     } else {
         /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
-        res = sio_transmit(slcan->port, request, 3);
+        res = send_request(slcan, request, 3, 0U);
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
          *       When a wrong number of bytes has been transmitted this will
@@ -488,11 +605,58 @@ int slcan_setup_btr(slcan_port_t port, uint16_t btr) {
 
 EXPORT
 int slcan_open_channel(slcan_port_t port) {
-    slcan_t *slcan = (slcan_t*)port;
+    int res = open_channel((slcan_t*)port, 'O');
+
+    SLCAN_DEBUG_INFO("slcan_open_channel (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_listen_channel(slcan_port_t port) {
+    int res = open_channel((slcan_t*)port, 'L');
+
+    SLCAN_DEBUG_INFO("slcan_listen_channel (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_silent_mode(slcan_port_t port, bool on) {
+    uint8_t request[3] = {'M','0','\r'};
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!port || !((slcan_t*)port)->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* send command 'Set mode' (CANable: M0 = normal, M1 = silent) */
+    request[1] = on ? '1' : '0';
+    res = short_command((slcan_t*)port, request, 3);
+    SLCAN_DEBUG_INFO("slcan_silent_mode (%i)\n", res);
+    return res;
+}
+
+EXPORT
+int slcan_auto_retransmit(slcan_port_t port, bool on) {
+    uint8_t request[3] = {'A','1','\r'};
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!port || !((slcan_t*)port)->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* send command 'Set auto-retransmit' (CANable: A0 = off, A1 = on) */
+    request[1] = on ? '1' : '0';
+    res = short_command((slcan_t*)port, request, 3);
+    SLCAN_DEBUG_INFO("slcan_auto_retransmit (%i)\n", res);
+    return res;
+}
+
+static int open_channel(slcan_t *slcan, uint8_t command) {
     uint8_t request[2] = {'O','\r'};
-    uint8_t response[1];
-    int nbytes;
-    int res = -1;
 
     /* sanity check */
     errno = 0;
@@ -500,12 +664,25 @@ int slcan_open_channel(slcan_port_t port) {
         errno = ENODEV;
         return -1;
     }
+    request[0] = command;
     /* clear the message queue */
     (void)queue_clear(slcan->messages);  // FIXME: (?)
+    /* no polls pending (responses of a closed channel are lost) */
+    slcan->status.polls = 0U;
     /* send command 'Open the CAN channel' */
+    return short_command(slcan, request, 2);
+}
+
+static int short_command(slcan_t *slcan, uint8_t *request, int length) {
+    uint8_t response[1];
+    int nbytes;
+    int res = -1;
+
+    assert(slcan);
+    assert(request);
     if (slcan->ack) {
         /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
-        nbytes = send_command(slcan, request, 2, response, 1, RESPONSE_TIMEOUT);
+        nbytes = send_command(slcan, request, (size_t)length, response, 1, RESPONSE_TIMEOUT);
         if ((nbytes == 1) && (response[0] == '\r')) {
             res = 0;
         }
@@ -520,18 +697,20 @@ int slcan_open_channel(slcan_port_t port) {
         }
     } else {
         /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
-        res = sio_transmit(slcan->port, request, 2);
+        res = send_request(slcan, request, (size_t)length, 0U);
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
          *       When a wrong number of bytes has been transmitted this will
          *       be interpreted as the sender or the receiver is busy (EBUSY).
          */
-        if (res != 2) {
+        if (res != length) {
             errno = EBUSY;
             res = -1;
         }
+        else {
+            res = 0;
+        }
     }
-    SLCAN_DEBUG_INFO("slcan_open_channel (%i)\n", res);
     return res;
 }
 
@@ -567,7 +746,7 @@ int slcan_close_channel(slcan_port_t port) {
         }
     } else {
         /* CANable SLCAN protocol (w/o ACK/NACK feaadback) */
-        res = sio_transmit(slcan->port, request, 2);
+        res = send_request(slcan, request, 2, 0U);
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
          *       When a wrong number of bytes has been transmitted this will
@@ -578,6 +757,8 @@ int slcan_close_channel(slcan_port_t port) {
             res = -1;
         }
     }
+    /* no polls pending (responses of a closed channel are lost) */
+    slcan->status.polls = 0U;
     SLCAN_DEBUG_INFO("slcan_close_channel (%i)\n", res);
     return res;
 }
@@ -606,38 +787,33 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
         errno = EFAULT;
         return -99;
     }
-    /* clear pending response, if any */
-    (void)buffer_clear(slcan->response);
     /* send CAN message to the device via serial port */
-    nbytes = sio_transmit(slcan->port, buffer, length);
-    if (nbytes == (int)length) {
-        if (slcan->ack) {
-            /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
-            uint8_t response[2];
-            /* wait for response in the reception buffer */
-            nbytes = buffer_get(slcan->response, (void*)response, 2, TRANSMIT_TIMEOUT);
-            if ((nbytes == 2) && (response[1] == '\r') &&
-                ((((response[0] == 'z') && ((buffer[0] == 't') || (buffer[0] == 'r')))) ||
-                    (((response[0] == 'Z') && ((buffer[0] == 'T') || (buffer[0] == 'R')))))) {
-                res = 0;
-            }
-            else if (nbytes >= 0) {
-                /* note: Variable 'errno' is set by the called functions according
-                 *       to their result. On error they return a negative value.
-                 *       Receiving a wrong number of bytes will be interpreted as
-                 *       protocol error (EBADMSG).
-                 */
-                errno = EBADMSG;
-                res = -1;
-            }
-        } else {
-            /* CANable SLCAN protocol (w/o ACK/NACK feedback) */
-            /* note: As the transmission is not confirmed by the CANable device
-             *       and data may be lost during bulk transmission, we have to
-             *       wait until all data bytes has been certainly sent.
+    if (slcan->ack) {
+        /* Lawicel SLCAN protocol (with ACK/NACK feaadback) */
+        uint8_t response[2];
+        /* wait for response in the reception buffer */
+        nbytes = send_command(slcan, buffer, length, response, 2, TRANSMIT_TIMEOUT);
+        if ((nbytes == 2) && (response[1] == '\r') &&
+            ((((response[0] == 'z') && ((buffer[0] == 't') || (buffer[0] == 'r')))) ||
+                (((response[0] == 'Z') && ((buffer[0] == 'T') || (buffer[0] == 'R')))))) {
+            res = 0;
+        }
+        else if (nbytes >= 0) {
+            /* note: Variable 'errno' is set by the called functions according
+             *       to their result. On error they return a negative value.
+             *       Receiving a wrong number of bytes will be interpreted as
+             *       protocol error (EBADMSG).
              */
-            res = wait_for_bytes_sent(slcan, nbytes);
+            errno = EBADMSG;
+            res = -1;
         }
+    } else if ((nbytes = send_request(slcan, buffer, length, 0U)) == (int)length) {
+        /* CANable SLCAN protocol (w/o ACK/NACK feedback) */
+        /* note: As the transmission is not confirmed by the CANable device
+         *       and data may be lost during bulk transmission, we have to
+         *       wait until all data bytes has been certainly sent.
+         */
+        res = wait_for_bytes_sent(slcan, nbytes);
     } else if (nbytes >= 0) {
         /* note: Variable 'errno' is set by the called functions according to
          *       their result. On error they return a negative value.
@@ -651,6 +827,50 @@ int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint1
     return res;
 }
 
+EXPORT
+int slcan_write_messages(slcan_port_t port, const slcan_message_t *messages, size_t count) {
+    slcan_t *slcan = (slcan_t*)port;
+    uint8_t buffer[BATCH_SIZE];
+    size_t index = 0U, length;
+    size_t n, sent = 0U;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!messages || !count || (count > (size_t)INT_MAX)) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* encode the CAN messages and send them in as few serial writes as possible */
+    /* note: The ACK/NACK feedback of the device is owed, not awaited.
+     */
+    for (n = 0U; n < count; n++) {
+        (void)encode_message(&messages[n], &buffer[index], &length);
+        index += length;
+        if (((index + MESSAGE_SIZE) > BATCH_SIZE) || ((n + 1U) == count)) {
+            if ((res = send_request(slcan, buffer, index, slcan->ack ? (n + 1U - sent) : 0U)) != (int)index) {
+                /* note: the messages written completely before a short write are sent */
+                for (length = 0U; (res > 0) && (length < (size_t)res); length++)
+                    sent += (buffer[length] == '\r') ? 1U : 0U;
+                break;
+            }
+            sent = n + 1U;
+            index = 0U;
+        }
+    }
+    if (!sent) {
+        if (!errno)
+            errno = EBUSY;
+        return -1;
+    }
+    SLCAN_DEBUG_INFO("slcan_write_messages (%i)\n", (int)sent);
+    return (int)sent;
+}
+
 EXPORT
 int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t timeout) {
     slcan_t *slcan = (slcan_t*)port;
@@ -670,10 +890,8 @@ int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t tim
     res = queue_dequeue(slcan->messages, (void*)message, sizeof(slcan_message_t), timeout);
     if (res == (int)sizeof(slcan_message_t)) {
         /* note: On success value 0 will be returned (CAN API compatible).
-         *       In case of a queue overflow variable 'errno' will be set.
+         *       In case of a queue overflow variable 'errno' is set (ENOSPC).
          */
-        if (queue_overflow(slcan->messages, NULL))
-            errno = ENOSPC;
         res = 0;
     } else if (res >= 0) {
         /* note: The queue elements are of type void* and may be truncated
@@ -690,6 +908,428 @@ int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t tim
     return (int)res;
 }
 
+EXPORT
+int slcan_read_messages(slcan_port_t port, slcan_message_t *messages, size_t count, uint16_t timeout) {
+    slcan_t *slcan = (slcan_t*)port;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->port) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!messages || !count) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* get up to n messages from the message queue, if any */
+    res = queue_dequeue_n(slcan->messages, (void*)messages, count, sizeof(slcan_message_t), timeout);
+    if (res > 0) {
+        /* note: On success the number of messages will be returned.
+         *       In case of a queue overflow variable 'errno' is set (ENOSPC).
+         */
+    } else if (res >= 0) {
+        errno = ENOMSG;
+        res = -30;
+    } else {
+        /* note: CAN API compatible error codes will be returned on error. */
+    }
+    if (res != -30)  // when not empty
+        SLCAN_DEBUG_INFO("slcan_read_messages (%i)\n", res);
+    return (int)res;
+}
+
+EXPORT
+int slcan_queue_status(slcan_port_t port, slcan_queue_t *status) {
+    slcan_t *slcan = (slcan_t*)port;
+    size_t used = 0U, size = 0U, high = 0U;
+    uint64_t ovfl = 0U, gaps = 0U;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!status) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* get the status of the message queue */
+    if (queue_status(slcan->messages, &used, &size, &high) < 0)
+        return -1;
+    (void)queue_overflow(slcan->messages, &ovfl, &gaps);
+    status->size = (uint32_t)size;
+    status->used = (uint32_t)used;
+    status->high = (uint32_t)high;
+    status->ovfl = ovfl;
+    status->gaps = gaps;
+    return 0;
+}
+
+EXPORT
+int slcan_queue_resize(slcan_port_t port, size_t queueSize, uint32_t options) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* reallocate the message queue (note: the options are the same as for the queue) */
+    return queue_resize(slcan->messages, queueSize, options);
+}
+
+EXPORT
+int slcan_queue_policy(slcan_port_t port, uint8_t policy, uint16_t timeout) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* set the overflow policy (note: the policies are the same as for the queue) */
+    return queue_policy(slcan->messages, policy, timeout);
+}
+
+EXPORT
+int slcan_lane_size(slcan_port_t port, size_t laneSize) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* set up the priority lanes (or remove them) */
+    if (queue_lanes(slcan->messages, laneSize ? SLCAN_MAX_LANES : 0U, laneSize) < 0)
+        return -1;
+    if (!laneSize) {
+        memset(slcan->lanes.std, 0, sizeof(slcan->lanes.std));
+        slcan->lanes.nxtd = 0U;
+    }
+    slcan->lanes.size = laneSize;
+    return 0;
+}
+
+EXPORT
+int slcan_lane_class(slcan_port_t port, uint32_t first, uint32_t last, uint32_t mask, bool xtd, uint8_t lane) {
+    slcan_t *slcan = (slcan_t*)port;
+    uint32_t id;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if ((first > last) || (last > (xtd ? CAN_XTD_MASK : CAN_STD_MASK)) || (lane > SLCAN_MAX_LANES)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (xtd && (slcan->lanes.nxtd >= SLCAN_MAX_XTD_CLASSES)) {
+        errno = ENOSPC;
+        return -1;
+    }
+    /* set up the priority lanes on first call */
+    if (!slcan->lanes.size && (slcan_lane_size(port, SLCAN_LANE_SIZE) < 0))
+        return -1;
+    /* 11-bit identifier: precompute the lane of each identifier */
+    if (!xtd) {
+        for (id = 0U; id <= CAN_STD_MASK; id++) {
+            if ((first <= (id & mask)) && ((id & mask) <= last))
+                slcan->lanes.std[id] = lane;
+        }
+    }
+    /* 29-bit identifier: add the class to the list */
+    else {
+        slcan->lanes.xtd[slcan->lanes.nxtd].first = first;
+        slcan->lanes.xtd[slcan->lanes.nxtd].last = last;
+        slcan->lanes.xtd[slcan->lanes.nxtd].mask = mask & CAN_XTD_MASK;
+        slcan->lanes.xtd[slcan->lanes.nxtd].lane = lane;
+        slcan->lanes.nxtd += 1U;
+    }
+    return 0;
+}
+
+EXPORT
+int slcan_lane_reset(slcan_port_t port) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* all identifiers to the message queue (the lanes are kept) */
+    memset(slcan->lanes.std, 0, sizeof(slcan->lanes.std));
+    slcan->lanes.nxtd = 0U;
+    return 0;
+}
+
+EXPORT
+int slcan_subscribe(slcan_port_t port, size_t queueSize, uint32_t stdCode, uint32_t stdMask,
+                                                         uint32_t xtdCode, uint32_t xtdMask) {
+    slcan_t *slcan = (slcan_t*)port;
+    queue_t queue = NULL;
+    int i;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!queueSize) {
+        errno = EINVAL;
+        return -1;
+    }
+    ENTER_LOCK(slcan->subs_lock);
+    /* find a free subscriber */
+    for (i = 0; i < (int)SLCAN_MAX_SUBSCRIBERS; i++) {
+        if (!slcan->subs[i].queue)
+            break;
+    }
+    if (i == (int)SLCAN_MAX_SUBSCRIBERS) {
+        LEAVE_LOCK(slcan->subs_lock);
+        errno = ENOSPC;
+        return -1;
+    }
+    /* create a message queue for the subscriber */
+    if ((queue = queue_create(queueSize, sizeof(slcan_message_t))) == NULL) {
+        /* errno set */
+        LEAVE_LOCK(slcan->subs_lock);
+        return -1;
+    }
+    (void)queue_marker(queue, overflow_marker);
+    slcan->subs[i].filter.stdCode = stdCode & stdMask & CAN_STD_MASK;
+    slcan->subs[i].filter.stdMask = stdMask & CAN_STD_MASK;
+    slcan->subs[i].filter.xtdCode = xtdCode & xtdMask & CAN_XTD_MASK;
+    slcan->subs[i].filter.xtdMask = xtdMask & CAN_XTD_MASK;
+    /* attach the subscriber queue to the message queue */
+    if (queue_attach(slcan->messages, queue, accept_message, &slcan->subs[i].filter) < 0) {
+        /* errno set */
+        (void)queue_destroy(queue);
+        LEAVE_LOCK(slcan->subs_lock);
+        return -1;
+    }
+    slcan->subs[i].queue = queue;
+    slcan->subs[i].readers = 0U;
+    slcan->subs[i].closing = false;
+    LEAVE_LOCK(slcan->subs_lock);
+    return i;
+}
+
+EXPORT
+int slcan_unsubscribe(slcan_port_t port, int subscriber) {
+    slcan_t *slcan = (slcan_t*)port;
+    struct subscriber_t *sub;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if ((subscriber < 0) || (subscriber >= (int)SLCAN_MAX_SUBSCRIBERS)) {
+        errno = EINVAL;
+        return -1;
+    }
+    sub = &slcan->subs[subscriber];
+    ENTER_LOCK(slcan->subs_lock);
+    if (!sub->queue || sub->closing) {
+        LEAVE_LOCK(slcan->subs_lock);
+        errno = EINVAL;
+        return -1;
+    }
+    /* detach the subscriber queue (no more messages are published into it) */
+    (void)queue_detach(slcan->messages, sub->queue);
+    sub->closing = true;
+    /* wake up the readers of the queue until the last one has left */
+    while (sub->readers > 0U) {
+        (void)queue_signal(sub->queue);
+        LEAVE_LOCK(slcan->subs_lock);
+        (void)timer_delay(DRAIN_DELAY);
+        ENTER_LOCK(slcan->subs_lock);
+    }
+    (void)queue_destroy(sub->queue);
+    sub->queue = NULL;
+    sub->closing = false;
+    LEAVE_LOCK(slcan->subs_lock);
+    return 0;
+}
+
+EXPORT
+int slcan_read_subscriber(slcan_port_t port, int subscriber, slcan_message_t *messages, size_t count, uint16_t timeout) {
+    slcan_t *slcan = (slcan_t*)port;
+    struct subscriber_t *sub;
+    queue_t queue;
+    int res;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if ((subscriber < 0) || (subscriber >= (int)SLCAN_MAX_SUBSCRIBERS) || !messages || !count) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* the queue is not destroyed as long as there are readers */
+    sub = &slcan->subs[subscriber];
+    ENTER_LOCK(slcan->subs_lock);
+    if (!sub->queue || sub->closing) {
+        LEAVE_LOCK(slcan->subs_lock);
+        errno = EINVAL;
+        return -1;
+    }
+    queue = sub->queue;
+    sub->readers += 1U;
+    LEAVE_LOCK(slcan->subs_lock);
+    /* get up to n messages from the subscriber queue, if any */
+    res = queue_dequeue_n(queue, (void*)messages, count, sizeof(slcan_message_t), timeout);
+    ENTER_LOCK(slcan->subs_lock);
+    sub->readers -= 1U;
+    LEAVE_LOCK(slcan->subs_lock);
+    if (res == 0) {
+        errno = ENOMSG;
+        res = -30;
+    }
+    return (int)res;
+}
+
+EXPORT
+int slcan_gateway(slcan_port_t port, slcan_port_t target, const slcan_route_t *routes, size_t count) {
+    slcan_t *slcan = (slcan_t*)port;
+    struct gateway_t *gateway;
+    uint32_t id;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if ((target == port) || (count > SLCAN_MAX_ROUTES) || (count && (!target || !routes))) {
+        errno = EINVAL;
+        return -1;
+    }
+    gateway = &slcan->gateway;
+    /* stop forwarding (wait until the reception thread is not forwarding) */
+    ENTER_LOCK(gateway->lock);
+    gateway->target = NULL;
+    gateway->index = 0U;
+    gateway->pending = 0U;
+    memset(gateway->std, 0, sizeof(gateway->std));
+    gateway->nxtd = 0U;
+    gateway->count = 0U;
+    if (!target || !count) {
+        LEAVE_LOCK(gateway->lock);
+        return 0;
+    }
+    /* compile the routes into a lookup table (the first matching route applies) */
+    for (i = 0U; i < count; i++) {
+        gateway->routes[i].route = routes[i];
+        gateway->routes[i].route.mask &= routes[i].xtd ? CAN_XTD_MASK : CAN_STD_MASK;
+        gateway->routes[i].route.code &= gateway->routes[i].route.mask;
+        gateway->routes[i].timer = 0U;
+        /* 11-bit identifier: precompute the route of each identifier */
+        if (!routes[i].xtd) {
+            for (id = 0U; id <= CAN_STD_MASK; id++) {
+                if (!gateway->std[id] && ((id & gateway->routes[i].route.mask) == gateway->routes[i].route.code))
+                    gateway->std[id] = (uint8_t)(i + 1U);
+            }
+        }
+        /* 29-bit identifier: add the route to the list */
+        else
+            gateway->xtd[gateway->nxtd++] = (uint8_t)i;
+    }
+    gateway->count = count;
+    gateway->forwarded = 0U;
+    gateway->limited = 0U;
+    gateway->failed = 0U;
+    /* start forwarding */
+    gateway->target = (slcan_t*)target;
+    LEAVE_LOCK(gateway->lock);
+    return 0;
+}
+
+EXPORT
+int slcan_gateway_status(slcan_port_t port, slcan_gateway_t *status) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    if (!status) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* number of routes and message counters */
+    status->routes = slcan->gateway.target ? (uint32_t)slcan->gateway.count : 0U;
+    status->forwarded = slcan->gateway.forwarded;
+    status->limited = slcan->gateway.limited;
+    status->failed = slcan->gateway.failed;
+    return 0;
+}
+
+EXPORT
+int slcan_set_hook(slcan_port_t port, slcan_hook_t hook, void *param) {
+    slcan_t *slcan = (slcan_t*)port;
+    size_t i;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* remove the hook with the given parameter */
+    if (!hook) {
+        for (i = 0U; i < SLCAN_MAX_HOOKS; i++) {
+            if (slcan->hooks[i].func && (slcan->hooks[i].param == param))
+                slcan->hooks[i].func = NULL;
+        }
+        return 0;
+    }
+    /* install the hook into a free slot */
+    for (i = 0U; i < SLCAN_MAX_HOOKS; i++) {
+        if (!slcan->hooks[i].func) {
+            /* note: the parameter is set before the function (reception thread) */
+            slcan->hooks[i].param = param;
+            slcan->hooks[i].func = hook;
+            return 0;
+        }
+    }
+    errno = EBUSY;
+    return -1;
+}
+
+EXPORT
+int slcan_event_fd(slcan_port_t port) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan || !slcan->messages) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* get the event file descriptor of the message queue */
+    return queue_event_fd(slcan->messages);
+}
+
 EXPORT
 int slcan_status_flags(slcan_port_t port, slcan_flags_t *flags) {
     slcan_t *slcan = (slcan_t*)port;
@@ -795,6 +1435,48 @@ int slcan_failure_flags(slcan_port_t port, slcan_flags_t *flags) {
     return res;
 }
 
+EXPORT
+int slcan_status_events(slcan_port_t port, bool enable) {
+    slcan_t *slcan = (slcan_t*)port;
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* note: changes of the status flags are reported from now on */
+    slcan->status.flags = 0x00U;
+    slcan->status.events = enable;
+    SLCAN_DEBUG_INFO("slcan_status_events (%i)\n", 0);
+    return 0;
+}
+
+EXPORT
+int slcan_status_polling(slcan_port_t port, uint16_t interval) {
+    slcan_t *slcan = (slcan_t*)port;
+    uint8_t request[2] = {'F','\r'};
+
+    /* sanity check */
+    errno = 0;
+    if (!slcan) {
+        errno = ENODEV;
+        return -1;
+    }
+    /* the reception thread polls the status flags (woken up when idle) */
+    slcan->status.timer = timer_new(TIMER_MSEC(interval));
+    slcan->status.interval = interval;
+    slcan->status.polls = 0U;
+    (void)sio_set_idle(slcan->port, interval);
+    /* note: The first poll is sent at once. Its response is owed (not taken
+     *       as the response to a command) and wakes up the reception thread.
+     */
+    if (interval)
+        (void)send_request(slcan, request, 2, 1U);
+    SLCAN_DEBUG_INFO("slcan_status_polling (%i)\n", 0);
+    return 0;
+}
+
 EXPORT
 int slcan_acceptance_code(slcan_port_t port, uint32_t code) {
     slcan_t *slcan = (slcan_t*)port;
@@ -1044,10 +1726,18 @@ static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
     assert(request);
     assert(response);
 
+    /* one command at a time (one response buffer) */
+    ENTER_LOCK(slcan->cmd_lock);
+    ENTER_LOCK(slcan->tx_lock);
+    /* owed replies not received in time are lost (e.g. channel closed) */
+    if (slcan->replies.ahead && timer_timeout(&slcan->replies.timer))
+        slcan->replies.ahead = 0U;
     /* clear pending response, if any */
     (void)buffer_clear(slcan->response);
     /* send request to the device via serial port */
+    slcan->replies.awaited = true;
     res = sio_transmit(slcan->port, request, nbytes);
+    LEAVE_LOCK(slcan->tx_lock);
     if (res == (int)nbytes) {
         /* wait for response in the reception buffer */
         res = buffer_get(slcan->response, (void*)response, maxbytes, timeout);
@@ -1063,10 +1753,85 @@ static int send_command(slcan_t *slcan, const uint8_t *request, size_t nbytes,
         errno = EBUSY;
         res = -1;
     }
+    /* the reply is no longer awaited (e.g. on time-out) */
+    ENTER_LOCK(slcan->tx_lock);
+    if (slcan->replies.awaited) {
+        slcan->replies.awaited = false;
+        slcan->replies.ahead += slcan->replies.behind;
+        slcan->replies.behind = 0U;
+    }
+    LEAVE_LOCK(slcan->tx_lock);
+    LEAVE_LOCK(slcan->cmd_lock);
     /* return number of received bytes, or a negative value on error */
     return res;
 }
 
+static int send_request(slcan_t *slcan, const uint8_t *request, size_t nbytes, size_t replies) {
+    timer_obj_t timer;
+    size_t sent, n;
+    int res;
+
+    assert(slcan);
+    assert(request);
+
+    /* send request(s) to the device via serial port (one writer at a time) */
+    ENTER_LOCK(slcan->tx_lock);
+    res = sio_transmit(slcan->port, request, nbytes);
+    if ((res > 0) && ((size_t)res < nbytes) && (request[res - 1] != '\r')) {
+        /* note: A short write must not truncate a request on the serial line,
+         *       otherwise the device rejects it together with the next one.
+         *       The request in progress is completed (bounded by a time-out).
+         */
+        sent = (size_t)res;
+        timer = timer_new(TIMER_MSEC(TRANSMIT_TIMEOUT));
+        for (n = sent; ((n + 1U) < nbytes) && (request[n] != '\r'); n++);
+        while ((sent <= n) && !timer_timeout(&timer)) {
+            if ((res = sio_transmit(slcan->port, &request[sent], n + 1U - sent)) > 0)
+                sent += (size_t)res;
+            else if ((res < 0) && (errno != EAGAIN))
+                break;
+            else
+                (void)timer_delay(DRAIN_DELAY);
+        }
+        res = (int)sent;
+    }
+    /* note: The replies to the request(s) are not awaited. They are owed by
+     *       the device, and the reception loop discards them, so that they
+     *       are not taken as the response to a command. After a short write
+     *       only the replies to the requests sent are owed.
+     */
+    if ((res > 0) && replies) {
+        if ((size_t)res < nbytes) {
+            for (n = 0U, sent = 0U; n < (size_t)res; n++)
+                sent += (request[n] == '\r') ? 1U : 0U;
+            replies = (sent < replies) ? sent : replies;
+        }
+        if (slcan->replies.awaited)
+            slcan->replies.behind += replies;
+        else
+            slcan->replies.ahead += replies;
+        slcan->replies.timer = timer_new(TIMER_MSEC(TRANSMIT_TIMEOUT));
+    }
+    LEAVE_LOCK(slcan->tx_lock);
+    return res;
+}
+
+static void take_reply(slcan_t *slcan) {
+    /* a reply of the device: owed (discarded) or awaited (response buffer) */
+    ENTER_LOCK(slcan->tx_lock);
+    if (slcan->replies.ahead > 0U) {
+        slcan->replies.ahead--;
+    } else {
+        if (slcan->replies.awaited) {
+            slcan->replies.awaited = false;
+            slcan->replies.ahead = slcan->replies.behind;
+            slcan->replies.behind = 0U;
+        }
+        (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+    }
+    LEAVE_LOCK(slcan->tx_lock);
+}
+
 static int wait_for_bytes_sent(slcan_t *slcan, int nbytes) {
     int baud = 57600; /* baud rate (in [bps]) */
     sio_attr_t attr;
@@ -1200,10 +1965,13 @@ static bool decode_message(slcan_message_t *message, const uint8_t *buffer, size
 static void reception_loop(const void *port, const uint8_t *buffer, size_t nbytes) {
     slcan_t *slcan = (slcan_t*)port;
     slcan_message_t message;
+    uint8_t flags;
 
     if (slcan && buffer) {
         assert(slcan->response);
         assert(slcan->messages);
+        /* the gateway is not changed during the reception */
+        ENTER_LOCK(slcan->gateway.lock);
         for (size_t index = 0; index < nbytes; index++) {
             /* get next byte (asynchronous reception) */
             if ((slcan->index + 1) < BUFFER_SIZE)
@@ -1215,28 +1983,207 @@ static void reception_loop(const void *port, const uint8_t *buffer, size_t nbyte
                     /* message indication or confirmation? */
                     if (slcan->index > 2) {
                         /* new message received (indication) */
-                        if (decode_message(&message, slcan->buffer, slcan->index))
-                            (void)queue_enqueue(slcan->messages, &message, sizeof(slcan_message_t));
+                        if (decode_message(&message, slcan->buffer, slcan->index)) {
+                            if (slcan->gateway.target)
+                                forward_message(slcan, &message);
+                            if (!consumed_message(slcan, &message))
+                                (void)queue_enqueue_lane(slcan->messages, lane_of(slcan, message.can_id),
+                                                         &message, sizeof(slcan_message_t));
+                        }
                     } else {
                         /* confirmation of a sent message received */
-                        (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+                        take_reply(slcan);
                     }
+                } else if ((slcan->buffer[0] == 'F') && (slcan->index == 4)) {
+                    /* status flags received (response of a request or of a poll) */
+                    flags = (uint8_t)(CHR2BCD(slcan->buffer[1]) << 4);
+                    flags |= (uint8_t)CHR2BCD(slcan->buffer[2]);
+                    if (slcan->status.events && (flags != slcan->status.flags))
+                        status_message(slcan, SLCAN_STS_CONTROLLER, flags);
+                    slcan->status.flags = flags;
+                    if (slcan->status.polls > 0U)
+                        slcan->status.polls--;
+                    take_reply(slcan);
                 } else {
                     /* response of a sent request received */
-                    (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+                    take_reply(slcan);
                 }
                 /* done: reset reception buffer */
                 slcan->index = 0U;
             } else if (buffer[index] == '\a') {
                 /* Negative ACKnowledge [BEL] received */
-                (void)buffer_put(slcan->response, slcan->buffer, slcan->index);
+                if (slcan->status.polls > 0U)
+                    slcan->status.polls--;
+                take_reply(slcan);
                 /* done: reset reception buffer */
                 slcan->index = 0U;
             }
         }
+        /* transmit the forwarded messages of this reception at once */
+        if (slcan->gateway.pending)
+            flush_gateway(slcan);
+        LEAVE_LOCK(slcan->gateway.lock);
+        /* poll the status flags (also called when the serial line is idle) */
+        if (slcan->status.interval)
+            poll_status(slcan);
+    } else if (slcan && !buffer) {
+        /* serial line disconnected: last message of the reception */
+        if (slcan->status.events)
+            status_message(slcan, SLCAN_STS_DISCONNECTED, slcan->status.flags);
+    }
+}
+
+static inline size_t lane_of(const slcan_t *slcan, uint32_t can_id) {
+    uint32_t id;
+    size_t i;
+
+    if (!(can_id & CAN_XTD_FRAME))
+        return (size_t)slcan->lanes.std[can_id & CAN_STD_MASK];
+    for (i = 0U; i < slcan->lanes.nxtd; i++) {
+        id = can_id & slcan->lanes.xtd[i].mask;
+        if ((slcan->lanes.xtd[i].first <= id) && (id <= slcan->lanes.xtd[i].last))
+            return (size_t)slcan->lanes.xtd[i].lane;
+    }
+    return 0U;
+}
+
+static bool accept_message(const void *element, size_t nbytes, const void *param) {
+    const slcan_message_t *message = (const slcan_message_t*)element;
+    const struct sub_filter_t *filter = (const struct sub_filter_t*)param;
+
+    (void)nbytes;
+    if (message->can_id & CAN_XTD_FRAME)
+        return ((message->can_id & filter->xtdMask) == filter->xtdCode) ? true : false;
+    else
+        return ((message->can_id & filter->stdMask) == filter->stdCode) ? true : false;
+}
+
+static bool consumed_message(slcan_t *slcan, const slcan_message_t *message) {
+    slcan_hook_t func;
+    size_t i;
+
+    /* call the reception hooks until one consumes the message */
+    for (i = 0U; i < SLCAN_MAX_HOOKS; i++) {
+        if ((func = slcan->hooks[i].func) != NULL) {
+            if (func(message, slcan->hooks[i].param))
+                return true;
+        }
+    }
+    return false;
+}
+
+static void forward_message(slcan_t *slcan, const slcan_message_t *message) {
+    struct gateway_t *gateway = &slcan->gateway;
+    struct gateway_route_t *entry = NULL;
+    slcan_message_t forward;
+    uint32_t id, mask;
+    size_t i, length;
+
+    /* find the route of the message (11-bit: lookup table, 29-bit: list) */
+    if (!(message->can_id & CAN_XTD_FRAME)) {
+        if (gateway->std[message->can_id & CAN_STD_MASK])
+            entry = &gateway->routes[gateway->std[message->can_id & CAN_STD_MASK] - 1U];
+    } else {
+        for (i = 0U; i < gateway->nxtd; i++) {
+            if ((message->can_id & gateway->routes[gateway->xtd[i]].route.mask) == gateway->routes[gateway->xtd[i]].route.code) {
+                entry = &gateway->routes[gateway->xtd[i]];
+                break;
+            }
+        }
+    }
+    if (!entry)
+        return;
+    /* rate limit: drop the message within the interval */
+    if (entry->route.interval) {
+        if (!timer_timeout(&entry->timer)) {
+            gateway->limited++;
+            return;
+        }
+        (void)timer_restart(&entry->timer, TIMER_MSEC(entry->route.interval));
+    }
+    /* rewrite identifier and payload */
+    forward = *message;
+    if (entry->route.idMask) {
+        mask = (message->can_id & CAN_XTD_FRAME) ? CAN_XTD_MASK : CAN_STD_MASK;
+        id = ((message->can_id & ~entry->route.idMask) | (entry->route.id & entry->route.idMask)) & mask;
+        forward.can_id = (message->can_id & ~mask) | id;
+    }
+    for (i = 0U; i < (size_t)MAX_DLC(forward.can_dlc); i++)
+        forward.data[i] = (forward.data[i] & ~entry->route.dataMask[i]) | (entry->route.data[i] & entry->route.dataMask[i]);
+    /* encode the message into the transmit buffer */
+    if ((gateway->index + MESSAGE_SIZE) > BATCH_SIZE)
+        flush_gateway(slcan);
+    if (encode_message(&forward, &gateway->buffer[gateway->index], &length)) {
+        gateway->index += length;
+        gateway->pending += 1U;
     }
 }
 
+static void flush_gateway(slcan_t *slcan) {
+    struct gateway_t *gateway = &slcan->gateway;
+    slcan_t *target = gateway->target;
+
+    /* transmit the encoded messages to the target port */
+    /* note: The ACK/NACK feedback of the target device is not awaited;
+     *       it is owed and discarded by the reception loop of the target.
+     */
+    if (target && target->port &&
+        (send_request(target, gateway->buffer, gateway->index,
+                      target->ack ? gateway->pending : 0U) == (int)gateway->index))
+        gateway->forwarded += (uint64_t)gateway->pending;
+    else
+        gateway->failed += (uint64_t)gateway->pending;
+    gateway->index = 0U;
+    gateway->pending = 0U;
+}
+
+static void status_message(slcan_t *slcan, uint32_t code, uint8_t flags) {
+    slcan_message_t message;
+
+    /* status message: in sequence with the received messages (lane 0) */
+    memset(&message, 0, sizeof(slcan_message_t));
+    message.can_id = CAN_ERR_FRAME | code;
+    message.can_dlc = 1U;
+    message.data[0] = flags;
+    (void)queue_enqueue_lane(slcan->messages, 0U, &message, sizeof(slcan_message_t));
+}
+
+static void poll_status(slcan_t *slcan) {
+    uint8_t request[2] = {'F','\r'};
+
+    /* send command 'Read Status Flags' w/o waiting for the response */
+    /* note: The response is owed and taken by the reception loop. No more
+     *       than MAX_POLLS polls are sent as long as responses are missing;
+     *       then one poll is skipped and polling is retried.
+     */
+    if (timer_timeout(&slcan->status.timer)) {
+        (void)timer_restart(&slcan->status.timer, TIMER_MSEC(slcan->status.interval));
+        if (slcan->status.polls < MAX_POLLS) {
+            if (send_request(slcan, request, 2, 1U) == 2)
+                slcan->status.polls++;
+        } else
+            slcan->status.polls = 0U;
+    }
+}
+
+static void overflow_marker(void *element, size_t nbytes, uint64_t lost, uint64_t interval) {
+    slcan_message_t message;
+    uint32_t value;
+    int i;
+
+    /* status message: number of lost messages and duration of the loss interval */
+    memset(&message, 0, sizeof(slcan_message_t));
+    message.can_id = CAN_ERR_FRAME | SLCAN_STS_QUEUE_OVERFLOW;
+    message.can_dlc = CAN_DLC_MAX;
+    value = (lost < (uint64_t)UINT32_MAX) ? (uint32_t)lost : UINT32_MAX;
+    for (i = 0; i < 4; i++)
+        message.data[i] = (uint8_t)(value >> (8 * i));
+    value = (interval < (uint64_t)UINT32_MAX) ? (uint32_t)interval : UINT32_MAX;
+    for (i = 0; i < 4; i++)
+        message.data[4 + i] = (uint8_t)(value >> (8 * i));
+    memcpy(element, &message, (nbytes < sizeof(slcan_message_t)) ? nbytes : sizeof(slcan_message_t));
+}
+
 /*  ----------------------------------------------------------------------
  *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
  *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
@@ -128,6 +128,42 @@
 
 #define CAN_INFINITE    65535U          /**< infinite time-out (blocking read) */
 
+/** @name  Queue Options
+ *  @brief Memory options of the reception queue
+ *  @{ */
+#define SLCAN_QUEUE_LAZY_COMMIT  0x01U  /**< pages are committed when touched */
+#define SLCAN_QUEUE_HUGE_PAGES   0x02U  /**< huge pages (if available) */
+#define SLCAN_QUEUE_SHRINK_IDLE  0x04U  /**< pages are released when the queue runs empty */
+/** @} */
+
+/** @name  Queue Policies
+ *  @brief Overflow policies of the reception queue
+ *  @{ */
+#define SLCAN_QUEUE_DROP_NEWEST     0U  /**< the received message is dropped (default) */
+#define SLCAN_QUEUE_DROP_OLDEST     1U  /**< the oldest message is overwritten */
+#define SLCAN_QUEUE_BLOCK_PRODUCER  2U  /**< the reception waits for free space (bounded) */
+/** @} */
+
+/** @name  Receive Lanes
+ *  @brief Priority lanes in front of the reception queue
+ *  @{ */
+#define SLCAN_MAX_LANES        3U       /**< number of priority lanes */
+#define SLCAN_LANE_SIZE        256U     /**< default size of a priority lane */
+#define SLCAN_MAX_XTD_CLASSES  8U       /**< max. number of classes for 29-bit identifier */
+/** @} */
+
+#define SLCAN_MAX_SUBSCRIBERS  8U       /**< max. number of subscribers (fan-out) */
+#define SLCAN_MAX_ROUTES      32U       /**< max. number of routes (gateway) */
+#define SLCAN_MAX_HOOKS        2U       /**< max. number of reception hooks (e.g. ISO-TP, J1939) */
+
+/** @name  Status Messages
+ *  @brief In-band status messages (CAN_ERR_FRAME | code)
+ *  @{ */
+#define SLCAN_STS_QUEUE_OVERFLOW  0x01U /**< messages lost: data[0..3] = number, data[4..7] = interval in [ms] */
+#define SLCAN_STS_CONTROLLER      0x02U /**< status flags changed: data[0] = status flags (slcan_flags_t) */
+#define SLCAN_STS_DISCONNECTED    0x03U /**< serial line disconnected (no further messages) */
+/** @} */
+
 
 /*  -----------  types  --------------------------------------------------
  */
@@ -147,6 +183,11 @@ typedef struct slcan_message_t_ {       /* SLCAN message: */
     uint8_t data[CAN_LEN_MAX];          /**< payload (max. 8 data bytes) */
 } slcan_message_t;
 
+/** @brief  SLCAN reception hook (called by the reception thread for each
+ *          received message; returns true if the message has been consumed)
+ */
+typedef bool (*slcan_hook_t)(const slcan_message_t *message, void *param);
+
 /** @brief  SLCAN status flags
  */
 typedef union slcan_flags_t_ {          /* SLACAN status flags */
@@ -163,6 +204,41 @@ typedef union slcan_flags_t_ {          /* SLACAN status flags */
     };
 } slcan_flags_t;
 
+/** @brief  SLCAN reception queue status
+ */
+typedef struct slcan_queue_t_ {         /* SLCAN reception queue: */
+    uint32_t size;                      /**< maximum number of messages */
+    uint32_t used;                      /**< number of queued messages */
+    uint32_t high;                      /**< high-water mark (max. number of queued messages) */
+    uint64_t ovfl;                      /**< number of lost messages (queue overflow) */
+    uint64_t gaps;                      /**< number of loss intervals (queue overflow) */
+} slcan_queue_t;
+
+/** @brief  SLCAN gateway route (rule for forwarding received messages)
+ *
+ *  @remarks A message matches the route if: (id & mask) == (code & mask),
+ *           for the selected identifier format (mask 0 = all identifiers).
+ */
+typedef struct slcan_route_t_ {         /* SLCAN gateway route: */
+    uint32_t code;                      /**< identifier code */
+    uint32_t mask;                      /**< identifier mask */
+    bool xtd;                           /**< 11-bit (false) or 29-bit (true) identifier */
+    uint16_t interval;                  /**< min. interval between two forwarded messages in [ms] (0 = no limit) */
+    uint32_t id;                        /**< new identifier bits (see idMask) */
+    uint32_t idMask;                    /**< identifier bits taken from 'id' (0 = unchanged) */
+    uint8_t data[CAN_LEN_MAX];          /**< new payload bits (see dataMask) */
+    uint8_t dataMask[CAN_LEN_MAX];      /**< payload bits taken from 'data' (0 = unchanged) */
+} slcan_route_t;
+
+/** @brief  SLCAN gateway status
+ */
+typedef struct slcan_gateway_t_ {       /* SLCAN gateway: */
+    uint32_t routes;                    /**< number of routes (0 = no gateway) */
+    uint64_t forwarded;                 /**< number of forwarded messages */
+    uint64_t limited;                   /**< number of messages dropped by rate limit */
+    uint64_t failed;                    /**< number of messages not transmitted */
+} slcan_gateway_t;
+
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -353,6 +429,79 @@ SLCANAPI int slcan_setup_btr(slcan_port_t port, uint16_t btr);
 SLCANAPI int slcan_open_channel(slcan_port_t port);
 
 
+/** @brief       opens the CAN channel in listen-only mode.
+ *
+ *  @remarks     The CAN controller neither acknowledges received frames nor
+ *               sends error frames (SJA1000 listen-only mode); transmission
+ *               is not possible. Same preconditions as 'Open Channel'.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EINVAL    - invalid argument (...)
+ *  @retval      EBADF     - bad file descriptor (device not connected)
+ *  @retval      EBUSY     - device / resource busy (disturbance)
+ *  @retval      EBADMSG   - bad message (format or disturbance)
+ *  @retval      ETIMEDOUT - timed out (command not acknowledged)
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'write', 'read', etc.
+ */
+SLCANAPI int slcan_listen_channel(slcan_port_t port);
+
+
+/** @brief       sets the silent mode of the CAN controller (CANable only).
+ *
+ *  @remarks     In silent mode the CAN controller neither acknowledges
+ *               received frames nor sends error frames (listen-only mode).
+ *               The command must be sent before the CAN channel is opened.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *  @param[in]   on    - true to enter, false to leave the silent mode
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EBADF     - bad file descriptor (device not connected)
+ *  @retval      EBUSY     - device / resource busy (disturbance)
+ *  @retval      EBADMSG   - bad message (format or disturbance)
+ *  @retval      ETIMEDOUT - timed out (command not acknowledged)
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'write', 'read', etc.
+ */
+SLCANAPI int slcan_silent_mode(slcan_port_t port, bool on);
+
+
+/** @brief       enables or disables the automatic retransmission of CAN
+ *               frames (CANable only).
+ *
+ *  @remarks     Without automatic retransmission a frame is sent only once,
+ *               even if it has lost arbitration or was not acknowledged.
+ *               The command must be sent before the CAN channel is opened.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *  @param[in]   on    - true to enable (default), false to disable it
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV    - no such device (invalid port instance)
+ *  @retval      EBADF     - bad file descriptor (device not connected)
+ *  @retval      EBUSY     - device / resource busy (disturbance)
+ *  @retval      EBADMSG   - bad message (format or disturbance)
+ *  @retval      ETIMEDOUT - timed out (command not acknowledged)
+ *  @retval      'errno'   - error code from called system functions:
+ *                           'write', 'read', etc.
+ */
+SLCANAPI int slcan_auto_retransmit(slcan_port_t port, bool on);
+
+
 /** @brief       closes the CAN channel.
  *
  *  @remarks     This command is only active if the CAN channel is open.
@@ -399,6 +548,30 @@ SLCANAPI int slcan_close_channel(slcan_port_t port);
 SLCANAPI int slcan_write_message(slcan_port_t port, const slcan_message_t *message, uint16_t timeout);
 
 
+/** @brief       write n CAN messages at once (batched serial write).
+ *
+ *  @remarks     The messages are encoded into one buffer and transmitted by
+ *               one serial write (or a few for many messages). No ACK/NACK
+ *               feedback is awaited (it is discarded by the reception thread),
+ *               the function can be called from the reception thread (e.g. by
+ *               a reception hook).
+ *
+ *  @param[in]   port      - pointer to a SLCAN instance
+ *  @param[in]   messages  - pointer to an array of messages to be sent
+ *  @param[in]   count     - number of messages to be sent
+ *
+ *  @returns     the number of messages sent if successful, or a negative value
+ *               on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (messages or count)
+ *  @retval      EBUSY   - device / resource busy (disturbance)
+ */
+SLCANAPI int slcan_write_messages(slcan_port_t port, const slcan_message_t *messages, size_t count);
+
+
 /** @brief       read one message from the message queue, if any.
  *
  *  @param[in]   port     - pointer to a SLCAN instance
@@ -427,6 +600,346 @@ SLCANAPI int slcan_write_message(slcan_port_t port, const slcan_message_t *messa
 SLCANAPI int slcan_read_message(slcan_port_t port, slcan_message_t *message, uint16_t timeout);
 
 
+/** @brief       read up to n messages from the message queue, if any.
+ *
+ *  @remarks     The function waits for the first message only, the following
+ *               messages are taken from the message queue if already received.
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[out]  messages - pointer to an array of message buffers
+ *  @param[in]   count    - maximum number of messages to be read
+ *  @param[in]   timeout  - time to wait for the reception of a message:
+ *                               0 means the function returns immediately,
+ *                               65535 means blocking read, and any other
+ *                               value means the time to wait im milliseconds
+ *
+ *  @returns     the number of messages read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      -30  - when the message queue is empty (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (messages or count)
+ *  @retval      ENOMSG  - no data available (message queue empty)
+ *  @retval      ENOSPC  - no space left (message queue overflow)
+ *
+ *  @remarks     If messages have been successfully read from the message queue,
+ *               the value ENOSPC in the system variable 'errno' indicates that
+ *               a message queue overflow has occurred and that at least one
+ *               CAN message has been lost.
+ */
+SLCANAPI int slcan_read_messages(slcan_port_t port, slcan_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       retrieves the status of the message queue (reception queue).
+ *
+ *  @remarks     The fill level is taken from the queue without waiting, so
+ *               it can be polled before reading messages from the queue.
+ *
+ *  @param[in]   port    - pointer to a SLCAN instance
+ *  @param[out]  status  - size, fill level, high-water mark and overflow
+ *                         counter of the message queue
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (status)
+ */
+SLCANAPI int slcan_queue_status(slcan_port_t port, slcan_queue_t *status);
+
+
+/** @brief       changes the size and the memory options of the message queue
+ *               (reception queue).
+ *
+ *  @remarks     The message queue is reallocated, all received CAN messages
+ *               that have not been read yet are discarded.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   queueSize  - size of the reception queue (number of messages)
+ *  @param[in]   options    - memory options (SLCAN_QUEUE_LAZY_COMMIT, etc.)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (queueSize)
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_queue_resize(slcan_port_t port, size_t queueSize, uint32_t options);
+
+
+/** @brief       sets the overflow policy of the message queue (reception queue).
+ *
+ *  @remarks     With policy SLCAN_QUEUE_BLOCK_PRODUCER the reception waits at
+ *               most 'timeout' milliseconds for free space in the queue, then
+ *               the received message is dropped. Note: during this time no
+ *               further data are taken from the serial port.
+ *
+ *  @remarks     Lost messages are reported in-band by a status message with
+ *               identifier CAN_ERR_FRAME | SLCAN_STS_QUEUE_OVERFLOW at the
+ *               position of the loss (number of lost messages and duration
+ *               of the loss interval, each as 32-bit little endian value).
+ *
+ *  @param[in]   port     - pointer to a SLCAN instance
+ *  @param[in]   policy   - overflow policy (SLCAN_QUEUE_DROP_NEWEST, etc.)
+ *  @param[in]   timeout  - maximum blocking time of the reception (in milliseconds)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (policy)
+ */
+SLCANAPI int slcan_queue_policy(slcan_port_t port, uint8_t policy, uint16_t timeout);
+
+
+/** @brief       sets up the priority lanes in front of the message queue
+ *               (reception queue).
+ *
+ *  @remarks     Each lane is a ring of its own. A read operation takes the
+ *               messages from the highest non-empty lane first, and from the
+ *               message queue when all lanes are empty. All messages in the
+ *               lanes are discarded. With 0 the lanes are removed and all
+ *               identifiers are assigned to the message queue.
+ *
+ *  @param[in]   port      - pointer to a SLCAN instance
+ *  @param[in]   laneSize  - size of each lane (number of messages)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_lane_size(slcan_port_t port, size_t laneSize);
+
+
+/** @brief       assigns a class of identifiers to a priority lane.
+ *
+ *  @remarks     An identifier belongs to the class if: first <= (id & mask) <= last.
+ *               The lanes are set up with the default size on first call.
+ *               For 11-bit identifiers a lookup table is updated, for 29-bit
+ *               identifiers the class is added to a short list (the first
+ *               matching class wins).
+ *               The classes should be changed only while the CAN channel is
+ *               closed (the reception reads them without locking).
+ *
+ *  @param[in]   port   - pointer to a SLCAN instance
+ *  @param[in]   first  - first identifier (or code)
+ *  @param[in]   last   - last identifier (or code)
+ *  @param[in]   mask   - identifier mask
+ *  @param[in]   xtd    - 11-bit (false) or 29-bit (true) identifier
+ *  @param[in]   lane   - lane number (0 = message queue, 1..SLCAN_MAX_LANES)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (identifier or lane)
+ *  @retval      ENOSPC  - no space left (too many classes for 29-bit identifier)
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_lane_class(slcan_port_t port, uint32_t first, uint32_t last, uint32_t mask, bool xtd, uint8_t lane);
+
+
+/** @brief       assigns all identifiers to the message queue (reception queue).
+ *
+ *  @param[in]   port   - pointer to a SLCAN instance
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_lane_reset(slcan_port_t port);
+
+
+/** @brief       creates a subscriber that receives a copy of each received
+ *               CAN message accepted by its filter (fan-out).
+ *
+ *  @remarks     Each subscriber has a message queue of its own, the messages
+ *               are read independently from the message queue of the port
+ *               and from other subscribers. A full subscriber queue drops the
+ *               messages of this subscriber only; the loss is reported by a
+ *               status message as for the message queue.
+ *
+ *  @remarks     A message is accepted if: (id & mask) == (code & mask), for
+ *               11-bit and 29-bit identifiers separately (mask 0 = all).
+ *
+ *  @remarks     Subscribing and unsubscribing are not thread-safe among each
+ *               other, a subscriber must not be read while unsubscribing.
+ *
+ *  @param[in]   port       - pointer to a SLCAN instance
+ *  @param[in]   queueSize  - size of the subscriber queue (number of messages)
+ *  @param[in]   stdCode    - code for 11-bit identifier
+ *  @param[in]   stdMask    - mask for 11-bit identifier
+ *  @param[in]   xtdCode    - code for 29-bit identifier
+ *  @param[in]   xtdMask    - mask for 29-bit identifier
+ *
+ *  @returns     the subscriber number (0..SLCAN_MAX_SUBSCRIBERS-1) if successful,
+ *               or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (queueSize)
+ *  @retval      ENOSPC  - no space left (SLCAN_MAX_SUBSCRIBERS reached)
+ *  @retval      ENOMEM  - out of memory (insufficient storage space)
+ */
+SLCANAPI int slcan_subscribe(slcan_port_t port, size_t queueSize, uint32_t stdCode, uint32_t stdMask,
+                                                                  uint32_t xtdCode, uint32_t xtdMask);
+
+
+/** @brief       removes a subscriber and its message queue.
+ *
+ *  @param[in]   port        - pointer to a SLCAN instance
+ *  @param[in]   subscriber  - subscriber number
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (subscriber)
+ */
+SLCANAPI int slcan_unsubscribe(slcan_port_t port, int subscriber);
+
+
+/** @brief       read up to n messages from the message queue of a subscriber,
+ *               if any.
+ *
+ *  @remarks     The function waits for the first message only, the following
+ *               messages are taken from the queue if already available.
+ *
+ *  @param[in]   port        - pointer to a SLCAN instance
+ *  @param[in]   subscriber  - subscriber number
+ *  @param[out]  messages    - pointer to an array of message buffers
+ *  @param[in]   count       - maximum number of messages to be read
+ *  @param[in]   timeout     - time to wait for the reception of a message
+ *
+ *  @returns     the number of messages read if successful, or a negative value
+ *               on error.
+ *
+ *  @retval      -30  - when the queue is empty (CAN API compatible)
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (subscriber, messages or count)
+ *  @retval      ENOMSG  - no data available (queue empty)
+ *  @retval      ENOSPC  - no space left (messages lost in front of the messages read)
+ */
+SLCANAPI int slcan_read_subscriber(slcan_port_t port, int subscriber, slcan_message_t *messages, size_t count, uint16_t timeout);
+
+
+/** @brief       sets up a gateway that forwards received CAN messages matching
+ *               one of the given routes to another port (or removes it).
+ *
+ *  @remarks     The routes are compiled into a lookup table. The messages are
+ *               forwarded by the reception thread of the port: the messages of
+ *               one reception are encoded into a buffer and transmitted to the
+ *               target port at once (no extra thread or queue, no ACK/NACK
+ *               feedback is awaited; the target discards it). The forwarded
+ *               messages are also put into the message queue of the port.
+ *
+ *  @remarks     The first matching route applies. Its rate limit, identifier
+ *               and payload rewriting are applied to the forwarded message:
+ *               id = (id & ~idMask) | (route.id & idMask), and the same for
+ *               each data byte with 'dataMask' and 'data'.
+ *
+ *  @remarks     The gateway can be changed while the reception is running.
+ *               On return the reception thread no longer forwards to the old
+ *               target, so it can be destroyed after the gateway is removed
+ *               (but not while the gateway is set up).
+ *
+ *  @param[in]   port    - pointer to a SLCAN instance
+ *  @param[in]   target  - pointer to the SLCAN instance to forward to (NULL = remove)
+ *  @param[in]   routes  - pointer to an array of routes
+ *  @param[in]   count   - number of routes (0 = remove the gateway)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (target, routes or count)
+ */
+SLCANAPI int slcan_gateway(slcan_port_t port, slcan_port_t target, const slcan_route_t *routes, size_t count);
+
+
+/** @brief       retrieves the status of the gateway (number of routes and
+ *               message counters).
+ *
+ *  @param[in]   port    - pointer to a SLCAN instance
+ *  @param[out]  status  - pointer to a buffer for the gateway status
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EINVAL  - invalid argument (status)
+ */
+SLCANAPI int slcan_gateway_status(slcan_port_t port, slcan_gateway_t *status);
+
+
+/** @brief       installs a reception hook that is called by the reception
+ *               thread for each received CAN message (or removes it).
+ *
+ *  @remarks     Up to SLCAN_MAX_HOOKS hooks are called in the order of their
+ *               installation, until one of them consumes the message. A hook
+ *               is removed by passing NULL and the parameter it was installed
+ *               with.
+ *
+ *  @remarks     A message consumed by the hook (return value true) is not put
+ *               into the message queue. The hook must not block; it can send
+ *               messages by 'slcan_write_messages'.
+ *
+ *  @remarks     The hook shall be removed only when the port is disconnected,
+ *               or when the hook and its parameter stay valid afterwards.
+ *
+ *  @param[in]   port   - pointer to a SLCAN instance
+ *  @param[in]   hook   - pointer to the hook function (NULL = remove)
+ *  @param[in]   param  - parameter passed to the hook function
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ *  @retval      EBUSY   - no more hooks (SLCAN_MAX_HOOKS reached)
+ */
+SLCANAPI int slcan_set_hook(slcan_port_t port, slcan_hook_t hook, void *param);
+
+
+/** @brief       retrieves a file descriptor that is readable as long as there
+ *               are messages in the message queue (reception queue).
+ *
+ *  @remarks     The file descriptor can be used to wait for messages by means
+ *               of 'select', 'poll' or an event loop. It is owned by the SLCAN
+ *               instance and must not be read or closed by the caller.
+ *
+ *  @param[in]   port  - pointer to a SLCAN instance
+ *
+ *  @returns     a file descriptor if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV   - no such device (invalid port instance)
+ *  @retval      ENOTSUP  - not supported (e.g. on Windows)
+ */
+SLCANAPI int slcan_event_fd(slcan_port_t port);
+
+
 /** @brief       read status flags.
  *
  *  @remarks     This command is only active if the CAN channel is open.
@@ -471,6 +984,51 @@ SLCANAPI int slcan_status_flags(slcan_port_t port, slcan_flags_t *flags);
 SLCANAPI int slcan_failure_flags(slcan_port_t port, slcan_flags_t *flags);
 
 
+/** @brief       enables or disables in-band status messages.
+ *
+ *  @remarks     When enabled, the reception puts a status message into the
+ *               message queue whenever the status flags of the CAN channel
+ *               change (identifier CAN_ERR_FRAME | SLCAN_STS_CONTROLLER) and
+ *               when the serial line is disconnected (identifier
+ *               CAN_ERR_FRAME | SLCAN_STS_DISCONNECTED), in sequence with
+ *               the received CAN messages.
+ *
+ *  @remarks     The status flags are taken from each response to command
+ *               'Read Status Flags', resp. from the polling of the flags.
+ *               @see slcan_status_polling
+ *
+ *  @param[in]   port    - pointer to a SLCAN instance
+ *  @param[in]   enable  - true to enable, false to disable status messages
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_status_events(slcan_port_t port, bool enable);
+
+
+/** @brief       sets the polling interval of the status flags.
+ *
+ *  @remarks     The reception thread sends command 'Read Status Flags' at
+ *               the given interval without waiting for the response; the
+ *               response is taken by the reception and does not interfere
+ *               with a pending command. This requires the Lawicel protocol
+ *               and an open CAN channel.
+ *
+ *  @param[in]   port      - pointer to a SLCAN instance
+ *  @param[in]   interval  - polling interval (in milliseconds, 0 = off)
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @note        System variable 'errno' will be set in case of an error.
+ *
+ *  @retval      ENODEV  - no such device (invalid port instance)
+ */
+SLCANAPI int slcan_status_polling(slcan_port_t port, uint16_t interval);
+
+
 /** @brief       sets Acceptance Code Register (ACn Register of SJA1000).
  *
  *  @remarks     This command is only active if the CAN channel is initiated
@@ -137,6 +137,29 @@ int timer_timeout(timer_obj_t *self);
  */
 int timer_delay(timer_val_t microseconds);
 
+
+/** @brief       suspends the calling thread until the given timer object has
+ *               expired (absolute deadline, no drift over several periods).
+ *
+ *  @param[in]   self  pointer to a timer object, or NULL (GPT0)
+ *
+ *  @returns     none-zero value on success, or zero otherwise
+ */
+int timer_wait(timer_obj_t *self);
+
+
+/** @brief       advances the deadline of the given timer object by a period
+ *               (periodic deadlines w/o drift), or restarts the timer when
+ *               the advanced deadline has already expired (no catch-up).
+ *
+ *  @param[in]   self  pointer to a timer object, or NULL (GPT0)
+ *  @param[in]   microseconds  in [usec]
+ *
+ *  @returns     none-zero value on success, or zero otherwise
+ */
+int timer_advance(timer_obj_t *self, timer_val_t microseconds);
+
+
 /** @brief       returns the current time as 'struct timespec'.
  *
  *  @returns     the current time in 'struct timespec'
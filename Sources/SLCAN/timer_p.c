@@ -177,6 +177,40 @@ int timer_delay(uint64_t microseconds) {
 #endif
 }
 
+int timer_wait(timer_obj_t *self) {
+    uint64_t llUntilStop = self ? (uint64_t)*self : (uint64_t)gpt0;
+#if (POSIX_DEPRECATED == 0) && defined(__linux__)
+    int rc;
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)(llUntilStop / TIMER_SEC(1));
+    deadline.tv_nsec = (long)((llUntilStop % TIMER_SEC(1)) * (uint64_t)1000);
+    while ((rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)) == EINTR) {
+        /* interrupted by a signal: sleep again */
+    }
+    return (rc != 0) ? 0 : 1;
+#else
+    uint64_t llNow = (uint64_t)timer_new(0U);
+    // note: 'timer_new(0)' returns the current time in [usec]
+    if (llNow < llUntilStop)
+        return timer_delay(llUntilStop - llNow);
+    return 1;
+#endif
+}
+
+int timer_advance(timer_obj_t *self, uint64_t microseconds) {
+    uint64_t llUntilStop = (self ? (uint64_t)*self : (uint64_t)gpt0) + microseconds;
+    uint64_t llNow = (uint64_t)timer_new(0U);
+    // note: 'timer_new(0)' returns the current time in [usec]
+    if (llUntilStop <= llNow)
+        return timer_restart(self, microseconds);
+    // update the timer instance or the general purpose timer (NULL)
+    if (self)
+        *self = (uint64_t)llUntilStop;
+    else
+         gpt0 = (uint64_t)llUntilStop;
+    return 1;
+}
+
 struct timespec timer_get_time(void) {
     struct timespec now = { 0, 0 };
     clock_gettime(CLOCK_REALTIME, &now);
@@ -196,6 +196,50 @@ int timer_delay(uint64_t microseconds) {
 #endif
 }
 
+int timer_wait(timer_obj_t *self) {
+    LARGE_INTEGER largeFrequency;       // high-resolution timer frequency
+    LARGE_INTEGER largeCounter;         // high-resolution performance counter
+
+    LONGLONG llUntilStop = self ? (LONGLONG)*self : (LONGLONG)gpt0;
+
+    // retrieve the frequency of the high-resolution performance counter
+    if (!QueryPerformanceFrequency(&largeFrequency))
+        return 0;
+    // retrieve the current value of the high-resolution performance counter
+    if (!QueryPerformanceCounter(&largeCounter))
+        return 0;
+    // wait for the remaining time, if any
+    if (largeCounter.QuadPart < llUntilStop)
+        return timer_delay((uint64_t)(((llUntilStop - largeCounter.QuadPart) * (LONGLONG)1000000)
+                                           / largeFrequency.QuadPart));
+    return 1;
+}
+
+int timer_advance(timer_obj_t *self, uint64_t microseconds) {
+    LARGE_INTEGER largeFrequency;       // high-resolution timer frequency
+    LARGE_INTEGER largeCounter;         // high-resolution performance counter
+
+    LONGLONG llUntilStop = self ? (LONGLONG)*self : (LONGLONG)gpt0;
+
+    // retrieve the frequency of the high-resolution performance counter
+    if (!QueryPerformanceFrequency(&largeFrequency))
+        return 0;
+    // retrieve the current value of the high-resolution performance counter
+    if (!QueryPerformanceCounter(&largeCounter))
+        return 0;
+    // calculate the counter value of the next deadline
+    llUntilStop += ((largeFrequency.QuadPart * (LONGLONG)microseconds) / (LONGLONG)1000000);
+    // deadline already expired: restart the timer (no catch-up)
+    if (llUntilStop <= largeCounter.QuadPart)
+        return timer_restart(self, microseconds);
+    // update the timer instance or the general purpose timer (NULL)
+    if (self)
+        *self = (uint64_t)llUntilStop;
+    else
+         gpt0 = (uint64_t)llUntilStop;
+    return 1;
+}
+
 struct timespec timer_get_time(void) {
     struct timespec now = { 0, 0 };
     static bool fInitialied = false;         // initialization flag
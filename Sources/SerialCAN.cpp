@@ -295,6 +295,78 @@ CANAPI_Return_t CSerialCAN::ReadMessage(CANAPI_Message_t &message, uint16_t time
     return can_read(m_Handle, &message, timeout);
 }
 
+EXPORT
+CANAPI_Return_t CSerialCAN::WriteFrames(const CANAPI_Frame_t *frames, size_t count, uint16_t timeout) {
+    // transmit several frames (compact layout) over the CAN bus
+    return can_write_frames(m_Handle, frames, count, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::ReadFrames(CANAPI_Frame_t *frames, size_t count, uint16_t timeout) {
+    // read several frames (compact layout) from the message queue of the CAN interface, if any
+    return can_read_frames(m_Handle, frames, count, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::Subscribe(size_t queueSize, uint64_t filter11, uint64_t filter29) {
+    // create a subscriber with its own message queue (returns the subscriber number)
+    return can_subscribe(m_Handle, filter11, filter29, queueSize);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::Unsubscribe(int subscriber) {
+    // remove a subscriber and its message queue
+    return can_unsubscribe(m_Handle, subscriber);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::ReadSubscriber(int subscriber, CANAPI_Message_t *messages, size_t count, uint16_t timeout) {
+    // read several messages from the message queue of a subscriber, if any
+    return can_read_subscriber(m_Handle, subscriber, messages, count, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::IsoTpOpen(const SIsoTpChannel &channel) {
+    // open an ISO-TP channel (returns the channel number)
+    return can_isotp_open(m_Handle, (const void*)&channel);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::IsoTpClose(int channel) {
+    // close an ISO-TP channel
+    return can_isotp_close(m_Handle, channel);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::IsoTpSend(int channel, const uint8_t *data, size_t length) {
+    // transmit a PDU on an ISO-TP channel (blocking until the last frame is written)
+    return can_isotp_send(m_Handle, channel, data, length);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::IsoTpReceive(int channel, uint8_t *buffer, size_t size, uint16_t timeout) {
+    // read a received PDU from an ISO-TP channel, if any (returns the length of the PDU)
+    return can_isotp_receive(m_Handle, channel, buffer, size, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::J1939Init(const SJ1939Engine *engine) {
+    // initialize the J1939 engine (released by TeardownChannel)
+    return can_j1939_init(m_Handle, (const void*)engine);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::J1939Claim(uint8_t address, uint64_t name) {
+    // claim an own address (waits for contending claims)
+    return can_j1939_claim(m_Handle, address, name);
+}
+
+EXPORT
+CANAPI_Return_t CSerialCAN::J1939Receive(uint32_t &pgn, uint8_t &src, uint8_t &dst, uint8_t *data, size_t size, uint16_t timeout) {
+    // read a reassembled PDU, if any (returns the length of the PDU)
+    return can_j1939_receive(m_Handle, &pgn, &src, &dst, data, size, timeout);
+}
+
 EXPORT
 CANAPI_Return_t CSerialCAN::GetStatus(CANAPI_Status_t &status) {
     // retrieve the status register of the CAN interface
@@ -83,6 +83,10 @@ public:
     };
     // serial line attributes
     typedef can_sio_attr_t SSerialAttributes;
+    // ISO-TP channel parameters
+    typedef can_sio_isotp_t SIsoTpChannel;
+    // J1939 engine parameters
+    typedef can_sio_j1939_t SJ1939Engine;
 
     // CSerial methods
     //static bool GetFirstChannel(SChannelInfo &info, SSerialAttributes &sioAttr);
@@ -111,6 +115,28 @@ public:
     CANAPI_Return_t WriteMessage(CANAPI_Message_t message, uint16_t timeout = 0U);
     CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, uint16_t timeout = CANWAIT_INFINITE);
 
+    // batch transmission and reception of CAN 2.0 frames in compact layout (24 bytes):
+    // the number of frames written or read is returned, or a negative value on error
+    CANAPI_Return_t WriteFrames(const CANAPI_Frame_t *frames, size_t count, uint16_t timeout = 0U);
+    CANAPI_Return_t ReadFrames(CANAPI_Frame_t *frames, size_t count, uint16_t timeout = CANWAIT_INFINITE);
+
+    CANAPI_Return_t Subscribe(size_t queueSize, uint64_t filter11 = 0U, uint64_t filter29 = 0U);
+    CANAPI_Return_t Unsubscribe(int subscriber);
+    CANAPI_Return_t ReadSubscriber(int subscriber, CANAPI_Message_t *messages, size_t count, uint16_t timeout = CANWAIT_INFINITE);
+
+    // ISO-TP transport protocol (ISO 15765-2) on the reception thread:
+    // IsoTpOpen returns the channel number, IsoTpReceive the length of the PDU
+    CANAPI_Return_t IsoTpOpen(const SIsoTpChannel &channel);
+    CANAPI_Return_t IsoTpClose(int channel);
+    CANAPI_Return_t IsoTpSend(int channel, const uint8_t *data, size_t length);
+    CANAPI_Return_t IsoTpReceive(int channel, uint8_t *buffer, size_t size, uint16_t timeout = CANWAIT_INFINITE);
+
+    // SAE J1939 transport protocol (BAM/CMDT reassembly) on the reception thread:
+    // J1939Receive returns the length of the PDU
+    CANAPI_Return_t J1939Init(const SJ1939Engine *engine = NULL);
+    CANAPI_Return_t J1939Claim(uint8_t address, uint64_t name);
+    CANAPI_Return_t J1939Receive(uint32_t &pgn, uint8_t &src, uint8_t &dst, uint8_t *data, size_t size, uint16_t timeout = CANWAIT_INFINITE);
+
     CANAPI_Return_t GetStatus(CANAPI_Status_t &status);
     CANAPI_Return_t GetBusLoad(uint8_t &load);
 
@@ -170,9 +196,32 @@ public:
 #define SERIALCAN_PROPERTY_TX_COUNTER           (CANPROP_GET_TX_COUNTER)
 #define SERIALCAN_PROPERTY_RX_COUNTER           (CANPROP_GET_RX_COUNTER)
 #define SERIALCAN_PROPERTY_ERR_COUNTER          (CANPROP_GET_ERR_COUNTER)
-//#define SERIALCAN_PROPERTY_RCV_QUEUE_SIZE       (CANPROP_GET_RCV_QUEUE_SIZE)
-//#define SERIALCAN_PROPERTY_RCV_QUEUE_HIGH       (CANPROP_GET_RCV_QUEUE_HIGH)
-//#define SERIALCAN_PROPERTY_RCV_QUEUE_OVFL       (CANPROP_GET_RCV_QUEUE_OVFL)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_SIZE       (CANPROP_GET_RCV_QUEUE_SIZE)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_HIGH       (CANPROP_GET_RCV_QUEUE_HIGH)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_OVFL       (CANPROP_GET_RCV_QUEUE_OVFL)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_FILL       (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_FILL)
+#define SERIALCAN_PROPERTY_RCV_EVENT_FD         (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_EVENT_FD)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_OPTIONS    (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_SIZE   (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_OPTIONS (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_POLICY     (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_BLOCK_TIME (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME)
+#define SERIALCAN_PROPERTY_RCV_QUEUE_GAPS       (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_GAPS)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_POLICY (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY)
+#define SERIALCAN_PROPERTY_SET_RCV_QUEUE_BLOCK_TIME (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME)
+#define SERIALCAN_PROPERTY_RCV_LANE_SIZE        (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE)
+#define SERIALCAN_PROPERTY_SET_RCV_LANE_SIZE    (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE)
+#define SERIALCAN_PROPERTY_SET_RCV_LANE_CLASS   (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_CLASS)
+#define SERIALCAN_PROPERTY_SET_RCV_LANE_RESET   (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_RESET)
+#define SERIALCAN_PROPERTY_SET_GATEWAY_ROUTES   (CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES)
+#define SERIALCAN_PROPERTY_GATEWAY_STATUS       (CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS)
+#define SERIALCAN_PROPERTY_J1939_STATUS         (CANPROP_GET_VENDOR_PROP + SLCAN_J1939_STATUS)
+#define SERIALCAN_PROPERTY_AUTO_BAUD_DWELL      (CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL)
+#define SERIALCAN_PROPERTY_SET_AUTO_BAUD_DWELL  (CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL)
+#define SERIALCAN_PROPERTY_AUTO_RETRANSMIT      (CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT)
+#define SERIALCAN_PROPERTY_SET_AUTO_RETRANSMIT  (CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT)
+#define SERIALCAN_PROPERTY_STATUS_POLL_TIME     (CANPROP_GET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME)
+#define SERIALCAN_PROPERTY_SET_STATUS_POLL_TIME (CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME)
 #define SERIALCAN_PROPERTY_SERIAL_NUMBER        (CANPROP_GET_VENDOR_PROP + SLCAN_SERIAL_NUMBER)
 #define SERIALCAN_PROPERTY_HARDWARE_VERSION     (CANPROP_GET_VENDOR_PROP + SLCAN_HARDWARE_VERSION)
 #define SERIALCAN_PROPERTY_FIRMWARE_VERSION     (CANPROP_GET_VENDOR_PROP + SLCAN_FIRMWARE_VERSION)
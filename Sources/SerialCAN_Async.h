@@ -0,0 +1,464 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (for CAN-over-Serial-Line Interfaces)
+//
+//  Copyright (c) 2016-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of SerialCAN.
+//
+//  SerialCAN is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You can
+//  choose between one of them if you use SerialCAN in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  SerialCAN IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF SerialCAN, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  SerialCAN is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  SerialCAN is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with SerialCAN.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef SERIALCAN_ASYNC_H_INCLUDED
+#define SERIALCAN_ASYNC_H_INCLUDED
+
+#include "SerialCAN.h"
+
+#if !defined(__cpp_impl_coroutine) || (__cpp_impl_coroutine < 201902L)
+#error C++20 coroutines required (e.g. compile with -std=c++20)
+#endif
+#if defined(_WIN32) || defined(_WIN64)
+#error Platform not supported (no event file descriptor on Windows)
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <stop_token>
+#include <optional>
+#include <utility>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <list>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+class CCanExecutor;
+
+/// \name   SerialCAN Coroutines
+/// \brief  Task type for C++20 coroutines driven by a CCanExecutor.
+/// \note   A task is started lazily: either it is awaited by another task
+///         (it runs on the executor of the awaiting task), or it is handed
+///         over to an executor by CCanExecutor::Spawn (detached task).
+/// \{
+struct CCanPromiseBase {
+    CCanExecutor *executor = nullptr;  ///< executor the task is running on
+    std::coroutine_handle<> continuation;  ///< awaiting task (if any)
+    std::exception_ptr exception;  ///< exception thrown by the task (if any)
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    struct SFinal {
+        bool await_ready() noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self) noexcept {
+            // resume the awaiting task (symmetric transfer), if any
+            std::coroutine_handle<> next = self.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    SFinal final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct CCanPromise : CCanPromiseBase {
+    T value{};  ///< result of the task
+    void return_value(T result) { value = std::move(result); }
+};
+
+template<>
+struct CCanPromise<void> : CCanPromiseBase {
+    void return_void() {}
+};
+
+template<typename T = void>
+class CCanTask {
+public:
+    struct promise_type : CCanPromise<T> {
+        CCanTask get_return_object() { return CCanTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+    typedef std::coroutine_handle<promise_type> Handle;
+private:
+    Handle m_Handle;  ///< coroutine frame (owned)
+    friend class CCanExecutor;
+public:
+    explicit CCanTask(Handle handle = nullptr) : m_Handle(handle) {}
+    CCanTask(CCanTask &&other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+    CCanTask &operator=(CCanTask &&other) noexcept {
+        if (this != &other) {
+            if (m_Handle)
+                m_Handle.destroy();
+            m_Handle = std::exchange(other.m_Handle, nullptr);
+        }
+        return *this;
+    }
+    CCanTask(const CCanTask &) = delete;
+    CCanTask &operator=(const CCanTask &) = delete;
+    ~CCanTask() { if (m_Handle) m_Handle.destroy(); }
+
+    struct SAwaiter {
+        Handle handle;
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> parent) noexcept {
+            // run the task on the executor of the awaiting task
+            handle.promise().executor = parent.promise().executor;
+            handle.promise().continuation = parent;
+            return handle;
+        }
+        T await_resume() {
+            if (handle.promise().exception)
+                std::rethrow_exception(handle.promise().exception);
+            if constexpr (!std::is_void_v<T>)
+                return std::move(handle.promise().value);
+        }
+    };
+    SAwaiter operator co_await() const noexcept { return SAwaiter{m_Handle}; }
+};
+/// \}
+
+/// \name   SerialCAN Executor
+/// \brief  Single-threaded executor for CAN tasks (poll-based event loop).
+/// \note   Suspended tasks wait for a file descriptor to become readable
+///         (e.g. the receive event of a CAN interface), for a deadline,
+///         or for a cancellation request (std::stop_token). One thread
+///         can drive any number of CAN interfaces this way. The executor
+///         can also be integrated into another event loop by calling
+///         RunOnce(0) when its file descriptor (GetFd) is readable or a
+///         deadline expired.
+/// \{
+class CCanExecutor {
+public:
+    typedef std::chrono::steady_clock Clock;
+    enum EWaitResult {
+        WaitReady,  ///< file descriptor readable
+        WaitTimeout,  ///< deadline expired
+        WaitCanceled  ///< cancellation requested
+    };
+    struct SWaiter {
+        int fd = -1;  ///< file descriptor (or -1 for a timer)
+        Clock::time_point deadline = Clock::time_point::max();  ///< deadline (or max)
+        std::coroutine_handle<> handle;  ///< suspended coroutine
+        std::atomic<bool> canceled{false};  ///< cancellation requested
+        bool registered = false;  ///< waiting in the executor
+        EWaitResult result = WaitReady;  ///< reason of the resumption
+    };
+private:
+    typedef CCanTask<void>::Handle TaskHandle;
+    std::list<TaskHandle> m_Tasks;  ///< detached tasks (owned)
+    std::deque<std::coroutine_handle<>> m_Ready;  ///< coroutines to be resumed
+    std::vector<SWaiter *> m_Waiters;  ///< suspended coroutines
+    std::vector<struct pollfd> m_PollFds;  ///< poll set (wake-up pipe first)
+    std::vector<SWaiter *> m_PollMap;  ///< poll set index -> waiter
+    int m_Wakeup[2];  ///< wake-up pipe (e.g. for cancellation)
+    std::atomic<bool> m_Stop;  ///< stop request
+public:
+    CCanExecutor() : m_Stop(false) {
+        m_Wakeup[0] = m_Wakeup[1] = -1;
+        if (pipe(m_Wakeup) == 0) {
+            for (int i = 0; i < 2; i++) {
+                (void)fcntl(m_Wakeup[i], F_SETFL, fcntl(m_Wakeup[i], F_GETFL) | O_NONBLOCK);
+                (void)fcntl(m_Wakeup[i], F_SETFD, FD_CLOEXEC);
+            }
+        }
+    }
+    ~CCanExecutor() {
+        // note: the waiters belong to the coroutine frames
+        m_Waiters.clear();
+        m_Ready.clear();
+        for (TaskHandle &task : m_Tasks)
+            task.destroy();
+        if (m_Wakeup[0] != -1) (void)close(m_Wakeup[0]);
+        if (m_Wakeup[1] != -1) (void)close(m_Wakeup[1]);
+    }
+    CCanExecutor(const CCanExecutor &) = delete;
+    CCanExecutor &operator=(const CCanExecutor &) = delete;
+
+    void Spawn(CCanTask<void> task) {
+        // take over the task and schedule it for its first run
+        TaskHandle handle = std::exchange(task.m_Handle, nullptr);
+        if (handle) {
+            handle.promise().executor = this;
+            m_Tasks.push_back(handle);
+            m_Ready.push_back(handle);
+        }
+    }
+    void Run() {
+        // run until all tasks have finished, or until stopped
+        m_Stop = false;
+        while (!m_Stop && RunOnce(-1))
+            ;
+    }
+    bool RunOnce(int timeout) {
+        // resume all coroutines ready to run
+        while (!m_Ready.empty()) {
+            std::coroutine_handle<> next = m_Ready.front();
+            m_Ready.pop_front();
+            next.resume();
+        }
+        // release the finished tasks (the first exception is rethrown)
+        std::exception_ptr exception;
+        for (auto it = m_Tasks.begin(); it != m_Tasks.end(); ) {
+            if (it->done()) {
+                if (it->promise().exception && !exception)
+                    exception = it->promise().exception;
+                it->destroy();
+                it = m_Tasks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (exception)
+            std::rethrow_exception(exception);
+        if (m_Tasks.empty())
+            return false;
+        // wait for an event, the next deadline or the given time-out [ms]
+        Clock::time_point now = Clock::now();
+        m_PollFds.clear();
+        m_PollMap.clear();
+        m_PollFds.push_back({m_Wakeup[0], POLLIN, 0});
+        m_PollMap.push_back(nullptr);
+        for (SWaiter *waiter : m_Waiters) {
+            if (waiter->canceled || (waiter->deadline <= now)) {
+                timeout = 0;
+            } else if (waiter->deadline != Clock::time_point::max()) {
+                auto delay = std::chrono::ceil<std::chrono::milliseconds>(waiter->deadline - now).count();
+                if ((timeout < 0) || (delay < timeout))
+                    timeout = (int)delay;
+            }
+            if (waiter->fd >= 0) {
+                m_PollFds.push_back({waiter->fd, POLLIN, 0});
+                m_PollMap.push_back(waiter);
+            }
+        }
+        if (poll(m_PollFds.data(), (nfds_t)m_PollFds.size(), timeout) < 0) {
+            if (errno != EINTR)
+                return true;
+        }
+        if (m_PollFds[0].revents) {
+            char buffer[64];
+            while (read(m_Wakeup[0], buffer, sizeof(buffer)) > 0)
+                ;
+        }
+        // schedule the coroutines whose event occurred
+        now = Clock::now();
+        for (size_t i = 1U; i < m_PollFds.size(); i++) {
+            if (m_PollFds[i].revents)
+                Resume(m_PollMap[i], WaitReady);
+        }
+        for (SWaiter *waiter : std::vector<SWaiter *>(m_Waiters)) {
+            if (waiter->canceled)
+                Resume(waiter, WaitCanceled);
+            else if (waiter->deadline <= now)
+                Resume(waiter, WaitTimeout);
+        }
+        return true;
+    }
+    void Stop() {
+        // note: can be called from any thread
+        m_Stop = true;
+        Wakeup();
+    }
+    void Wakeup() {
+        // note: can be called from any thread
+        if (m_Wakeup[1] != -1)
+            (void)!write(m_Wakeup[1], "", 1);
+    }
+    int GetFd() const { return m_Wakeup[0]; }
+    size_t GetTasks() const { return m_Tasks.size(); }
+
+    /// \brief  awaitable: wait until a file descriptor is readable, a deadline
+    ///         expired or a cancellation was requested (whatever comes first)
+    class CWait {
+        struct SCancel {
+            SWaiter *waiter;
+            CCanExecutor **executor;
+            void operator()() noexcept {
+                waiter->canceled = true;
+                if (*executor)
+                    (*executor)->Wakeup();
+            }
+        };
+        SWaiter m_Waiter;
+        std::stop_token m_Token;
+        CCanExecutor *m_Executor = nullptr;
+        std::optional<std::stop_callback<SCancel>> m_Callback;
+    public:
+        CWait(int fd, Clock::time_point deadline, std::stop_token token) : m_Token(std::move(token)) {
+            m_Waiter.fd = fd;
+            m_Waiter.deadline = deadline;
+        }
+        CWait(const CWait &) = delete;
+        CWait &operator=(const CWait &) = delete;
+        ~CWait() {
+            m_Callback.reset();
+            if (m_Waiter.registered && m_Executor)
+                m_Executor->Unregister(&m_Waiter);
+        }
+        bool await_ready() noexcept {
+            if (m_Token.stop_requested()) {
+                m_Waiter.result = WaitCanceled;
+                return true;
+            }
+            return false;
+        }
+        template<typename P>
+        void await_suspend(std::coroutine_handle<P> handle) {
+            m_Executor = handle.promise().executor;
+            m_Waiter.handle = handle;
+            m_Executor->Register(&m_Waiter);
+            if (m_Token.stop_possible())
+                m_Callback.emplace(m_Token, SCancel{&m_Waiter, &m_Executor});
+        }
+        EWaitResult await_resume() noexcept {
+            m_Callback.reset();
+            return m_Waiter.result;
+        }
+    };
+    static CWait WaitReadable(int fd, Clock::time_point deadline, std::stop_token token = {}) {
+        return CWait(fd, deadline, std::move(token));
+    }
+    static CWait Sleep(std::chrono::milliseconds delay, std::stop_token token = {}) {
+        return CWait(-1, Clock::now() + delay, std::move(token));
+    }
+private:
+    void Register(SWaiter *waiter) {
+        waiter->registered = true;
+        m_Waiters.push_back(waiter);
+    }
+    void Unregister(SWaiter *waiter) {
+        for (auto it = m_Waiters.begin(); it != m_Waiters.end(); ++it) {
+            if (*it == waiter) {
+                m_Waiters.erase(it);
+                break;
+            }
+        }
+        waiter->registered = false;
+    }
+    void Resume(SWaiter *waiter, EWaitResult result) {
+        if (waiter->registered) {
+            Unregister(waiter);
+            waiter->result = result;
+            m_Ready.push_back(waiter->handle);
+        }
+    }
+};
+/// \}
+
+/// \name   SerialCAN Async API
+/// \brief  CSerialCAN with awaitable read and write operations (C++20).
+/// \note   The operations must be awaited from a CCanTask that is running
+///         on a CCanExecutor. The reception is driven by the receive event
+///         file descriptor of the CAN interface (property RCV_EVENT_FD);
+///         the transmitter is retried while busy. All operations can be
+///         canceled by a std::stop_token. The message buffers passed by
+///         reference must exist until the operation has completed.
+/// \{
+class CSerialCANAsync : public CSerialCAN {
+public:
+    typedef CCanExecutor::Clock Clock;
+    enum EAsyncErrorCodes {
+        OperationCanceled = VendorSpecific - ECANCELED  ///< canceled by a stop request
+    };
+    static constexpr std::chrono::milliseconds PollInterval{1};  ///< without event fd, or when busy
+
+    /// \brief  read one message (awaitable), CANERR_RX_EMPTY on time-out
+    CCanTask<CANAPI_Return_t> ReadMessageAsync(CANAPI_Message_t &message, uint16_t timeout = CANWAIT_INFINITE, std::stop_token token = {}) {
+        co_return co_await ReadMessageUntil(message, Deadline(timeout), token);
+    }
+    /// \brief  read one message (awaitable), CANERR_RX_EMPTY when the deadline expired
+    CCanTask<CANAPI_Return_t> ReadMessageUntil(CANAPI_Message_t &message, Clock::time_point deadline, std::stop_token token = {}) {
+        for (;;) {
+            CANAPI_Return_t rc = ReadMessage(message, 0U);
+            if (rc != CANERR_RX_EMPTY)
+                co_return rc;
+            // wait for the receive event (or poll when not available)
+            int32_t fd = -1;
+            if (GetProperty(SERIALCAN_PROPERTY_RCV_EVENT_FD, (void *)&fd, sizeof(int32_t)) != CANERR_NOERROR)
+                fd = -1;
+            Clock::time_point until = deadline;
+            if ((fd < 0) && ((Clock::now() + PollInterval) < deadline))
+                until = Clock::now() + PollInterval;
+            CCanExecutor::EWaitResult result = co_await CCanExecutor::WaitReadable(fd, until, token);
+            if (result == CCanExecutor::WaitCanceled)
+                co_return (CANAPI_Return_t)OperationCanceled;
+            if ((result == CCanExecutor::WaitTimeout) && (Clock::now() >= deadline))
+                co_return (CANAPI_Return_t)CANERR_RX_EMPTY;
+        }
+    }
+    /// \brief  write one message (awaitable), CANERR_TX_BUSY on time-out
+    CCanTask<CANAPI_Return_t> WriteMessageAsync(CANAPI_Message_t message, uint16_t timeout = 0U, std::stop_token token = {}) {
+        Clock::time_point deadline = Deadline(timeout);
+        for (;;) {
+            CANAPI_Return_t rc = WriteMessage(message, 0U);
+            if ((rc != CANERR_TX_BUSY) || (Clock::now() >= deadline))
+                co_return rc;
+            // yield to other tasks while the transmitter is busy
+            if (co_await CCanExecutor::Sleep(PollInterval, token) == CCanExecutor::WaitCanceled)
+                co_return (CANAPI_Return_t)OperationCanceled;
+        }
+    }
+    /// \brief  wait for a message with the given identifier (awaitable),
+    ///         messages with other identifiers are discarded,
+    ///         CANERR_TIMEOUT when the deadline expired
+    CCanTask<CANAPI_Return_t> WaitForId(uint32_t id, Clock::time_point deadline, CANAPI_Message_t &message, std::stop_token token = {}) {
+        for (;;) {
+            CANAPI_Return_t rc = co_await ReadMessageUntil(message, deadline, token);
+            if (rc == CANERR_RX_EMPTY)
+                co_return (CANAPI_Return_t)CANERR_TIMEOUT;
+            if (rc != CANERR_NOERROR)
+                co_return rc;
+            if (!message.sts && (message.id == id))
+                co_return (CANAPI_Return_t)CANERR_NOERROR;
+        }
+    }
+private:
+    static Clock::time_point Deadline(uint16_t timeout) {
+        return (timeout == CANWAIT_INFINITE) ? Clock::time_point::max()
+                                             : Clock::now() + std::chrono::milliseconds(timeout);
+    }
+};
+/// \}
+
+#endif // SERIALCAN_ASYNC_H_INCLUDED
@@ -78,12 +78,21 @@
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
 #include "slcan.h"
+#include "shmem.h"
+#include "isotp.h"
+#include "j1939.h"
+#include "timer.h"
 #else
 #include <unistd.h>
 #include "slcan.h"
+#include "shmem.h"
+#include "isotp.h"
+#include "j1939.h"
+#include "timer.h"
 #endif
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -117,7 +126,7 @@ static void _finalizer() {
 #endif
 #define INVALID_HANDLE          (-1)
 #define IS_HANDLE_VALID(hnd)    ((0 <= (hnd)) && ((hnd) < CAN_MAX_HANDLES))
-#define IS_HANDLE_OPENED(hnd)   (can[hnd].port != NULL)
+#define IS_HANDLE_OPENED(hnd)   ((can[hnd].port != NULL) || (can[hnd].shm != NULL))
 
 #define SERIAL_BAUDRATE         57600U
 #define SERIAL_BYTESIZE         CANSIO_8DATABITS
@@ -125,10 +134,19 @@ static void _finalizer() {
 #define SERIAL_STOPBITS         CANSIO_1STOPBIT
 #define SERIAL_PROTOCOL         CANSIO_LAWICEL
 
-#define SUPPORTED_OP_MODE       (CANMODE_DEFAULT)
+#define SUPPORTED_OP_MODE       (CANMODE_MON | CANMODE_ERR)
 #define CAN_CLOCK_FREQUENCY     CANBTR_FREQ_SJA1000
 #define CAN_BTR_DEFAULT         0x011CU
 #define SLCAN_QUEUE_SIZE        65536U
+#define SLCAN_QUEUE_OPTIONS     SLCAN_QUEUE_LAZY_COMMIT
+#define SLCAN_QUEUE_OPTION_MASK (CANSIO_QUEUE_LAZY_COMMIT | CANSIO_QUEUE_HUGE_PAGES | CANSIO_QUEUE_SHRINK_IDLE)
+#define SLCAN_QUEUE_POLICY      SLCAN_QUEUE_DROP_NEWEST
+#define CAN_READ_N_CHUNK        64U
+#define CAN_WRITE_N_CHUNK       64U
+#define AUTO_BAUD_FRAMES        2       // received frames for an early decision
+#define AUTO_BAUD_POLL          5U      // polling interval of the bit-rate detection (in [ms])
+#define CTRL_MODE_SILENT        0x01U   // listen-only mode (Lawicel: 'L', CANable: 'M1')
+#define CTRL_MODE_ONE_SHOT      0x02U   // no automatic retransmission (CANable: 'A0')
 #define FILTER_STD_CODE         (uint32_t)(0x000)
 #define FILTER_STD_MASK         (uint32_t)(0x000)
 #define FILTER_XTD_CODE         (uint32_t)(0x00000000)
@@ -167,15 +185,33 @@ typedef struct {                        // frame counters:
 
 typedef struct {                        // SLCAN interface:
     slcan_port_t port;                  //   serial communication port
+    shmem_t shm;                        //   shared-memory rings (CANSIO_SHARED)
     can_sio_attr_t attr;                //   serial communication attributes
     can_mode_t mode;                    //   operation mode of the CAN channel
     can_filter_t filter;                //   message filter settings
     can_status_t status;                //   8-bit status register
     can_counter_t counters;             //   statistical counters
     uint16_t btr0btr1;                  //   bit-rate settings
+    uint32_t queue_options;             //   memory options of the reception queue
+    uint8_t queue_policy;               //   overflow policy of the reception queue
+    uint16_t queue_block_time;          //   max. blocking time of the reception (in [ms])
+    uint32_t lane_size;                 //   size of each priority lane (0 = no lanes)
+    uint16_t auto_baud_dwell;           //   dwell time per bit-rate candidate (in [ms])
+    uint8_t ctrl_mode;                  //   controller mode to be applied (CTRL_MODE_xxx)
+    uint8_t ctrl_set;                   //   controller mode set in the device (CANable)
+    uint16_t status_poll_time;          //   polling interval of the status flags (in [ms])
+    int gateway;                        //   handle of the gateway target (-1 = none)
+    isotp_t isotp;                      //   ISO-TP engine (created on first use)
+    j1939_t j1939;                      //   J1939 engine (can_j1939_init)
     char name[CANPROP_MAX_BUFFER_SIZE]; //   TTY device name
 }   can_interface_t;
 
+typedef struct {                        // element layout of a batch:
+    int (*map)(can_interface_t *iface, const void *items, size_t index, slcan_message_t *slcan);
+    void (*unmap)(can_interface_t *iface, const slcan_message_t *slcan, void *items, size_t index);
+    void (*shared)(const can_message_t *msg, void *items, size_t index);  // NULL = CAN messages
+}   batch_layout_t;
+
 /*  -----------  prototypes  ---------------------------------------------
  */
 static void var_init(void);             // initialize all variables
@@ -189,6 +225,29 @@ static int slcan_error(int code);       // SLCAN specific errors
 static int get_sio_attr(slcan_port_t port, can_sio_attr_t *attr);
 static int set_filter(int handle, uint64_t filter, bool xtd);
 static int reset_filter(int handle);
+static int set_gateway(int handle, const can_sio_gateway_t *gateway);
+static int detect_bitrate(int handle, int32_t *index);
+static void update_status(can_interface_t *iface, uint8_t status);
+static int map_message(can_interface_t *iface, const can_message_t *msg, slcan_message_t *slcan);
+static void unmap_message(can_interface_t *iface, const slcan_message_t *slcan, can_message_t *msg);
+static int map_frame(can_interface_t *iface, const can_frame_t *frame, slcan_message_t *slcan);
+static void unmap_frame(can_interface_t *iface, const slcan_message_t *slcan, can_frame_t *frame);
+static int write_message(can_interface_t *iface, const can_message_t *msg, uint16_t timeout);
+static int read_message(can_interface_t *iface, can_message_t *msg, uint16_t timeout);
+static int write_batch(can_interface_t *iface, const batch_layout_t *layout, const void *items, size_t count, uint16_t timeout);
+static int read_batch(can_interface_t *iface, const batch_layout_t *layout, void *items, size_t count, uint16_t timeout);
+static int map_message_at(can_interface_t *iface, const void *items, size_t index, slcan_message_t *slcan);
+static void unmap_message_at(can_interface_t *iface, const slcan_message_t *slcan, void *items, size_t index);
+static int map_frame_at(can_interface_t *iface, const void *items, size_t index, slcan_message_t *slcan);
+static void unmap_frame_at(can_interface_t *iface, const slcan_message_t *slcan, void *items, size_t index);
+static void frame_shared_at(const can_message_t *msg, void *items, size_t index);
+
+static int init_shared(int handle, const char *name, uint8_t mode);
+static int start_shared(int handle, const can_bitrate_t *bitrate);
+static int post_shared(can_interface_t *iface, const can_message_t *msg, uint16_t timeout);
+static int read_shared(can_interface_t *iface, can_message_t *msgs, size_t count, uint16_t timeout);
+static void frame_shared(const can_message_t *msg, can_frame_t *frame);
+static int shared_parameter(int handle, uint16_t param, void *value, size_t nbyte);
 
 static int lib_parameter(uint16_t param, void *value, size_t nbyte);
 static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte);
@@ -205,6 +264,17 @@ can_board_t can_boards[NUM_CHANNELS+1] = {  // list of supported CAN channels
 //static const uint8_t dlc_table[16] = {  // DLC to length
 //    0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
 //};
+static const int32_t auto_baud[] = {   // bit-rate candidates (by their likelihood)
+    CANBTR_INDEX_500K, CANBTR_INDEX_250K, CANBTR_INDEX_125K,
+    CANBTR_INDEX_1M, CANBTR_INDEX_100K, CANBTR_INDEX_50K,
+    CANBTR_INDEX_800K, CANBTR_INDEX_20K, CANBTR_INDEX_10K
+};
+static const batch_layout_t message_layout = {  // can_write_n/can_read_n
+    map_message_at, unmap_message_at, NULL
+};
+static const batch_layout_t frame_layout = {  // can_write_frames/can_read_frames
+    map_frame_at, unmap_frame_at, frame_shared_at
+};
 static can_interface_t can[CAN_MAX_HANDLES];  // interface handles
 static int init = 0;                    // initialization flag
 
@@ -249,6 +319,7 @@ int can_test(int32_t channel, uint8_t mode, const void *param, int *result)
     case CANSIO_LAWICEL: break;         //   Lawicel SLCAN protocol
     case CANSIO_CANABLE: break;         //   CANable SLCAN protocol
     case CANSIO_WEACT:   break;         //   WeAct SLCAN protocol
+    case CANSIO_SHARED:  break;         //   shared access (SerialCAN daemon)
     default:                            //   sorry, not supported
         rc = CANERR_ILLPARA;
         goto end_test;
@@ -260,7 +331,7 @@ int can_test(int32_t channel, uint8_t mode, const void *param, int *result)
     }
     /* check if the SLCAN device is occupied by own process */
     for (i = 0; i < CAN_MAX_HANDLES; i++) {
-        if (can[i].port && !strcmp(can[i].name, name)) {
+        if (IS_HANDLE_OPENED(i) && !strcmp(can[i].name, name)) {
             if (result)
                 *result = CANBRD_OCCUPIED;
             break;
@@ -309,12 +380,12 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
         init = 1;                       //   set initialization flag
     }
     for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if ((can[handle].port != NULL) &&  // channel already in use
+        if (IS_HANDLE_OPENED(handle) &&  // channel already in use
             !strcmp(can[handle].name, name))
             return CANERR_YETINIT;
     }
     for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if (can[handle].port == NULL)   // get an unused handle, if any
+        if (!IS_HANDLE_OPENED(handle))  // get an unused handle, if any
             break;
     }
     if (!IS_HANDLE_VALID(handle)) {     // no free handle found
@@ -325,6 +396,7 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
     case CANSIO_LAWICEL: break;         //   Lawicel SLCAN protocol
     case CANSIO_CANABLE: break;         //   CANable SLCAN protocol
     case CANSIO_WEACT:   break;         //   WeAct SLCAN protocol
+    case CANSIO_SHARED:  break;         //   shared access (SerialCAN daemon)
     default:                            //   sorry, not supported
         rc = CANERR_ILLPARA;
         goto err_init;
@@ -334,6 +406,17 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
         rc = CANERR_ILLPARA;
         goto err_init;
     }
+    // shared access: attach to the SerialCAN daemon which owns the TTY
+    if (((can_sio_param_t*)param)->attr.protocol == CANSIO_SHARED) {
+        // note: the daemon owns the CAN controller (listen-only mode not possible)
+        //       and does not publish status messages (error frames not possible)
+        if ((mode & (CANMODE_MON | CANMODE_ERR)) != 0) {
+            rc = CANERR_ILLPARA;
+            goto err_init;
+        }
+        return init_shared(handle, name, mode);
+    }
+
     // create an SLCAN port (w/ message queue)
     can[handle].port = slcan_create(SLCAN_QUEUE_SIZE);
     if (can[handle].port == NULL) {
@@ -376,6 +459,20 @@ int can_init(int32_t channel, uint8_t mode, const void *param)
     (void)get_sio_attr(can[handle].port, &can[handle].attr);
     can[handle].mode.byte = mode;       // store selected operation mode
     can[handle].status.byte = CANSTAT_RESET; // CAN controller not started yet
+    can[handle].queue_options = SLCAN_QUEUE_OPTIONS;
+    can[handle].queue_policy = SLCAN_QUEUE_POLICY;
+    can[handle].queue_block_time = 0U;
+    can[handle].lane_size = 0U;
+    can[handle].auto_baud_dwell = CANSIO_AUTO_BAUD_DWELL;
+    can[handle].ctrl_mode = (mode & CANMODE_MON) ? CTRL_MODE_SILENT : 0x00U;
+    can[handle].ctrl_set = 0x00U;       // device defaults (M0, A1)
+    can[handle].status_poll_time = CANSIO_STATUS_POLL_TIME;
+    // error frames: in-band status messages in the receive queue
+    if ((mode & CANMODE_ERR) != 0)
+        (void)slcan_status_events(can[handle].port, true);
+    can[handle].gateway = -1;
+    can[handle].isotp = NULL;
+    can[handle].j1939 = NULL;
     return handle;                      // return the handle
 
 err_init:                               // otherwise:
@@ -386,6 +483,7 @@ err_init:                               // otherwise:
 static int exit_channel(int handle)
 {
     int rc;                             // return value
+    int i;                              // loop variable
 
     if (!IS_HANDLE_VALID(handle))       // must be a valid handle
         return CANERR_HANDLE;
@@ -394,11 +492,39 @@ static int exit_channel(int handle)
     if (!can[handle].status.can_stopped) { // if running then go bus off
         (void)can_reset(handle);
     }
+    for (i = 0; i < CAN_MAX_HANDLES; i++) {  // remove gateways to this interface
+        if (IS_HANDLE_OPENED(i) && (can[i].gateway == handle)) {
+            // note: returns when the reception thread of the source no longer
+            //       forwards to this interface (it can then be destroyed)
+            (void)slcan_gateway(can[i].port, NULL, NULL, 0U);
+            can[i].gateway = -1;
+        }
+    }
+    can[handle].gateway = -1;
+    if (can[handle].shm != NULL) {      // shared access:
+        (void)shmem_destroy(can[handle].shm);  //   detach from the daemon
+        can[handle].status.byte |= CANSTAT_RESET;
+        can[handle].shm = NULL;         //   handle can be used again
+        return CANERR_NOERROR;
+    }
+    if (can[handle].ctrl_set & CTRL_MODE_SILENT)  // restore the device defaults
+        (void)slcan_silent_mode(can[handle].port, false);
+    if (can[handle].ctrl_set & CTRL_MODE_ONE_SHOT)
+        (void)slcan_auto_retransmit(can[handle].port, true);
+    can[handle].ctrl_set = 0x00U;
     rc = slcan_disconnect(can[handle].port);  // disconnect serial interface
     rc = slcan_error(rc);
     if (rc != CANERR_NOERROR) {         // errno is set in this case
         return rc;
     }
+    if (can[handle].isotp != NULL) {    // ISO-TP engine (waits for blocked callers)
+        (void)isotp_destroy(can[handle].isotp);
+        can[handle].isotp = NULL;
+    }
+    if (can[handle].j1939 != NULL) {    // J1939 engine (waits for blocked callers)
+        (void)j1939_destroy(can[handle].j1939);
+        can[handle].j1939 = NULL;
+    }
     (void)slcan_destroy(can[handle].port);  // destroy SLCAN port
 
     can[handle].status.byte |= CANSTAT_RESET;  // CAN controller in INIT state
@@ -438,7 +564,10 @@ static int kill_channel(int handle)
         return CANERR_HANDLE;
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
-    rc = slcan_signal(can[handle].port);// wake up the SLCAN thread
+    if (can[handle].shm == NULL)
+        rc = slcan_signal(can[handle].port);// wake up the SLCAN thread
+    else
+        rc = shmem_signal(can[handle].shm); // wake up a waiting reader
     rc = slcan_error(rc);
     if (rc != CANERR_NOERROR) {         // errno is set in this case
         return rc;
@@ -485,9 +614,19 @@ int can_start(int handle, const can_bitrate_t *bitrate)
     if (!can[handle].status.can_stopped) // must be stopped
         return CANERR_ONLINE;
 
+    // automatic bit-rate detection (listen-only probing)
+    //
+    if (bitrate->index == CANSIO_BITRATE_AUTO) {
+        temporary.index = CANSIO_BITRATE_AUTO;
+        // shared access: take over the bit-rate of the daemon
+        if (can[handle].shm != NULL)
+            return start_shared(handle, &temporary);
+        if ((rc = detect_bitrate(handle, &temporary.index)) != CANERR_NOERROR)
+            return rc;
+    }
     // note: CANable devices do not support SJA1000 bit-rate settings
     //
-    if ((bitrate->index > 0) && (can[handle].attr.protocol == CANSIO_CANABLE || can[handle].attr.protocol == CANSIO_WEACT)) {
+    else if ((bitrate->index > 0) && (can[handle].attr.protocol == CANSIO_CANABLE || can[handle].attr.protocol == CANSIO_WEACT)) {
         // convert bit-rate settings to index (SJA1000)
         if(btr_bitrate2index(bitrate, &temporary.index) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
@@ -499,6 +638,10 @@ int can_start(int handle, const can_bitrate_t *bitrate)
         // accept both: bit-rate settings or index
         memcpy(&temporary, bitrate, sizeof(can_bitrate_t));
     }
+    // shared access: the daemon has started the CAN controller already
+    if (can[handle].shm != NULL)
+        return start_shared(handle, &temporary);
+
     // set bit-rate (from index or BTR0BTR1 register)
     if (temporary.index <= 0) {
         // convert index to SJA1000 BTR0/BTR1 register
@@ -525,10 +668,35 @@ int can_start(int handle, const can_bitrate_t *bitrate)
         if (rc < 0)
             return slcan_error(rc);
     }
-    // start the CAN controller
-    rc = slcan_open_channel(can[handle].port);
+    // set the controller mode (CANable: silent mode and auto-retransmission)
+    if (can[handle].attr.protocol == CANSIO_CANABLE || can[handle].attr.protocol == CANSIO_WEACT) {
+        // note: the commands are only sent when the mode differs from the device,
+        //       so that firmware without these commands is still operable
+        if ((can[handle].ctrl_mode ^ can[handle].ctrl_set) & CTRL_MODE_SILENT) {
+            rc = slcan_silent_mode(can[handle].port, (can[handle].ctrl_mode & CTRL_MODE_SILENT) ? true : false);
+            if (rc < 0)
+                return slcan_error(rc);
+            can[handle].ctrl_set ^= CTRL_MODE_SILENT;
+        }
+        if ((can[handle].ctrl_mode ^ can[handle].ctrl_set) & CTRL_MODE_ONE_SHOT) {
+            rc = slcan_auto_retransmit(can[handle].port, (can[handle].ctrl_mode & CTRL_MODE_ONE_SHOT) ? false : true);
+            if (rc < 0)
+                return slcan_error(rc);
+            can[handle].ctrl_set ^= CTRL_MODE_ONE_SHOT;
+        }
+        // start the CAN controller
+        rc = slcan_open_channel(can[handle].port);
+    }
+    // start the CAN controller (Lawicel: in listen-only mode, if requested)
+    else if (can[handle].ctrl_mode & CTRL_MODE_SILENT)
+        rc = slcan_listen_channel(can[handle].port);
+    else
+        rc = slcan_open_channel(can[handle].port);
     if (rc < 0)
         return slcan_error(rc);
+    // error frames: poll the status flags (not supported by CANable devices)
+    if (can[handle].mode.err && (can[handle].attr.protocol == CANSIO_LAWICEL))
+        (void)slcan_status_polling(can[handle].port, can[handle].status_poll_time);
     // store the bit-rate settings
     can[handle].btr0btr1 = btr0btr1;
     // clear old status and counters
@@ -560,6 +728,13 @@ int can_reset(int handle)
         //       the CAN controller has not been started
         return CANERR_NOERROR;
 #endif
+    // shared access: the daemon keeps the CAN controller running
+    if (can[handle].shm != NULL) {
+        can[handle].status.can_stopped = 1;
+        return CANERR_NOERROR;
+    }
+    // stop polling the status flags, if any
+    (void)slcan_status_polling(can[handle].port, 0U);
     // stop the CAN controller (INIT state)
     rc = slcan_close_channel(can[handle].port);
     rc = slcan_error(rc);
@@ -570,7 +745,72 @@ int can_reset(int handle)
 EXPORT
 int can_write(int handle, const can_message_t *msg, uint16_t timeout)
 {
-    slcan_message_t slcan;              // SLCAN message
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+
+    return write_message(&can[handle], msg, timeout);
+}
+
+EXPORT
+int can_read(int handle, can_message_t *msg, uint16_t timeout)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+
+    return read_message(&can[handle], msg, timeout);
+}
+
+EXPORT
+int can_write_n(int handle, const can_message_t *msgs, size_t count, uint16_t timeout)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+
+    return write_batch(&can[handle], &message_layout, msgs, count, timeout);
+}
+
+EXPORT
+int can_read_n(int handle, can_message_t *msgs, size_t count, uint16_t timeout)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+
+    return read_batch(&can[handle], &message_layout, msgs, count, timeout);
+}
+
+EXPORT
+int can_write_frames(int handle, const can_frame_t *frames, size_t count, uint16_t timeout)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+
+    return write_batch(&can[handle], &frame_layout, frames, count, timeout);
+}
+
+EXPORT
+int can_read_frames(int handle, can_frame_t *frames, size_t count, uint16_t timeout)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+
+    return read_batch(&can[handle], &frame_layout, frames, count, timeout);
+}
+
+EXPORT
+int can_subscribe(int handle, uint64_t filter11, uint64_t filter29, size_t queueSize)
+{
     int rc = CANERR_FATAL;              // return value
 
     if (!init)                          // must be initialized
@@ -579,43 +819,177 @@ int can_write(int handle, const can_message_t *msg, uint16_t timeout)
         return CANERR_HANDLE;
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
-    if (msg == NULL)                    // check for null-pointer
+    if ((queueSize == 0U) || (queueSize > (size_t)INT_MAX))
+        return CANERR_ILLPARA;          // invalid queue size
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+
+    // create a subscriber with its own message queue
+    rc = slcan_subscribe(can[handle].port, queueSize,
+                         (uint32_t)(filter11 >> 32), (uint32_t)filter11,
+                         (uint32_t)(filter29 >> 32), (uint32_t)filter29);
+    if (rc < 0)
+        rc = ((errno == ENOSPC) || (errno == ENOMEM)) ? CANERR_RESOURCE : slcan_error(rc);
+    return rc;
+}
+
+EXPORT
+int can_unsubscribe(int handle, int subscriber)
+{
+    int rc = CANERR_FATAL;              // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+
+    // remove the subscriber and its message queue
+    rc = slcan_unsubscribe(can[handle].port, subscriber);
+    return slcan_error(rc);
+}
+
+EXPORT
+int can_read_subscriber(int handle, int subscriber, can_message_t *messages, size_t count, uint16_t timeout)
+{
+    slcan_message_t slcan[CAN_READ_N_CHUNK];  // SLCAN messages
+    int rc = CANERR_FATAL;              // return value
+    size_t n = 0U;                      // number of messages
+    int i;
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if ((messages == NULL) || (count == 0U))  // check for null-pointer
         return CANERR_NULLPTR;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
     if (can[handle].status.can_stopped) // must be running
         return CANERR_OFFLINE;
+    if (count > (size_t)INT_MAX)        // limit to return type
+        count = (size_t)INT_MAX;
+
+    // read the CAN messages in chunks from the subscriber queue (wait for the first one only)
+    while (n < count) {
+        size_t chunk = ((count - n) < CAN_READ_N_CHUNK) ? (count - n) : CAN_READ_N_CHUNK;
+        rc = slcan_read_subscriber(can[handle].port, subscriber, slcan, chunk, (n == 0U) ? timeout : 0U);
+        if (rc <= 0)
+            break;
+        // map message layout (note: the receive counters are not updated)
+        for (i = 0; i < rc; i++)
+            unmap_message(NULL, &slcan[i], &messages[n + (size_t)i]);
+        n += (size_t)rc;
+        if ((size_t)rc < chunk)
+            break;
+    }
+    if ((n == 0U) && (rc != CANERR_RX_EMPTY))
+        rc = slcan_error(rc);
 
-    if (msg->id > (uint32_t)(msg->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
-        return CANERR_ILLPARA;          // invalid identifier
-    if (msg->dlc > CAN_MAX_DLC)
-        return CANERR_ILLPARA;          // invalid data length code
-    if (msg->xtd && can[handle].mode.nxtd)
-        return CANERR_ILLPARA;          // suppress extended frames
-    if (msg->rtr && can[handle].mode.nrtr)
-        return CANERR_ILLPARA;          // suppress remote frames
-    if (msg->sts)
-        return CANERR_ILLPARA;          // error frames cannot be sent
+    // note: the number of messages read is returned, or an error code
+    return (n > 0U) ? (int)n : rc;
+}
 
-    // map message layout
-    memset(&slcan, 0x00, sizeof(slcan_message_t));
-    slcan.can_id = msg->id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
-    slcan.can_id |= (msg->xtd ? CAN_XTD_FRAME : 0x00000000U);
-    slcan.can_id |= (msg->rtr ? CAN_RTR_FRAME : 0x00000000U);
-    slcan.can_dlc = msg->dlc;
-    memcpy(slcan.data, msg->data, slcan.can_dlc);
-    // transmit the CAN message
-    rc = slcan_write_message(can[handle].port, &slcan, timeout);
-    rc = slcan_error(rc);
-    // update status and tx counter
-    can[handle].status.transmitter_busy = (rc != CANERR_NOERROR) ? 1 : 0;
-    can[handle].counters.tx += (rc == CANERR_NOERROR) ? 1U : 0U;
+EXPORT
+int can_isotp_open(int handle, const void *param)
+{
+    const can_sio_isotp_t *channel = (const can_sio_isotp_t*)param;
+    isotp_param_t isotp;                // ISO-TP channel parameters
+    int rc = CANERR_FATAL;              // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if (channel == NULL)                // check for null-pointer
+        return CANERR_NULLPTR;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+
+    // map the channel parameters (identifier format by flag)
+    memset(&isotp, 0, sizeof(isotp_param_t));
+    isotp.txId = channel->xtd ? (channel->txId | CAN_XTD_FRAME) : channel->txId;
+    isotp.rxId = channel->xtd ? (channel->rxId | CAN_XTD_FRAME) : channel->rxId;
+    isotp.mode = channel->mode;
+    isotp.txAddr = channel->txAddr;
+    isotp.rxAddr = channel->rxAddr;
+    isotp.blockSize = channel->blockSize;
+    isotp.stMin = channel->stMin;
+    isotp.padding = channel->padding ? true : false;
+    isotp.padByte = channel->padByte;
+    isotp.timeout = channel->timeout;
+
+    // create the ISO-TP engine on first use (it hooks into the reception thread)
+    if ((can[handle].isotp == NULL) &&
+        ((can[handle].isotp = isotp_create(can[handle].port)) == NULL))
+        return (errno == ENOMEM) ? CANERR_RESOURCE : (errno == EBUSY) ? CANERR_NOTSUPP : slcan_error(-1);
+    // open a channel of the engine (returns the channel number)
+    rc = isotp_open(can[handle].isotp, &isotp);
+    if (rc < 0)
+        rc = ((errno == ENOSPC) || (errno == ENOMEM)) ? CANERR_RESOURCE : (errno == EEXIST) ? CANERR_ILLPARA : slcan_error(rc);
+    return rc;
+}
+
+EXPORT
+int can_isotp_close(int handle, int channel)
+{
+    int rc = CANERR_FATAL;              // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+    if (can[handle].isotp == NULL)      // no channel opened yet
+        return CANERR_ILLPARA;
+
+    // close the channel (the engine stays installed)
+    rc = isotp_close(can[handle].isotp, channel);
+    return slcan_error(rc);
+}
+
+EXPORT
+int can_isotp_send(int handle, int channel, const uint8_t *data, size_t length)
+{
+    int rc = CANERR_FATAL;              // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if (data == NULL)                   // check for null-pointer
+        return CANERR_NULLPTR;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+    if (can[handle].isotp == NULL)      // no channel opened yet
+        return CANERR_ILLPARA;
+    if (can[handle].status.can_stopped) // must be running
+        return CANERR_OFFLINE;
 
+    // transmit the PDU (segmented and paced as requested by the receiver)
+    rc = isotp_send(can[handle].isotp, channel, data, length);
+    if (rc < 0) {
+        can[handle].status.transmitter_busy = (errno == EBUSY) ? 1 : 0;
+        rc = (errno == ETIMEDOUT) ? CANERR_TIMEOUT : (errno == EBUSY) ? CANERR_TX_BUSY : slcan_error(rc);
+    }
     return rc;
 }
 
 EXPORT
-int can_read(int handle, can_message_t *msg, uint16_t timeout)
+int can_isotp_receive(int handle, int channel, uint8_t *buffer, size_t size, uint16_t timeout)
 {
-    slcan_message_t slcan;              // SLCAN message
     int rc = CANERR_FATAL;              // return value
 
     if (!init)                          // must be initialized
@@ -624,39 +998,113 @@ int can_read(int handle, can_message_t *msg, uint16_t timeout)
         return CANERR_HANDLE;
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
-    if (msg == NULL)                    // check for null-pointer
+    if ((buffer == NULL) || (size == 0U))  // check for null-pointer
         return CANERR_NULLPTR;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+    if (can[handle].isotp == NULL)      // no channel opened yet
+        return CANERR_ILLPARA;
     if (can[handle].status.can_stopped) // must be running
         return CANERR_OFFLINE;
+    if (size > (size_t)INT_MAX)         // limit to return type
+        size = (size_t)INT_MAX;
 
-    memset(msg, 0x00, sizeof(can_message_t));
-    msg->id = 0xFFFFFFFFu;
-    msg->sts = 1;
+    // read the next PDU from the queue of the channel
+    rc = isotp_receive(can[handle].isotp, channel, buffer, size, timeout);
+    if ((rc < 0) && (rc != CANERR_RX_EMPTY))
+        rc = (errno == EMSGSIZE) ? CANERR_ILLPARA : slcan_error(rc);
+    return rc;
+}
 
-    // read one CAN message from message queue, if any
-    rc = slcan_read_message(can[handle].port, &slcan, timeout);
-    if (rc == CANERR_NOERROR) {
-        // map message layout
-        msg->xtd = (slcan.can_id & CAN_XTD_FRAME) ? 1 : 0;
-        msg->sts = (slcan.can_id & CAN_ERR_FRAME) ? 1 : 0;
-        msg->rtr = (slcan.can_id & CAN_RTR_FRAME) ? 1 : 0;
-        msg->id = slcan.can_id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
-        msg->dlc = (slcan.can_dlc < CAN_DLC_MAX) ? slcan.can_dlc : CAN_LEN_MAX;
-        memcpy(msg->data, slcan.data, msg->dlc);
-        // update receive counter
-        can[handle].counters.rx += !msg->sts ? 1U : 0U;
-        can[handle].counters.err += msg->sts ? 1U : 0U;
-    }
-    else if (rc != CANERR_RX_EMPTY) {
-        rc = slcan_error(rc);
-    }
-    else {
-        rc = CANERR_RX_EMPTY;
+EXPORT
+int can_j1939_init(int handle, const void *param)
+{
+    const can_sio_j1939_t *engine = (const can_sio_j1939_t*)param;
+    j1939_param_t j1939;                // J1939 engine parameters
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+    if (can[handle].j1939 != NULL)      // only one engine per interface
+        return CANERR_YETINIT;
+
+    // map the engine parameters (defaults without)
+    memset(&j1939, 0, sizeof(j1939_param_t));
+    if (engine != NULL) {
+        j1939.options = engine->options;
+        j1939.sessions = engine->sessions;
+        j1939.queueSize = engine->queueSize;
     }
-    // update status register
-    can[handle].status.receiver_empty = (rc != CANERR_NOERROR) ? 1 : 0;
-    can[handle].status.queue_overrun |= (errno == ENOSPC) ? 1 : 0;
+    // create the J1939 engine (it hooks into the reception thread)
+    if ((can[handle].j1939 = j1939_create(can[handle].port, &j1939)) == NULL)
+        return (errno == ENOMEM) ? CANERR_RESOURCE : (errno == EBUSY) ? CANERR_NOTSUPP : slcan_error(-1);
+    return CANERR_NOERROR;
+}
+
+EXPORT
+int can_j1939_claim(int handle, uint8_t address, uint64_t name)
+{
+    int rc = CANERR_FATAL;              // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+    if (can[handle].j1939 == NULL)      // not initialized yet
+        return CANERR_ILLPARA;
+    if (can[handle].status.can_stopped) // must be running
+        return CANERR_OFFLINE;
+
+    // claim the address (waits for contending claims)
+    rc = j1939_claim(can[handle].j1939, address, name);
+    if (rc < 0)
+        rc = (errno == EBUSY) ? CANERR_TX_BUSY : slcan_error(rc);
+    return rc;
+}
+
+EXPORT
+int can_j1939_receive(int handle, uint32_t *pgn, uint8_t *src, uint8_t *dst, uint8_t *data, size_t size, uint16_t timeout)
+{
+    j1939_pdu_t pdu;                    // J1939 PDU
+    int rc = CANERR_FATAL;              // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+        return CANERR_HANDLE;
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        return CANERR_HANDLE;
+    if ((data == NULL) || (size == 0U)) // check for null-pointer
+        return CANERR_NULLPTR;
+    if (can[handle].shm != NULL)        // not with shared access
+        return CANERR_NOTSUPP;
+    if (can[handle].j1939 == NULL)      // not initialized yet
+        return CANERR_ILLPARA;
+    if (can[handle].status.can_stopped) // must be running
+        return CANERR_OFFLINE;
 
+    // read the next PDU from the queue of the engine
+    rc = j1939_receive(can[handle].j1939, &pdu, timeout);
+    if (rc >= 0) {
+        if (pgn) *pgn = pdu.pgn;
+        if (src) *src = pdu.src;
+        if (dst) *dst = pdu.dst;
+        if ((size_t)rc <= size)
+            memcpy(data, pdu.data, (size_t)rc);
+        else                            // buffer too small (PDU discarded)
+            rc = CANERR_ILLPARA;
+    }
+    else if (rc != CANERR_RX_EMPTY)
+        rc = slcan_error(rc);
     return rc;
 }
 
@@ -666,6 +1114,8 @@ int can_status(int handle, uint8_t *status)
     int rc = CANERR_FATAL;              // return value
 
     slcan_flags_t flags;                // SLCAN flags
+    can_sio_shared_t info;              // daemon status (shared access)
+    can_status_t device;                // device status (shared access)
 
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
@@ -674,7 +1124,17 @@ int can_status(int handle, uint8_t *status)
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
 
-    if (!can[handle].status.can_stopped) { // if running get bus status
+    if (!can[handle].status.can_stopped && (can[handle].shm != NULL)) {
+        // get status-register of the device from the daemon
+        if (shmem_info_read(can[handle].shm, &info, sizeof(can_sio_shared_t)) < 0)
+            return (errno == EPIPE) ? CANERR_OFFLINE : slcan_error(-1);
+        device.byte = info.status;
+        can[handle].status.message_lost = device.message_lost;
+        can[handle].status.bus_error = device.bus_error;
+        can[handle].status.warning_level = device.warning_level;
+        can[handle].status.bus_off = device.bus_off;
+    }
+    else if (!can[handle].status.can_stopped) { // if running get bus status
         // get status-register from device (CAN API V1 compatible)
         switch (can[handle].attr.protocol) {
           case CANSIO_WEACT:
@@ -688,11 +1148,7 @@ int can_status(int handle, uint8_t *status)
         }
         if (rc < 0)
             return slcan_error(rc);
-        // TODO: SJA1000 datasheet, rtfm!
-        can[handle].status.message_lost = (flags.DOI | flags.RxFIFO | flags.TxFIFO) ? 1 : 0;
-        can[handle].status.bus_error = flags.BEI ? 1 : 0;
-        can[handle].status.warning_level = (flags.EI | flags.EPI);
-        can[handle].status.bus_off = flags.ALI;
+        update_status(&can[handle], flags.byte);
     }
     if (status)                         // status-register
         *status = can[handle].status.byte;
@@ -792,6 +1248,12 @@ char *can_hardware(int handle)
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return NULL;
 
+    // shared access: the device is owned by the daemon
+    if (can[handle].shm != NULL) {
+        snprintf(hardware, (2 * CANPROP_MAX_BUFFER_SIZE), "Shared memory (%s)", can[handle].name);
+        hardware[(2 * CANPROP_MAX_BUFFER_SIZE)] = '\0';
+        return (char*)hardware;
+    }
     // get version number: HW and SW
     if (slcan_version_number(can[handle].port, &hw_version, NULL) < 0)
         return NULL;
@@ -811,6 +1273,7 @@ char *can_firmware(int handle)
 {
     static char firmware[CANPROP_MAX_BUFFER_SIZE+1] = "";
     uint8_t sw_version = 0x00U;
+    can_sio_shared_t info;
 
     if (!init)                          // must be initialized
         return NULL;
@@ -819,6 +1282,17 @@ char *can_firmware(int handle)
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return NULL;
 
+    // shared access: the device is owned by the daemon
+    if (can[handle].shm != NULL) {
+        if (shmem_info_read(can[handle].shm, &info, sizeof(can_sio_shared_t)) < 0)
+            return NULL;
+        snprintf(firmware, CANPROP_MAX_BUFFER_SIZE, "SerialCAN daemon, pid %i (%s SLCAN protocol)", (int)info.pid,
+            info.protocol == CANSIO_LAWICEL ? "Lawicel" :
+            info.protocol == CANSIO_CANABLE ? "CANable" :
+            info.protocol == CANSIO_WEACT   ? "WeAct"   : "?");
+        firmware[CANPROP_MAX_BUFFER_SIZE] = '\0';
+        return (char*)firmware;
+    }
     // get version number: HW and SW
     if (slcan_version_number(can[handle].port, NULL, &sw_version) < 0)
         return NULL;
@@ -834,36 +1308,495 @@ char *can_firmware(int handle)
 
 /*  -----------  local functions  ----------------------------------------
  */
-static void var_init(void)
+static int write_message(can_interface_t *iface, const can_message_t *msg, uint16_t timeout)
 {
-    int i;
-
-    for (i = 0; i < CAN_MAX_HANDLES; i++) {
-        memset(&can[i], 0, sizeof(can_interface_t));
-        can[i].port = NULL;
-        can[i].name[0] = '\0';
-        can[i].attr.baudrate = SERIAL_BAUDRATE;
-        can[i].attr.bytesize = SERIAL_BYTESIZE;
-        can[i].attr.parity = SERIAL_PARITY;
-        can[i].attr.stopbits = SERIAL_STOPBITS;
-        can[i].attr.protocol = SERIAL_PROTOCOL;
-        can[i].btr0btr1 = CAN_BTR_DEFAULT;
-        can[i].mode.byte = CANMODE_DEFAULT;
-        can[i].status.byte = CANSTAT_RESET;
-        can[i].filter.sja1000.code = FILTER_SJA1000_CODE;
-        can[i].filter.sja1000.mask = FILTER_SJA1000_MASK;
-        can[i].filter.std.code = FILTER_STD_CODE;
-        can[i].filter.std.mask = FILTER_STD_MASK;
-        can[i].filter.xtd.code = FILTER_XTD_CODE;
-        can[i].filter.xtd.mask = FILTER_XTD_MASK;
-        can[i].counters.tx = 0ull;
-        can[i].counters.rx = 0ull;
-        can[i].counters.err = 0ull;
-    }
-}
+    slcan_message_t slcan;              // SLCAN message
+    int rc = CANERR_FATAL;              // return value
 
-static int all_closed(void)
-{
+    if ((iface->port == NULL) && (iface->shm == NULL))  // must be an open handle
+        return CANERR_HANDLE;
+    if (msg == NULL)                    // check for null-pointer
+        return CANERR_NULLPTR;
+    if (iface->status.can_stopped)      // must be running
+        return CANERR_OFFLINE;
+
+    // map message layout
+    if ((rc = map_message(iface, msg, &slcan)) != CANERR_NOERROR)
+        return rc;
+    // transmit the CAN message (or post it to the daemon)
+    if (iface->shm == NULL) {
+        rc = slcan_write_message(iface->port, &slcan, timeout);
+        rc = slcan_error(rc);
+    }
+    else
+        rc = post_shared(iface, msg, timeout);
+    // update status and tx counter
+    iface->status.transmitter_busy = (rc != CANERR_NOERROR) ? 1 : 0;
+    iface->counters.tx += (rc == CANERR_NOERROR) ? 1U : 0U;
+
+    return rc;
+}
+
+static int read_message(can_interface_t *iface, can_message_t *msg, uint16_t timeout)
+{
+    slcan_message_t slcan;              // SLCAN message
+    int rc = CANERR_FATAL;              // return value
+
+    if ((iface->port == NULL) && (iface->shm == NULL))  // must be an open handle
+        return CANERR_HANDLE;
+    if (msg == NULL)                    // check for null-pointer
+        return CANERR_NULLPTR;
+    if (iface->status.can_stopped)      // must be running
+        return CANERR_OFFLINE;
+
+    // shared access: read one CAN message from the ring of the daemon, if any
+    if (iface->shm != NULL) {
+        if ((rc = read_shared(iface, msg, 1U, timeout)) == 1)
+            return CANERR_NOERROR;
+        memset(msg, 0x00, sizeof(can_message_t));
+        msg->id = 0xFFFFFFFFu;
+        msg->sts = 1;
+        return rc;
+    }
+    // read one CAN message from message queue, if any
+    rc = slcan_read_message(iface->port, &slcan, timeout);
+    if (rc == CANERR_NOERROR) {
+        // map message layout and update receive counter
+        unmap_message(iface, &slcan, msg);
+    }
+    else {
+        // note: the message buffer is cleared only once (also on error)
+        memset(msg, 0x00, sizeof(can_message_t));
+        msg->id = 0xFFFFFFFFu;
+        msg->sts = 1;
+        rc = (rc != CANERR_RX_EMPTY) ? slcan_error(rc) : CANERR_RX_EMPTY;
+    }
+    // update status register
+    iface->status.receiver_empty = (rc != CANERR_NOERROR) ? 1 : 0;
+    iface->status.queue_overrun |= (errno == ENOSPC) ? 1 : 0;
+
+    return rc;
+}
+
+static int write_batch(can_interface_t *iface, const batch_layout_t *layout, const void *items, size_t count, uint16_t timeout)
+{
+    slcan_message_t slcan[CAN_WRITE_N_CHUNK];  // SLCAN messages
+    can_message_t msg;                  // CAN message (shared access)
+    int rc = CANERR_FATAL;              // return value
+    size_t n = 0U;                      // number of elements
+    size_t i, chunk;
+    int res;
+
+    if ((iface->port == NULL) && (iface->shm == NULL))  // must be an open handle
+        return CANERR_HANDLE;
+    if ((items == NULL) || (count == 0U))  // check for null-pointer
+        return CANERR_NULLPTR;
+    if (iface->status.can_stopped)      // must be running
+        return CANERR_OFFLINE;
+    if (count > (size_t)INT_MAX)        // limit to return type
+        count = (size_t)INT_MAX;
+
+    // shared access: post the elements one after the other (stop on error)
+    while ((iface->shm != NULL) && (n < count)) {
+        if ((rc = layout->map(iface, items, n, &slcan[0])) != CANERR_NOERROR)
+            break;
+        unmap_message(NULL, &slcan[0], &msg);
+        if ((rc = post_shared(iface, &msg, timeout)) != CANERR_NOERROR)
+            break;
+        iface->counters.tx++;
+        n++;
+    }
+    // transmit the elements in chunks, each by batched serial writes (stop on error)
+    // note: the ACK/NACK feedback of the device is not awaited (no time-out)
+    while ((iface->shm == NULL) && (n < count)) {
+        chunk = ((count - n) < CAN_WRITE_N_CHUNK) ? (count - n) : CAN_WRITE_N_CHUNK;
+        for (i = 0U, rc = CANERR_NOERROR; (i < chunk) && (rc == CANERR_NOERROR); i++)
+            rc = layout->map(iface, items, n + i, &slcan[i]);
+        if (rc != CANERR_NOERROR)       // invalid element (send the ones before)
+            chunk = i - 1U;
+        if (chunk > 0U) {
+            if ((res = slcan_write_messages(iface->port, slcan, chunk)) < 0) {
+                rc = ((errno == EBUSY) || (errno == EAGAIN)) ? CANERR_TX_BUSY : slcan_error(res);
+                break;
+            }
+            iface->counters.tx += (uint64_t)res;
+            n += (size_t)res;
+            if ((size_t)res < chunk) {  // serial port busy
+                rc = CANERR_TX_BUSY;
+                break;
+            }
+        }
+        if (rc != CANERR_NOERROR)
+            break;
+    }
+    // update status register
+    iface->status.transmitter_busy = (rc != CANERR_NOERROR) ? 1 : 0;
+
+    // note: the number of elements sent is returned, or the error of the first one
+    return (n > 0U) ? (int)n : rc;
+}
+
+static int read_batch(can_interface_t *iface, const batch_layout_t *layout, void *items, size_t count, uint16_t timeout)
+{
+    slcan_message_t slcan[CAN_READ_N_CHUNK];  // SLCAN messages
+    can_message_t msgs[CAN_READ_N_CHUNK];     // CAN messages (shared access)
+    int rc = CANERR_FATAL;              // return value
+    size_t n = 0U;                      // number of elements
+    int i;
+
+    if ((iface->port == NULL) && (iface->shm == NULL))  // must be an open handle
+        return CANERR_HANDLE;
+    if ((items == NULL) || (count == 0U))  // check for null-pointer
+        return CANERR_NULLPTR;
+    if (iface->status.can_stopped)      // must be running
+        return CANERR_OFFLINE;
+    if (count > (size_t)INT_MAX)        // limit to return type
+        count = (size_t)INT_MAX;
+
+    // shared access: the messages are copied from the ring of the daemon
+    if ((iface->shm != NULL) && (layout->shared == NULL))
+        return read_shared(iface, (can_message_t*)items, count, timeout);
+    while ((iface->shm != NULL) && (n < count)) {
+        size_t chunk = ((count - n) < CAN_READ_N_CHUNK) ? (count - n) : CAN_READ_N_CHUNK;
+        rc = read_shared(iface, msgs, chunk, (n == 0U) ? timeout : 0U);
+        if (rc <= 0)
+            break;
+        for (i = 0; i < rc; i++)
+            layout->shared(&msgs[i], items, n + (size_t)i);
+        n += (size_t)rc;
+        if ((size_t)rc < chunk)
+            break;
+    }
+    if (iface->shm != NULL)
+        return (n > 0U) ? (int)n : rc;
+
+    // read the elements in chunks from message queue (wait for the first one only)
+    while (n < count) {
+        size_t chunk = ((count - n) < CAN_READ_N_CHUNK) ? (count - n) : CAN_READ_N_CHUNK;
+        rc = slcan_read_messages(iface->port, slcan, chunk, (n == 0U) ? timeout : 0U);
+        if (rc <= 0)
+            break;
+        iface->status.queue_overrun |= (errno == ENOSPC) ? 1 : 0;
+        // map element layout and update receive counter
+        for (i = 0; i < rc; i++)
+            layout->unmap(iface, &slcan[i], items, n + (size_t)i);
+        n += (size_t)rc;
+        if ((size_t)rc < chunk)
+            break;
+    }
+    if ((n == 0U) && (rc != CANERR_RX_EMPTY))
+        rc = slcan_error(rc);
+    // update status register
+    iface->status.receiver_empty = (n == 0U) ? 1 : 0;
+
+    // note: the number of elements read is returned, or an error code
+    return (n > 0U) ? (int)n : rc;
+}
+
+static int map_message(can_interface_t *iface, const can_message_t *msg, slcan_message_t *slcan)
+{
+    if (msg->id > (uint32_t)(msg->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
+        return CANERR_ILLPARA;          // invalid identifier
+    if (msg->dlc > CAN_MAX_DLC)
+        return CANERR_ILLPARA;          // invalid data length code
+    if (msg->xtd && iface->mode.nxtd)
+        return CANERR_ILLPARA;          // suppress extended frames
+    if (msg->rtr && iface->mode.nrtr)
+        return CANERR_ILLPARA;          // suppress remote frames
+    if (msg->sts)
+        return CANERR_ILLPARA;          // error frames cannot be sent
+
+    memset(slcan, 0x00, sizeof(slcan_message_t));
+    slcan->can_id = msg->id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+    slcan->can_id |= (msg->xtd ? CAN_XTD_FRAME : 0x00000000U);
+    slcan->can_id |= (msg->rtr ? CAN_RTR_FRAME : 0x00000000U);
+    slcan->can_dlc = msg->dlc;
+    memcpy(slcan->data, msg->data, slcan->can_dlc);
+    return CANERR_NOERROR;
+}
+
+static void unmap_message(can_interface_t *iface, const slcan_message_t *slcan, can_message_t *msg)
+{
+    memset(msg, 0x00, sizeof(can_message_t));
+    msg->xtd = (slcan->can_id & CAN_XTD_FRAME) ? 1 : 0;
+    msg->sts = (slcan->can_id & CAN_ERR_FRAME) ? 1 : 0;
+    msg->rtr = (slcan->can_id & CAN_RTR_FRAME) ? 1 : 0;
+    msg->id = slcan->can_id & (msg->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+    msg->dlc = (slcan->can_dlc < CAN_DLC_MAX) ? slcan->can_dlc : CAN_LEN_MAX;
+    memcpy(msg->data, slcan->data, msg->dlc);
+    // update receive counter and status register (not for subscribers)
+    if (iface) {
+        iface->counters.rx += !msg->sts ? 1U : 0U;
+        iface->counters.err += msg->sts ? 1U : 0U;
+        if (msg->sts && (msg->id == CANSIO_STS_CONTROLLER))
+            update_status(iface, msg->data[0]);
+    }
+}
+
+static int map_frame(can_interface_t *iface, const can_frame_t *frame, slcan_message_t *slcan)
+{
+    if (frame->id > (uint32_t)(frame->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
+        return CANERR_ILLPARA;          // invalid identifier
+    if (frame->dlc > CAN_MAX_LEN)
+        return CANERR_ILLPARA;          // invalid data length code
+    if (frame->xtd && iface->mode.nxtd)
+        return CANERR_ILLPARA;          // suppress extended frames
+    if (frame->rtr && iface->mode.nrtr)
+        return CANERR_ILLPARA;          // suppress remote frames
+    if (frame->sts)
+        return CANERR_ILLPARA;          // error frames cannot be sent
+
+    memset(slcan, 0x00, sizeof(slcan_message_t));
+    slcan->can_id = frame->id & (frame->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+    slcan->can_id |= (frame->xtd ? CAN_XTD_FRAME : 0x00000000U);
+    slcan->can_id |= (frame->rtr ? CAN_RTR_FRAME : 0x00000000U);
+    slcan->can_dlc = frame->dlc;
+    memcpy(slcan->data, frame->data, slcan->can_dlc);
+    return CANERR_NOERROR;
+}
+
+static void unmap_frame(can_interface_t *iface, const slcan_message_t *slcan, can_frame_t *frame)
+{
+    // note: the frame is written as a whole (time-stamp 0, SLCAN has none)
+    memset(frame, 0x00, sizeof(can_frame_t));
+    frame->xtd = (slcan->can_id & CAN_XTD_FRAME) ? 1 : 0;
+    frame->sts = (slcan->can_id & CAN_ERR_FRAME) ? 1 : 0;
+    frame->rtr = (slcan->can_id & CAN_RTR_FRAME) ? 1 : 0;
+    frame->id = slcan->can_id & (frame->xtd ? CAN_XTD_MASK : CAN_STD_MASK);
+    frame->dlc = (slcan->can_dlc < CAN_DLC_MAX) ? slcan->can_dlc : CAN_LEN_MAX;
+    memcpy(frame->data, slcan->data, frame->dlc);
+    // update receive counter and status register
+    iface->counters.rx += !frame->sts ? 1U : 0U;
+    iface->counters.err += frame->sts ? 1U : 0U;
+    if (frame->sts && (frame->id == CANSIO_STS_CONTROLLER))
+        update_status(iface, frame->data[0]);
+}
+
+static int map_message_at(can_interface_t *iface, const void *items, size_t index, slcan_message_t *slcan)
+{
+    return map_message(iface, &((const can_message_t*)items)[index], slcan);
+}
+
+static void unmap_message_at(can_interface_t *iface, const slcan_message_t *slcan, void *items, size_t index)
+{
+    unmap_message(iface, slcan, &((can_message_t*)items)[index]);
+}
+
+static int map_frame_at(can_interface_t *iface, const void *items, size_t index, slcan_message_t *slcan)
+{
+    return map_frame(iface, &((const can_frame_t*)items)[index], slcan);
+}
+
+static void unmap_frame_at(can_interface_t *iface, const slcan_message_t *slcan, void *items, size_t index)
+{
+    unmap_frame(iface, slcan, &((can_frame_t*)items)[index]);
+}
+
+static void update_status(can_interface_t *iface, uint8_t status)
+{
+    slcan_flags_t flags;                // status flags
+
+    flags.byte = status;
+    // TODO: SJA1000 datasheet, rtfm!
+    iface->status.message_lost = (flags.DOI | flags.RxFIFO | flags.TxFIFO) ? 1 : 0;
+    iface->status.bus_error = flags.BEI ? 1 : 0;
+    iface->status.warning_level = (flags.EI | flags.EPI);
+    iface->status.bus_off = flags.ALI;
+}
+
+/*  ---  shared access  ---
+ *
+ *  With protocol CANSIO_SHARED the TTY is owned by the SerialCAN daemon,
+ *  which publishes all received messages into a shared-memory ring and
+ *  transmits the messages posted by its clients. Each handle reads the ring
+ *  with its own cursor, so the receive queue, the subscribers and the
+ *  device settings of the daemon are not available to the client.
+ */
+static int init_shared(int handle, const char *name, uint8_t mode)
+{
+    can_sio_shared_t info;              // daemon status
+    char object[SHMEM_MAX_NAME];        // name of the shared-memory object
+    int rc;                             // return value
+
+    // attach to the shared-memory object of the daemon
+    if (shmem_name(object, CANSIO_SHM_PREFIX, name) < 0)
+        return slcan_error(-1);
+    if ((can[handle].shm = shmem_attach(object)) == NULL)
+        return slcan_error(-1);
+    if (shmem_info_read(can[handle].shm, &info, sizeof(can_sio_shared_t)) < 0) {
+        rc = slcan_error(-1);
+        (void)shmem_destroy(can[handle].shm);
+        can[handle].shm = NULL;
+        return rc;
+    }
+    // store the tty name, the operation mode and the daemon settings
+    strncpy(can[handle].name, name, CANPROP_MAX_BUFFER_SIZE);
+    can[handle].name[CANPROP_MAX_BUFFER_SIZE - 1] = '\0';
+    can[handle].attr.protocol = CANSIO_SHARED;
+    can[handle].btr0btr1 = info.btr0btr1;
+    can[handle].mode.byte = mode;       // store selected operation mode
+    can[handle].status.byte = CANSTAT_RESET; // CAN controller not started yet
+    return handle;                      // return the handle
+}
+
+static int start_shared(int handle, const can_bitrate_t *bitrate)
+{
+    can_sio_shared_t info;              // daemon status
+    uint16_t btr0btr1 = CAN_BTR_DEFAULT;// btr0btr1 value
+
+    // the bit-rate must match the bit-rate of the daemon
+    if (shmem_info_read(can[handle].shm, &info, sizeof(can_sio_shared_t)) < 0)
+        return (errno == EPIPE) ? CANERR_OFFLINE : slcan_error(-1);
+    // convert bit-rate settings (or index) to SJA1000 BTR0/BTR1 register
+    if (bitrate->index == CANSIO_BITRATE_AUTO) {
+        btr0btr1 = info.btr0btr1;
+    }
+    else if (bitrate->index <= 0) {
+        if (btr_index2sja1000(bitrate->index, &btr0btr1) != CANERR_NOERROR)
+            return CANERR_BAUDRATE;
+    }
+    else {
+        if (btr_bitrate2sja1000(bitrate, &btr0btr1) != CANERR_NOERROR)
+            return CANERR_BAUDRATE;
+    }
+    if (info.btr0btr1 != btr0btr1)
+        return CANERR_BAUDRATE;
+    // receive messages from now on
+    (void)shmem_rewind(can[handle].shm);
+    can[handle].btr0btr1 = btr0btr1;
+    // clear old status and counters
+    can[handle].status.byte = 0x00u;
+    can[handle].counters.tx = 0ull;
+    can[handle].counters.rx = 0ull;
+    can[handle].counters.err = 0ull;
+    // CAN controller started!
+    can[handle].status.can_stopped = 0;
+    return CANERR_NOERROR;
+}
+
+static int post_shared(can_interface_t *iface, const can_message_t *msg, uint16_t timeout)
+{
+    int rc;                             // return value
+
+    // post the CAN message into the transmit ring of the daemon
+    rc = shmem_post(iface->shm, msg, timeout);
+    if (rc == -20)
+        rc = CANERR_TX_BUSY;
+    else if (rc < 0)
+        rc = (errno == EPIPE) ? CANERR_OFFLINE : slcan_error(rc);
+    return rc;
+}
+
+static int read_shared(can_interface_t *iface, can_message_t *msgs, size_t count, uint16_t timeout)
+{
+    int rc;                             // return value
+    int i;
+
+    // copy the CAN messages from the receive ring of the daemon (no system call when available)
+    rc = shmem_receive(iface->shm, msgs, count, timeout);
+    if (rc > 0) {
+        iface->status.queue_overrun |= (errno == ENOSPC) ? 1 : 0;
+        // update receive counter
+        for (i = 0; i < rc; i++) {
+            iface->counters.rx += !msgs[i].sts ? 1U : 0U;
+            iface->counters.err += msgs[i].sts ? 1U : 0U;
+        }
+    }
+    else if (rc != CANERR_RX_EMPTY)
+        rc = (errno == EPIPE) ? CANERR_OFFLINE : slcan_error(rc);
+    // update status register
+    iface->status.receiver_empty = (rc <= 0) ? 1 : 0;
+    return rc;
+}
+
+static void frame_shared(const can_message_t *msg, can_frame_t *frame)
+{
+    // note: the frame is written as a whole (CAN 2.0 payload only)
+    memset(frame, 0x00, sizeof(can_frame_t));
+    frame->xtd = msg->xtd;
+    frame->sts = msg->sts;
+    frame->rtr = msg->rtr;
+    frame->id = msg->id;
+    frame->dlc = (msg->dlc < CAN_DLC_MAX) ? msg->dlc : CAN_LEN_MAX;
+    memcpy(frame->data, msg->data, frame->dlc);
+    frame->timestamp = ((uint64_t)msg->timestamp.tv_sec * 1000000000ULL) + (uint64_t)msg->timestamp.tv_nsec;
+}
+
+static void frame_shared_at(const can_message_t *msg, void *items, size_t index)
+{
+    frame_shared(msg, &((can_frame_t*)items)[index]);
+}
+
+static int shared_parameter(int handle, uint16_t param, void *value, size_t nbyte)
+{
+    int rc = CANERR_ILLPARA;            // suppose an invalid parameter
+    uint64_t lost = 0ull;               // number of lost messages
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(can[handle].shm != NULL);
+
+    switch (param) {
+    case CANPROP_GET_RCV_QUEUE_OVFL:    // number of messages overwritten before they were read (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            (void)shmem_overflow(can[handle].shm, &lost);
+            *(uint64_t*)value = lost;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_SHARED_INFO):  // status of the SerialCAN daemon (can_sio_shared_t)
+        if (nbyte >= sizeof(can_sio_shared_t)) {
+            if (shmem_info_read(can[handle].shm, value, sizeof(can_sio_shared_t)) < 0)
+                rc = (errno == EPIPE) ? CANERR_OFFLINE : slcan_error(-1);
+            else
+                rc = CANERR_NOERROR;
+        }
+        break;
+    default:
+        rc = CANERR_NOTSUPP;
+        break;
+    }
+    return rc;
+}
+
+static void var_init(void)
+{
+    int i;
+
+    for (i = 0; i < CAN_MAX_HANDLES; i++) {
+        memset(&can[i], 0, sizeof(can_interface_t));
+        can[i].port = NULL;
+        can[i].name[0] = '\0';
+        can[i].attr.baudrate = SERIAL_BAUDRATE;
+        can[i].attr.bytesize = SERIAL_BYTESIZE;
+        can[i].attr.parity = SERIAL_PARITY;
+        can[i].attr.stopbits = SERIAL_STOPBITS;
+        can[i].attr.protocol = SERIAL_PROTOCOL;
+        can[i].btr0btr1 = CAN_BTR_DEFAULT;
+        can[i].queue_options = SLCAN_QUEUE_OPTIONS;
+        can[i].queue_policy = SLCAN_QUEUE_POLICY;
+        can[i].queue_block_time = 0U;
+        can[i].lane_size = 0U;
+        can[i].auto_baud_dwell = CANSIO_AUTO_BAUD_DWELL;
+        can[i].ctrl_mode = 0x00U;
+        can[i].ctrl_set = 0x00U;
+        can[i].status_poll_time = CANSIO_STATUS_POLL_TIME;
+        can[i].gateway = -1;
+        can[i].mode.byte = CANMODE_DEFAULT;
+        can[i].status.byte = CANSTAT_RESET;
+        can[i].filter.sja1000.code = FILTER_SJA1000_CODE;
+        can[i].filter.sja1000.mask = FILTER_SJA1000_MASK;
+        can[i].filter.std.code = FILTER_STD_CODE;
+        can[i].filter.std.mask = FILTER_STD_MASK;
+        can[i].filter.xtd.code = FILTER_XTD_CODE;
+        can[i].filter.xtd.mask = FILTER_XTD_MASK;
+        can[i].counters.tx = 0ull;
+        can[i].counters.rx = 0ull;
+        can[i].counters.err = 0ull;
+    }
+}
+
+static int all_closed(void)
+{
     int handle;
 
     if (!init)
@@ -1004,6 +1937,120 @@ static int reset_filter(int handle)
     return CANERR_NOERROR;
 }
 
+static int set_gateway(int handle, const can_sio_gateway_t *gateway)
+{
+    slcan_route_t routes[CANSIO_MAX_ROUTES];  // SLCAN routes
+    int rc;                             // return value
+    uint32_t i;                         // loop variable
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(gateway);
+
+    /* count = 0 removes the gateway, otherwise the target must be another opened interface
+     * (not a shared one), and the routes must be valid
+     */
+    if (gateway->count > CANSIO_MAX_ROUTES)
+        return CANERR_ILLPARA;
+    if (gateway->count) {
+        if (gateway->routes == NULL)
+            return CANERR_NULLPTR;
+        if (!IS_HANDLE_VALID(gateway->target) || (gateway->target == handle))
+            return CANERR_ILLPARA;
+        if (!IS_HANDLE_OPENED(gateway->target) || (can[gateway->target].shm != NULL))
+            return CANERR_HANDLE;
+    }
+    for (i = 0U; i < gateway->count; i++) {
+        if (gateway->routes[i].xtd > 1U)
+            return CANERR_ILLPARA;
+        routes[i].code = gateway->routes[i].code;
+        routes[i].mask = gateway->routes[i].mask;
+        routes[i].xtd = gateway->routes[i].xtd ? true : false;
+        routes[i].interval = gateway->routes[i].interval;
+        routes[i].id = gateway->routes[i].id;
+        routes[i].idMask = gateway->routes[i].idMask;
+        memcpy(routes[i].data, gateway->routes[i].data, CAN_MAX_LEN);
+        memcpy(routes[i].dataMask, gateway->routes[i].dataMask, CAN_MAX_LEN);
+    }
+    /* compile the routes into the lookup table of the SLCAN port */
+    rc = slcan_gateway(can[handle].port, gateway->count ? can[gateway->target].port : NULL,
+                       routes, (size_t)gateway->count);
+    if ((rc = slcan_error(rc)) == CANERR_NOERROR)
+        can[handle].gateway = gateway->count ? (int)gateway->target : -1;
+    return rc;
+}
+
+static int detect_bitrate(int handle, int32_t *index)
+{
+    slcan_message_t message;            // received message
+    slcan_flags_t flags;                // status flags
+    timer_obj_t dwell;                  // dwell time per candidate
+    uint16_t btr0btr1;                  // btr0btr1 value
+    int frames, best = 0;               // received frames
+    int rc, rc2;                        // return values
+    size_t i;                           // loop variable
+    bool canable;                       // CANable protocol
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(index);
+
+    // note: the candidates are probed in listen-only mode, i.e. the CAN controller
+    //       neither acknowledges frames nor sends error frames (the bus is not disturbed).
+    //       A candidate is scored by the number of received frames and the error flags
+    //       from the status register; the first candidate without errors is taken.
+    //       CANable devices are probed in silent mode ('M1'), they have no status flags:
+    //       the first candidate with AUTO_BAUD_FRAMES received frames is taken.
+    canable = (can[handle].attr.protocol == CANSIO_CANABLE || can[handle].attr.protocol == CANSIO_WEACT);
+    if (canable && !(can[handle].ctrl_set & CTRL_MODE_SILENT)) {
+        if ((rc = slcan_silent_mode(can[handle].port, true)) < 0)
+            return slcan_error(rc);
+        can[handle].ctrl_set |= CTRL_MODE_SILENT;  // (reverted by can_start)
+    }
+    memset(&flags, 0, sizeof(slcan_flags_t));
+    for (i = 0U; i < sizeof(auto_baud) / sizeof(auto_baud[0]); i++) {
+        // set the bit-rate (CANable: index, others: bit-timing register)
+        if (canable)
+            rc = slcan_setup_bitrate(can[handle].port, (uint8_t)(CANBDR_10 + auto_baud[i]));
+        else if (btr_index2sja1000(auto_baud[i], &btr0btr1) == CANERR_NOERROR)
+            rc = slcan_setup_btr(can[handle].port, btr0btr1);
+        else
+            continue;
+        if (rc < 0)
+            return slcan_error(rc);
+        // start the CAN controller in listen-only mode (resp. silent mode)
+        if ((rc = canable ? slcan_open_channel(can[handle].port) : slcan_listen_channel(can[handle].port)) < 0)
+            return slcan_error(rc);
+        // clear the error flags (they are reset when read)
+        if (!canable)
+            (void)slcan_status_flags(can[handle].port, &flags);
+        // count received frames during the dwell time
+        frames = 0;
+        dwell = timer_new(TIMER_MSEC(can[handle].auto_baud_dwell));
+        while ((frames < AUTO_BAUD_FRAMES) && !timer_timeout(&dwell)) {
+            if ((slcan_read_message(can[handle].port, &message, AUTO_BAUD_POLL) == 0) &&
+                !(message.can_id & CAN_ERR_FRAME))  // status messages are not bus frames
+                frames++;
+        }
+        rc = !canable ? slcan_status_flags(can[handle].port, &flags) : 0;
+        rc2 = slcan_close_channel(can[handle].port);
+        if (rc < 0)
+            return slcan_error(rc);
+        if (rc2 < 0)
+            return slcan_error(rc2);
+        // frames without error flags (CANable: enough frames): bit-rate detected
+        if (canable ? (frames >= AUTO_BAUD_FRAMES) : ((frames > 0) && !flags.BEI && !flags.EPI && !flags.EI)) {
+            *index = auto_baud[i];
+            return CANERR_NOERROR;
+        }
+        // frames with error flags: remember the best candidate
+        if (frames > best) {
+            *index = auto_baud[i];
+            best = frames;
+        }
+    }
+    // no frames received at any bit-rate: bus silent (or not connected)
+    return (best > 0) ? CANERR_NOERROR : CANERR_TIMEOUT;
+}
+
 /*  - - - - - -  CAN API V3 properties  - - - - - - - - - - - - - - - - -
  */
 static int lib_parameter(uint16_t param, void *value, size_t nbyte)
@@ -1194,15 +2241,35 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
     uint8_t load = 0u;                  // bus load
     uint8_t version_no = 0x00u;         // version number (8-bit)
     uint32_t serial_no = 0x00000000u;   // serial number (32-bit)
+    slcan_queue_t queue;                // reception queue status
+    can_sio_lane_t *lane;               // priority class (receive lanes)
+    slcan_gateway_t gateway;            // gateway status
+    j1939_status_t j1939;               // J1939 engine status
 
     assert(IS_HANDLE_VALID(handle));    // just to make sure
 
     if (value == NULL) {                // check for null-pointer
         if ((param != CANPROP_SET_FIRST_CHANNEL) &&
             (param != CANPROP_SET_NEXT_CHANNEL) &&
-            (param != CANPROP_SET_FILTER_RESET))
+            (param != CANPROP_SET_FILTER_RESET) &&
+            (param != (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_RESET)))
             return CANERR_NULLPTR;
     }
+    // shared access: the device and its reception queue are owned by the daemon
+    if (can[handle].shm != NULL) {
+        switch (param) {
+        case CANPROP_GET_RCV_QUEUE_OVFL:
+        case (CANPROP_GET_VENDOR_PROP + SLCAN_SHARED_INFO):
+            return shared_parameter(handle, param, value, nbyte);
+        case CANPROP_GET_RCV_QUEUE_SIZE:
+        case CANPROP_GET_RCV_QUEUE_HIGH:
+            return CANERR_NOTSUPP;      // note: there is no receive queue
+        default:
+            if (param >= CANPROP_GET_VENDOR_PROP)
+                return CANERR_NOTSUPP;
+            break;
+        }
+    }
     // query or modify a CAN interface property
     switch (param) {
     case CANPROP_GET_DEVICE_TYPE:       // device type of the CAN interface (int32_t)
@@ -1327,10 +2394,37 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         }
         break;
     case CANPROP_GET_RCV_QUEUE_SIZE:    // maximum number of message the receive queue can hold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0) {
+                *(uint32_t*)value = (uint32_t)queue.size;
+                rc = CANERR_NOERROR;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
+        break;
     case CANPROP_GET_RCV_QUEUE_HIGH:    // maximum number of message the receive queue has hold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0) {
+                *(uint32_t*)value = (uint32_t)queue.high;
+                rc = CANERR_NOERROR;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
+        break;
     case CANPROP_GET_RCV_QUEUE_OVFL:    // overflow counter of the receive queue (uint64_t)
-        // note: cannot be determined
-        rc = CANERR_NOTSUPP;
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0) {
+                *(uint64_t*)value = (uint64_t)queue.ovfl;
+                rc = CANERR_NOERROR;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
         break;
     case CANPROP_GET_FILTER_11BIT:      // acceptance filter code and mask for 11-bit identifier (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
@@ -1425,6 +2519,266 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
             }
         }
         break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_FILL):      // receive queue fill level (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0) {
+                *(uint32_t*)value = (uint32_t)queue.used;
+                rc = CANERR_NOERROR;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE):      // receive queue size (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0) {
+                *(uint32_t*)value = (uint32_t)queue.size;
+                rc = CANERR_NOERROR;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS):   // receive queue memory options (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = (uint32_t)can[handle].queue_options;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE):      // set receive queue size (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (*(uint32_t*)value != 0U) {
+                if (can[handle].status.can_stopped) {
+                    // note: the queue is reallocated only if the CAN controller is in INIT mode
+                    rc = slcan_queue_resize(can[handle].port, (size_t)*(uint32_t*)value, can[handle].queue_options);
+                    rc = slcan_error(rc);
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS):   // set receive queue memory options (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (!(*(uint32_t*)value & ~SLCAN_QUEUE_OPTION_MASK)) {
+                if (can[handle].status.can_stopped) {
+                    // note: the queue is reallocated only if the CAN controller is in INIT mode
+                    if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0)
+                        rc = slcan_queue_resize(can[handle].port, (size_t)queue.size, *(uint32_t*)value);
+                    if ((rc = slcan_error(rc)) == CANERR_NOERROR)
+                        can[handle].queue_options = *(uint32_t*)value;
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY):    // receive queue overflow policy (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = (uint8_t)can[handle].queue_policy;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME):// receive queue max. blocking time (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = (uint16_t)can[handle].queue_block_time;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_GAPS):      // receive queue loss intervals (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            if ((rc = slcan_queue_status(can[handle].port, &queue)) == 0) {
+                *(uint64_t*)value = (uint64_t)queue.gaps;
+                rc = CANERR_NOERROR;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY):    // set receive queue overflow policy (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value <= CANSIO_QUEUE_BLOCK_PRODUCER) {
+                // note: the policy can be changed at any time
+                rc = slcan_queue_policy(can[handle].port, *(uint8_t*)value, can[handle].queue_block_time);
+                if ((rc = slcan_error(rc)) == CANERR_NOERROR)
+                    can[handle].queue_policy = *(uint8_t*)value;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME):// set receive queue max. blocking time (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            rc = slcan_queue_policy(can[handle].port, can[handle].queue_policy, *(uint16_t*)value);
+            if ((rc = slcan_error(rc)) == CANERR_NOERROR)
+                can[handle].queue_block_time = *(uint16_t*)value;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE):       // size of each priority lane (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = (uint32_t)can[handle].lane_size;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE):       // set size of each priority lane (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (can[handle].status.can_stopped) {
+                // note: the lanes are reallocated only if the CAN controller is in INIT mode
+                rc = slcan_lane_size(can[handle].port, (size_t)*(uint32_t*)value);
+                if ((rc = slcan_error(rc)) == CANERR_NOERROR)
+                    can[handle].lane_size = *(uint32_t*)value;
+            }
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_CLASS):      // assign identifiers to a priority lane (can_sio_lane_t)
+        if (nbyte >= sizeof(can_sio_lane_t)) {
+            lane = (can_sio_lane_t*)value;
+            if ((lane->lane <= CANSIO_MAX_LANES) && (lane->first <= lane->last) &&
+                (lane->last <= (uint32_t)(lane->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))) {
+                if (can[handle].status.can_stopped) {
+                    // note: the classes are changed only if the CAN controller is in INIT mode
+                    rc = slcan_lane_class(can[handle].port, lane->first, lane->last, lane->mask, lane->xtd ? true : false, lane->lane);
+                    if ((rc = slcan_error(rc)) == CANERR_NOERROR) {
+                        if (!can[handle].lane_size)  // lanes set up with default size
+                            can[handle].lane_size = CANSIO_LANE_SIZE;
+                    }
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_RESET):      // assign all identifiers to the receive queue (NULL)
+        if (can[handle].status.can_stopped) {
+            // note: the classes are changed only if the CAN controller is in INIT mode
+            rc = slcan_lane_reset(can[handle].port);
+            rc = slcan_error(rc);
+        }
+        else
+            rc = CANERR_ONLINE;
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES):      // forward received frames to another interface (can_sio_gateway_t)
+        if (nbyte >= sizeof(can_sio_gateway_t)) {
+            if (can[handle].status.can_stopped)
+                // note: the routes are changed only if the CAN controller is in INIT mode
+                rc = set_gateway(handle, (can_sio_gateway_t*)value);
+            else
+                rc = CANERR_ONLINE;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS):      // number of routes and frame counters of the gateway (can_sio_gateway_status_t)
+        if (nbyte >= sizeof(can_sio_gateway_status_t)) {
+            if ((rc = slcan_gateway_status(can[handle].port, &gateway)) == 0) {
+                ((can_sio_gateway_status_t*)value)->routes = gateway.routes;
+                ((can_sio_gateway_status_t*)value)->target = (int32_t)can[handle].gateway;
+                ((can_sio_gateway_status_t*)value)->forwarded = gateway.forwarded;
+                ((can_sio_gateway_status_t*)value)->limited = gateway.limited;
+                ((can_sio_gateway_status_t*)value)->failed = gateway.failed;
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL):     // dwell time per candidate of the bit-rate detection (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = (uint16_t)can[handle].auto_baud_dwell;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL):     // set dwell time per candidate of the bit-rate detection (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if (*(uint16_t*)value != 0U) {
+                can[handle].auto_baud_dwell = *(uint16_t*)value;
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT):     // automatic retransmission of CAN frames (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = (can[handle].ctrl_mode & CTRL_MODE_ONE_SHOT) ? 0U : 1U;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT):     // set automatic retransmission of CAN frames (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (can[handle].attr.protocol != CANSIO_CANABLE && can[handle].attr.protocol != CANSIO_WEACT)
+                rc = CANERR_NOTSUPP;
+            else if (*(uint8_t*)value > 1U)
+                rc = CANERR_ILLPARA;
+            else if (!can[handle].status.can_stopped)
+                rc = CANERR_ONLINE;
+            else {
+                // note: the setting is applied when the CAN controller is started
+                if (*(uint8_t*)value)
+                    can[handle].ctrl_mode &= (uint8_t)~CTRL_MODE_ONE_SHOT;
+                else
+                    can[handle].ctrl_mode |= CTRL_MODE_ONE_SHOT;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME):    // polling interval of the status flags (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            *(uint16_t*)value = (uint16_t)can[handle].status_poll_time;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case (CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME):    // set polling interval of the status flags (uint16_t)
+        if (nbyte >= sizeof(uint16_t)) {
+            if (!can[handle].status.can_stopped)
+                rc = CANERR_ONLINE;
+            else {
+                // note: the interval is applied when the CAN controller is started
+                can[handle].status_poll_time = *(uint16_t*)value;
+                rc = CANERR_NOERROR;
+            }
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_J1939_STATUS):        // own address and session counters of the J1939 engine (can_sio_j1939_status_t)
+        if (nbyte >= sizeof(can_sio_j1939_status_t)) {
+            memset(&j1939, 0, sizeof(j1939_status_t));
+            j1939.address = CANSIO_J1939_NULL_ADDR;
+            if ((can[handle].j1939 == NULL) || ((rc = j1939_status(can[handle].j1939, &j1939)) == 0)) {
+                memset(value, 0, sizeof(can_sio_j1939_status_t));
+                ((can_sio_j1939_status_t*)value)->address = j1939.address;
+                ((can_sio_j1939_status_t*)value)->active = j1939.active;
+                ((can_sio_j1939_status_t*)value)->completed = j1939.completed;
+                ((can_sio_j1939_status_t*)value)->aborted = j1939.aborted;
+                ((can_sio_j1939_status_t*)value)->expired = j1939.expired;
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = slcan_error(rc);
+        }
+        break;
+    case (CANPROP_GET_VENDOR_PROP + SLCAN_RCV_EVENT_FD):        // receive event file descriptor (int32_t)
+        if (nbyte >= sizeof(int32_t)) {
+            if ((rc = slcan_event_fd(can[handle].port)) >= 0) {
+                *(int32_t*)value = (int32_t)rc;
+                rc = CANERR_NOERROR;
+            }
+            else if (errno == ENOTSUP) {
+                rc = CANERR_NOTSUPP;
+            }
+            else {
+                rc = slcan_error(rc);
+            }
+        }
+        break;
     default:
         rc = lib_parameter(param, value, nbyte);   // library properties (see lib_parameter)
         break;
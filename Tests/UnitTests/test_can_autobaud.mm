@@ -0,0 +1,211 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+#import <thread>
+#import <atomic>
+
+//  Bit-rate detection of DUT1 (CANSIO_BITRATE_AUTO), DUT2 sends the messages
+#define AUTO_BAUD_DWELL  20U
+
+static int StartAutoBaud(int handle1, int handle2, int32_t index) {
+    can_bitrate_t bitrate = {};
+    can_bitrate_t detect = {};
+    can_message_t message = {};
+    std::atomic<bool> running(true);
+    int rc = CANERR_FATAL;
+    // note: DUT2 sends a message every 2ms during the bit-rate detection of DUT1
+    bitrate.index = index;
+    if ((rc = can_start(handle2, &bitrate)) != CANERR_NOERROR)
+        return rc;
+    std::thread sender([&]() {
+        message.id = 0x555U;
+        message.dlc = 2U;
+        while (running) {
+            (void)can_write(handle2, &message, 0U);
+            CTimer::Delay(2U*CTimer::MSEC);
+        }
+    });
+    detect.index = CANSIO_BITRATE_AUTO;
+    rc = can_start(handle1, &detect);
+    running = false;
+    sender.join();
+    return rc;
+}
+
+static float BusSpeed(int handle) {
+    can_bitrate_t bitrate = {};
+    can_speed_t speed = {};
+    if (can_bitrate(handle, &bitrate, &speed) != CANERR_NOERROR)
+        return 0.0F;
+    return speed.nominal.speed;
+}
+
+@interface test_can_autobaud : XCTestCase {
+    int handle1;
+    int handle2;
+}
+
+@end
+
+@implementation test_can_autobaud
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    uint16_t dwell = AUTO_BAUD_DWELL;
+    int rc = CANERR_FATAL;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- shorten the dwell time per candidate of DUT1
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL, (void*)&dwell, sizeof(dwell));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC31.1: Read and set the dwell time per candidate of the bit-rate detection
+//
+// @expected: CANERR_NOERROR, and CANERR_ILLPARA for a dwell time of 0ms
+//
+- (void)testDwellTime {
+    uint16_t dwell = 0xFFFFU;
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- the default dwell time (DUT2)
+    rc = can_property(handle2, CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL, (void*)&dwell, sizeof(dwell));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_AUTO_BAUD_DWELL, dwell);
+    // @- the dwell time set in setUp (DUT1)
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL, (void*)&dwell, sizeof(dwell));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(AUTO_BAUD_DWELL, dwell);
+    // @- dwell time 0ms
+    dwell = 0U;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL, (void*)&dwell, sizeof(dwell));
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_BAUD_DWELL, (void*)&dwell, sizeof(dwell));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(AUTO_BAUD_DWELL, dwell);
+    // @end.
+}
+
+// @xctest TC31.2: Detect the bit-rate of the bus (configured bit-rate)
+//
+// @expected: CANERR_NOERROR, DUT1 is started with the bit-rate of DUT2
+//
+- (void)testDetectBitrate {
+    can_message_t request = {};
+    can_message_t message = {};
+    uint8_t status = 0U;
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = StartAutoBaud(handle1, handle2, TEST_BTRINDEX);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 is started with the same bit-rate as DUT2
+    rc = can_status(handle1, &status);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x00U, status & CANSTAT_RESET);
+    XCTAssertEqual(BusSpeed(handle2), BusSpeed(handle1));
+    // @- messages are exchanged with DUT2 (DUT1 is not in listen-only mode)
+    request.id = 0x123U;
+    request.dlc = 0U;
+    rc = can_write(handle1, &request, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_read(handle2, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x123U, message.id);
+    // @end.
+}
+
+// @xctest TC31.3: Detect the bit-rate of the bus (not the first candidate)
+//
+// @expected: CANERR_NOERROR, the candidates with errors are skipped
+//
+- (void)testDetectLaterCandidate {
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- note: 125kbps is probed after 500kbps and 250kbps
+    rc = StartAutoBaud(handle1, handle2, CANBTR_INDEX_125K);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(125000.0F, BusSpeed(handle1));
+    // @end.
+}
+
+// @xctest TC31.4: Detect the bit-rate of a silent bus
+//
+// @expected: CANERR_TIMEOUT, DUT1 is not started
+//
+- (void)testSilentBus {
+    can_bitrate_t bitrate = {};
+    uint8_t status = 0U;
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- DUT2 is not started (no messages on the bus)
+    bitrate.index = CANSIO_BITRATE_AUTO;
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_TIMEOUT, rc);
+    rc = can_status(handle1, &status);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSTAT_RESET, status & CANSTAT_RESET);
+    // @- DUT1 can be started with a bit-rate afterwards
+    bitrate.index = TEST_BTRINDEX;
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
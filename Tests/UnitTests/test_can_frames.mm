@@ -0,0 +1,227 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  Compact frames from DUT2 to DUT1 (standard, extended and remote frames)
+#define NUM_FRAMES  48U
+
+static void FillFrames(can_frame_t *frames, size_t count) {
+    memset(frames, 0, count * sizeof(can_frame_t));
+    for (size_t i = 0U; i < count; i++) {
+        frames[i].xtd = (i % 3U) == 1U ? 1 : 0;
+        frames[i].rtr = (i % 3U) == 2U ? 1 : 0;
+        frames[i].id = frames[i].xtd ? (uint32_t)(0x18FEF000U + i) : (uint32_t)(0x100U + i);
+        frames[i].dlc = (uint8_t)(i % 9U);
+        if (!frames[i].rtr)
+            for (uint8_t j = 0U; j < frames[i].dlc; j++)
+                frames[i].data[j] = (uint8_t)(i + j);
+    }
+}
+
+static size_t ReadFrames(int handle, can_frame_t *frames, size_t count, uint16_t timeout) {
+    size_t n = 0U, m;
+    int rc;
+    // note: status messages are skipped
+    while (n < count) {
+        rc = can_read_frames(handle, &frames[n], count - n, timeout);
+        if (rc <= 0)
+            break;
+        for (size_t i = m = n; i < (n + (size_t)rc); i++)
+            if (!frames[i].sts)
+                frames[m++] = frames[i];
+        n = m;
+    }
+    return n;
+}
+
+@interface test_can_frames : XCTestCase {
+    int handle1;
+    int handle2;
+}
+
+@end
+
+@implementation test_can_frames
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    int rc = CANERR_FATAL;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT1 and DUT2 with configured bit-rate settings
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @issue(PeakCAN): a delay of 100ms is required here
+    PCBUSB_INIT_DELAY();
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC25.1: Send and receive compact frames (round trip)
+//
+// @expected: CANERR_NOERROR (number of frames), all frames received unchanged
+//
+- (void)testWriteAndReadFrames {
+    can_frame_t sent[NUM_FRAMES];
+    can_frame_t received[NUM_FRAMES];
+    int rc = CANERR_FATAL;
+    FillFrames(sent, NUM_FRAMES);
+    // @test:
+    // @- the compact layout has 24 bytes per frame
+    XCTAssertEqual(24U, sizeof(can_frame_t));
+    // @- send the frames from DUT2 (until all are sent)
+    for (size_t n = 0U; n < NUM_FRAMES; ) {
+        rc = can_write_frames(handle2, &sent[n], NUM_FRAMES - n, 0U);
+        if (CANERR_TX_BUSY == rc)
+            continue;
+        XCTAssertGreaterThan(rc, 0);
+        if (rc <= 0)
+            break;
+        n += (size_t)rc;
+    }
+    // @- read the frames on DUT1 and compare them
+    memset(received, 0xFF, sizeof(received));
+    XCTAssertEqual(NUM_FRAMES, ReadFrames(handle1, received, NUM_FRAMES, 1000U));
+    for (size_t i = 0U; i < NUM_FRAMES; i++) {
+        XCTAssertEqual(sent[i].id, received[i].id);
+        XCTAssertEqual(sent[i].xtd, received[i].xtd);
+        XCTAssertEqual(sent[i].rtr, received[i].rtr);
+        XCTAssertEqual(sent[i].dlc, received[i].dlc);
+        if (!sent[i].rtr)
+            XCTAssertEqual(0, memcmp(sent[i].data, received[i].data, sent[i].dlc));
+        // @- SLCAN devices do not time-stamp the frames
+        XCTAssertEqual(0U, received[i].timestamp);
+    }
+    // @end.
+}
+
+// @xctest TC25.2: Send compact frames and receive them as messages
+//
+// @expected: CANERR_NOERROR, the messages are equal to the frames
+//
+- (void)testWriteFramesReadMessages {
+    can_frame_t sent[6];
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    FillFrames(sent, 6U);
+    // @test:
+    // @- send the frames from DUT2
+    rc = can_write_frames(handle2, sent, 6U, 0U);
+    XCTAssertEqual(6, rc);
+    // @- read them one by one on DUT1 with can_read
+    for (size_t i = 0U; i < 6U; i++) {
+        do {
+            rc = can_read(handle1, &message, 1000U);
+        } while ((CANERR_NOERROR == rc) && message.sts);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(sent[i].id, message.id);
+        XCTAssertEqual(sent[i].xtd, message.xtd);
+        XCTAssertEqual(sent[i].rtr, message.rtr);
+        XCTAssertEqual(sent[i].dlc, message.dlc);
+        if (!sent[i].rtr)
+            XCTAssertEqual(0, memcmp(sent[i].data, message.data, sent[i].dlc));
+    }
+    // @end.
+}
+
+// @xctest TC25.3: Send compact frames with invalid contents
+//
+// @expected: CANERR_ILLPARA (for the first frame), the number of valid frames before
+//
+- (void)testInvalidFrames {
+    can_frame_t frames[4];
+    int rc = CANERR_FATAL;
+    FillFrames(frames, 4U);
+    // @test:
+    // @- data length code greater than 8
+    frames[0].dlc = CAN_MAX_LEN + 1U;
+    rc = can_write_frames(handle2, frames, 4U, 0U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- standard identifier greater than 0x7FF
+    FillFrames(frames, 4U);
+    frames[2].xtd = 0;
+    frames[2].id = CAN_MAX_STD_ID + 1U;
+    rc = can_write_frames(handle2, frames, 4U, 0U);
+    XCTAssertEqual(2, rc);
+    // @- status messages cannot be sent
+    FillFrames(frames, 4U);
+    frames[0].sts = 1;
+    rc = can_write_frames(handle2, frames, 4U, 0U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @end.
+}
+
+// @xctest TC25.4: Read compact frames from an empty reception queue
+//
+// @expected: CANERR_RX_EMPTY
+//
+- (void)testReadFramesEmpty {
+    can_frame_t frames[4];
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = can_read_frames(handle1, frames, 4U, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    rc = can_read_frames(handle1, frames, 4U, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
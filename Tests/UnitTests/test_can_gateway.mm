@@ -0,0 +1,292 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  Gateway of DUT1 with DUT2 as target: frames sent by DUT2 are forwarded
+//  (rewritten) by DUT1 to DUT2, which transmits them back to DUT1.
+#define NUM_ROUTES  3U
+
+static int WriteFrame(int handle, uint32_t id, const uint8_t *data) {
+    can_message_t message = {};
+    int rc;
+    message.id = id;
+    message.dlc = 8U;
+    memcpy(message.data, data, 8U);
+    do {
+        rc = can_write(handle, &message, 0U);
+    } while (CANERR_TX_BUSY == rc);
+    return rc;
+}
+
+static int ReadFrame(int handle, can_message_t *message, uint16_t timeout) {
+    int rc;
+    // note: status messages are skipped
+    do {
+        memset(message, 0, sizeof(can_message_t));
+        rc = can_read(handle, message, timeout);
+    } while ((CANERR_NOERROR == rc) && message->sts);
+    return rc;
+}
+
+@interface test_can_gateway : XCTestCase {
+    int handle1;
+    int handle2;
+    can_sio_route_t routes[NUM_ROUTES];
+}
+
+@end
+
+@implementation test_can_gateway
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_sio_gateway_t gateway = {};
+    int rc = CANERR_FATAL;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- route 0: 0x105 is forwarded as 0x205 with data[0] = 0xAA
+    memset(routes, 0, sizeof(routes));
+    routes[0].code = 0x105U; routes[0].mask = 0x7FFU;
+    routes[0].id = 0x205U; routes[0].idMask = 0x7FFU;
+    routes[0].data[0] = 0xAAU; routes[0].dataMask[0] = 0xFFU;
+    // @- route 1: 0x1F0..0x1FF are forwarded as 0x3F0..0x3FF (upper bits replaced)
+    routes[1].code = 0x1F0U; routes[1].mask = 0x7F0U;
+    routes[1].id = 0x300U; routes[1].idMask = 0x700U;
+    // @- route 2: 0x108..0x10B are forwarded as 0x408..0x40B at most every 100ms
+    routes[2].code = 0x108U; routes[2].mask = 0x7FCU; routes[2].interval = 100U;
+    routes[2].id = 0x400U; routes[2].idMask = 0x700U;
+    // @- set up the gateway of DUT1 (in INIT mode)
+    gateway.target = handle2;
+    gateway.count = NUM_ROUTES;
+    gateway.routes = routes;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES, (void*)&gateway, sizeof(gateway));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- start DUT1 and DUT2 with configured bit-rate settings
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @issue(PeakCAN): a delay of 100ms is required here
+    PCBUSB_INIT_DELAY();
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC23.1: Forward a frame with rewritten identifier and payload
+//
+// @expected: CANERR_NOERROR, the original and the rewritten frame are received
+//
+- (void)testRewriteIdentifierAndData {
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    can_message_t message = {};
+    can_sio_gateway_status_t status = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send frame 0x105 from DUT2
+    rc = WriteFrame(handle2, 0x105U, data);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 receives the original frame
+    rc = ReadFrame(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x105U, message.id);
+    XCTAssertEqual(0, memcmp(message.data, data, 8U));
+    // @- DUT1 receives the forwarded frame: 0x205, data[0] replaced, data[1..7] unchanged
+    rc = ReadFrame(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x205U, message.id);
+    XCTAssertEqual(8U, message.dlc);
+    XCTAssertEqual(0xAAU, message.data[0]);
+    XCTAssertEqual(0, memcmp(&message.data[1], &data[1], 7U));
+    // @- check the gateway status of DUT1
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(NUM_ROUTES, status.routes);
+    XCTAssertEqual(handle2, status.target);
+    XCTAssertEqual(1U, status.forwarded);
+    XCTAssertEqual(0U, status.limited);
+    XCTAssertEqual(0U, status.failed);
+    // @end.
+}
+
+// @xctest TC23.2: Forward a frame with partly rewritten identifier
+//
+// @expected: CANERR_NOERROR, only the identifier bits of 'idMask' are replaced
+//
+- (void)testRewriteIdentifierBits {
+    uint8_t data[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send frame 0x1F3 from DUT2
+    rc = WriteFrame(handle2, 0x1F3U, data);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 receives the original frame and the forwarded frame 0x3F3 (payload unchanged)
+    rc = ReadFrame(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x1F3U, message.id);
+    rc = ReadFrame(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x3F3U, message.id);
+    XCTAssertEqual(0, memcmp(message.data, data, 8U));
+    // @end.
+}
+
+// @xctest TC23.3: Send a frame that matches no route
+//
+// @expected: CANERR_RX_EMPTY after the original frame (nothing forwarded)
+//
+- (void)testNoMatchingRoute {
+    uint8_t data[8] = {};
+    can_message_t message = {};
+    can_sio_gateway_status_t status = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send frame 0x222 from DUT2
+    rc = WriteFrame(handle2, 0x222U, data);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 receives the original frame only
+    rc = ReadFrame(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x222U, message.id);
+    rc = ReadFrame(handle1, &message, 200U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- check the gateway status of DUT1
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, status.forwarded);
+    // @end.
+}
+
+// @xctest TC23.4: Send a burst of frames on a rate-limited route
+//
+// @expected: CANERR_NOERROR, only the first frame of the burst is forwarded
+//
+- (void)testRateLimit {
+    uint8_t data[8] = {};
+    can_message_t message = {};
+    can_sio_gateway_status_t status = {};
+    int rc = CANERR_FATAL;
+    int forwarded = 0;
+    // @test:
+    // @- send 5 frames 0x108 from DUT2 (in less than 100ms)
+    for (int i = 0; i < 5; i++) {
+        data[0] = (uint8_t)i;
+        rc = WriteFrame(handle2, 0x108U, data);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+    }
+    // @- DUT1 receives 5 original frames and 1 forwarded frame 0x408
+    while (CANERR_NOERROR == ReadFrame(handle1, &message, 200U)) {
+        if (message.id == 0x408U) {
+            XCTAssertEqual(0U, message.data[0]);
+            forwarded++;
+        }
+    }
+    XCTAssertEqual(1, forwarded);
+    // @- check the gateway status of DUT1
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1U, status.forwarded);
+    XCTAssertEqual(4U, status.limited);
+    // @end.
+}
+
+// @xctest TC23.5: Set up a gateway with invalid settings
+//
+// @expected: CANERR_ONLINE when running, CANERR_ILLPARA for the own handle as target
+//
+- (void)testWithInvalidSettings {
+    can_sio_gateway_t gateway = {};
+    can_sio_gateway_status_t status = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- try to change the routes while DUT1 is running
+    gateway.target = handle2;
+    gateway.count = 1U;
+    gateway.routes = routes;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES, (void*)&gateway, sizeof(gateway));
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    // @- stop/reset DUT1
+    rc = can_reset(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- try to forward to DUT1 itself
+    gateway.target = handle1;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES, (void*)&gateway, sizeof(gateway));
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- try to set up more than CANSIO_MAX_ROUTES routes
+    gateway.target = handle2;
+    gateway.count = CANSIO_MAX_ROUTES + 1U;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES, (void*)&gateway, sizeof(gateway));
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- the routes of DUT1 are unchanged
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(NUM_ROUTES, status.routes);
+    XCTAssertEqual(handle2, status.target);
+    // @- remove the gateway of DUT1
+    gateway.count = 0U;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_GATEWAY_ROUTES, (void*)&gateway, sizeof(gateway));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_GATEWAY_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, status.routes);
+    XCTAssertEqual(-1, status.target);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
@@ -0,0 +1,311 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+#import <thread>
+
+//  ISO-TP channel of DUT1 (DUT2 plays the peer and reads/writes the raw frames)
+#define ISOTP_TX_ID   0x7E0U
+#define ISOTP_RX_ID   0x7E8U
+#define ISOTP_TIMEOUT  200U
+
+static int WriteFrame(int handle, uint32_t id, const uint8_t *data, uint8_t dlc) {
+    can_message_t message = {};
+    int rc;
+    message.id = id;
+    message.dlc = dlc;
+    memcpy(message.data, data, dlc);
+    do {
+        rc = can_write(handle, &message, 0U);
+    } while (CANERR_TX_BUSY == rc);
+    return rc;
+}
+
+static int ReadFrame(int handle, uint32_t id, can_message_t *message, uint16_t timeout) {
+    int rc;
+    // note: status messages and frames with other identifiers are skipped
+    do {
+        memset(message, 0, sizeof(can_message_t));
+        rc = can_read(handle, message, timeout);
+    } while ((CANERR_NOERROR == rc) && (message->sts || (message->id != id)));
+    return rc;
+}
+
+@interface test_can_isotp : XCTestCase {
+    int handle1;
+    int handle2;
+    int channel;
+}
+
+@end
+
+@implementation test_can_isotp
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_sio_isotp_t param = {};
+    int rc = CANERR_FATAL;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- open an ISO-TP channel on DUT1 (block size 2, padding)
+    param.txId = ISOTP_TX_ID;
+    param.rxId = ISOTP_RX_ID;
+    param.mode = CANSIO_ISOTP_NORMAL;
+    param.blockSize = 2U;
+    param.stMin = 0U;
+    param.padding = 1U;
+    param.padByte = 0xCCU;
+    param.timeout = ISOTP_TIMEOUT;
+    channel = can_isotp_open(handle1, &param);
+    XCTAssertLessThanOrEqual(0, channel);
+    // @- start DUT1 and DUT2 with configured bit-rate settings
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @issue(PeakCAN): a delay of 100ms is required here
+    PCBUSB_INIT_DELAY();
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC21.1: Receive a Single Frame PDU
+//
+// @expected: CANERR_NOERROR (length of the PDU)
+//
+- (void)testSingleFrameReception {
+    uint8_t frame[8] = { 0x03, 0x11, 0x22, 0x33 };
+    uint8_t buffer[CANSIO_ISOTP_MAX_PDU] = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send a Single Frame with 3 bytes from DUT2
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 4U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- receive the PDU on DUT1 and compare the data
+    rc = can_isotp_receive(handle1, channel, buffer, sizeof(buffer), 1000U);
+    XCTAssertEqual(3, rc);
+    XCTAssertEqual(0, memcmp(buffer, &frame[1], 3U));
+    // @- the frame is consumed by the channel (not in the receive queue)
+    can_message_t message = {};
+    rc = ReadFrame(handle1, ISOTP_RX_ID, &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC21.2: Receive a segmented PDU (First Frame, Flow Control, Consecutive Frames)
+//
+// @expected: CANERR_NOERROR (length of the PDU), a Flow Control frame after each block
+//
+- (void)testSegmentedReception {
+    uint8_t pdu[30];
+    uint8_t frame[8];
+    uint8_t buffer[CANSIO_ISOTP_MAX_PDU] = {};
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    int i, sn;
+    for (i = 0; i < 30; i++)
+        pdu[i] = (uint8_t)(i + 1);
+    // @test:
+    // @- send a First Frame (length 30) from DUT2
+    frame[0] = 0x10; frame[1] = 30;
+    memcpy(&frame[2], &pdu[0], 6U);
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 8U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 answers with a Flow Control frame (CTS, block size 2, STmin 0, padded)
+    rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(8U, message.dlc);
+    XCTAssertEqual(0x30U, message.data[0]);
+    XCTAssertEqual(2U, message.data[1]);
+    XCTAssertEqual(0U, message.data[2]);
+    XCTAssertEqual(0xCCU, message.data[3]);
+    // @- send four Consecutive Frames, a Flow Control frame is expected after the second
+    for (i = 6, sn = 1; i < 30; i += 7, sn++) {
+        memset(frame, 0xAA, 8U);
+        frame[0] = (uint8_t)(0x20 | sn);
+        memcpy(&frame[1], &pdu[i], ((30 - i) < 7) ? (size_t)(30 - i) : 7U);
+        rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 8U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        if (sn == 2) {
+            rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 1000U);
+            XCTAssertEqual(CANERR_NOERROR, rc);
+            XCTAssertEqual(0x30U, message.data[0]);
+        }
+    }
+    // @- receive the PDU on DUT1 and compare the data
+    rc = can_isotp_receive(handle1, channel, buffer, sizeof(buffer), 1000U);
+    XCTAssertEqual(30, rc);
+    XCTAssertEqual(0, memcmp(buffer, pdu, 30U));
+    // @- no further Flow Control frame after the last block
+    rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC21.3: Receive a segmented PDU with a wrong sequence number
+//
+// @expected: CANERR_RX_EMPTY (the reception is aborted)
+//
+- (void)testWrongSequenceNumber {
+    uint8_t frame[8] = { 0x10, 20, 1, 2, 3, 4, 5, 6 };
+    uint8_t buffer[CANSIO_ISOTP_MAX_PDU] = {};
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send a First Frame (length 20) from DUT2 and wait for the Flow Control frame
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 8U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- send the Consecutive Frames with sequence numbers 2 and 3 (1 is missing)
+    frame[0] = 0x22;
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 8U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    frame[0] = 0x23;
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 8U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- no PDU on DUT1
+    rc = can_isotp_receive(handle1, channel, buffer, sizeof(buffer), 200U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC21.4: Receive a PDU into a buffer that is too small
+//
+// @expected: CANERR_ILLPARA (the PDU is discarded)
+//
+- (void)testBufferTooSmall {
+    uint8_t frame[8] = { 0x10, 10, 1, 2, 3, 4, 5, 6 };
+    uint8_t buffer[8] = {};
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send a PDU of 10 bytes from DUT2 (First Frame, Consecutive Frame)
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 8U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    frame[0] = 0x21; frame[1] = 7; frame[2] = 8; frame[3] = 9; frame[4] = 10;
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 5U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- try to receive the PDU on DUT1 with a buffer of 8 bytes
+    rc = can_isotp_receive(handle1, channel, buffer, sizeof(buffer), 1000U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- the PDU has been discarded
+    rc = can_isotp_receive(handle1, channel, buffer, sizeof(buffer), 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC21.5: Send a segmented PDU (First Frame, Flow Control, Consecutive Frames)
+//
+// @expected: CANERR_NOERROR, frames with sequence numbers 1 to 3 and padding
+//
+- (void)testSegmentedTransmission {
+    uint8_t pdu[24];
+    uint8_t frame[8] = { 0x30, 0, 0 };
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    int result = CANERR_FATAL;
+    int i;
+    for (i = 0; i < 24; i++)
+        pdu[i] = (uint8_t)(0x80 + i);
+    // @test:
+    // @- send a PDU of 24 bytes on DUT1 (the function waits for the Flow Control frame)
+    std::thread sender([&]() {
+        result = can_isotp_send(handle1, channel, pdu, 24U);
+    });
+    // @- DUT2 receives the First Frame (length 24, first 6 bytes)
+    rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(8U, message.dlc);
+    XCTAssertEqual(0x10U, message.data[0]);
+    XCTAssertEqual(24U, message.data[1]);
+    XCTAssertEqual(0, memcmp(&message.data[2], &pdu[0], 6U));
+    // @- DUT2 answers with a Flow Control frame (CTS, no block size, no separation time)
+    rc = WriteFrame(handle2, ISOTP_RX_ID, frame, 3U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT2 receives three Consecutive Frames, the last one padded
+    for (i = 6; i < 24; i += 7) {
+        rc = ReadFrame(handle2, ISOTP_TX_ID, &message, 1000U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(8U, message.dlc);
+        XCTAssertEqual((uint8_t)(0x20 + 1 + (i - 6) / 7), message.data[0]);
+        XCTAssertEqual(0, memcmp(&message.data[1], &pdu[i], ((24 - i) < 7) ? (size_t)(24 - i) : 7U));
+    }
+    XCTAssertEqual(0xCCU, message.data[7]);
+    sender.join();
+    XCTAssertEqual(CANERR_NOERROR, result);
+    // @end.
+}
+
+// @xctest TC21.6: Send a segmented PDU without a Flow Control frame
+//
+// @expected: CANERR_TIMEOUT (time-out N_Bs)
+//
+- (void)testFlowControlTimeout {
+    uint8_t pdu[20] = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send a PDU of 20 bytes on DUT1, DUT2 does not answer the First Frame
+    rc = can_isotp_send(handle1, channel, pdu, 20U);
+    XCTAssertEqual(CANERR_TIMEOUT, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
@@ -0,0 +1,315 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  J1939 nodes (DUT1 runs the engine, DUT2 plays the originator of the sessions)
+#define OWN_ADDRESS   0x80U
+#define OWN_NAME      0x8000000000001234ULL
+#define PEER_ADDRESS  0x20U
+#define PGN_DM1       0x0FECAU
+
+//  29-bit identifiers: priority 7, PGN TP.CM (0xEC00) or TP.DT (0xEB00), destination and source
+#define TP_CM_ID(dst,src)  (0x1CEC0000U | ((uint32_t)(dst) << 8) | (uint32_t)(src))
+#define TP_DT_ID(dst,src)  (0x1CEB0000U | ((uint32_t)(dst) << 8) | (uint32_t)(src))
+
+static int WriteFrame(int handle, uint32_t id, const uint8_t *data) {
+    can_message_t message = {};
+    int rc;
+    message.id = id;
+    message.xtd = 1;
+    message.dlc = 8U;
+    memcpy(message.data, data, 8U);
+    do {
+        rc = can_write(handle, &message, 0U);
+    } while (CANERR_TX_BUSY == rc);
+    return rc;
+}
+
+static int ReadFrame(int handle, uint32_t id, can_message_t *message, uint16_t timeout) {
+    int rc;
+    // note: status messages and frames with other identifiers are skipped
+    do {
+        memset(message, 0, sizeof(can_message_t));
+        rc = can_read(handle, message, timeout);
+    } while ((CANERR_NOERROR == rc) && (message->sts || !message->xtd || (message->id != id)));
+    return rc;
+}
+
+static int WritePackets(int handle, uint8_t dst, const uint8_t *pdu, size_t length, uint8_t first, uint8_t count) {
+    uint8_t frame[8];
+    size_t offset;
+    int rc = CANERR_NOERROR;
+    // note: the last packet is padded with 0xFF
+    for (uint8_t sn = first; (sn < (uint8_t)(first + count)) && (CANERR_NOERROR == rc); sn++) {
+        memset(frame, 0xFF, 8U);
+        frame[0] = sn;
+        offset = (size_t)(sn - 1U) * 7U;
+        memcpy(&frame[1], &pdu[offset], ((length - offset) < 7U) ? (length - offset) : 7U);
+        rc = WriteFrame(handle, TP_DT_ID(dst, PEER_ADDRESS), frame);
+    }
+    return rc;
+}
+
+@interface test_can_j1939 : XCTestCase {
+    int handle1;
+    int handle2;
+}
+
+@end
+
+@implementation test_can_j1939
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    can_sio_j1939_t param = {};
+    int rc = CANERR_FATAL;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- initialize the J1939 engine of DUT1 (TP frames are consumed)
+    param.options = CANSIO_J1939_CONSUME_FRAMES;
+    rc = can_j1939_init(handle1, &param);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- start DUT1 and DUT2 with configured bit-rate settings
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @issue(PeakCAN): a delay of 100ms is required here
+    PCBUSB_INIT_DELAY();
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC22.1: Receive a broadcast PDU (BAM)
+//
+// @expected: CANERR_NOERROR (length of the PDU), PGN, source and global destination
+//
+- (void)testBroadcastReception {
+    uint8_t pdu[20];
+    uint8_t frame[8] = { 32, 20, 0, 3, 0xFF, (uint8_t)PGN_DM1, (uint8_t)(PGN_DM1 >> 8), 0x00 };
+    uint8_t buffer[CANSIO_J1939_MAX_PDU] = {};
+    can_message_t message = {};
+    uint32_t pgn = 0U;
+    uint8_t src = 0U, dst = 0U;
+    int rc = CANERR_FATAL;
+    for (int i = 0; i < 20; i++)
+        pdu[i] = (uint8_t)(i + 1);
+    // @test:
+    // @- send the Broadcast Announce Message (20 bytes, 3 packets) and the packets from DUT2
+    rc = WriteFrame(handle2, TP_CM_ID(0xFF, PEER_ADDRESS), frame);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = WritePackets(handle2, 0xFF, pdu, 20U, 1U, 3U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- receive the PDU on DUT1 and compare the data
+    rc = can_j1939_receive(handle1, &pgn, &src, &dst, buffer, sizeof(buffer), 1000U);
+    XCTAssertEqual(20, rc);
+    XCTAssertEqual(PGN_DM1, pgn);
+    XCTAssertEqual(PEER_ADDRESS, src);
+    XCTAssertEqual(0xFFU, dst);
+    XCTAssertEqual(0, memcmp(buffer, pdu, 20U));
+    // @- the TP frames are consumed by the engine (not in the receive queue)
+    rc = ReadFrame(handle1, TP_DT_ID(0xFF, PEER_ADDRESS), &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC22.2: Receive a connection mode PDU to the own address (RTS/CTS)
+//
+// @expected: CANERR_NOERROR (length of the PDU), CTS after each block and EOMA
+//
+- (void)testConnectionModeReception {
+    uint8_t pdu[20];
+    uint8_t frame[8] = { 16, 20, 0, 3, 2, (uint8_t)PGN_DM1, (uint8_t)(PGN_DM1 >> 8), 0x00 };
+    uint8_t buffer[CANSIO_J1939_MAX_PDU] = {};
+    can_message_t message = {};
+    uint32_t pgn = 0U;
+    uint8_t src = 0U, dst = 0U;
+    int rc = CANERR_FATAL;
+    for (int i = 0; i < 20; i++)
+        pdu[i] = (uint8_t)(0x40 + i);
+    // @pre:
+    // @- claim the own address on DUT1
+    rc = can_j1939_claim(handle1, OWN_ADDRESS, OWN_NAME);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    // @- send a Request To Send (20 bytes, 3 packets, 2 packets per CTS) from DUT2
+    rc = WriteFrame(handle2, TP_CM_ID(OWN_ADDRESS, PEER_ADDRESS), frame);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 clears packets 1 and 2
+    rc = ReadFrame(handle2, TP_CM_ID(PEER_ADDRESS, OWN_ADDRESS), &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(17U, message.data[0]);
+    XCTAssertEqual(2U, message.data[1]);
+    XCTAssertEqual(1U, message.data[2]);
+    XCTAssertEqual((uint8_t)(PGN_DM1 >> 8), message.data[6]);
+    rc = WritePackets(handle2, OWN_ADDRESS, pdu, 20U, 1U, 2U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 clears packet 3
+    rc = ReadFrame(handle2, TP_CM_ID(PEER_ADDRESS, OWN_ADDRESS), &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(17U, message.data[0]);
+    XCTAssertEqual(1U, message.data[1]);
+    XCTAssertEqual(3U, message.data[2]);
+    rc = WritePackets(handle2, OWN_ADDRESS, pdu, 20U, 3U, 1U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 acknowledges the PDU (End of Message Acknowledge)
+    rc = ReadFrame(handle2, TP_CM_ID(PEER_ADDRESS, OWN_ADDRESS), &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(19U, message.data[0]);
+    XCTAssertEqual(20U, message.data[1]);
+    XCTAssertEqual(0U, message.data[2]);
+    XCTAssertEqual(3U, message.data[3]);
+    // @- receive the PDU on DUT1 and compare the data
+    rc = can_j1939_receive(handle1, &pgn, &src, &dst, buffer, sizeof(buffer), 1000U);
+    XCTAssertEqual(20, rc);
+    XCTAssertEqual(PGN_DM1, pgn);
+    XCTAssertEqual(PEER_ADDRESS, src);
+    XCTAssertEqual(OWN_ADDRESS, dst);
+    XCTAssertEqual(0, memcmp(buffer, pdu, 20U));
+    // @end.
+}
+
+// @xctest TC22.3: Receive a broadcast PDU with a wrong sequence number
+//
+// @expected: CANERR_RX_EMPTY (the session is aborted)
+//
+- (void)testWrongSequenceNumber {
+    uint8_t pdu[20] = {};
+    uint8_t frame[8] = { 32, 20, 0, 3, 0xFF, (uint8_t)PGN_DM1, (uint8_t)(PGN_DM1 >> 8), 0x00 };
+    uint8_t buffer[CANSIO_J1939_MAX_PDU] = {};
+    can_sio_j1939_status_t status = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send the Broadcast Announce Message and the packets 1 and 3 from DUT2
+    rc = WriteFrame(handle2, TP_CM_ID(0xFF, PEER_ADDRESS), frame);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = WritePackets(handle2, 0xFF, pdu, 20U, 1U, 1U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = WritePackets(handle2, 0xFF, pdu, 20U, 3U, 1U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- no PDU on DUT1
+    rc = can_j1939_receive(handle1, NULL, NULL, NULL, buffer, sizeof(buffer), 200U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- the session has been aborted
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_J1939_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, status.active);
+    XCTAssertEqual(0U, status.completed);
+    XCTAssertEqual(1U, status.aborted);
+    // @end.
+}
+
+// @xctest TC22.4: Receive a broadcast PDU with a gap longer than T1 between two packets
+//
+// @expected: CANERR_RX_EMPTY (the session is timed out)
+//
+- (void)testSessionTimeout {
+    uint8_t pdu[20] = {};
+    uint8_t frame[8] = { 32, 20, 0, 3, 0xFF, (uint8_t)PGN_DM1, (uint8_t)(PGN_DM1 >> 8), 0x00 };
+    uint8_t buffer[CANSIO_J1939_MAX_PDU] = {};
+    can_sio_j1939_status_t status = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send the Broadcast Announce Message and the first packet from DUT2
+    rc = WriteFrame(handle2, TP_CM_ID(0xFF, PEER_ADDRESS), frame);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = WritePackets(handle2, 0xFF, pdu, 20U, 1U, 1U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- wait longer than T1 (750ms) and send the remaining packets
+    CTimer::Delay(1000U*CTimer::MSEC);
+    rc = WritePackets(handle2, 0xFF, pdu, 20U, 2U, 2U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- no PDU on DUT1
+    rc = can_j1939_receive(handle1, NULL, NULL, NULL, buffer, sizeof(buffer), 200U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- the session has been timed out
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_J1939_STATUS, (void*)&status, sizeof(status));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, status.active);
+    XCTAssertEqual(0U, status.completed);
+    XCTAssertEqual(1U, status.expired);
+    // @end.
+}
+
+
+// @xctest TC22.5: Receive a broadcast PDU into a buffer that is too small
+//
+// @expected: CANERR_ILLPARA (the PDU is discarded)
+//
+- (void)testBufferTooSmall {
+    uint8_t pdu[20] = {};
+    uint8_t frame[8] = { 32, 20, 0, 3, 0xFF, (uint8_t)PGN_DM1, (uint8_t)(PGN_DM1 >> 8), 0x00 };
+    uint8_t buffer[CANSIO_J1939_MAX_PDU] = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- send the Broadcast Announce Message (20 bytes, 3 packets) and the packets from DUT2
+    rc = WriteFrame(handle2, TP_CM_ID(0xFF, PEER_ADDRESS), frame);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = WritePackets(handle2, 0xFF, pdu, 20U, 1U, 3U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- receive the PDU on DUT1 with a buffer of 19 bytes
+    rc = can_j1939_receive(handle1, NULL, NULL, NULL, buffer, 19U, 1000U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- the PDU has been discarded
+    rc = can_j1939_receive(handle1, NULL, NULL, NULL, buffer, sizeof(buffer), 200U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
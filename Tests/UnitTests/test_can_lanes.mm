@@ -0,0 +1,292 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  Priority lanes of DUT1 (configured in INIT mode), DUT2 sends the messages
+#define LANE_SIZE  10U
+
+static int SendMessage(int handle, uint32_t id, uint32_t seq) {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // note: the sequence number is sent in data[0..3] (little endian)
+    message.id = id;
+    message.dlc = 8U;
+    for (int j = 0; j < 4; j++)
+        message.data[j] = (uint8_t)(seq >> (8 * j));
+    do {
+        rc = can_write(handle, &message, 0U);
+    } while (CANERR_TX_BUSY == rc);
+    return rc;
+}
+
+static uint32_t GetValue(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static int SetLane(int handle, uint32_t first, uint32_t last, uint8_t lane) {
+    can_sio_lane_t param = {};
+    param.first = first;
+    param.last = last;
+    param.mask = CAN_MAX_STD_ID;
+    param.xtd = 0U;
+    param.lane = lane;
+    return can_property(handle, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_CLASS, (void*)&param, sizeof(param));
+}
+
+@interface test_can_lanes : XCTestCase {
+    int handle1;
+    int handle2;
+    can_bitrate_t bitrate;
+}
+
+@end
+
+@implementation test_can_lanes
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    int rc = CANERR_FATAL;
+    bitrate.index = TEST_BTRINDEX;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT2 with configured bit-rate settings (DUT1 is started by the test)
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC28.1: Read the default size of the priority lanes
+//
+// @expected: CANERR_NOERROR, no lanes (size 0)
+//
+- (void)testDefaultLaneSize {
+    uint32_t size = 0xFFFFFFFFU;
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, size);
+    // @- a priority class sets up the lanes with default size
+    rc = SetLane(handle1, 0x700U, 0x7FFU, CANSIO_MAX_LANES);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_LANE_SIZE, size);
+    // @end.
+}
+
+// @xctest TC28.2: Read messages from the priority lanes and the receive queue
+//
+// @expected: the highest lane is served first, the order within a lane is kept
+//
+- (void)testLaneOrder {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- assign 0x700..0x7FF to lane 3 and 0x300..0x3FF to lane 1 (0x100 to the queue)
+    rc = SetLane(handle1, 0x700U, 0x7FFU, 3U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = SetLane(handle1, 0x300U, 0x3FFU, 1U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- send 0x100, 0x300 and 0x7FF interleaved from DUT2 (DUT1 does not read)
+    for (uint32_t i = 0U; i < 5U; i++) {
+        XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x100U, i));
+        XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x300U, i));
+        XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x7FFU, i));
+    }
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @test:
+    // @- lane 3 first, then lane 1 and then the receive queue
+    const uint32_t ids[3] = { 0x7FFU, 0x300U, 0x100U };
+    for (int j = 0; j < 3; j++) {
+        for (uint32_t i = 0U; i < 5U; i++) {
+            rc = can_read(handle1, &message, 0U);
+            XCTAssertEqual(CANERR_NOERROR, rc);
+            XCTAssertEqual(0, message.sts);
+            XCTAssertEqual(ids[j], message.id);
+            XCTAssertEqual(i, GetValue(message.data));
+        }
+    }
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC28.3: Overflow of a priority lane
+//
+// @expected: a loss marker is read in front of the remaining messages of the lane
+//
+- (void)testLaneOverflow {
+    can_message_t message = {};
+    uint32_t size = LANE_SIZE;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- set the lane size and assign 0x700..0x7FF to lane 2
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = SetLane(handle1, 0x700U, 0x7FFU, 2U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- send LANE_SIZE + 5 messages to lane 2 and one to the queue from DUT2
+    for (uint32_t i = 0U; i < LANE_SIZE + 5U; i++)
+        XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x700U, i));
+    XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x100U, 0U));
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @test:
+    // @- the loss marker of the lane is read first (5 messages lost)
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1, message.sts);
+    XCTAssertEqual(CANSIO_STS_QUEUE_OVERFLOW, message.id);
+    XCTAssertEqual(5U, GetValue(&message.data[0]));
+    // @- followed by the first LANE_SIZE messages of the lane (drop newest)
+    for (uint32_t i = 0U; i < LANE_SIZE; i++) {
+        rc = can_read(handle1, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0x700U, message.id);
+        XCTAssertEqual(i, GetValue(message.data));
+    }
+    // @- and the message in the receive queue
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x100U, message.id);
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC28.4: Assign all identifiers to the receive queue
+//
+// @expected: CANERR_NOERROR, the messages are read in order of reception
+//
+- (void)testLaneReset {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = SetLane(handle1, 0x700U, 0x7FFU, 3U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_RESET, NULL, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- send 0x100 and 0x7FF interleaved from DUT2
+    for (uint32_t i = 0U; i < 5U; i++) {
+        XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x100U, i));
+        XCTAssertEqual(CANERR_NOERROR, SendMessage(handle2, 0x7FFU, i));
+    }
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @- the messages are read in order of reception
+    for (uint32_t i = 0U; i < 5U; i++) {
+        rc = can_read(handle1, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0x100U, message.id);
+        rc = can_read(handle1, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0x7FFU, message.id);
+    }
+    // @end.
+}
+
+// @xctest TC28.5: Assign identifiers to a priority lane when started
+//
+// @expected: CANERR_ONLINE
+//
+- (void)testSetWhenStarted {
+    uint32_t size = LANE_SIZE;
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    rc = SetLane(handle1, 0x700U, 0x7FFU, 1U);
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_LANE_RESET, NULL, 0U);
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    // @end.
+}
+
+// @xctest TC28.6: Assign identifiers to an invalid lane or an invalid range
+//
+// @expected: CANERR_ILLPARA
+//
+- (void)testInvalidClass {
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- lane number greater than CANSIO_MAX_LANES
+    rc = SetLane(handle1, 0x700U, 0x7FFU, CANSIO_MAX_LANES + 1U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- first identifier greater than last identifier
+    rc = SetLane(handle1, 0x7FFU, 0x700U, 1U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- 11-bit identifier out of range
+    rc = SetLane(handle1, 0x700U, 0x800U, 1U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
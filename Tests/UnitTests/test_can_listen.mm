@@ -0,0 +1,232 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  DUT1 in listen-only mode (CANMODE_MON), DUT2 in default mode
+static uint8_t Protocol(void *param) {
+    // note: the SLCAN protocol of the device under test (Lawicel or CANable)
+    return param ? ((can_sio_param_t*)param)->attr.protocol : CANSIO_LAWICEL;
+}
+
+@interface test_can_listen : XCTestCase {
+    int handle1;
+    int handle2;
+    can_bitrate_t bitrate;
+}
+
+@end
+
+@implementation test_can_listen
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    int rc = CANERR_FATAL;
+    bitrate.index = TEST_BTRINDEX;
+    // @- initialize DUT1 in listen-only mode and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE | CANMODE_MON, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT2 with configured bit-rate settings (DUT1 is started by the test)
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC32.1: Read the operation mode and the operation capability
+//
+// @expected: CANERR_NOERROR, listen-only mode is selected and supported
+//
+- (void)testOperationMode {
+    can_mode_t capa = { CANMODE_DEFAULT };
+    can_mode_t mode = { CANMODE_DEFAULT };
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = can_property(handle1, CANPROP_GET_OP_CAPABILITY, (void*)&capa.byte, sizeof(uint8_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANMODE_MON, capa.byte & CANMODE_MON);
+    rc = can_property(handle1, CANPROP_GET_OP_MODE, (void*)&mode.byte, sizeof(uint8_t));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANMODE_MON, mode.byte & CANMODE_MON);
+    // @end.
+}
+
+// @xctest TC32.2: Receive messages in listen-only mode
+//
+// @expected: CANERR_NOERROR, DUT1 receives the messages of DUT2
+//
+- (void)testReceiveMessages {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    message.id = 0x123U;
+    message.dlc = 1U;
+    for (uint8_t i = 0U; i < TEST_FRAMES; i++) {
+        message.data[0] = i;
+        rc = can_write(handle2, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+    }
+    for (uint8_t i = 0U; i < TEST_FRAMES; i++) {
+        rc = can_read(handle1, &message, 1000U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0x123U, message.id);
+        XCTAssertEqual(i, message.data[0]);
+    }
+    // @end.
+}
+
+// @xctest TC32.3: Send a message in listen-only mode
+//
+// @expected: DUT2 receives no message (Lawicel: not CANERR_NOERROR)
+//
+- (void)testSendMessage {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- note: the device does not send the message (Lawicel: NACK)
+    message.id = 0x123U;
+    message.dlc = 0U;
+    rc = can_write(handle1, &message, 0U);
+    if (Protocol(TEST_PARAM(PAR1)) == CANSIO_LAWICEL)
+        XCTAssertNotEqual(CANERR_NOERROR, rc);
+    rc = can_read(handle2, &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC32.4: Restart in listen-only mode
+//
+// @expected: CANERR_NOERROR, DUT1 is still in listen-only mode
+//
+- (void)testRestart {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_reset(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- DUT1 receives the messages of DUT2
+    message.id = 0x123U;
+    message.dlc = 0U;
+    rc = can_write(handle2, &message, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_read(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0x123U, message.id);
+    // @- DUT1 does not send messages
+    message.id = 0x124U;
+    message.dlc = 0U;
+    rc = can_write(handle1, &message, 0U);
+    if (Protocol(TEST_PARAM(PAR1)) == CANSIO_LAWICEL)
+        XCTAssertNotEqual(CANERR_NOERROR, rc);
+    rc = can_read(handle2, &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC32.5: Set the automatic retransmission of CAN frames
+//
+// @expected: CANERR_NOERROR on CANable devices, CANERR_NOTSUPP on Lawicel devices
+//
+- (void)testAutoRetransmit {
+    uint8_t value = 0xFFU;
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- automatic retransmission is on by default
+    rc = can_property(handle2, CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1U, value);
+    // @- switch it off (DUT1 in INIT mode)
+    value = 0U;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT, (void*)&value, sizeof(value));
+    if ((Protocol(TEST_PARAM(PAR1)) == CANSIO_CANABLE) || (Protocol(TEST_PARAM(PAR1)) == CANSIO_WEACT)) {
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        value = 0xFFU;
+        rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT, (void*)&value, sizeof(value));
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0U, value);
+        // @- invalid value
+        value = 2U;
+        rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT, (void*)&value, sizeof(value));
+        XCTAssertEqual(CANERR_ILLPARA, rc);
+        // @- the setting is applied by can_start and cannot be changed when started
+        rc = can_start(handle1, &bitrate);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        value = 1U;
+        rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_AUTO_RETRANSMIT, (void*)&value, sizeof(value));
+        XCTAssertEqual(CANERR_ONLINE, rc);
+    }
+    else {
+        // @- note: Lawicel devices have no command for it
+        XCTAssertEqual(CANERR_NOTSUPP, rc);
+    }
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
@@ -0,0 +1,313 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  Receive queue of DUT1 (configured in INIT mode), DUT2 sends the messages
+#define QUEUE_SIZE  100U
+#define QUEUE_LOST  50U
+
+static int SendMessages(int handle, size_t count) {
+    can_message_t messages[64] = {};
+    size_t n = 0U, chunk;
+    int rc = CANERR_NOERROR;
+    while (n < count) {
+        // note: the sequence number is sent in data[0..3] (little endian)
+        chunk = ((count - n) < 64U) ? (count - n) : 64U;
+        for (size_t i = 0U; i < chunk; i++) {
+            messages[i].id = 0x100U;
+            messages[i].dlc = 8U;
+            for (int j = 0; j < 4; j++)
+                messages[i].data[j] = (uint8_t)((n + i) >> (8 * j));
+        }
+        rc = can_write_n(handle, messages, chunk, 0U);
+        if (CANERR_TX_BUSY == rc)
+            continue;
+        if (rc <= 0)
+            break;
+        n += (size_t)rc;
+    }
+    return (int)n;
+}
+
+static uint32_t GetValue(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static int SetupQueue(int handle, uint8_t policy, uint16_t block_time) {
+    uint32_t size = QUEUE_SIZE;
+    int rc = can_property(handle, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    if (CANERR_NOERROR == rc)
+        rc = can_property(handle, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME, (void*)&block_time, sizeof(block_time));
+    if (CANERR_NOERROR == rc)
+        rc = can_property(handle, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY, (void*)&policy, sizeof(policy));
+    return rc;
+}
+
+@interface test_can_overflow : XCTestCase {
+    int handle1;
+    int handle2;
+    can_bitrate_t bitrate;
+}
+
+@end
+
+@implementation test_can_overflow
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    int rc = CANERR_FATAL;
+    bitrate.index = TEST_BTRINDEX;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT2 with configured bit-rate settings (DUT1 is started by the test)
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC27.1: Read the default overflow policy of the receive queue
+//
+// @expected: CANERR_NOERROR, drop newest, no blocking time and no loss intervals
+//
+- (void)testDefaultPolicy {
+    uint8_t policy = 0xFFU;
+    uint16_t block_time = 0xFFFFU;
+    uint64_t gaps = 0xFFFFU;
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY, (void*)&policy, sizeof(policy));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_QUEUE_DROP_NEWEST, policy);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME, (void*)&block_time, sizeof(block_time));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, block_time);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_GAPS, (void*)&gaps, sizeof(gaps));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, gaps);
+    // @end.
+}
+
+// @xctest TC27.2: Overflow of the receive queue with policy 'drop newest'
+//
+// @expected: the first QUEUE_SIZE messages are read, followed by a loss marker
+//
+- (void)testDropNewest {
+    can_message_t message = {};
+    uint64_t gaps = 0U;
+    uint8_t status = 0U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- set queue size and policy of DUT1 and start it
+    rc = SetupQueue(handle1, CANSIO_QUEUE_DROP_NEWEST, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- send QUEUE_SIZE + QUEUE_LOST messages from DUT2 (DUT1 does not read)
+    XCTAssertEqual((int)(QUEUE_SIZE + QUEUE_LOST), SendMessages(handle2, QUEUE_SIZE + QUEUE_LOST));
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @test:
+    // @- one loss interval is counted
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_GAPS, (void*)&gaps, sizeof(gaps));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1U, gaps);
+    // @- the first QUEUE_SIZE messages are read in order
+    for (uint32_t i = 0U; i < QUEUE_SIZE; i++) {
+        rc = can_read(handle1, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0, message.sts);
+        XCTAssertEqual(i, GetValue(message.data));
+    }
+    // @- followed by the loss marker (number of lost messages)
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1, message.sts);
+    XCTAssertEqual(CANSIO_STS_QUEUE_OVERFLOW, message.id);
+    XCTAssertEqual(8U, message.dlc);
+    XCTAssertEqual(QUEUE_LOST, GetValue(&message.data[0]));
+    XCTAssertLessThanOrEqual(GetValue(&message.data[4]), 500U);
+    // @- the queue is empty and the overrun is flagged
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    rc = can_status(handle1, &status);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSTAT_QUE_OVR, status & CANSTAT_QUE_OVR);
+    // @end.
+}
+
+// @xctest TC27.3: Overflow of the receive queue with policy 'drop oldest'
+//
+// @expected: a loss marker is read first, followed by the last QUEUE_SIZE messages
+//
+- (void)testDropOldest {
+    can_message_t message = {};
+    uint64_t gaps = 0U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- set queue size and policy of DUT1 and start it
+    rc = SetupQueue(handle1, CANSIO_QUEUE_DROP_OLDEST, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- send QUEUE_SIZE + QUEUE_LOST messages from DUT2 (DUT1 does not read)
+    XCTAssertEqual((int)(QUEUE_SIZE + QUEUE_LOST), SendMessages(handle2, QUEUE_SIZE + QUEUE_LOST));
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @test:
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_GAPS, (void*)&gaps, sizeof(gaps));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1U, gaps);
+    // @- the loss marker is read first (number of lost messages)
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1, message.sts);
+    XCTAssertEqual(CANSIO_STS_QUEUE_OVERFLOW, message.id);
+    XCTAssertEqual(QUEUE_LOST, GetValue(&message.data[0]));
+    // @- followed by the last QUEUE_SIZE messages in order
+    for (uint32_t i = QUEUE_LOST; i < QUEUE_SIZE + QUEUE_LOST; i++) {
+        rc = can_read(handle1, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0, message.sts);
+        XCTAssertEqual(i, GetValue(message.data));
+    }
+    rc = can_read(handle1, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC27.4: Overflow of the receive queue with policy 'block producer'
+//
+// @expected: all messages are read in order, no loss marker
+//
+- (void)testBlockProducer {
+    can_message_t message = {};
+    uint64_t gaps = 0U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- set queue size, policy and blocking time (5s) of DUT1 and start it
+    rc = SetupQueue(handle1, CANSIO_QUEUE_BLOCK_PRODUCER, 5000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @- send QUEUE_SIZE + QUEUE_LOST messages from DUT2 (DUT1 does not read yet)
+    XCTAssertEqual((int)(QUEUE_SIZE + QUEUE_LOST), SendMessages(handle2, QUEUE_SIZE + QUEUE_LOST));
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @test:
+    // @- all messages are read in order (the reception is resumed)
+    for (uint32_t i = 0U; i < QUEUE_SIZE + QUEUE_LOST; i++) {
+        rc = can_read(handle1, &message, 1000U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0, message.sts);
+        XCTAssertEqual(i, GetValue(message.data));
+    }
+    rc = can_read(handle1, &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- no loss interval is counted
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_GAPS, (void*)&gaps, sizeof(gaps));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, gaps);
+    // @end.
+}
+
+// @xctest TC27.5: Change the overflow policy of the receive queue when started
+//
+// @expected: CANERR_NOERROR (the policy can be changed at any time)
+//
+- (void)testChangePolicyWhenStarted {
+    uint8_t policy = CANSIO_QUEUE_DROP_OLDEST;
+    uint16_t block_time = 100U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY, (void*)&policy, sizeof(policy));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME, (void*)&block_time, sizeof(block_time));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    policy = 0xFFU;
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY, (void*)&policy, sizeof(policy));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_QUEUE_DROP_OLDEST, policy);
+    block_time = 0U;
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_BLOCK_TIME, (void*)&block_time, sizeof(block_time));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(100U, block_time);
+    // @end.
+}
+
+// @xctest TC27.6: Set an invalid overflow policy of the receive queue
+//
+// @expected: CANERR_ILLPARA
+//
+- (void)testInvalidPolicy {
+    uint8_t policy = CANSIO_QUEUE_BLOCK_PRODUCER + 1U;
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY, (void*)&policy, sizeof(policy));
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- the policy is not changed
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_POLICY, (void*)&policy, sizeof(policy));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_QUEUE_DROP_NEWEST, policy);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
@@ -0,0 +1,279 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  Receive queue of DUT1 (configured in INIT mode), DUT2 sends the messages
+#define QUEUE_SIZE  100U
+
+static int SendMessages(int handle, size_t count) {
+    can_message_t messages[64] = {};
+    size_t n = 0U, chunk;
+    int rc = CANERR_NOERROR;
+    for (size_t i = 0U; i < 64U; i++) {
+        messages[i].id = (uint32_t)(0x100U + i);
+        messages[i].dlc = 8U;
+    }
+    while (n < count) {
+        chunk = ((count - n) < 64U) ? (count - n) : 64U;
+        rc = can_write_n(handle, messages, chunk, 0U);
+        if (CANERR_TX_BUSY == rc)
+            continue;
+        if (rc <= 0)
+            break;
+        n += (size_t)rc;
+    }
+    return (int)n;
+}
+
+static size_t ReadMessages(int handle) {
+    can_message_t message = {};
+    size_t n = 0U;
+    // note: status messages are skipped
+    while (CANERR_NOERROR == can_read(handle, &message, 0U))
+        n += !message.sts ? 1U : 0U;
+    return n;
+}
+
+static uint32_t QueueFill(int handle) {
+    uint32_t fill = 0xFFFFFFFFU;
+    (void)can_property(handle, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_FILL, (void*)&fill, sizeof(fill));
+    return fill;
+}
+
+@interface test_can_queue : XCTestCase {
+    int handle1;
+    int handle2;
+    can_bitrate_t bitrate;
+}
+
+@end
+
+@implementation test_can_queue
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    int rc = CANERR_FATAL;
+    bitrate.index = TEST_BTRINDEX;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT2 with configured bit-rate settings (DUT1 is started by the test)
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC26.1: Read the default size and memory options of the receive queue
+//
+// @expected: CANERR_NOERROR, 65536 messages and lazy commit
+//
+- (void)testDefaultSettings {
+    uint32_t size = 0U, options = 0U;
+    int rc = CANERR_FATAL;
+    // @test:
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(65536U, size);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS, (void*)&options, sizeof(options));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_QUEUE_LAZY_COMMIT, options);
+    // @- the receive queue is empty
+    XCTAssertEqual(0U, QueueFill(handle1));
+    // @end.
+}
+
+// @xctest TC26.2: Resize the receive queue and fill it up
+//
+// @expected: CANERR_NOERROR, the queue holds at most QUEUE_SIZE messages
+//
+- (void)testResizeQueue {
+    uint32_t size = QUEUE_SIZE;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- set the queue size of DUT1 in INIT mode and read it back
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    size = 0U;
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(QUEUE_SIZE, size);
+    // @- start DUT1
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- send 1.5 times the queue size from DUT2 (DUT1 does not read)
+    XCTAssertEqual((int)(QUEUE_SIZE * 3U / 2U), SendMessages(handle2, QUEUE_SIZE * 3U / 2U));
+    CTimer::Delay(500U*CTimer::MSEC);
+    // @- the queue of DUT1 is full
+    XCTAssertEqual(QUEUE_SIZE, QueueFill(handle1));
+    // @- read all messages on DUT1
+    XCTAssertEqual(QUEUE_SIZE, ReadMessages(handle1));
+    XCTAssertEqual(0U, QueueFill(handle1));
+    // @end.
+}
+
+// @xctest TC26.3: Set memory options of the receive queue
+//
+// @expected: CANERR_NOERROR, the options are taken over and the queue is operable
+//
+- (void)testMemoryOptions {
+    uint32_t options = CANSIO_QUEUE_HUGE_PAGES | CANSIO_QUEUE_SHRINK_IDLE;
+    uint32_t size = 0U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- set the memory options of DUT1 in INIT mode and read them back
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS, (void*)&options, sizeof(options));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    options = 0U;
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS, (void*)&options, sizeof(options));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_QUEUE_HUGE_PAGES | CANSIO_QUEUE_SHRINK_IDLE, options);
+    // @- the queue size is not changed
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(65536U, size);
+    // @- start DUT1
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- send 1000 messages from DUT2 and read them on DUT1
+    XCTAssertEqual(1000, SendMessages(handle2, 1000U));
+    CTimer::Delay(500U*CTimer::MSEC);
+    XCTAssertEqual(1000U, ReadMessages(handle1));
+    XCTAssertEqual(0U, QueueFill(handle1));
+    // @end.
+}
+
+// @xctest TC26.4: Resize the receive queue with messages in it
+//
+// @expected: CANERR_NOERROR, the queued messages are discarded
+//
+- (void)testResizeDiscardsMessages {
+    uint32_t size = QUEUE_SIZE;
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- start DUT1, send 10 messages from DUT2 and stop DUT1
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    XCTAssertEqual(10, SendMessages(handle2, 10U));
+    CTimer::Delay(200U*CTimer::MSEC);
+    XCTAssertEqual(10U, QueueFill(handle1));
+    rc = can_reset(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    // @- resize the queue of DUT1: it is empty
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, QueueFill(handle1));
+    // @- restart DUT1: no message received
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_read(handle1, &message, 100U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC26.5: Set the size and memory options of the receive queue when started
+//
+// @expected: CANERR_ONLINE
+//
+- (void)testSetWhenStarted {
+    uint32_t size = QUEUE_SIZE;
+    uint32_t options = CANSIO_QUEUE_LAZY_COMMIT;
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS, (void*)&options, sizeof(options));
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    // @end.
+}
+
+// @xctest TC26.6: Set an invalid size or invalid memory options of the receive queue
+//
+// @expected: CANERR_ILLPARA
+//
+- (void)testInvalidSettings {
+    uint32_t size = 0U;
+    uint32_t options = 0x80U;
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- queue size 0
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- undefined memory option
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS, (void*)&options, sizeof(options));
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- the settings are not changed
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_SIZE, (void*)&size, sizeof(size));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(65536U, size);
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_RCV_QUEUE_OPTIONS, (void*)&options, sizeof(options));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_QUEUE_LAZY_COMMIT, options);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
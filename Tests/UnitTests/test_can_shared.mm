@@ -0,0 +1,300 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import "shmem.h"
+#import <XCTest/XCTest.h>
+#import <unistd.h>
+#import <errno.h>
+
+//  The test case plays the SerialCAN daemon (server side of the shared-memory
+//  rings), the device under test attaches to it with protocol CANSIO_SHARED.
+#define SHARED_DEVICE  "/dev/ttySLCAN-xctest"
+#define SHARED_RING  64U  // note: a client is overtaken after SHARED_RING - 1 elements
+#define SHARED_POST  16U
+#define SHARED_BTR0BTR1  0x011CU  // SJA1000 BTR0/BTR1 for 250kbps (CANBTR_INDEX_250K)
+
+static shmem_t CreateDaemon(void) {
+    char name[SHMEM_MAX_NAME];
+    can_sio_shared_t info = {};
+    shmem_t shm = NULL;
+    if ((shmem_name(name, CANSIO_SHM_PREFIX, SHARED_DEVICE) == 0) &&
+        ((shm = shmem_create(name, SHARED_RING, SHARED_POST, sizeof(can_message_t), 0U)) != NULL)) {
+        info.pid = (int32_t)getpid();
+        info.btr0btr1 = SHARED_BTR0BTR1;
+        info.protocol = CANSIO_LAWICEL;
+        (void)shmem_info_write(shm, &info, sizeof(can_sio_shared_t));
+    }
+    return shm;
+}
+
+static int PublishMessages(shmem_t shm, uint32_t first, size_t count) {
+    can_message_t message = {};
+    int n = 0;
+    message.id = 0x123U;
+    message.dlc = 8U;
+    for (size_t i = 0U; i < count; i++) {
+        // note: the sequence number is sent in data[0..3] (little endian)
+        for (int j = 0; j < 4; j++)
+            message.data[j] = (uint8_t)((first + i) >> (8 * j));
+        n += (shmem_publish(shm, &message, 1U) == 1) ? 1 : 0;
+    }
+    return n;
+}
+
+static uint32_t GetValue(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+@interface test_can_shared : XCTestCase {
+    shmem_t server;
+    can_sio_param_t param;
+    can_bitrate_t bitrate;
+}
+
+@end
+
+@implementation test_can_shared
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    memset(&param, 0, sizeof(param));
+    param.name = (char*)SHARED_DEVICE;
+    param.attr.protocol = CANSIO_SHARED;
+    bitrate.index = CANBTR_INDEX_250K;
+    // @- create the shared-memory rings of the daemon
+    server = CreateDaemon();
+    XCTAssertTrue(NULL != server);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+    if (server)
+        (void)shmem_destroy(server);
+}
+
+// @xctest TC30.1: Attach to the SerialCAN daemon when it is not running
+//
+// @expected: CANERR_VENDOR - ENOENT (no such shared-memory object)
+//
+- (void)testDaemonNotRunning {
+    int handle = CANERR_FATAL;
+    // @pre:
+    // @- terminate the daemon
+    XCTAssertEqual(0, shmem_destroy(server));
+    server = NULL;
+    // @test:
+    handle = can_init(DUT1, TEST_CANMODE, (void*)&param);
+    XCTAssertEqual(CANERR_VENDOR - ENOENT, handle);
+    // @end.
+}
+
+// @xctest TC30.2: Receive messages published by the SerialCAN daemon
+//
+// @expected: CANERR_NOERROR, the messages published after can_start are read in order
+//
+- (void)testReceiveMessages {
+    can_message_t message = {};
+    uint64_t lost = 0xFFFFU;
+    int handle = CANERR_FATAL;
+    int rc = CANERR_FATAL;
+    // @pre:
+    handle = can_init(DUT1, TEST_CANMODE, (void*)&param);
+    XCTAssertLessThanOrEqual(0, handle);
+    // @- messages published before can_start are not received
+    XCTAssertEqual(10, PublishMessages(server, 1000U, 10U));
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    XCTAssertEqual(10, PublishMessages(server, 0U, 10U));
+    for (uint32_t i = 0U; i < 10U; i++) {
+        rc = can_read(handle, &message, 100U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0x123U, message.id);
+        XCTAssertEqual(i, GetValue(message.data));
+    }
+    rc = can_read(handle, &message, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- no message lost
+    rc = can_property(handle, CANPROP_GET_RCV_QUEUE_OVFL, (void*)&lost, sizeof(lost));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(0U, lost);
+    // @end.
+}
+
+// @xctest TC30.3: Overrun of the receive ring of the SerialCAN daemon
+//
+// @expected: the client resumes at the oldest message in the ring, the loss is counted
+//
+- (void)testRingOverrun {
+    can_message_t messages[SHARED_RING] = {};
+    uint64_t lost = 0U;
+    uint8_t status = 0U;
+    int handle = CANERR_FATAL;
+    int rc = CANERR_FATAL;
+    // @pre:
+    handle = can_init(DUT1, TEST_CANMODE, (void*)&param);
+    XCTAssertLessThanOrEqual(0, handle);
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- publish SHARED_RING + 36 messages (the client does not read)
+    XCTAssertEqual((int)SHARED_RING + 36, PublishMessages(server, 0U, SHARED_RING + 36U));
+    // @test:
+    // @- the client reads the last SHARED_RING - 1 messages in order
+    rc = can_read_n(handle, messages, SHARED_RING, 0U);
+    XCTAssertEqual((int)SHARED_RING - 1, rc);
+    for (int i = 0; (i < rc) && (i < (int)SHARED_RING); i++)
+        XCTAssertEqual(37U + (uint32_t)i, GetValue(messages[i].data));
+    // @- the lost messages are counted and the overrun is flagged
+    rc = can_property(handle, CANPROP_GET_RCV_QUEUE_OVFL, (void*)&lost, sizeof(lost));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(37U, lost);
+    rc = can_status(handle, &status);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSTAT_QUE_OVR, status & CANSTAT_QUE_OVR);
+    // @- the client is in sync again: following messages are read without loss
+    XCTAssertEqual(5, PublishMessages(server, SHARED_RING + 36U, 5U));
+    rc = can_read_n(handle, messages, SHARED_RING, 0U);
+    XCTAssertEqual(5, rc);
+    for (int i = 0; (i < rc) && (i < (int)SHARED_RING); i++)
+        XCTAssertEqual(SHARED_RING + 36U + (uint32_t)i, GetValue(messages[i].data));
+    rc = can_property(handle, CANPROP_GET_RCV_QUEUE_OVFL, (void*)&lost, sizeof(lost));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(37U, lost);
+    // @end.
+}
+
+// @xctest TC30.4: Post messages to the SerialCAN daemon
+//
+// @expected: CANERR_NOERROR, the daemon fetches the messages in order
+//
+- (void)testPostMessages {
+    can_message_t message = {};
+    can_message_t fetched[SHARED_POST] = {};
+    int handle = CANERR_FATAL;
+    int rc = CANERR_FATAL;
+    // @pre:
+    handle = can_init(DUT1, TEST_CANMODE, (void*)&param);
+    XCTAssertLessThanOrEqual(0, handle);
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    message.id = 0x7E0U;
+    message.dlc = 1U;
+    for (uint8_t i = 0U; i < 10U; i++) {
+        message.data[0] = i;
+        rc = can_write(handle, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+    }
+    rc = shmem_fetch(server, fetched, SHARED_POST, 100U);
+    XCTAssertEqual(10, rc);
+    for (int i = 0; (i < rc) && (i < (int)SHARED_POST); i++) {
+        XCTAssertEqual(0x7E0U, fetched[i].id);
+        XCTAssertEqual((uint8_t)i, fetched[i].data[0]);
+    }
+    // @- the transmit ring is full when the daemon does not fetch
+    for (uint8_t i = 0U; i < SHARED_POST; i++)
+        (void)can_write(handle, &message, 0U);
+    rc = can_write(handle, &message, 0U);
+    XCTAssertEqual(CANERR_TX_BUSY, rc);
+    // @end.
+}
+
+// @xctest TC30.5: Start with a bit-rate other than the bit-rate of the SerialCAN daemon
+//
+// @expected: CANERR_BAUDRATE, and CANERR_NOERROR with CANSIO_BITRATE_AUTO
+//
+- (void)testBitrateMismatch {
+    can_bitrate_t other = {};
+    int handle = CANERR_FATAL;
+    int rc = CANERR_FATAL;
+    // @pre:
+    handle = can_init(DUT1, TEST_CANMODE, (void*)&param);
+    XCTAssertLessThanOrEqual(0, handle);
+    // @test:
+    other.index = CANBTR_INDEX_500K;
+    rc = can_start(handle, &other);
+    XCTAssertEqual(CANERR_BAUDRATE, rc);
+    // @- the bit-rate of the daemon is taken over
+    other.index = CANSIO_BITRATE_AUTO;
+    rc = can_start(handle, &other);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+
+// @xctest TC30.6: Read messages when the SerialCAN daemon has terminated
+//
+// @expected: CANERR_OFFLINE
+//
+- (void)testDaemonTerminated {
+    can_message_t message = {};
+    can_message_t request = {};
+    int handle = CANERR_FATAL;
+    int rc = CANERR_FATAL;
+    // @pre:
+    handle = can_init(DUT1, TEST_CANMODE, (void*)&param);
+    XCTAssertLessThanOrEqual(0, handle);
+    rc = can_start(handle, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    // @- terminate the daemon
+    XCTAssertEqual(0, shmem_destroy(server));
+    server = NULL;
+    rc = can_read(handle, &message, 100U);
+    XCTAssertEqual(CANERR_OFFLINE, rc);
+    request.id = 0x7E0U;
+    request.dlc = 0U;
+    rc = can_write(handle, &request, 0U);
+    XCTAssertEqual(CANERR_OFFLINE, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
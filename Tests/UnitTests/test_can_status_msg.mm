@@ -0,0 +1,263 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  DUT1 with error frames (CANMODE_ERR), DUT2 sends at the same or at another bit-rate
+#define OTHER_BTRINDEX  ((TEST_BTRINDEX != CANBTR_INDEX_125K) ? CANBTR_INDEX_125K : CANBTR_INDEX_250K)
+
+static uint8_t Protocol(void *param) {
+    // note: the SLCAN protocol of the device under test (Lawicel or CANable)
+    return param ? ((can_sio_param_t*)param)->attr.protocol : CANSIO_LAWICEL;
+}
+
+static int SendMessage(int handle, int32_t index) {
+    can_bitrate_t bitrate = {};
+    can_message_t message = {};
+    // note: the CAN controller is (re-)started with the given bit-rate
+    bitrate.index = index;
+    (void)can_reset(handle);
+    int rc = can_start(handle, &bitrate);
+    if (rc == CANERR_NOERROR) {
+        message.id = 0x7FFU;
+        message.dlc = 0U;
+        rc = can_write(handle, &message, 0U);
+    }
+    return rc;
+}
+
+@interface test_can_status_msg : XCTestCase {
+    int handle1;
+    int handle2;
+    can_bitrate_t bitrate;
+}
+
+@end
+
+@implementation test_can_status_msg
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    bitrate.index = TEST_BTRINDEX;
+    // @- initialize DUT1 with error frames and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE | CANMODE_ERR, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- note: both CAN controllers are started by the test
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC33.1: Read and set the polling interval of the status flags
+//
+// @expected: CANERR_NOERROR in INIT mode, CANERR_ONLINE when started
+//
+- (void)testPollTime {
+    uint16_t value = 0U;
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- the default polling interval is CANSIO_STATUS_POLL_TIME
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(CANSIO_STATUS_POLL_TIME, value);
+    // @- the polling interval can be set in INIT mode
+    value = 20U;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    value = 0U;
+    rc = can_property(handle1, CANPROP_GET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(20U, value);
+    // @- but not when the CAN controller is started
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    value = 50U;
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_ONLINE, rc);
+    // @post:
+    rc = can_reset(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @end.
+}
+
+// @xctest TC33.2: Status message on a change of the status flags
+//
+// @expected: CANERR_NOERROR, a status message with the bus error flag is read (Lawicel only)
+//
+- (void)testStatusMessage {
+    can_message_t message = {};
+    uint64_t errors = 0U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    if (Protocol(TEST_PARAM(PAR1)) != CANSIO_LAWICEL)
+        return;  // note: CANable devices have no status flags
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 sends at another bit-rate (bus error at DUT1)
+    rc = SendMessage(handle2, OTHER_BTRINDEX);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 reads a status message with the changed flags
+    rc = can_read(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1, message.sts);
+    XCTAssertEqual(CANSIO_STS_CONTROLLER, message.id);
+    XCTAssertEqual(1U, message.dlc);
+    XCTAssertEqual(0x80U, message.data[0] & 0x80U);
+    // @- the status message is counted as an error frame
+    rc = can_property(handle1, CANPROP_GET_ERR_COUNTER, (void*)&errors, sizeof(errors));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1U, errors);
+    // @end.
+}
+
+// @xctest TC33.3: Status message in sequence with the received messages
+//
+// @expected: CANERR_NOERROR, the status message is read after the messages received before
+//
+- (void)testStatusMessageInSequence {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    if (Protocol(TEST_PARAM(PAR1)) != CANSIO_LAWICEL)
+        return;  // note: CANable devices have no status flags
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 sends TEST_FRAMES messages at the same bit-rate
+    message.id = 0x123U;
+    message.dlc = 1U;
+    for (uint8_t i = 0U; i < TEST_FRAMES; i++) {
+        message.data[0] = i;
+        rc = can_write(handle2, &message, 0U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+    }
+    // @- then one message at another bit-rate (bus error at DUT1)
+    rc = SendMessage(handle2, OTHER_BTRINDEX);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 reads the messages first
+    for (uint8_t i = 0U; i < TEST_FRAMES; i++) {
+        rc = can_read(handle1, &message, 1000U);
+        XCTAssertEqual(CANERR_NOERROR, rc);
+        XCTAssertEqual(0, message.sts);
+        XCTAssertEqual(0x123U, message.id);
+        XCTAssertEqual(i, message.data[0]);
+    }
+    // @- followed by the status message
+    rc = can_read(handle1, &message, 1000U);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    XCTAssertEqual(1, message.sts);
+    XCTAssertEqual(CANSIO_STS_CONTROLLER, message.id);
+    XCTAssertEqual(0x80U, message.data[0] & 0x80U);
+    // @end.
+}
+
+// @xctest TC33.4: No status message without error frames
+//
+// @expected: CANERR_RX_EMPTY, the bus error is not reported in the receive queue
+//
+- (void)testNoStatusMessageWithoutErrorFrames {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- re-initialize DUT1 without error frames
+    rc = can_exit(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 sends at another bit-rate (bus error at DUT1)
+    rc = SendMessage(handle2, OTHER_BTRINDEX);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 reads nothing
+    rc = can_read(handle1, &message, 500U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC33.5: No status message when polling is switched off
+//
+// @expected: CANERR_RX_EMPTY, the status flags are not polled (interval 0)
+//
+- (void)testNoStatusMessageWithoutPolling {
+    can_message_t message = {};
+    uint16_t value = 0U;
+    int rc = CANERR_FATAL;
+    // @pre:
+    rc = can_property(handle1, CANPROP_SET_VENDOR_PROP + SLCAN_STATUS_POLL_TIME, (void*)&value, sizeof(value));
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 sends at another bit-rate (bus error at DUT1)
+    rc = SendMessage(handle2, OTHER_BTRINDEX);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @- DUT1 reads nothing
+    rc = can_read(handle1, &message, 500U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
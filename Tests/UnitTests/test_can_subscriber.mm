@@ -0,0 +1,300 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+#import <thread>
+
+//  Subscribers of DUT1 (fan-out), DUT2 sends the messages
+#define SUBSCRIBER_QUEUE  100U
+#define MAX_SUBSCRIBERS  8
+
+static int SendMessages(int handle, uint32_t id, size_t count) {
+    can_message_t message = {};
+    int rc = CANERR_FATAL;
+    message.id = id;
+    message.dlc = 8U;
+    for (size_t i = 0U; i < count; i++) {
+        // note: the sequence number is sent in data[0..3] (little endian)
+        for (int j = 0; j < 4; j++)
+            message.data[j] = (uint8_t)(i >> (8 * j));
+        do {
+            rc = can_write(handle, &message, 0U);
+        } while (CANERR_TX_BUSY == rc);
+        if (CANERR_NOERROR != rc)
+            return (int)i;
+    }
+    return (int)count;
+}
+
+static uint32_t GetValue(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static size_t ReadMessages(int handle) {
+    can_message_t message = {};
+    size_t n = 0U;
+    // note: status messages are skipped
+    while (CANERR_NOERROR == can_read(handle, &message, 0U))
+        n += !message.sts ? 1U : 0U;
+    return n;
+}
+
+@interface test_can_subscriber : XCTestCase {
+    int handle1;
+    int handle2;
+}
+
+@end
+
+@implementation test_can_subscriber
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    can_bitrate_t bitrate = {};
+    int rc = CANERR_FATAL;
+    bitrate.index = TEST_BTRINDEX;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT1 and DUT2 with configured bit-rate settings
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    PCBUSB_INIT_DELAY();
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC29.1: Receive messages by two subscribers and by the reception queue
+//
+// @expected: each subscriber and the reception queue receive a copy of each message
+//
+- (void)testFanOut {
+    can_message_t messages[32] = {};
+    int sub1, sub2;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- create two subscribers of DUT1 (accept all identifiers)
+    sub1 = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertLessThanOrEqual(0, sub1);
+    sub2 = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertLessThanOrEqual(0, sub2);
+    XCTAssertNotEqual(sub1, sub2);
+    // @- send 20 messages from DUT2
+    XCTAssertEqual(20, SendMessages(handle2, 0x123U, 20U));
+    CTimer::Delay(200U*CTimer::MSEC);
+    // @test:
+    // @- each subscriber receives all messages in order
+    rc = can_read_subscriber(handle1, sub1, messages, 32U, 0U);
+    XCTAssertEqual(20, rc);
+    for (uint32_t i = 0U; i < 20U; i++) {
+        XCTAssertEqual(0x123U, messages[i].id);
+        XCTAssertEqual(i, GetValue(messages[i].data));
+    }
+    rc = can_read_subscriber(handle1, sub2, messages, 32U, 0U);
+    XCTAssertEqual(20, rc);
+    rc = can_read_subscriber(handle1, sub2, messages, 32U, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @- the reception queue receives all messages
+    XCTAssertEqual(20U, ReadMessages(handle1));
+    // @post:
+    XCTAssertEqual(CANERR_NOERROR, can_unsubscribe(handle1, sub1));
+    XCTAssertEqual(CANERR_NOERROR, can_unsubscribe(handle1, sub2));
+    // @end.
+}
+
+// @xctest TC29.2: Receive messages by a subscriber with acceptance filter
+//
+// @expected: the subscriber receives the accepted messages only
+//
+- (void)testSubscriberFilter {
+    can_message_t messages[32] = {};
+    int sub;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- create a subscriber of DUT1 for 11-bit identifier 0x100 only
+    sub = can_subscribe(handle1, ((uint64_t)0x100U << 32) | 0x7FFU, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertLessThanOrEqual(0, sub);
+    // @- send 10 messages with identifier 0x100 and 10 with 0x200 from DUT2
+    XCTAssertEqual(10, SendMessages(handle2, 0x100U, 10U));
+    XCTAssertEqual(10, SendMessages(handle2, 0x200U, 10U));
+    CTimer::Delay(200U*CTimer::MSEC);
+    // @test:
+    rc = can_read_subscriber(handle1, sub, messages, 32U, 0U);
+    XCTAssertEqual(10, rc);
+    for (int i = 0; (i < rc) && (i < 32); i++)
+        XCTAssertEqual(0x100U, messages[i].id);
+    // @- the reception queue is not filtered
+    XCTAssertEqual(20U, ReadMessages(handle1));
+    // @end.
+}
+
+// @xctest TC29.3: Overflow of a subscriber queue
+//
+// @expected: the messages of this subscriber are dropped only (reported by a loss marker)
+//
+- (void)testSubscriberIsolation {
+    can_message_t messages[64] = {};
+    int sub1, sub2;
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- create a subscriber with a small queue (10) and one with a large queue
+    sub1 = can_subscribe(handle1, 0U, 0U, 10U);
+    XCTAssertLessThanOrEqual(0, sub1);
+    sub2 = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertLessThanOrEqual(0, sub2);
+    // @- send 30 messages from DUT2 (no subscriber reads)
+    XCTAssertEqual(30, SendMessages(handle2, 0x123U, 30U));
+    CTimer::Delay(200U*CTimer::MSEC);
+    // @test:
+    // @- the small subscriber queue holds the first 10 messages and a loss marker
+    rc = can_read_subscriber(handle1, sub1, messages, 64U, 0U);
+    XCTAssertEqual(11, rc);
+    for (uint32_t i = 0U; i < 10U; i++) {
+        XCTAssertEqual(0, messages[i].sts);
+        XCTAssertEqual(i, GetValue(messages[i].data));
+    }
+    XCTAssertEqual(1, messages[10].sts);
+    XCTAssertEqual(CANSIO_STS_QUEUE_OVERFLOW, messages[10].id);
+    XCTAssertEqual(20U, GetValue(&messages[10].data[0]));
+    // @- the other subscriber and the reception queue lost nothing
+    rc = can_read_subscriber(handle1, sub2, messages, 64U, 0U);
+    XCTAssertEqual(30, rc);
+    for (int i = 0; (i < rc) && (i < 64); i++)
+        XCTAssertEqual(0, messages[i].sts);
+    XCTAssertEqual(30U, ReadMessages(handle1));
+    // @end.
+}
+
+// @xctest TC29.4: Remove a subscriber while a reader is blocked on its queue
+//
+// @expected: CANERR_NOERROR, the blocked reader returns and the subscriber is invalid
+//
+- (void)testUnsubscribeBlockedReader {
+    can_message_t message = {};
+    int sub;
+    int rc = CANERR_FATAL;
+    // @pre:
+    sub = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertLessThanOrEqual(0, sub);
+    // @- a reader waits for a message of the subscriber (blocking read)
+    int res = CANERR_FATAL;
+    std::thread reader([&]() {
+        can_message_t buffer = {};
+        res = can_read_subscriber(handle1, sub, &buffer, 1U, CANREAD_INFINITE);
+    });
+    CTimer::Delay(100U*CTimer::MSEC);
+    // @test:
+    // @- remove the subscriber: the reader returns without a message
+    rc = can_unsubscribe(handle1, sub);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    reader.join();
+    XCTAssertGreaterThan(0, res);
+    // @- the subscriber is invalid
+    rc = can_read_subscriber(handle1, sub, &message, 1U, 0U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    rc = can_unsubscribe(handle1, sub);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @end.
+}
+
+// @xctest TC29.5: Create more than the maximum number of subscribers
+//
+// @expected: CANERR_RESOURCE, and CANERR_ILLPARA for an invalid queue size
+//
+- (void)testSubscriberLimits {
+    int sub[MAX_SUBSCRIBERS];
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- queue size 0
+    rc = can_subscribe(handle1, 0U, 0U, 0U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @- create the maximum number of subscribers
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        sub[i] = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+        XCTAssertLessThanOrEqual(0, sub[i]);
+    }
+    // @- one more subscriber
+    rc = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertEqual(CANERR_RESOURCE, rc);
+    // @- a removed subscriber can be created again
+    XCTAssertEqual(CANERR_NOERROR, can_unsubscribe(handle1, sub[0]));
+    rc = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertEqual(sub[0], rc);
+    // @end.
+}
+
+// @xctest TC29.6: Read from a subscriber when the interface is stopped
+//
+// @expected: CANERR_OFFLINE
+//
+- (void)testReadWhenStopped {
+    can_message_t message = {};
+    int sub;
+    int rc = CANERR_FATAL;
+    // @pre:
+    sub = can_subscribe(handle1, 0U, 0U, SUBSCRIBER_QUEUE);
+    XCTAssertLessThanOrEqual(0, sub);
+    rc = can_reset(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_read_subscriber(handle1, sub, &message, 1U, 0U);
+    XCTAssertEqual(CANERR_OFFLINE, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
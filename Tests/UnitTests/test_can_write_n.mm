@@ -0,0 +1,214 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-3.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v3.0 (or any later version). You
+//  can choose between one of them if you use CAN API V3 in whole or in part.
+//
+//  BSD 2-Clause "Simplified" License:
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  GNU General Public License v3.0 or later:
+//  CAN API V3 is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with CAN API V3.  If not, see <https://www.gnu.org/licenses/>.
+//
+#import "Settings.h"
+#import "can_api.h"
+#import <XCTest/XCTest.h>
+
+//  Batch transmission from DUT2 and batch reception on DUT1
+#define NUM_MESSAGES  200U
+
+static void FillMessages(can_message_t *messages, size_t count) {
+    memset(messages, 0, count * sizeof(can_message_t));
+    for (size_t i = 0U; i < count; i++) {
+        messages[i].id = (uint32_t)(0x100U + (i % 0x100U));
+        messages[i].dlc = 8U;
+        for (int j = 0; j < 8; j++)
+            messages[i].data[j] = (uint8_t)(i >> (j * 8));
+    }
+}
+
+static size_t ReadMessages(int handle, can_message_t *messages, size_t count, uint16_t timeout) {
+    size_t n = 0U, m;
+    int rc;
+    // note: status messages are skipped
+    while (n < count) {
+        rc = can_read_n(handle, &messages[n], count - n, timeout);
+        if (rc <= 0)
+            break;
+        for (size_t i = m = n; i < (n + (size_t)rc); i++)
+            if (!messages[i].sts)
+                messages[m++] = messages[i];
+        n = m;
+    }
+    return n;
+}
+
+@interface test_can_write_n : XCTestCase {
+    int handle1;
+    int handle2;
+}
+
+@end
+
+@implementation test_can_write_n
+
+- (void)setUp {
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    can_bitrate_t bitrate = { TEST_BTRINDEX };
+    int rc = CANERR_FATAL;
+    // @- initialize DUT1 and DUT2 with configured settings
+    handle1 = can_init(DUT1, TEST_CANMODE, TEST_PARAM(PAR1));
+    XCTAssertLessThanOrEqual(0, handle1);
+    handle2 = can_init(DUT2, TEST_CANMODE, TEST_PARAM(PAR2));
+    XCTAssertLessThanOrEqual(0, handle2);
+    // @- start DUT1 and DUT2 with configured bit-rate settings
+    rc = can_start(handle1, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_start(handle2, &bitrate);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @issue(PeakCAN): a delay of 100ms is required here
+    PCBUSB_INIT_DELAY();
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    (void)can_exit(CANKILL_ALL);
+}
+
+// @xctest TC24.1: Send and receive several messages at once
+//
+// @expected: CANERR_NOERROR (number of messages), all messages received in order
+//
+- (void)testWriteAndReadMessages {
+    can_message_t sent[NUM_MESSAGES];
+    can_message_t received[NUM_MESSAGES];
+    int rc = CANERR_FATAL;
+    FillMessages(sent, NUM_MESSAGES);
+    // @test:
+    // @- send the messages from DUT2 (until all are sent)
+    for (size_t n = 0U; n < NUM_MESSAGES; ) {
+        rc = can_write_n(handle2, &sent[n], NUM_MESSAGES - n, 0U);
+        if (CANERR_TX_BUSY == rc)
+            continue;
+        XCTAssertGreaterThan(rc, 0);
+        if (rc <= 0)
+            break;
+        n += (size_t)rc;
+    }
+    // @- read the messages on DUT1 and compare them
+    memset(received, 0, sizeof(received));
+    XCTAssertEqual(NUM_MESSAGES, ReadMessages(handle1, received, NUM_MESSAGES, 1000U));
+    for (size_t i = 0U; i < NUM_MESSAGES; i++) {
+        XCTAssertEqual(sent[i].id, received[i].id);
+        XCTAssertEqual(sent[i].dlc, received[i].dlc);
+        XCTAssertEqual(0, memcmp(sent[i].data, received[i].data, 8U));
+    }
+    // @- the reception queue is empty now
+    rc = can_read_n(handle1, received, NUM_MESSAGES, 0U);
+    XCTAssertEqual(CANERR_RX_EMPTY, rc);
+    // @end.
+}
+
+// @xctest TC24.2: Send several messages with an invalid message in between
+//
+// @expected: number of messages before the invalid one, they are received
+//
+- (void)testWriteStopsAtInvalidMessage {
+    can_message_t sent[10];
+    can_message_t received[10];
+    int rc = CANERR_FATAL;
+    FillMessages(sent, 10U);
+    sent[5].dlc = CAN_MAX_DLC + 1U;
+    // @test:
+    // @- send the messages from DUT2: 5 are sent
+    rc = can_write_n(handle2, sent, 10U, 0U);
+    XCTAssertEqual(5, rc);
+    // @- read the messages on DUT1: 5 are received
+    memset(received, 0, sizeof(received));
+    XCTAssertEqual(5U, ReadMessages(handle1, received, 10U, 200U));
+    XCTAssertEqual(sent[4].id, received[4].id);
+    // @- send the messages from the invalid one on: error
+    rc = can_write_n(handle2, &sent[5], 5U, 0U);
+    XCTAssertEqual(CANERR_ILLPARA, rc);
+    // @end.
+}
+
+// @xctest TC24.3: Call can_write_n and can_read_n with invalid parameters
+//
+// @expected: CANERR_NULLPTR
+//
+- (void)testInvalidParameters {
+    can_message_t messages[2] = {};
+    int rc = CANERR_FATAL;
+    // @test:
+    // @- no messages or no count
+    rc = can_write_n(handle2, NULL, 2U, 0U);
+    XCTAssertEqual(CANERR_NULLPTR, rc);
+    rc = can_write_n(handle2, messages, 0U, 0U);
+    XCTAssertEqual(CANERR_NULLPTR, rc);
+    rc = can_read_n(handle1, NULL, 2U, 0U);
+    XCTAssertEqual(CANERR_NULLPTR, rc);
+    rc = can_read_n(handle1, messages, 0U, 0U);
+    XCTAssertEqual(CANERR_NULLPTR, rc);
+    // @end.
+}
+
+// @xctest TC24.4: Call can_write_n and can_read_n when the CAN controller is stopped
+//
+// @expected: CANERR_OFFLINE
+//
+- (void)testWhenStopped {
+    can_message_t messages[2] = {};
+    int rc = CANERR_FATAL;
+    // @pre:
+    // @- stop DUT1 and DUT2
+    rc = can_reset(handle1);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    rc = can_reset(handle2);
+    XCTAssertEqual(CANERR_NOERROR, rc);
+    // @test:
+    rc = can_write_n(handle2, messages, 2U, 0U);
+    XCTAssertEqual(CANERR_OFFLINE, rc);
+    rc = can_read_n(handle1, messages, 2U, 0U);
+    XCTAssertEqual(CANERR_OFFLINE, rc);
+    // @end.
+}
+
+@end
+
+// $Id$  Copyright (c) UV Software, Berlin //
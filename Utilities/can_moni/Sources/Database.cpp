@@ -0,0 +1,228 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Database.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <algorithm>
+
+#define DBC_XTD_FLAG  0x80000000UL  // extended identifier in DBC files
+
+static const uint8_t c_DlcTable[16] = {
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U
+};
+
+static inline const char *skip_space(const char *ptr) {
+    while (*ptr && isspace((unsigned char)*ptr))
+        ptr++;
+    return ptr;
+}
+
+static inline const char *get_token(const char *ptr, std::string &token) {
+    const char *start = ptr;
+    while (*ptr && !isspace((unsigned char)*ptr) && (*ptr != ':'))
+        ptr++;
+    token.assign(start, (size_t)(ptr - start));
+    return ptr;
+}
+
+CDatabase::CDatabase() {
+    m_nSignals = 0U;
+}
+
+bool CDatabase::Load(const char *filename, int *errorLine) {
+    FILE *fp;
+    std::string line;
+    char chunk[256];
+    int number = 0;
+
+    *this = CDatabase();
+    if (!filename || !(fp = fopen(filename, "r")))
+        return false;
+    // read the file line by line (lines may be of any length)
+    while (fgets(chunk, sizeof(chunk), fp)) {
+        line += chunk;
+        if (!line.empty() && (line.back() != '\n') && !feof(fp))
+            continue;
+        number++;
+        const char *ptr = skip_space(line.c_str());
+        bool ok = true;
+        if (!strncmp(ptr, "BO_ ", 4))
+            ok = ParseMessage(ptr + 4);
+        else if (!strncmp(ptr, "SG_ ", 4))
+            ok = ParseSignal(ptr + 4);
+        line.clear();
+        if (!ok) {
+            if (errorLine)
+                *errorLine = number;
+            fclose(fp);
+            return false;
+        }
+    }
+    fclose(fp);
+    // build the lookup tables (the first definition of an ID wins)
+    m_StdIndex.assign(CAN_MAX_STD_ID + 1, -1);
+    for (size_t i = 0U; i < m_Messages.size(); i++) {
+        if (!m_Messages[i].xtd) {
+            if (m_StdIndex[m_Messages[i].id] < 0)
+                m_StdIndex[m_Messages[i].id] = (int32_t)i;
+        } else {
+            m_XtdIndex.push_back(std::make_pair(m_Messages[i].id, (int32_t)i));
+        }
+    }
+    std::stable_sort(m_XtdIndex.begin(), m_XtdIndex.end(),
+                     [](const std::pair<uint32_t, int32_t> &a, const std::pair<uint32_t, int32_t> &b) { return a.first < b.first; });
+    return true;
+}
+
+const CDatabase::SMessage *CDatabase::Lookup(uint32_t id, bool xtd) const {
+    if (!xtd)
+        return ((id <= CAN_MAX_STD_ID) && !m_StdIndex.empty() && (m_StdIndex[id] >= 0)) ? &m_Messages[m_StdIndex[id]] : NULL;
+    auto it = std::lower_bound(m_XtdIndex.begin(), m_XtdIndex.end(), id,
+                               [](const std::pair<uint32_t, int32_t> &a, uint32_t b) { return a.first < b; });
+    return ((it != m_XtdIndex.end()) && (it->first == id)) ? &m_Messages[it->second] : NULL;
+}
+
+size_t CDatabase::Format(const can_message_t &message, char *string, size_t length) const {
+    const SMessage *entry;
+    uint64_t little = 0U, big = 0U;
+    size_t used = 0U;
+    int n;
+
+    if (!string || !length)
+        return 0U;
+    string[0] = '\0';
+    if (message.sts || message.rtr || !(entry = Lookup(message.id, message.xtd ? true : false)))
+        return 0U;
+    // read the payload as little-endian and as big-endian word
+    uint8_t bytes = c_DlcTable[message.dlc & 0xFU];
+    if (bytes > CAN_MAX_LEN)
+        bytes = CAN_MAX_LEN;
+    for (uint8_t i = 0U; i < bytes; i++) {
+        little |= (uint64_t)message.data[i] << (8U * i);
+        big |= (uint64_t)message.data[i] << (56U - 8U * i);
+    }
+    // decode the multiplexer signal (if any)
+    int64_t mux = -1;
+    if (entry->multiplexer >= 0) {
+        const SSignal &signal = entry->signals[entry->multiplexer];
+        if (signal.bytes <= bytes)
+            mux = (int64_t)(((signal.motorola ? big : little) >> signal.shift) & signal.mask);
+    }
+    n = snprintf(string, length, "%s:", entry->name.c_str());
+    used = (n > 0) ? std::min((size_t)n, length - 1U) : 0U;
+    for (size_t i = 0U; (i < entry->signals.size()) && (used < (length - 1U)); i++) {
+        const SSignal &signal = entry->signals[i];
+        if ((signal.bytes > bytes) || ((signal.mux >= 0) && (signal.mux != mux)))
+            continue;
+        n = snprintf(&string[used], length - used, " %s=%g%s%s", signal.name.c_str(),
+                     Decode(signal, little, big), signal.unit.empty() ? "" : " ", signal.unit.c_str());
+        used += (n > 0) ? std::min((size_t)n, length - used - 1U) : 0U;
+    }
+    return used;
+}
+
+//  BO_ <id> <name>: <dlc> <transmitter>
+//
+bool CDatabase::ParseMessage(const char *line) {
+    SMessage message;
+    char *end;
+
+    unsigned long id = strtoul(line, &end, 10);
+    if (end == line)
+        return false;
+    const char *ptr = get_token(skip_space(end), message.name);
+    if (message.name.empty() || (*skip_space(ptr) != ':'))
+        return false;
+    message.xtd = (id & DBC_XTD_FLAG) ? true : false;
+    message.id = (uint32_t)id & (message.xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID);
+    message.multiplexer = -1;
+    m_Messages.push_back(message);
+    return true;
+}
+
+//  SG_ <name> [M|m<value>] : <start>|<length>@<order><sign> (<factor>,<offset>) [<min>|<max>] "<unit>" <receivers>
+//
+bool CDatabase::ParseSignal(const char *line) {
+    SSignal signal;
+    std::string token;
+    unsigned int start, length;
+    char order, sign;
+    bool multiplexer = false;
+
+    if (m_Messages.empty())
+        return false;
+    const char *ptr = get_token(skip_space(line), signal.name);
+    ptr = skip_space(ptr);
+    signal.mux = -1;
+    if (*ptr != ':') {
+        ptr = skip_space(get_token(ptr, token));
+        if (token == "M")
+            multiplexer = true;
+        else if ((token.size() > 1U) && (token[0] == 'm') && isdigit((unsigned char)token[1]))
+            signal.mux = (int64_t)strtoul(&token[1], NULL, 10);  // note: extended multiplexing is not resolved
+        else
+            return false;
+    }
+    if (signal.name.empty() || (*ptr != ':'))
+        return false;
+    if (sscanf(ptr + 1, " %u|%u@%c%c (%lf,%lf)", &start, &length, &order, &sign,
+               &signal.factor, &signal.offset) != 6)
+        return false;
+    if (((order != '0') && (order != '1')) || ((sign != '+') && (sign != '-')))
+        return false;
+    const char *quote = strchr(ptr, '"');
+    if (quote) {
+        const char *close = strchr(quote + 1, '"');
+        if (close)
+            signal.unit.assign(quote + 1, (size_t)(close - quote - 1));
+    }
+    // compile the extraction plan (signals beyond 64 bits are ignored)
+    if ((length < 1U) || (length > 64U) || (start >= 64U))
+        return true;
+    if (order == '1') {
+        // Intel: <start> is the LSB, counted from bit 0 of byte 0
+        if ((start + length) > 64U)
+            return true;
+        signal.shift = (uint8_t)start;
+        signal.bytes = (uint8_t)((start + length + 7U) / 8U);
+    } else {
+        // Motorola: <start> is the MSB, byte 0 is the most significant byte
+        int msb = 56 - 8 * (int)(start / 8U) + (int)(start % 8U);
+        int lsb = msb - (int)(length - 1U);
+        if (lsb < 0)
+            return true;
+        signal.shift = (uint8_t)lsb;
+        signal.bytes = (uint8_t)(8 - (lsb / 8));
+    }
+    signal.motorola = (order == '0');
+    signal.sign = (sign == '-');
+    signal.mask = (length < 64U) ? (((uint64_t)1U << length) - 1U) : ~(uint64_t)0U;
+    signal.extend = ~signal.mask;
+    SMessage &message = m_Messages.back();
+    if (multiplexer)
+        message.multiplexer = (int32_t)message.signals.size();
+    message.signals.push_back(signal);
+    m_nSignals++;
+    return true;
+}
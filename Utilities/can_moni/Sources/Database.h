@@ -0,0 +1,89 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef CAN_MONI_DATABASE_H_INCLUDED
+#define CAN_MONI_DATABASE_H_INCLUDED
+
+#include "CANAPI_Types.h"
+
+#include <stdint.h>
+
+#include <vector>
+#include <string>
+
+/// \name   Message Database
+/// \brief  Signal decoding by means of a CAN database (DBC file).
+/// \note   When the DBC file is loaded, each signal is compiled into an
+///         extraction plan: the payload is read once as a little-endian
+///         and a big-endian 64-bit word, a signal is then a shift and a
+///         mask of one of them, with sign extension and scaling resolved
+///         in advance. Messages are looked up by their identifier in a
+///         direct table (11-bit IDs) or a sorted table (29-bit IDs).
+///         Signals beyond the first 8 bytes of the payload are ignored.
+/// \{
+class CDatabase {
+public:
+    struct SSignal {
+        std::string name;  // signal name
+        std::string unit;  // physical unit
+        bool motorola;  // big-endian signal (byte order)
+        bool sign;  // signed raw value (two's complement)
+        uint8_t shift;  // position of the LSB in the payload word
+        uint8_t bytes;  // number of payload bytes required
+        uint64_t mask;  // mask of the raw value (after the shift)
+        uint64_t extend;  // bits to be set for a negative raw value
+        double factor;  // scaling factor
+        double offset;  // scaling offset
+        int64_t mux;  // multiplexer value (or -1 if not multiplexed)
+    };
+    struct SMessage {
+        uint32_t id;  // CAN identifier
+        bool xtd;  // extended identifier
+        std::string name;  // message name
+        int32_t multiplexer;  // index of the multiplexer signal (or -1)
+        std::vector<SSignal> signals;  // compiled signals
+    };
+private:
+    std::vector<SMessage> m_Messages;  // all messages (in order of appearance)
+    std::vector<int32_t> m_StdIndex;  // 11-bit ID -> message index (or -1)
+    std::vector<std::pair<uint32_t, int32_t>> m_XtdIndex;  // 29-bit ID -> message index (sorted)
+    size_t m_nSignals;  // total number of signals
+    bool ParseMessage(const char *line);
+    bool ParseSignal(const char *line);
+public:
+    CDatabase();
+    virtual ~CDatabase() {};
+
+    bool Load(const char *filename, int *errorLine = NULL);  // false on error
+    size_t GetMessages() const { return m_Messages.size(); }
+    size_t GetSignals() const { return m_nSignals; }
+
+    const SMessage *Lookup(uint32_t id, bool xtd) const;
+    size_t Format(const can_message_t &message, char *string, size_t length) const;  // returns length of the string
+
+    static inline double Decode(const SSignal &signal, uint64_t little, uint64_t big) {
+        uint64_t raw = ((signal.motorola ? big : little) >> signal.shift) & signal.mask;
+        if (signal.sign && (raw & ~(signal.mask >> 1)))
+            return (double)(int64_t)(raw | signal.extend) * signal.factor + signal.offset;
+        return (double)raw * signal.factor + signal.offset;
+    }
+};
+/// \}
+
+#endif // CAN_MONI_DATABASE_H_INCLUDED
@@ -0,0 +1,196 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#define strncasecmp _strnicmp
+#endif
+
+#define J1939_PGN_MAX   0x3FFFFU  // 18-bit parameter group number
+#define J1939_PDU2_MIN  240U  // PDU format of broadcast PGNs
+
+static bool get_number(const char *&str, uint32_t &value);
+
+CIdFilter::CIdFilter() {
+    memset(m_StdBitmap, 0, sizeof(m_StdBitmap));
+    m_fInverted = false;
+    m_fStdAgree = m_fXtdAgree = false;
+    m_u32StdValue = m_u32StdDiffer = 0U;
+    m_u32XtdValue = m_u32XtdDiffer = 0U;
+}
+
+bool CIdFilter::Compile(const char *expression) {
+    const char *ptr = expression;
+    uint32_t first, last;
+    bool xtd;
+
+    *this = CIdFilter();
+    if (!ptr)
+        return false;
+    if (*ptr == '~') {
+        m_fInverted = true;
+        ptr++;
+    }
+    for (;;) {
+        if (!strncasecmp(ptr, "pgn:", 4)) {
+            /* J1939 PGN: PDU1 format has the destination address in PS */
+            ptr += 4;
+            if (!get_number(ptr, first) || (first > J1939_PGN_MAX))
+                return false;
+            if (((first >> 8) & 0xFFU) < J1939_PDU2_MIN)
+                AddMask((first & 0x3FF00U) << 8, 0x3FF0000U, true);
+            else
+                AddMask(first << 8, 0x3FFFF00U, true);
+        } else {
+            xtd = false;
+            if (!strncasecmp(ptr, "x:", 2)) {
+                xtd = true;
+                ptr += 2;
+            }
+            if (!get_number(ptr, first))
+                return false;
+            if (*ptr == '/') {
+                /* code and mask: mask bits set are relevant */
+                ptr++;
+                if (!get_number(ptr, last))
+                    return false;
+                AddMask(first, last, xtd || (first > CAN_MAX_STD_ID) || (last > CAN_MAX_STD_ID));
+            } else {
+                /* single ID or ID range (in either direction) */
+                last = first;
+                if (*ptr == '-') {
+                    ptr++;
+                    if (!get_number(ptr, last))
+                        return false;
+                    if (last < first)
+                        std::swap(first, last);
+                }
+                AddRange(first, last, xtd || (last > CAN_MAX_STD_ID));
+            }
+        }
+        if (*ptr == '\0')
+            break;
+        if (*ptr++ != ',')
+            return false;
+    }
+    /* merge overlapping and adjacent 29-bit ranges */
+    std::sort(m_XtdRanges.begin(), m_XtdRanges.end(),
+              [](const SRange &a, const SRange &b) { return a.first < b.first; });
+    size_t n = 0U;
+    for (size_t i = 1U; i < m_XtdRanges.size(); i++) {
+        if (m_XtdRanges[i].first <= m_XtdRanges[n].last + 1U)
+            m_XtdRanges[n].last = std::max(m_XtdRanges[n].last, m_XtdRanges[i].last);
+        else
+            m_XtdRanges[++n] = m_XtdRanges[i];
+    }
+    if (!m_XtdRanges.empty())
+        m_XtdRanges.resize(n + 1U);
+    return true;
+}
+
+bool CIdFilter::GetAcceptanceFilter(bool xtd, uint32_t &code, uint32_t &mask) const {
+    /* only a list of included IDs can narrow the reception, and
+     * as a SJA1000 has only one pair of code and mask registers,
+     * the list must not contain IDs of the other type */
+    if (!m_fInverted || !(xtd ? m_fXtdAgree : m_fStdAgree) || (xtd ? m_fStdAgree : m_fXtdAgree))
+        return false;
+    uint32_t max = xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID;
+    uint32_t relevant = ~(xtd ? m_u32XtdDiffer : m_u32StdDiffer) & max;
+    if (!relevant)
+        return false;
+    code = (xtd ? m_u32XtdValue : m_u32StdValue) & relevant;
+    mask = relevant;
+    return true;
+}
+
+void CIdFilter::AddRange(uint32_t first, uint32_t last, bool xtd) {
+    if (!xtd) {
+        for (uint32_t id = first; id <= last; id++)
+            m_StdBitmap[id >> 5] |= (uint32_t)1U << (id & 31U);
+    } else {
+        m_XtdRanges.push_back({first, last});
+    }
+    /* the bits of the common prefix are relevant for the acceptance filter */
+    uint32_t diff = first ^ last;
+    diff |= diff >> 1; diff |= diff >> 2; diff |= diff >> 4;
+    diff |= diff >> 8; diff |= diff >> 16;
+    Accept(first, ~diff, xtd);
+}
+
+void CIdFilter::AddMask(uint32_t code, uint32_t mask, bool xtd) {
+    if (!xtd) {
+        for (uint32_t id = 0U; id <= CAN_MAX_STD_ID; id++)
+            if ((id & mask) == (code & mask))
+                m_StdBitmap[id >> 5] |= (uint32_t)1U << (id & 31U);
+    } else {
+        m_XtdMasks.push_back({code & mask, mask});
+    }
+    Accept(code, mask, xtd);
+}
+
+void CIdFilter::Accept(uint32_t code, uint32_t mask, bool xtd) {
+    uint32_t max = xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID;
+    bool &agree = xtd ? m_fXtdAgree : m_fStdAgree;
+    uint32_t &value = xtd ? m_u32XtdValue : m_u32StdValue;
+    uint32_t &differ = xtd ? m_u32XtdDiffer : m_u32StdDiffer;
+
+    if (!agree) {
+        value = code & mask & max;
+        differ = ~mask & max;
+        agree = true;
+    } else {
+        differ |= (~mask | ((code & mask) ^ value)) & max;
+    }
+}
+
+bool CIdFilter::IsListedXtd(uint32_t id) const {
+    /* binary search in the sorted range table */
+    size_t lo = 0U, hi = m_XtdRanges.size();
+    while (lo < hi) {
+        size_t mid = lo + ((hi - lo) >> 1);
+        if (id < m_XtdRanges[mid].first)
+            hi = mid;
+        else if (id > m_XtdRanges[mid].last)
+            lo = mid + 1U;
+        else
+            return true;
+    }
+    for (size_t i = 0U; i < m_XtdMasks.size(); i++)
+        if ((id & m_XtdMasks[i].mask) == m_XtdMasks[i].code)
+            return true;
+    return false;
+}
+
+static bool get_number(const char *&str, uint32_t &value) {
+    char *end;
+    errno = 0;
+    unsigned long number = strtoul(str, &end, 0);
+    if ((errno != 0) || (end == str) || (*str == '-') || (number > CAN_MAX_XTD_ID))
+        return false;
+    value = (uint32_t)number;
+    str = end;
+    return true;
+}
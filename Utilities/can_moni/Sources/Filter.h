@@ -0,0 +1,83 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef CAN_MONI_FILTER_H_INCLUDED
+#define CAN_MONI_FILTER_H_INCLUDED
+
+#include "CANAPI_Types.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+/// \name   Message Filter
+/// \brief  CAN identifier filter compiled from a filter expression.
+/// \note   Syntax: [~]<item>{,<item>} with <item> = [x:]<id>[-<id>] or
+///         [x:]<code>/<mask> or pgn:<pgn>. Identifiers greater than 7FFh
+///         (or prefixed by 'x:') apply to 29-bit IDs, otherwise to 11-bit
+///         IDs. The listed IDs are excluded, or with '~' the only ones
+///         included. 11-bit IDs are compiled into a bitmap, 29-bit IDs
+///         into a sorted table of disjoint ranges plus a code/mask table.
+/// \{
+class CIdFilter {
+private:
+    struct SRange {
+        uint32_t first;  // first ID of the range
+        uint32_t last;  // last ID of the range (inclusive)
+    };
+    struct SMask {
+        uint32_t code;  // acceptance code (only bits of mask)
+        uint32_t mask;  // acceptance mask (1 = relevant bit)
+    };
+    uint32_t m_StdBitmap[(CAN_MAX_STD_ID + 1) / 32];  // listed 11-bit IDs
+    std::vector<SRange> m_XtdRanges;  // listed 29-bit ID ranges (sorted, disjoint)
+    std::vector<SMask> m_XtdMasks;  // listed 29-bit ID code/mask pairs
+    bool m_fInverted;  // listed IDs are included, not excluded
+    bool m_fStdAgree;  // acceptance bits over 11-bit items (if any):
+    uint32_t m_u32StdValue;  // - value of a listed ID
+    uint32_t m_u32StdDiffer;  // - bits not equal over all listed IDs
+    bool m_fXtdAgree;  // acceptance bits over 29-bit items (if any):
+    uint32_t m_u32XtdValue;  // - value of a listed ID
+    uint32_t m_u32XtdDiffer;  // - bits not equal over all listed IDs
+    void AddRange(uint32_t first, uint32_t last, bool xtd);
+    void AddMask(uint32_t code, uint32_t mask, bool xtd);
+    void Accept(uint32_t code, uint32_t mask, bool xtd);
+    bool IsListedXtd(uint32_t id) const;
+public:
+    CIdFilter();
+    virtual ~CIdFilter() {};
+
+    bool Compile(const char *expression);  // false on syntax error
+    bool IsInverted() const { return m_fInverted; }
+
+    /// \brief  acceptance filter (code/mask) that covers all included IDs
+    ///         of the given type, if such a filter narrows the reception.
+    bool GetAcceptanceFilter(bool xtd, uint32_t &code, uint32_t &mask) const;
+
+    inline bool IsIncluded(const can_message_t &message) const {
+        bool listed;
+        if (!message.xtd)
+            listed = (m_StdBitmap[(message.id & CAN_MAX_STD_ID) >> 5] >> (message.id & 31U)) & 1U;
+        else
+            listed = IsListedXtd(message.id);
+        return listed == m_fInverted;
+    }
+};
+/// \}
+#endif // CAN_MONI_FILTER_H_INCLUDED
@@ -0,0 +1,138 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Merger.h"
+#include "Timer.h"
+
+#include <algorithm>
+
+#define NSEC_PER_MSEC  1000000ULL
+#define NSEC_PER_SEC   1000000000ULL
+
+static inline uint64_t nanoseconds(const struct timespec &ts) {
+    return ((uint64_t)ts.tv_sec * NSEC_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+CMerger::CMerger(int32_t ports, uint32_t window) {
+    m_nPorts = (ports > 0) ? ports : 1;
+    m_pPorts = new SPort[m_nPorts];
+    for (int32_t i = 0; i < m_nPorts; i++) {
+        m_pPorts[i].ring = new SEntry[RingSize];
+        m_pPorts[i].head = 0U;
+        m_pPorts[i].tail = 0U;
+        m_pPorts[i].dropped = 0U;
+        m_pPorts[i].pending = false;
+    }
+    m_Heap.reserve(m_nPorts);
+    m_nWindow = (uint64_t)window * NSEC_PER_MSEC;
+    m_nFrames = 0U;
+}
+
+CMerger::~CMerger() {
+    for (int32_t i = 0; i < m_nPorts; i++)
+        delete[] m_pPorts[i].ring;
+    delete[] m_pPorts;
+}
+
+uint64_t CMerger::GetDropped(int32_t port) const {
+    return ((0 <= port) && (port < m_nPorts)) ? m_pPorts[port].dropped.load() : 0U;
+}
+
+//  Reception thread (producer): stamp the message with the time of its
+//  reception and copy it into the ring of the interface
+//
+void CMerger::Push(int32_t port, const can_message_t &message) {
+    SPort &self = m_pPorts[port];
+    size_t head = self.head.load(std::memory_order_relaxed);
+    size_t tail = self.tail.load(std::memory_order_acquire);
+
+    if ((head - tail) >= RingSize) {
+        self.dropped++;
+        return;
+    }
+    SEntry &entry = self.ring[head & (RingSize - 1U)];
+    entry.arrival = CTimer::GetTime();
+    entry.message = message;
+    if (!entry.message.timestamp.tv_sec && !entry.message.timestamp.tv_nsec)
+        entry.message.timestamp = entry.arrival;
+    self.head.store(head + 1U, std::memory_order_release);
+}
+
+//  Merge loop (consumer): k-way merge of the pending messages, the oldest
+//  one is released when it can't be preceded by a message of an interface
+//  without pending messages anymore (or on flush)
+//
+size_t CMerger::Merge(COutputPipeline &output, bool flush) {
+    COutputPipeline::SFrame batch[COutputPipeline::BatchSize];
+    auto later = [this](int32_t a, int32_t b) { return Later(a, b); };
+    size_t n = 0U, total = 0U;
+
+    for (int32_t i = 0; i < m_nPorts; i++) {
+        if (!m_pPorts[i].pending && Refill(i)) {
+            m_Heap.push_back(i);
+            std::push_heap(m_Heap.begin(), m_Heap.end(), later);
+        }
+    }
+    uint64_t now = nanoseconds(CTimer::GetTime());
+    while (!m_Heap.empty()) {
+        int32_t top = m_Heap.front();
+        SPort &port = m_pPorts[top];
+        if (!flush && (m_Heap.size() < (size_t)m_nPorts) &&
+            ((nanoseconds(port.entry.arrival) + m_nWindow) > now))
+            break;
+        std::pop_heap(m_Heap.begin(), m_Heap.end(), later);
+        m_Heap.pop_back();
+        batch[n].counter = ++m_nFrames;
+        batch[n].channel = top;
+        batch[n].message = port.entry.message;
+        port.pending = false;
+        if (++n == COutputPipeline::BatchSize) {
+            (void)output.Push(batch, n);
+            total += n;
+            n = 0U;
+        }
+        if (Refill(top)) {
+            m_Heap.push_back(top);
+            std::push_heap(m_Heap.begin(), m_Heap.end(), later);
+        }
+    }
+    if (n)
+        (void)output.Push(batch, n);
+    return total + n;
+}
+
+bool CMerger::Refill(int32_t port) {
+    SPort &self = m_pPorts[port];
+    size_t tail = self.tail.load(std::memory_order_relaxed);
+    size_t head = self.head.load(std::memory_order_acquire);
+
+    if (head == tail)
+        return false;
+    self.entry = self.ring[tail & (RingSize - 1U)];
+    self.tail.store(tail + 1U, std::memory_order_release);
+    self.pending = true;
+    return true;
+}
+
+bool CMerger::Later(int32_t a, int32_t b) const {
+    // note: std::push_heap/pop_heap build a max-heap, hence the inverted order
+    uint64_t ta = nanoseconds(m_pPorts[a].entry.message.timestamp);
+    uint64_t tb = nanoseconds(m_pPorts[b].entry.message.timestamp);
+    return (ta != tb) ? (ta > tb) : (a > b);
+}
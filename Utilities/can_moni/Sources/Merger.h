@@ -0,0 +1,76 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef CAN_MONI_MERGER_H_INCLUDED
+#define CAN_MONI_MERGER_H_INCLUDED
+
+#include "Pipeline.h"
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <vector>
+
+/// \name   Message Merger
+/// \brief  Merges the messages of several CAN interfaces into one stream
+///         ordered by their time-stamps.
+/// \note   Each reception thread pushes its messages into its own single-
+///         producer/single-consumer ring. The merge loop keeps the oldest
+///         pending message of each interface in a binary heap (k-way merge)
+///         and releases the top of the heap when every interface has a
+///         message pending, or when it waited longer than the reorder window.
+///         Messages without a time-stamp get the time of their reception.
+/// \{
+class CMerger {
+public:
+    static const size_t RingSize = 16384U;  // ring size per interface in messages (power of 2)
+private:
+    struct SEntry {
+        struct timespec arrival;  // time of reception
+        can_message_t message;  // CAN message
+    };
+    struct SPort {
+        SEntry *ring;  // ring of received messages
+        std::atomic<size_t> head;  // write index (reception thread)
+        std::atomic<size_t> tail;  // read index (merge loop)
+        std::atomic<uint64_t> dropped;  // messages dropped on merge
+        bool pending;  // message pending in the heap
+        SEntry entry;  // the pending message
+    };
+    SPort *m_pPorts;  // one entry per interface
+    int32_t m_nPorts;  // number of interfaces
+    std::vector<int32_t> m_Heap;  // interfaces ordered by their pending message
+    uint64_t m_nWindow;  // reorder window (in [ns])
+    uint64_t m_nFrames;  // number of merged messages
+    bool Refill(int32_t port);
+    bool Later(int32_t a, int32_t b) const;
+public:
+    CMerger(int32_t ports, uint32_t window);
+    virtual ~CMerger();
+
+    void Push(int32_t port, const can_message_t &message);  // from reception thread of <port>
+    size_t Merge(COutputPipeline &output, bool flush = false);  // returns number of merged messages
+
+    uint64_t GetFrames() const { return m_nFrames; }
+    uint64_t GetDropped(int32_t port) const;
+};
+/// \}
+
+#endif // CAN_MONI_MERGER_H_INCLUDED
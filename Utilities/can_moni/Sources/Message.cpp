@@ -53,13 +53,17 @@
 
 //  Methods to format a CAN message
 //
-bool CCanMessage::Format(TCanMessage message, uint64_t counter, char *string, size_t length) {
-    char *szMessage = msg_format_message(&message, MSG_RX_MESSAGE, counter, 0);
-    if (szMessage) {
-        strncpy(string, szMessage, length);
-        return true;
-    } else
+bool CCanMessage::Format(TCanMessage message, uint64_t counter, char *string, size_t length, int32_t channel) {
+    // note: each thread formats with its own context (time-stamp reference),
+    //       the current formatter options are applied on each call.
+    static thread_local struct SFormatter {
+        SFormatter() { msg_init_formatter(&context); }
+        msg_formatter_t context;
+    } formatter;
+    if (!string || !length)
         return false;
+    (void) msg_format_message_r(&formatter.context, &message, MSG_RX_MESSAGE, counter, channel, string, length);
+    return true;
 }
 
 bool CCanMessage::SetTimestampFormat(EFormatTimestamp option) {
@@ -85,3 +89,7 @@ bool CCanMessage::SetAsciiFormat(EFormatOption option) {
 bool CCanMessage::SetWraparound(EFormatWraparound option) {
     return msg_set_fmt_wraparound((msg_fmt_wraparound_t) option) ? true : false;
 }
+
+bool CCanMessage::SetChannelFormat(EFormatOption option) {
+    return msg_set_fmt_channel((msg_fmt_option_t) option) ? true : false;
+}
@@ -83,7 +83,8 @@ public:
     static bool SetDataFormat(EFormatNumber option);
     static bool SetAsciiFormat(EFormatOption option);
     static bool SetWraparound(EFormatWraparound option);
-    static bool Format(TCanMessage message, uint64_t counter, char *string, size_t length);
+    static bool SetChannelFormat(EFormatOption option);
+    static bool Format(TCanMessage message, uint64_t counter, char *string, size_t length, int32_t channel = 0);
 };
 /// \}
 
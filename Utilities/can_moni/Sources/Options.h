@@ -49,10 +49,14 @@
                              "along with this program.  If not, see <https://www.gnu.org/licenses/>."
 #define CAN_MONI_PROGRAM     "can_moni"
 
+#define MAX_INTERFACES  8  // max. number of interfaces monitored at once
+
 struct SOptions {
     // attributes
     char* m_szBasename;
     char* m_szInterface;
+    char* m_szInterfaces[MAX_INTERFACES];
+    int m_nInterfaces;
 #if (OPTION_CANAPI_LIBRARY != 0)
     char* m_szSearchPath;
 #else
@@ -71,6 +75,8 @@ struct SOptions {
         uint32_t m_u32Mask;
     } m_StdFilter, m_XtdFilter;
     char* m_szExcludeList;
+    uint32_t m_u32StatInterval;
+    char* m_szDatabase;
 #if (CAN_TRACE_SUPPORTED != 0)
     enum {
         eTraceOff,
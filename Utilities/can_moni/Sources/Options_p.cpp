@@ -48,6 +48,7 @@
 
 #define DEFAULT_OP_MODE   CANMODE_DEFAULT
 #define DEFAULT_BAUDRATE  CANBTR_INDEX_250K
+#define DEFAULT_INTERVAL  1000U
 
 static const char* c_szApplication = CAN_MONI_APPLICATION;
 static const char* c_szCopyright = CAN_MONI_COPYRIGHT;
@@ -63,6 +64,9 @@ SOptions::SOptions() {
     // initialization
     m_szBasename = (char*)c_szBasename;
     m_szInterface = (char*)c_szInterface;
+    for (int i = 0; i < MAX_INTERFACES; i++)
+        m_szInterfaces[i] = (char*)NULL;
+    m_nInterfaces = 0;
 #if (OPTION_CANAPI_LIBRARY != 0)
     m_szSearchPath = (char*)NULL;
 #else
@@ -80,6 +84,8 @@ SOptions::SOptions() {
     m_XtdFilter.m_u32Code = CANACC_CODE_29BIT;
     m_XtdFilter.m_u32Mask = CANACC_MASK_29BIT;
     m_szExcludeList = (char*)NULL;
+    m_u32StatInterval = 0U;
+    m_szDatabase = (char*)NULL;
 #if (CAN_TRACE_SUPPORTED != 0)
     m_eTraceMode = SOptions::eTraceOff;
 #endif
@@ -114,6 +120,8 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     int optFmtWrap = 0;
 #endif
     int optExclude = 0;
+    int optStatistics = 0;
+    int optDatabase = 0;
 #if (CAN_TRACE_SUPPORTED != 0)
     int optTraceMode = 0;
 #endif
@@ -164,6 +172,8 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
         {"wrap", required_argument, 0, 'w'},
         {"wraparound", required_argument, 0, 'w'},
         {"exclude", required_argument, 0, 'x'},
+        {"statistics", optional_argument, 0, '5'},
+        {"dbc", required_argument, 0, '6'},
         {"script", required_argument, 0, 's'},
         {"trace", required_argument, 0, 'y'},
         {"list-bitrates", optional_argument, 0, 'l'},
@@ -278,7 +288,7 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             break;
 #endif
 #if (SERIAL_CAN_SUPPORTED != 0)
-        /* option '--protocol=(Lawicel|CANable|WeAct)' */
+        /* option '--protocol=(Lawicel|CANable|WeAct|Shared)' */
         case 'z':
             if (optProtocol++) {
                 fprintf(err, "%s: duplicated option `--protocol' (%c)\n", m_szBasename, opt);
@@ -294,6 +304,8 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
                 m_u8Protocol = CANSIO_CANABLE;
             else if (!strcasecmp(optarg, "WeAct"))
                 m_u8Protocol = CANSIO_WEACT;
+            else if (!strcasecmp(optarg, "Shared"))
+                m_u8Protocol = CANSIO_SHARED;
             else {
                 fprintf(err, "%s: illegal argument for option `--protocol' (%c)\n", m_szBasename, opt);
                 return 1;
@@ -637,6 +649,37 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             }
             m_szExcludeList = optarg;
             break;
+        /* option '--statistics[=<interval>]' */
+        case '5':
+            if (optStatistics++) {
+                fprintf(err, "%s: duplicated option `--statistics'\n", m_szBasename);
+                return 1;
+            }
+            m_u32StatInterval = DEFAULT_INTERVAL;
+            if (optarg != NULL) {
+                if (sscanf(optarg, "%" SCNi64, &intarg) != 1) {
+                    fprintf(err, "%s: illegal argument for option `--statistics'\n", m_szBasename);
+                    return 1;
+                }
+                if ((intarg < 100) || (intarg > 60000)) {
+                    fprintf(err, "%s: illegal argument for option `--statistics'\n", m_szBasename);
+                    return 1;
+                }
+                m_u32StatInterval = (uint32_t)intarg;
+            }
+            break;
+        /* option '--dbc=<filename>' */
+        case '6':
+            if (optDatabase++) {
+                fprintf(err, "%s: duplicated option `--dbc'\n", m_szBasename);
+                return 1;
+            }
+            if (optarg == NULL) {
+                fprintf(err, "%s: missing argument for option `--dbc'\n", m_szBasename);
+                return 1;
+            }
+            m_szDatabase = optarg;
+            break;
         /* option '--list-bitrates[=(2.0|FDF[+BRS])]' */
         case 'l':
             if (optListBitrates++) {
@@ -746,8 +789,8 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
         }
     }
     // (3) scan command-line for argument <interface>
-    // - check if one and only one <interface> is given
-    if (optind + 1 != argc) {
+    // - check if at least one and at most MAX_INTERFACES <interface> are given
+    if ((optind == argc) || ((argc - optind) > MAX_INTERFACES)) {
         if (optind != argc) {
             fprintf(err, "%s: too many arguments given\n", m_szBasename);
             return 1;
@@ -759,7 +802,9 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             return 0;
         }
     } else {
-        m_szInterface = (char*)argv[optind];
+        for (m_nInterfaces = 0; optind < argc; optind++)
+            m_szInterfaces[m_nInterfaces++] = (char*)argv[optind];
+        m_szInterface = m_szInterfaces[0];
     }
     // (4) check for illegal combinations
 #if (CAN_FD_SUPPORTED != 0)
@@ -769,6 +814,11 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
         return 1;
     }
 #endif
+    /* - check statistics mode (n/a for several interfaces) */
+    if (m_u32StatInterval && (m_nInterfaces > 1)) {
+        fprintf(err, "%s: option `--statistics' not possible with more than one interface\n", m_szBasename);
+        return 1;
+    }
     return 0;
 }
 
@@ -794,7 +844,7 @@ void SOptions::ShowVersion(FILE* stream) {
 void SOptions::ShowUsage(FILE* stream, bool args) {
     if(!stream)
         return;
-    fprintf(stream, "Usage: %s <interface> [<option>...]\n", m_szBasename);
+    fprintf(stream, "Usage: %s <interface> [<interface>...] [<option>...]\n", m_szBasename);
     fprintf(stream, "Options:\n");
     fprintf(stream, " -t, --time=(ZERO|ABS|REL)            absolute or relative time (default=0)\n");
     fprintf(stream, " -i  --id=(HEX|DEC|OCT)               display mode of CAN-IDs (default=HEX)\n");
@@ -803,7 +853,9 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
 #if (CAN_FD_SUPPORTED != 0)
     fprintf(stream, " -w, --wrap=(NO|8|10|16|32|64)        wraparound after n data bytes (default=NO)\n");
 #endif
-    fprintf(stream, " -x, --exclude=[~]<id-list>           exclude CAN-IDs: <id-list> = <id>[-<id>]{,<id>[-<id>]}\n");
+    fprintf(stream, " -x, --exclude=[~]<id-list>           exclude CAN-IDs: <id-list> = <item>{,<item>}\n");
+    fprintf(stream, "     --statistics[=<ms>]              show per-ID statistics, refreshed every <ms> (default=%u)\n", DEFAULT_INTERVAL);
+    fprintf(stream, "     --dbc=<filename>                 decode signals by means of a CAN database (DBC file)\n");
     fprintf(stream, "     --code=<id>                      acceptance code for 11-bit IDs (default=0x%03x)\n", CANACC_CODE_11BIT);
     fprintf(stream, "     --mask=<id>                      acceptance mask for 11-bit IDs (default=0x%03x)\n", CANACC_MASK_11BIT);
     fprintf(stream, "     --xtd-code=<id>                  acceptance code for 29-bit IDs (default=0x%08x)\n", CANACC_CODE_29BIT);
@@ -830,6 +882,7 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
 #endif
 #if (SERIAL_CAN_SUPPORTED != 0)
     fprintf(stream, " -z, --protocol=(Lawicel|CANable|WeAct) select SLCAN protocol (default=Lawicel)\n");
+    fprintf(stream, "                                       or Shared for access through the SerialCAN daemon\n");
 #endif
 #if (CAN_FD_SUPPORTED != 0)
     fprintf(stream, "     --list-bitrates[=<mode>]         list standard bit-rate settings and exit\n");
@@ -849,6 +902,7 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
     if (args) {
         fprintf(stream, "Arguments:\n");
         fprintf(stream, "  <id>           CAN identifier (11-bit)\n");
+        fprintf(stream, "  <item>         [x:]<id>[-<id>], [x:]<code>/<mask> or pgn:<pgn> (x: = 29-bit)\n");
         fprintf(stream, "  <interface>    CAN interface board (list all with /LIST)\n");
         fprintf(stream, "  <baudrate>     CAN baud rate index (default=3):\n");
         fprintf(stream, "                 0 = 1000 kbps\n");
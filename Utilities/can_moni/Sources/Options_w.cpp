@@ -45,6 +45,7 @@ extern "C" {
 
 #define DEFAULT_OP_MODE   CANMODE_DEFAULT
 #define DEFAULT_BAUDRATE  CANBTR_INDEX_250K
+#define DEFAULT_INTERVAL  1000U
 
 #define BAUDRATE_STR      0
 #define BAUDRATE_CHR      1
@@ -75,29 +76,31 @@ extern "C" {
 #define WRAPAROUND_CHR    26
 #define EXCLUDE_STR       27
 #define EXCLUDE_CHR       28
-#define STD_CODE_STR      29
-#define STD_MASK_CHR      30
-#define XTD_CODE_STR      31
-#define XTD_MASK_CHR      32
-#define SCRIPT_STR        33
-#define SCRIPT_CHR        34
-#define TRACEFILE_STR     35
-#define TRACEFILE_CHR     36
-#define LISTBITRATES_STR  37
-#define LISTBOARDS_STR    38
-#define LISTBOARDS_CHR    39
-#define TESTBOARDS_STR    40
-#define TESTBOARDS_CHR    41
-#define PROTOCOL_STR      42
-#define PROTOCOL_CHR      43
-#define JSON_STR          44
-#define JSON_CHR          45
-#define HELP              46
-#define QUESTION_MARK     47
-#define ABOUT             48
-#define CHARACTER_MJU     49
-#define VERSION           50
-#define MAX_OPTIONS       51
+#define STATISTICS_STR    29
+#define DATABASE_STR      30
+#define STD_CODE_STR      31
+#define STD_MASK_CHR      32
+#define XTD_CODE_STR      33
+#define XTD_MASK_CHR      34
+#define SCRIPT_STR        35
+#define SCRIPT_CHR        36
+#define TRACEFILE_STR     37
+#define TRACEFILE_CHR     38
+#define LISTBITRATES_STR  39
+#define LISTBOARDS_STR    40
+#define LISTBOARDS_CHR    41
+#define TESTBOARDS_STR    42
+#define TESTBOARDS_CHR    43
+#define PROTOCOL_STR      44
+#define PROTOCOL_CHR      45
+#define JSON_STR          46
+#define JSON_CHR          47
+#define HELP              48
+#define QUESTION_MARK     49
+#define ABOUT             50
+#define CHARACTER_MJU     51
+#define VERSION           52
+#define MAX_OPTIONS       53
 
 static char* option[MAX_OPTIONS] = {
     (char*)"BAUDRATE", (char*)"bd",
@@ -115,6 +118,8 @@ static char* option[MAX_OPTIONS] = {
     (char*)"ASCII", (char*)"a",
     (char*)"WARAPAROUND", (char*)"w",
     (char*)"EXCLUDE", (char*)"x",
+    (char*)"STATISTICS",
+    (char*)"DBC",
     (char*)"CODE", (char*)"MASK",
     (char*)"XTD-CODE", (char*)"XTD-MASK",
     (char*)"SCRIPT", (char*)"s",
@@ -150,6 +155,9 @@ SOptions::SOptions() {
     // initialization
     m_szBasename = (char*)c_szBasename;
     m_szInterface = (char*)c_szInterface;
+    for (int i = 0; i < MAX_INTERFACES; i++)
+        m_szInterfaces[i] = (char*)NULL;
+    m_nInterfaces = 0;
 #if (OPTION_CANAPI_LIBRARY != 0)
     m_szSearchPath = (char*)NULL;
 #else
@@ -167,6 +175,8 @@ SOptions::SOptions() {
     m_XtdFilter.m_u32Code = CANACC_CODE_29BIT;
     m_XtdFilter.m_u32Mask = CANACC_MASK_29BIT;
     m_szExcludeList = (char*)NULL;
+    m_u32StatInterval = 0U;
+    m_szDatabase = (char*)NULL;
 #if (CAN_TRACE_SUPPORTED != 0)
     m_eTraceMode = SOptions::eTraceOff;
 #endif
@@ -203,6 +213,8 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     int optFmtWrap = 0;
 #endif
     int optExclude = 0;
+    int optStatistics = 0;
+    int optDatabase = 0;
 #if (CAN_TRACE_SUPPORTED != 0)
     int optTraceMode = 0;
 #endif
@@ -747,6 +759,37 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
             }
             m_szExcludeList = optarg;
             break;
+        /* option '--statistics[=<interval>]' */
+        case STATISTICS_STR:
+            if ((optStatistics++)) {
+                fprintf(err, "%s: duplicated option /STATISTICS\n", m_szBasename);
+                return 1;
+            }
+            m_u32StatInterval = DEFAULT_INTERVAL;
+            if ((optarg = getOptionParameter()) != NULL) {
+                if (sscanf_s(optarg, "%lli", &intarg) != 1) {
+                    fprintf(err, "%s: illegal argument for option /STATISTICS\n", m_szBasename);
+                    return 1;
+                }
+                if ((intarg < 100) || (intarg > 60000)) {
+                    fprintf(err, "%s: illegal argument for option /STATISTICS\n", m_szBasename);
+                    return 1;
+                }
+                m_u32StatInterval = (uint32_t)intarg;
+            }
+            break;
+        /* option '--dbc=<filename>' */
+        case DATABASE_STR:
+            if ((optDatabase++)) {
+                fprintf(err, "%s: duplicated option /DBC\n", m_szBasename);
+                return 1;
+            }
+            if ((optarg = getOptionParameter()) == NULL) {
+                fprintf(err, "%s: missing argument for option /DBC\n", m_szBasename);
+                return 1;
+            }
+            m_szDatabase = optarg;
+            break;
         /* option '--list-bitrates[=(2.0|FDF[+BRS])]' */
         case LISTBITRATES_STR:
             if ((optListBitrates++)) {
@@ -847,14 +890,15 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
     // (3) scan command-line for argument <interface>
     for (int i = 1; i < argc; i++) {
         if (!isOption(argc, (char**)argv, MAX_OPTIONS, option, i)) {
-            if ((argInterface++)) {
+            if ((argInterface++) >= MAX_INTERFACES) {
                 fprintf(err, "%s: too many arguments\n", m_szBasename);
                 return 1;
             }
-            m_szInterface = (char*)argv[i];
+            m_szInterfaces[m_nInterfaces++] = (char*)argv[i];
+            m_szInterface = m_szInterfaces[0];
         }
     }
-    // - check if one and only one <interface> is given
+    // - check if at least one <interface> is given
     if (!argInterface && !m_fExit) {
         fprintf(err, "%s: no interface given\n", m_szBasename);
         return 1;
@@ -867,6 +911,11 @@ int SOptions::ScanCommanline(int argc, const char* argv[], FILE* err, FILE* out)
         return 1;
     }
 #endif
+    /* - check statistics mode (n/a for several interfaces) */
+    if (m_u32StatInterval && (m_nInterfaces > 1)) {
+        fprintf(err, "%s: option /STATISTICS not possible with more than one interface\n", m_szBasename);
+        return 1;
+    }
     return 0;
 }
 
@@ -892,7 +941,7 @@ void SOptions::ShowVersion(FILE* stream) {
 void SOptions::ShowUsage(FILE* stream, bool args) {
     if(!stream)
         return;
-    fprintf(stream, "Usage: %s <interface> [<option>...]\n", m_szBasename);
+    fprintf(stream, "Usage: %s <interface> [<interface>...] [<option>...]\n", m_szBasename);
     fprintf(stream, "Options:\n");
     fprintf(stream, "  /Time:(ZERO|ABS|REL)                absolute or relative time (default=0)\n");
     fprintf(stream, "  /Id:(HEX|DEC|OCT)                   display mode of CAN-IDs (default=HEX)\n");
@@ -901,7 +950,9 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
 #if (CAN_FD_SUPPORTED != 0)
     fprintf(stream, "  /Wraparound:(No|8|10|16|32|64)      wraparound after n data bytes (default=NO)\n");
 #endif
-    fprintf(stream, "  /eXclude:[~]<id-list>               exclude CAN-IDs: <id-list> = <id>[-<id>]{,<id>[-<id>]}\n");
+    fprintf(stream, "  /eXclude:[~]<id-list>               exclude CAN-IDs: <id-list> = <item>{,<item>}\n");
+    fprintf(stream, "  /STATISTICS[:<ms>]                  show per-ID statistics, refreshed every <ms> (default=%u)\n", DEFAULT_INTERVAL);
+    fprintf(stream, "  /DBC:<filename>                     decode signals by means of a CAN database (DBC file)\n");
     fprintf(stream, "  /CODE:<id>                          acceptance code for 11-bit IDs (default=0x%03lx)\n", CANACC_CODE_11BIT);
     fprintf(stream, "  /MASK:<id>                          acceptance mask for 11-bit IDs (default=0x%03lx)\n", CANACC_MASK_11BIT);
     fprintf(stream, "  /XTD-CODE:<id>                      acceptance code for 29-bit IDs (default=0x%08lx)\n", CANACC_CODE_29BIT);
@@ -947,6 +998,7 @@ void SOptions::ShowUsage(FILE* stream, bool args) {
     if (args) {
         fprintf(stream, "Arguments:\n");
         fprintf(stream, "  <id>           CAN identifier (11-bit)\n");
+        fprintf(stream, "  <item>         [x:]<id>[-<id>], [x:]<code>/<mask> or pgn:<pgn> (x: = 29-bit)\n");
         fprintf(stream, "  <interface>    CAN interface board (list all with /LIST)\n");
         fprintf(stream, "  <baudrate>     CAN baud rate index (default=3):\n");
         fprintf(stream, "                 0 = 1000 kbps\n");
@@ -0,0 +1,131 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Pipeline.h"
+#include "Message.h"
+
+#include <string.h>
+
+#include <chrono>
+
+COutputPipeline::COutputPipeline(FILE *file) {
+    m_pRing = new SFrame[RingSize];
+    m_pBuffer = new char[BufferSize];
+    m_nHead = 0U;
+    m_nTail = 0U;
+    m_nDropped = 0U;
+    m_fRunning = false;
+    m_pFile = file;
+    m_pDatabase = NULL;
+}
+
+COutputPipeline::~COutputPipeline() {
+    Stop();
+    delete[] m_pBuffer;
+    delete[] m_pRing;
+}
+
+bool COutputPipeline::Start() {
+    if (m_fRunning || !m_pFile)
+        return false;
+    m_fRunning = true;
+    try {
+        m_Thread = std::thread(&COutputPipeline::WriterLoop, this);
+    } catch (...) {
+        m_fRunning = false;
+        return false;
+    }
+    return true;
+}
+
+void COutputPipeline::Stop() {
+    if (m_Thread.joinable()) {
+        m_fRunning = false;
+        m_Cond.notify_one();
+        m_Thread.join();
+    }
+}
+
+//  Reception loop (producer): copy a batch of messages into the ring,
+//  messages that don't fit are dropped and counted
+//
+size_t COutputPipeline::Push(const SFrame *frames, size_t count) {
+    size_t head = m_nHead.load(std::memory_order_relaxed);
+    size_t tail = m_nTail.load(std::memory_order_acquire);
+    size_t free = RingSize - (head - tail);
+    size_t n = (count < free) ? count : free;
+
+    for (size_t i = 0U; i < n; i++)
+        m_pRing[(head + i) & (RingSize - 1U)] = frames[i];
+    m_nHead.store(head + n, std::memory_order_release);
+    if (n < count)
+        m_nDropped += (uint64_t)(count - n);
+    if (n)
+        m_Cond.notify_one();
+    return n;
+}
+
+//  Writer thread (consumer): format the messages into the output buffer,
+//  write it when it is full or when the ring runs empty
+//
+void COutputPipeline::WriterLoop() {
+    size_t reserve = CANPROP_MAX_STRING_LENGTH + 2U + (m_pDatabase ? SignalSize + 2U : 0U);
+    size_t used = 0U;
+
+    for (;;) {
+        size_t tail = m_nTail.load(std::memory_order_relaxed);
+        size_t head = m_nHead.load(std::memory_order_acquire);
+        if (head == tail) {
+            if (used) {
+                (void)fwrite(m_pBuffer, 1U, used, m_pFile);
+                (void)fflush(m_pFile);
+                used = 0U;
+            }
+            if (!m_fRunning)
+                break;
+            // note: the time-out covers a notification sent before we wait
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Cond.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                return (m_nHead.load() != m_nTail.load()) || !m_fRunning;
+            });
+            continue;
+        }
+        // note: release the slots every batch to make room for the reader
+        if ((head - tail) > BatchSize)
+            head = tail + BatchSize;
+        for (; tail != head; tail++) {
+            const SFrame &frame = m_pRing[tail & (RingSize - 1U)];
+            if ((BufferSize - used) < reserve) {
+                (void)fwrite(m_pBuffer, 1U, used, m_pFile);
+                used = 0U;
+            }
+            (void)CCanMessage::Format(frame.message, frame.counter, &m_pBuffer[used], CANPROP_MAX_STRING_LENGTH + 1U, frame.channel);
+            used += strlen(&m_pBuffer[used]);
+            if (m_pDatabase) {
+                // note: the decoded signals are shown behind the message
+                m_pBuffer[used] = ' ';
+                m_pBuffer[used + 1U] = ' ';
+                size_t n = m_pDatabase->Format(frame.message, &m_pBuffer[used + 2U], SignalSize);
+                used += n ? (n + 2U) : 0U;
+            }
+            m_pBuffer[used++] = '\n';
+        }
+        m_nTail.store(tail, std::memory_order_release);
+    }
+}
@@ -0,0 +1,79 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef CAN_MONI_PIPELINE_H_INCLUDED
+#define CAN_MONI_PIPELINE_H_INCLUDED
+
+#include "CANAPI_Types.h"
+#include "Database.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+/// \name   Output Pipeline
+/// \brief  Decouples the reception of CAN messages from their output.
+/// \note   The reception loop pushes received messages in batches into a
+///         single-producer/single-consumer ring. A writer thread formats
+///         them into a large buffer that is written with one fwrite call.
+///         When the output can't keep up, messages are dropped on the
+///         output side and counted (they are not lost on the bus).
+/// \{
+class COutputPipeline {
+public:
+    static const size_t RingSize = 65536U;  // ring size in messages (power of 2)
+    static const size_t BatchSize = 64U;  // max. number of messages per batch
+    static const size_t BufferSize = 65536U;  // output buffer size in bytes
+    static const size_t SignalSize = 1024U;  // max. length of decoded signals in bytes
+    struct SFrame {
+        uint64_t counter;  // message counter
+        int32_t channel;  // message source (interface)
+        can_message_t message;  // CAN message
+    };
+private:
+    SFrame *m_pRing;  // ring of received messages
+    std::atomic<size_t> m_nHead;  // write index (reception loop)
+    std::atomic<size_t> m_nTail;  // read index (writer thread)
+    std::atomic<uint64_t> m_nDropped;  // messages dropped on output
+    std::atomic<bool> m_fRunning;  // writer thread running
+    std::mutex m_Mutex;
+    std::condition_variable m_Cond;
+    std::thread m_Thread;
+    FILE *m_pFile;  // output stream
+    char *m_pBuffer;  // output buffer
+    const CDatabase *m_pDatabase;  // signal decoding (optional)
+    void WriterLoop();
+public:
+    COutputPipeline(FILE *file = stdout);
+    virtual ~COutputPipeline();
+
+    bool Start();  // start the writer thread
+    void Stop();  // flush pending messages and stop the writer thread
+
+    size_t Push(const SFrame *frames, size_t count);  // returns number of messages taken over
+    void SetDatabase(const CDatabase *database) { m_pDatabase = database; }  // before Start()
+    uint64_t GetDropped() const { return m_nDropped.load(); }
+};
+/// \}
+
+#endif // CAN_MONI_PIPELINE_H_INCLUDED
@@ -0,0 +1,276 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Statistics.h"
+#include "Timer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include <algorithm>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING  0x0004
+#endif
+#endif
+
+#define XTD_HASH_SIZE  1024U  // initial size of the hash table (power of 2)
+
+#define ANSI_HOME      "\033[H"
+#define ANSI_CLEAR     "\033[2J"
+#define ANSI_EOL       "\033[K"
+#define ANSI_EOS       "\033[J"
+#define ANSI_HIGHLIGHT "\033[7m"
+#define ANSI_NORMAL    "\033[0m"
+
+static const uint8_t c_DlcTable[16] = {
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U
+};
+
+static inline uint32_t hash_id(uint32_t id) {
+    id ^= id >> 16;
+    id *= 0x45D9F3BU;
+    id ^= id >> 16;
+    return id;
+}
+
+//  Estimated number of bits on the bus: SOF to EOF plus intermission
+//  (nominal bit-rate, without stuff bits)
+//
+static inline uint32_t frame_bits(const can_message_t &message, uint8_t length) {
+    return (message.xtd ? 67U : 47U) + (8U * (uint32_t)length);
+}
+
+CStatistics::CStatistics(double bitrate) {
+    m_StdIndex.assign(CAN_MAX_STD_ID + 1, -1);
+    m_XtdHash.assign(XTD_HASH_SIZE, -1);
+    m_nXtdCount = 0U;
+    m_fResort = false;
+    m_nFrames = 0U;
+    m_nErrors = 0U;
+    m_nIntervalBits = 0U;
+    m_nIntervalFrames = 0U;
+    m_dBitrate = bitrate;
+    m_Start = CTimer::GetTime();
+    m_Buffer.reserve(65536U);
+    m_pDatabase = NULL;
+#if defined(_WIN32) || defined(_WIN64)
+    // note: the table is redrawn by means of VT100 escape sequences
+    HANDLE hOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD dwMode = 0;
+    if (GetConsoleMode(hOutput, &dwMode))
+        (void)SetConsoleMode(hOutput, dwMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+}
+
+void CStatistics::Update(const can_message_t &message) {
+    m_nFrames++;
+    if (message.sts) {
+        m_nErrors++;
+        return;
+    }
+    SEntry &entry = m_Entries[Lookup(message.id, message.xtd ? true : false)];
+    uint8_t dlc = message.dlc & 0xFU;
+    uint8_t length = message.rtr ? 0U : c_DlcTable[dlc];
+    uint32_t bits = frame_bits(message, length);
+
+    // counters
+    entry.frames++;
+    entry.bits += bits;
+    entry.histogram[dlc]++;
+    m_nIntervalFrames++;
+    m_nIntervalBits += bits;
+    // period and jitter (Welford's online algorithm)
+    struct timespec now = message.timestamp;
+    if (!now.tv_sec && !now.tv_nsec)
+        now = CTimer::GetTime();  // note: time of reception as a fallback
+    if (entry.count) {
+        double period = CTimer::DiffTime(entry.last, now);
+        if (period >= 0.0) {
+            double delta = period - entry.mean;
+            entry.periods++;
+            entry.mean += delta / (double)entry.periods;
+            entry.m2 += delta * (period - entry.mean);
+        }
+    }
+    entry.last = now;
+    // payload (changed bytes are highlighted)
+    if (length > CAN_MAX_LEN)
+        length = CAN_MAX_LEN;
+    for (uint8_t i = 0U; i < length; i++) {
+        if (entry.data[i] != message.data[i]) {
+            entry.data[i] = message.data[i];
+            entry.changed |= (uint8_t)(1U << i);
+        }
+    }
+    if (!entry.count)
+        entry.changed = 0x00U;
+    entry.dlc = dlc;
+    entry.count++;
+}
+
+int32_t CStatistics::Lookup(uint32_t id, bool xtd) {
+    int32_t index;
+    size_t slot, mask;
+
+    if (!xtd) {
+        id &= CAN_MAX_STD_ID;
+        if ((index = m_StdIndex[id]) >= 0)
+            return index;
+    } else {
+        id &= CAN_MAX_XTD_ID;
+        mask = m_XtdHash.size() - 1U;
+        for (slot = hash_id(id) & mask; (index = m_XtdHash[slot]) >= 0; slot = (slot + 1U) & mask) {
+            if (m_Entries[index].id == id)
+                return index;
+        }
+    }
+    // new identifier
+    SEntry entry;
+    memset(&entry, 0, sizeof(SEntry));
+    entry.id = id;
+    entry.xtd = xtd;
+    index = (int32_t)m_Entries.size();
+    m_Entries.push_back(entry);
+    m_fResort = true;
+    if (!xtd) {
+        m_StdIndex[id] = index;
+    } else {
+        m_XtdHash[slot] = index;
+        if ((++m_nXtdCount * 2U) > m_XtdHash.size())
+            Rehash(m_XtdHash.size() * 2U);
+    }
+    return index;
+}
+
+void CStatistics::Rehash(size_t size) {
+    size_t mask = size - 1U;
+    size_t slot;
+
+    m_XtdHash.assign(size, -1);
+    for (size_t i = 0U; i < m_Entries.size(); i++) {
+        if (!m_Entries[i].xtd)
+            continue;
+        for (slot = hash_id(m_Entries[i].id) & mask; m_XtdHash[slot] >= 0; slot = (slot + 1U) & mask);
+        m_XtdHash[slot] = (int32_t)i;
+    }
+}
+
+void CStatistics::Draw(FILE *stream) {
+    struct timespec now = CTimer::GetTime();
+    double elapsed = CTimer::DiffTime(m_Start, now);
+    double load = 0.0;
+    char line[256];
+    char signals[1024];
+
+    if (!stream)
+        return;
+    if (elapsed <= 0.0)
+        elapsed = 1e-9;
+    // (1) take over the figures of the elapsed interval
+    for (size_t i = 0U; i < m_Entries.size(); i++) {
+        SEntry &entry = m_Entries[i];
+        entry.rate = (double)entry.frames / elapsed;
+        entry.load = (m_dBitrate > 0.0) ? ((double)entry.bits * 100.0) / (elapsed * m_dBitrate) : 0.0;
+        entry.frames = 0U;
+        entry.bits = 0U;
+    }
+    if (m_dBitrate > 0.0)
+        load = ((double)m_nIntervalBits * 100.0) / (elapsed * m_dBitrate);
+    double rate = (double)m_nIntervalFrames / elapsed;
+    m_nIntervalFrames = 0U;
+    m_nIntervalBits = 0U;
+    m_Start = now;
+    // (2) sort the entries by identifier (only if new IDs were added)
+    if (m_fResort) {
+        m_Order.resize(m_Entries.size());
+        for (size_t i = 0U; i < m_Order.size(); i++)
+            m_Order[i] = (int32_t)i;
+        std::sort(m_Order.begin(), m_Order.end(), [this](int32_t a, int32_t b) {
+            const SEntry &x = m_Entries[a], &y = m_Entries[b];
+            return (x.xtd != y.xtd) ? !x.xtd : (x.id < y.id);
+        });
+        m_fResort = false;
+    }
+    // (3) render the table and write it at once
+    m_Buffer.clear();
+    m_Buffer += ANSI_HOME;
+    snprintf(line, sizeof(line), "Messages=%" PRIu64 "  Errors=%" PRIu64 "  IDs=%zu (11-bit=%zu, 29-bit=%zu)  Rate=%.1f/s  Bus-load=%.2f%%" ANSI_EOL "\n" ANSI_EOL "\n",
+             m_nFrames, m_nErrors, m_Entries.size(), m_Entries.size() - m_nXtdCount, m_nXtdCount, rate, load);
+    m_Buffer += line;
+    m_Buffer += "CAN-ID         Count    Rate/s  Period[ms]  Jitter[ms]  Load[%]  DLC  Data" ANSI_EOL "\n";
+    for (size_t i = 0U; i < m_Order.size(); i++) {
+        SEntry &entry = m_Entries[m_Order[i]];
+        double jitter = (entry.periods > 1U) ? sqrt(entry.m2 / (double)(entry.periods - 1U)) : 0.0;
+        snprintf(line, sizeof(line), entry.xtd ? "%08" PRIX32 "  " : "%03" PRIX32 "       ", entry.id);
+        m_Buffer += line;
+        snprintf(line, sizeof(line), "%10" PRIu64 "  %8.1f  %10.3f  %10.3f  %7.2f  %2u%c ",
+                 entry.count, entry.rate, entry.mean * 1000.0, jitter * 1000.0, entry.load,
+                 c_DlcTable[entry.dlc], (entry.histogram[entry.dlc] != entry.count) ? '*' : ' ');
+        m_Buffer += line;
+        uint8_t length = c_DlcTable[entry.dlc];
+        for (uint8_t j = 0U; (j < length) && (j < CAN_MAX_LEN); j++) {
+            bool changed = (entry.changed & (1U << j)) ? true : false;
+            snprintf(line, sizeof(line), " %s%02X%s", changed ? ANSI_HIGHLIGHT : "", entry.data[j], changed ? ANSI_NORMAL : "");
+            m_Buffer += line;
+        }
+        if (length > CAN_MAX_LEN)
+            m_Buffer += " ..";
+        m_Buffer += ANSI_EOL "\n";
+        // decoded signals of the last message (if any) in a line below
+        if (m_pDatabase) {
+            can_message_t message = {};
+            message.id = entry.id;
+            message.xtd = entry.xtd ? 1 : 0;
+            message.dlc = entry.dlc;
+            memcpy(message.data, entry.data, CAN_MAX_LEN);
+            if (m_pDatabase->Format(message, signals, sizeof(signals))) {
+                m_Buffer += "          ";
+                m_Buffer += signals;
+                m_Buffer += ANSI_EOL "\n";
+            }
+        }
+        entry.changed = 0x00U;
+    }
+    m_Buffer += ANSI_EOS;
+    (void)fwrite(m_Buffer.data(), 1U, m_Buffer.size(), stream);
+    (void)fflush(stream);
+}
+
+void CStatistics::Summary(FILE *stream) {
+    if (!stream)
+        return;
+    // note: DLC histograms of all IDs with varying data length
+    fprintf(stream, "\n");
+    for (size_t i = 0U; i < m_Order.size(); i++) {
+        const SEntry &entry = m_Entries[m_Order[i]];
+        if (entry.histogram[entry.dlc] == entry.count)
+            continue;
+        fprintf(stream, entry.xtd ? "%08" PRIX32 " DLC:" : "%03" PRIX32 " DLC:", entry.id);
+        for (int dlc = 0; dlc <= CANFD_MAX_DLC; dlc++) {
+            if (entry.histogram[dlc])
+                fprintf(stream, " %u=%" PRIu32, c_DlcTable[dlc], entry.histogram[dlc]);
+        }
+        fprintf(stream, "\n");
+    }
+}
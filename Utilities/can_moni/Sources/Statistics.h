@@ -0,0 +1,87 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  CAN Monitor for generic Interfaces (CAN API V3)
+//
+//  Copyright (c) 2007,2012-2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef CAN_MONI_STATISTICS_H_INCLUDED
+#define CAN_MONI_STATISTICS_H_INCLUDED
+
+#include "CANAPI_Types.h"
+#include "Database.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <vector>
+#include <string>
+
+/// \name   Message Statistics
+/// \brief  Per-ID statistics of received CAN messages ("top" mode).
+/// \note   11-bit identifiers are looked up in a direct array, 29-bit
+///         identifiers in an open-addressing hash table. The update per
+///         received message is O(1); the table is rendered per interval.
+/// \{
+class CStatistics {
+public:
+    struct SEntry {
+        uint32_t id;  // CAN identifier
+        bool xtd;  // extended identifier
+        uint8_t dlc;  // last data length code
+        uint8_t data[CAN_MAX_LEN];  // last payload (first 8 bytes)
+        uint8_t changed;  // changed payload bytes since last redraw (bit mask)
+        uint64_t count;  // number of messages
+        uint64_t frames;  // number of messages in the current interval
+        uint64_t bits;  // number of bits on the bus in the current interval
+        double rate;  // message rate of the last interval (1/s)
+        double load;  // bus load share of the last interval (%)
+        struct timespec last;  // time-stamp of the last message
+        uint64_t periods;  // number of measured periods
+        double mean;  // mean period (s)
+        double m2;  // sum of squared deviations (for the jitter)
+        uint32_t histogram[CANFD_MAX_DLC + 1];  // DLC histogram
+    };
+private:
+    std::vector<SEntry> m_Entries;  // all entries (in order of appearance)
+    std::vector<int32_t> m_StdIndex;  // 11-bit ID -> entry index (or -1)
+    std::vector<int32_t> m_XtdHash;  // hash table for 29-bit IDs -> entry index (or -1)
+    size_t m_nXtdCount;  // number of 29-bit IDs
+    std::vector<int32_t> m_Order;  // entry indexes sorted by ID
+    bool m_fResort;  // new IDs since last redraw
+    uint64_t m_nFrames;  // number of messages
+    uint64_t m_nErrors;  // number of status messages
+    uint64_t m_nIntervalBits;  // number of bits in the current interval
+    uint64_t m_nIntervalFrames;  // number of messages in the current interval
+    double m_dBitrate;  // nominal bit-rate (bps)
+    struct timespec m_Start;  // start of the current interval
+    std::string m_Buffer;  // output buffer
+    const CDatabase *m_pDatabase;  // signal decoding (optional)
+    int32_t Lookup(uint32_t id, bool xtd);
+    void Rehash(size_t size);
+public:
+    CStatistics(double bitrate);
+    virtual ~CStatistics() {};
+
+    void Update(const can_message_t &message);  // O(1) per message
+    void Draw(FILE *stream);  // redraw the table in place
+    void Summary(FILE *stream);  // DLC histograms of IDs with varying length (after the final Draw)
+    uint64_t GetFrames() const { return m_nFrames; }
+    void SetDatabase(const CDatabase *database) { m_pDatabase = database; }
+};
+/// \}
+
+#endif // CAN_MONI_STATISTICS_H_INCLUDED
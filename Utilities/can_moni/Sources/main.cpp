@@ -20,6 +20,11 @@
 #include "Driver.h"
 #include "Options.h"
 #include "Message.h"
+#include "Pipeline.h"
+#include "Statistics.h"
+#include "Filter.h"
+#include "Merger.h"
+#include "Database.h"
 #include "Timer.h"
 #if (SERIAL_CAN_SUPPORTED != 0)
 #include "SerialCAN_Defines.h"
@@ -35,6 +40,9 @@
 
 #include <inttypes.h>
 
+#include <thread>
+#include <vector>
+
 #if defined(_WIN64)
 #define PLATFORM  "x64"
 #elif defined(_WIN32)
@@ -54,13 +62,16 @@
 #define strcasecmp _stricmp
 #endif
 
-#define MAX_ID  (CAN_MAX_STD_ID + 1)
-
-static int get_exclusion(const char* arg);
+#define STATISTICS_TIMEOUT  10U  // read time-out in statistics mode (in [ms])
+#define MERGE_WINDOW  20U  // reorder window for several interfaces (in [ms])
+#define MERGE_INTERVAL  1U  // merge interval when idle (in [ms])
 
 class CCanDevice : public CCanDriver {
 public:
+    CANAPI_Return_t StartInterface(const char* name, const SOptions& opts);
     uint64_t ReceptionLoop();
+    uint64_t StatisticsLoop(uint32_t interval, double bitrate);
+    static uint64_t MergedReceptionLoop(CCanDevice devices[], int count);
 public:
     int ListCanDevices(void);
     int TestCanDevices(CANAPI_OpMode_t opMode);
@@ -74,36 +85,18 @@ public:
 static void sigterm(int signo);
 
 static volatile int running = 1;
-static int can_id[MAX_ID];
-static int can_id_xtd = 1;
+static CIdFilter idFilter = CIdFilter();
+static CDatabase database = CDatabase();
 
-static CCanDevice canDevice = CCanDevice();  // global due to SignalChannel() in sigterm()
+static CCanDevice canDevice[MAX_INTERFACES];  // global due to SignalChannel() in sigterm()
+static int numDevices = 0;
 
 int main(int argc, const char* argv[]) {
-    CCanDevice::SChannelInfo channel = { (-1), "", "", (-1), "" };
-#if (OPTION_CANAPI_LIBRARY != 0)
-    CCanDevice::SLibraryInfo library = { (-1), "", "" };
-#endif
     CANAPI_Return_t retVal = CANERR_FATAL;
     char property[CANPROP_MAX_BUFFER_SIZE + 1] = "";
     char* string = NULL;
+    int port;
 
-    /* device parameter */
-    void* devParam = NULL;
-#if (SERIAL_CAN_SUPPORTED != 0)
-    /* - CAN-over-Serial-Line (SLCAN protocol) */
-    can_sio_param_t sioParam;
-    sioParam.name = NULL;
-    sioParam.attr.protocol = CANSIO_SLCAN;
-    sioParam.attr.baudrate = CANSIO_BD57600;
-    sioParam.attr.bytesize = CANSIO_8DATABITS;
-    sioParam.attr.parity = CANSIO_NOPARITY;
-    sioParam.attr.stopbits = CANSIO_1STOPBIT;
-#endif
-    /* exclude list (11-bit IDs only) */
-    for (int i = 0; i < MAX_ID; i++) {
-        can_id[i] = 1;
-    }
     /* signal handler */
     if ((signal(SIGINT, sigterm) == SIG_ERR) ||
 #if !defined(_WIN32) && !defined(_WIN64)
@@ -134,7 +127,7 @@ int main(int argc, const char* argv[]) {
 #else
     /* - write library info and device list into JSON file */
     if (opts.m_szJsonFilename) {
-        if (!canDevice.WriteJsonFile(opts.m_szJsonFilename)) {
+        if (!canDevice[0].WriteJsonFile(opts.m_szJsonFilename)) {
             fprintf(stderr, "+++ error: JSON file could not be written\n");
             return 1;
         }
@@ -145,28 +138,48 @@ int main(int argc, const char* argv[]) {
 #endif
     /* - list all supported devices (optional) */
     if (opts.m_fListBoards) {
-        int n = canDevice.ListCanDevices();
+        int n = canDevice[0].ListCanDevices();
         fprintf(stdout, "Number of supported CAN interfaces: %i\n", n);
     }
     /* - list all present devices (optional) */
     if (opts.m_fTestBoards) {
-        int n = canDevice.TestCanDevices(opts.m_OpMode);
+        int n = canDevice[0].TestCanDevices(opts.m_OpMode);
         fprintf(stdout, "Number of present CAN interfaces: %i\n", n);
     }
     /* - list bit-rate settings (optional) */
     if (opts.m_fListBitrates) {
-        (void)canDevice.ListCanBitrates(opts.m_OpMode);
+        (void)canDevice[0].ListCanBitrates(opts.m_OpMode);
     }
     /* - exit if no interface is given */
     if (opts.m_fExit) {
         return 0;
     }
-    /* - update exclude list (if set) */
+    /* - compile exclude list (if set) */
     if (opts.m_szExcludeList) {
-        if (!get_exclusion(opts.m_szExcludeList)) {
+        if (!idFilter.Compile(opts.m_szExcludeList)) {
             fprintf(stderr, "+++ error: %s could not be parsed\n", opts.m_szExcludeList);
             return 1;
         }
+        /* -- push the list of included IDs down to the acceptance filter (if not set) */
+        if ((opts.m_StdFilter.m_u32Code == CANACC_CODE_11BIT) && (opts.m_StdFilter.m_u32Mask == CANACC_MASK_11BIT) &&
+            (opts.m_XtdFilter.m_u32Code == CANACC_CODE_29BIT) && (opts.m_XtdFilter.m_u32Mask == CANACC_MASK_29BIT)) {
+            if (!idFilter.GetAcceptanceFilter(false, opts.m_StdFilter.m_u32Code, opts.m_StdFilter.m_u32Mask) &&
+                !opts.m_OpMode.nxtd)
+                (void)idFilter.GetAcceptanceFilter(true, opts.m_XtdFilter.m_u32Code, opts.m_XtdFilter.m_u32Mask);
+        }
+    }
+    /* - load CAN database (if set) */
+    if (opts.m_szDatabase) {
+        int line = 0;
+        if (!database.Load(opts.m_szDatabase, &line)) {
+            if (line)
+                fprintf(stderr, "+++ error: %s could not be parsed (line %i)\n", opts.m_szDatabase, line);
+            else
+                fprintf(stderr, "+++ error: %s could not be opened\n", opts.m_szDatabase);
+            return 1;
+        }
+        if (opts.m_fVerbose)
+            fprintf(stdout, "Database=%s (%zu messages, %zu signals)\n", opts.m_szDatabase, database.GetMessages(), database.GetSignals());
     }
     /* - show operation mode, bit-rate settings and acceptance filter (if set) */
     if (opts.m_fVerbose) {
@@ -203,14 +216,96 @@ int main(int argc, const char* argv[]) {
             fprintf(stdout, "Acc.-filter 29-bit=set (code=%08Xh, mask=%08Xh)\n", opts.m_XtdFilter.m_u32Code, opts.m_XtdFilter.m_u32Mask);
         fputc('\n', stdout);
     }
-    /* - search the <interface> by its name in the device list */
+    /* - initialize and start the interface(s) */
+    for (numDevices = 0; numDevices < opts.m_nInterfaces; numDevices++) {
+        retVal = canDevice[numDevices].StartInterface(opts.m_szInterfaces[numDevices], opts);
+        if (retVal != CCanApi::NoError)
+            goto teardown;
+    }
+    /* - reception loop (or statistics loop) */
+    if (opts.m_u32StatInterval)
+        canDevice[0].StatisticsLoop(opts.m_u32StatInterval, opts.m_BusSpeed.nominal.speed);
+    else if (numDevices > 1)
+        CCanDevice::MergedReceptionLoop(canDevice, numDevices);
+    else
+        canDevice[0].ReceptionLoop();
+    /* - for all interfaces: */
+    for (port = 0; port < numDevices; port++) {
+        /* -- stop trace session (if enabled) */
+#if (CAN_TRACE_SUPPORTED != 0)
+        if (opts.m_eTraceMode != SOptions::eTraceOff) {
+            /* --- get trace file name */
+            retVal = canDevice[port].GetProperty(CANPROP_GET_TRACE_FILE, (void*)property, CANPROP_MAX_BUFFER_SIZE);
+            if (retVal == CCanApi::NoError) {
+                property[CANPROP_MAX_BUFFER_SIZE] = '\0';
+                fprintf(stdout, "Trace-file=%s\n", property);
+            }
+            /* --- set trace inactive */
+            property[0] = CANPARA_TRACE_OFF;
+            (void)canDevice[port].SetProperty(CANPROP_SET_TRACE_ACTIVE, (void*)&property[0], sizeof(uint8_t));
+        }
+#endif
+        /* -- show interface information */
+        if ((string = canDevice[port].GetHardwareVersion()) != NULL)
+            fprintf(stdout, "Hardware: %s\n", string);
+        if ((string = canDevice[port].GetFirmwareVersion()) != NULL)
+            fprintf(stdout, "Firmware: %s\n", string);
+#if (OPTION_CANAPI_LIBRARY != 0)
+        if ((string = canDevice[port].GetSoftwareVersion()) != NULL)
+            fprintf(stdout, "Software: %s\n", string);
+        if ((string = CCanDevice::GetVersion()) != NULL)
+            fprintf(stdout, "          %s\n", string);
+#else
+        if ((string = CCanDevice::GetVersion()) != NULL)
+            fprintf(stdout, "Software: %s\n", string);
+#endif
+    }
+teardown:
+    /* - teardown the interface(s) */
+    for (port = 0; port < numDevices; port++) {
+        retVal = canDevice[port].TeardownChannel();
+        if (retVal != CCanApi::NoError)
+            fprintf(stderr, "+++ error: CAN Controller could not be reset (%i)\n", retVal);
+    }
+    /* So long and farewell! */
+    opts.ShowFarewell(stdout);
+    return retVal;
+}
+
+/*  Initialize and start the interface <name>:
+ *  - the acceptance filter and the trace session are set up according to
+ *    the options; on error the interface is teared down again
+ */
+CANAPI_Return_t CCanDevice::StartInterface(const char* name, const SOptions& opts) {
+    CCanDevice::SChannelInfo channel = { (-1), "", "", (-1), "" };
+#if (OPTION_CANAPI_LIBRARY != 0)
+    CCanDevice::SLibraryInfo library = { (-1), "", "" };
+#endif
+    CANAPI_Return_t retVal = CANERR_FATAL;
+#if (CAN_TRACE_SUPPORTED != 0)
+    char property[CANPROP_MAX_BUFFER_SIZE + 1] = "";
+#endif
+
+    /* device parameter */
+    void* devParam = NULL;
+#if (SERIAL_CAN_SUPPORTED != 0)
+    /* - CAN-over-Serial-Line (SLCAN protocol) */
+    can_sio_param_t sioParam;
+    sioParam.name = NULL;
+    sioParam.attr.protocol = CANSIO_SLCAN;
+    sioParam.attr.baudrate = CANSIO_BD57600;
+    sioParam.attr.bytesize = CANSIO_8DATABITS;
+    sioParam.attr.parity = CANSIO_NOPARITY;
+    sioParam.attr.stopbits = CANSIO_1STOPBIT;
+#endif
+    /* search the <interface> by its name in the device list */
     bool flagFound = false;
 #if (OPTION_CANAPI_LIBRARY != 0)
     bool iterLibrary = CCanDevice::GetFirstLibrary(library);
     while (iterLibrary && !flagFound) {
         bool iterChannel = CCanDevice::GetFirstChannel(library.m_nLibraryId, channel);
         while (iterChannel) {
-            if (strcasecmp(opts.m_szInterface, channel.m_szDeviceName) == 0) {
+            if (strcasecmp(name, channel.m_szDeviceName) == 0) {
                 flagFound = true;
                 break;
             }
@@ -220,42 +315,42 @@ int main(int argc, const char* argv[]) {
     }
 #else
 #if (SERIAL_CAN_SUPPORTED == 0)
-    /* -- loop over build-in device list (old 'can_boards[]') */
+    /* - loop over build-in device list (old 'can_boards[]') */
     bool iterChannel = CCanDevice::GetFirstChannel(channel);
     while (iterChannel) {
-        if (strcasecmp(opts.m_szInterface, channel.m_szDeviceName) == 0) {
+        if (strcasecmp(name, channel.m_szDeviceName) == 0) {
             flagFound = true;
             break;
         }
         iterChannel = CCanDevice::GetNextChannel(channel);
     }
 #else
-    /* -- note: SerialCAN has no build-in device list (fake it) */
+    /* - note: SerialCAN has no build-in device list (fake it) */
     channel.m_nLibraryId = CANLIB_SERIALCAN;
     channel.m_nChannelNo = CANDEV_SERIAL;
     flagFound = true;
 #endif
 #endif
     if (!flagFound) {
-        fprintf(stderr, "+++ error: %s could not be found\n", opts.m_szInterface);
-        return 1;
+        fprintf(stderr, "+++ error: %s could not be found\n", name);
+        return CCanApi::FatalError;
     }
 #if (SERIAL_CAN_SUPPORTED != 0)
-    /* - CAN-over-Serial-Line (SLCAN protocol) */
+    /* CAN-over-Serial-Line (SLCAN protocol) */
     if (channel.m_nLibraryId == CANLIB_SERIALCAN) {
         channel.m_nChannelNo = CANDEV_SERIAL;  // note: override channel number from JSON file
-        sioParam.name = opts.m_szInterface;
+        sioParam.name = (char*)name;
         sioParam.attr.protocol = opts.m_u8Protocol;
         devParam = (void*)&sioParam;
     }
 #endif
-    /* - initialize interface */
-    fprintf(stdout, "Hardware=%s...", opts.m_szInterface);
+    /* initialize interface */
+    fprintf(stdout, "Hardware=%s...", name);
     fflush (stdout);
 #if (OPTION_CANAPI_LIBRARY != 0)
-    retVal = canDevice.InitializeChannel(channel.m_nLibraryId, channel.m_nChannelNo, opts.m_OpMode, devParam);
+    retVal = InitializeChannel(channel.m_nLibraryId, channel.m_nChannelNo, opts.m_OpMode, devParam);
 #else
-    retVal = canDevice.InitializeChannel(channel.m_nChannelNo, opts.m_OpMode, devParam);
+    retVal = InitializeChannel(channel.m_nChannelNo, opts.m_OpMode, devParam);
 #endif
     if (retVal != CCanApi::NoError) {
         fprintf(stdout, "FAILED!\n");
@@ -263,28 +358,30 @@ int main(int argc, const char* argv[]) {
         if (retVal == CCanApi::IllegalParameter)
             fprintf(stderr, "\n           - possibly CAN operating mode %02Xh not supported", opts.m_OpMode.byte);
         fputc('\n', stderr);
-        goto farewell;
+        return retVal;
     }
-    /* -- set acceptance filter for 11-bit IDs */
+    /* - set acceptance filter for 11-bit IDs */
     if ((opts.m_StdFilter.m_u32Code != CANACC_CODE_11BIT) || (opts.m_StdFilter.m_u32Mask != CANACC_MASK_11BIT)) {
-        retVal = canDevice.SetFilter11Bit(opts.m_StdFilter.m_u32Code, opts.m_StdFilter.m_u32Mask);
+        retVal = SetFilter11Bit(opts.m_StdFilter.m_u32Code, opts.m_StdFilter.m_u32Mask);
         if (retVal != CCanApi::NoError) {
             fprintf(stdout, "FAILED!\n");
             fprintf(stderr, "+++ error: CAN acceptance filter could not be set (%i)\n", retVal);
-            goto teardown;
+            (void)TeardownChannel();
+            return retVal;
         }
     }
-    /* -- set acceptance filter for 29-bit IDs */
+    /* - set acceptance filter for 29-bit IDs */
     if (((opts.m_XtdFilter.m_u32Code != CANACC_CODE_29BIT) || (opts.m_XtdFilter.m_u32Mask != CANACC_MASK_29BIT)) && !opts.m_OpMode.nxtd) {
-        retVal = canDevice.SetFilter29Bit(opts.m_XtdFilter.m_u32Code, opts.m_XtdFilter.m_u32Mask);
+        retVal = SetFilter29Bit(opts.m_XtdFilter.m_u32Code, opts.m_XtdFilter.m_u32Mask);
         if (retVal != CCanApi::NoError) {
             fprintf(stdout, "FAILED!\n");
             fprintf(stderr, "+++ error: CAN acceptance filter could not be set (%i)\n", retVal);
-            goto teardown;
+            (void)TeardownChannel();
+            return retVal;
         }
     }
     fprintf(stdout, "OK!\n");
-    /* - start communication */
+    /* start communication */
     if (opts.m_Bitrate.btr.frequency > 0) {
         fprintf(stdout, "Bit-rate=%.0fkbps", opts.m_BusSpeed.nominal.speed / 1000.);
 #if (CAN_FD_SUPPORTED != 0)
@@ -308,16 +405,17 @@ int main(int argc, const char* argv[]) {
             opts.m_Bitrate.index == CANBTR_INDEX_10K  ? "10" : "?");
     }
     fflush(stdout);
-    retVal = canDevice.StartController(opts.m_Bitrate);
+    retVal = StartController(opts.m_Bitrate);
     if (retVal != CCanApi::NoError) {
         fprintf(stdout, "FAILED!\n");
         fprintf(stderr, "+++ error: CAN Controller could not be started (%i)\n", retVal);
-        goto teardown;
+        (void)TeardownChannel();
+        return retVal;
     }
-    /* - start trace session (if enabled) */
+    /* start trace session (if enabled) */
 #if (CAN_TRACE_SUPPORTED != 0)
     if (opts.m_eTraceMode != SOptions::eTraceOff) {
-        /* -- set trace format */
+        /* - set trace format */
         switch (opts.m_eTraceMode) {
             case SOptions::eTraceVendor:
                 property[0] = CANPARA_TRACE_TYPE_VENDOR;
@@ -330,59 +428,20 @@ int main(int argc, const char* argv[]) {
                 property[0] = CANPARA_TRACE_TYPE_BINARY;
                 break;
         }
-        (void)canDevice.SetProperty(CANPROP_SET_TRACE_TYPE, (void*)&property[0], sizeof(uint8_t));
-        /* -- set trace active */
+        (void)SetProperty(CANPROP_SET_TRACE_TYPE, (void*)&property[0], sizeof(uint8_t));
+        /* - set trace active */
         property[0] = CANPARA_TRACE_ON;
-        retVal = canDevice.SetProperty(CANPROP_SET_TRACE_ACTIVE, (void*)&property[0], sizeof(uint8_t));
+        retVal = SetProperty(CANPROP_SET_TRACE_ACTIVE, (void*)&property[0], sizeof(uint8_t));
         if (retVal != CCanApi::NoError) {
             fprintf(stdout, "FAILED!\n");
             fprintf(stderr, "+++ error: trace session could not be started (%i)\n", retVal);
-            goto teardown;
+            (void)TeardownChannel();
+            return retVal;
         }
     }
 #endif
     fprintf(stdout, "OK!\n");
-    /* - reception loop */
-    canDevice.ReceptionLoop();
-    /* - stop trace session (if enabled) */
-#if (CAN_TRACE_SUPPORTED != 0)
-    if (opts.m_eTraceMode != SOptions::eTraceOff) {
-        /* -- get trace file name */
-        retVal = canDevice.GetProperty(CANPROP_GET_TRACE_FILE, (void*)property, CANPROP_MAX_BUFFER_SIZE);
-        if (retVal == CCanApi::NoError) {
-            property[CANPROP_MAX_BUFFER_SIZE] = '\0';
-            fprintf(stdout, "Trace-file=%s\n", property);
-        }
-        /* -- set trace inactive */
-        property[0] = CANPARA_TRACE_OFF;
-        (void)canDevice.SetProperty(CANPROP_SET_TRACE_ACTIVE, (void*)&property[0], sizeof(uint8_t));
-    }
-#endif
-    /* - show interface information */
-    if ((string = canDevice.GetHardwareVersion()) != NULL)
-        fprintf(stdout, "Hardware: %s\n", string);
-    if ((string = canDevice.GetFirmwareVersion()) != NULL)
-        fprintf(stdout, "Firmware: %s\n", string);
-#if (OPTION_CANAPI_LIBRARY != 0)
-    if ((string = canDevice.GetSoftwareVersion()) != NULL)
-        fprintf(stdout, "Software: %s\n", string);
-    if ((string = CCanDevice::GetVersion()) != NULL)
-        fprintf(stdout, "          %s\n", string);
-#else
-    if ((string = CCanDevice::GetVersion()) != NULL)
-        fprintf(stdout, "Software: %s\n", string);
-#endif
-teardown:
-    /* - teardown the interface*/
-    retVal = canDevice.TeardownChannel();
-    if (retVal != CCanApi::NoError) {
-        fprintf(stderr, "+++ error: CAN Controller could not be reset (%i)\n", retVal);
-        goto farewell;
-    }
-farewell:
-    /* So long and farewell! */
-    opts.ShowFarewell(stdout);
-    return retVal;
+    return CCanApi::NoError;
 }
 
 /*  List all supported CAN devices from CAN device list :
@@ -685,94 +744,131 @@ bool CCanDevice::WriteJsonFile(const char* filename) {
 #endif
 
 /*  Reception loop: count received CAN messages until Ctrl-C
+ *  - the messages are read in batches and handed over to the output
+ *    pipeline, so that a slow console doesn't stall the reception
  */
 uint64_t CCanDevice::ReceptionLoop() {
-    CANAPI_Message_t message;
+    COutputPipeline::SFrame batch[COutputPipeline::BatchSize];
+    COutputPipeline output(stdout);
+    CANAPI_Status_t status;
     uint64_t frames = 0U;
+    uint16_t timeout;
+    size_t n;
 
-    char string[CANPROP_MAX_STRING_LENGTH+1];
-    memset(string, 0, CANPROP_MAX_STRING_LENGTH+1);
-
+    if (database.GetMessages())
+        output.SetDatabase(&database);
+    if (!output.Start()) {
+        fprintf(stderr, "+++ error: output thread could not be started\n");
+        return 0U;
+    }
     fprintf(stderr, "\nPress ^C to abort.\n\n");
     while(running) {
-        if (ReadMessage(message) == CCanApi::NoError) {
-            if ((((message.id < MAX_ID) && can_id[message.id]) || ((message.id >= MAX_ID) && can_id_xtd))) {
-                (void)CCanMessage::Format(message, ++frames, string, CANPROP_MAX_STRING_LENGTH);
-                fprintf(stdout, "%s\n", string);
+        /* wait for the first message, then drain the receive queue */
+        for (n = 0U, timeout = CANWAIT_INFINITE; n < COutputPipeline::BatchSize; timeout = 0U) {
+            CANAPI_Message_t &message = batch[n].message;
+            if (ReadMessage(message, timeout) != CCanApi::NoError)
+                break;
+            if (idFilter.IsIncluded(message)) {
+                batch[n].channel = 0;
+                batch[n++].counter = ++frames;
             }
         }
+        if (n)
+            (void)output.Push(batch, n);
     }
+    output.Stop();
     fprintf(stdout, "\n");
+    /* report messages lost on output and on reception */
+    if (output.GetDropped())
+        fprintf(stderr, "+++ warning: %" PRIu64 " message(s) dropped on output (console too slow)\n", output.GetDropped());
+    if ((GetStatus(status) == CCanApi::NoError) && status.queue_overrun)
+        fprintf(stderr, "+++ warning: receive queue overrun (message(s) lost on reception)\n");
     return frames;
 }
 
-// FIXME: matured code from can_moni for BerliOS SocketCAN
-static int get_exclusion(const char* arg)
-{
-    char* val, *end;
-    int i, inv = 0;
-    long id, last = -1;
-
-    if (!arg)
-        return 0;
-
-    val = (char* )arg;
-    if (*val == '~') {
-        inv = 1;
-        val++;
-    }
-    for (;;) {
-        errno = 0;
-        id = strtol(val, &end, 0);
-
-        if (errno == ERANGE && (id == LONG_MAX || id == LONG_MIN))
-            return 0;
-        if (errno != 0 && id == 0)
-            return 0;
-        if (val == end)
-            return 0;
-
-        if (id < MAX_ID)
-            can_id[id] = 0;
+/*  Reception loop for several interfaces: until Ctrl-C
+ *  - each interface is read by its own reception thread, the messages
+ *    are merged by their time-stamps and shown with their channel number
+ */
+uint64_t CCanDevice::MergedReceptionLoop(CCanDevice devices[], int count) {
+    COutputPipeline output(stdout);
+    CMerger merger(count, MERGE_WINDOW);
+    std::vector<std::thread> threads;
+    CANAPI_Status_t status;
 
-        if (*end == '\0') {
-            if (last != -1) {
-                while (last != id) {
-                    if (last < id)
-                        last++;
-                    else
-                        last--;
-                    can_id[last] = 0;
+    (void)CCanMessage::SetChannelFormat(CCanMessage::OptionOn);
+    if (database.GetMessages())
+        output.SetDatabase(&database);
+    if (!output.Start()) {
+        fprintf(stderr, "+++ error: output thread could not be started\n");
+        return 0U;
+    }
+    fprintf(stderr, "\nPress ^C to abort.\n\n");
+    for (int i = 0; i < count; i++) {
+        threads.push_back(std::thread([&devices, &merger, i]() {
+            CANAPI_Message_t message;
+            CANAPI_Return_t retVal;
+            while (running) {
+                if ((retVal = devices[i].ReadMessage(message, CANWAIT_INFINITE)) != CCanApi::NoError) {
+                    if (retVal == CCanApi::ReceiverEmpty)
+                        continue;
+                    // note: persistent error (e.g. adapter unplugged), end the reception of this channel
+                    if (running)
+                        fprintf(stderr, "+++ error: reception of channel %i stopped (%i)\n", i, retVal);
+                    break;
                 }
-                /*last = -1; <<< dead store */
+                if (idFilter.IsIncluded(message))
+                    merger.Push(i, message);
             }
-            break;
+        }));
+    }
+    while (running) {
+        if (!merger.Merge(output))
+            (void)CTimer::Delay(MERGE_INTERVAL * CTimer::MSEC);
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    (void)merger.Merge(output, true);
+    output.Stop();
+    fprintf(stdout, "\n");
+    /* report messages lost on merge, on output and on reception */
+    for (int i = 0; i < count; i++) {
+        if (merger.GetDropped(i))
+            fprintf(stderr, "+++ warning: %" PRIu64 " message(s) of channel %i dropped on merge\n", merger.GetDropped(i), i);
+        if ((devices[i].GetStatus(status) == CCanApi::NoError) && status.queue_overrun)
+            fprintf(stderr, "+++ warning: receive queue overrun of channel %i (message(s) lost on reception)\n", i);
+    }
+    if (output.GetDropped())
+        fprintf(stderr, "+++ warning: %" PRIu64 " message(s) dropped on output (console too slow)\n", output.GetDropped());
+    return merger.GetFrames();
+}
+
+/*  Statistics loop: show per-ID statistics until Ctrl-C
+ *  - the table is redrawn in place every <interval> milliseconds
+ */
+uint64_t CCanDevice::StatisticsLoop(uint32_t interval, double bitrate) {
+    CStatistics statistics(bitrate);
+    CTimer timer((uint64_t)interval * CTimer::MSEC);
+    CANAPI_Message_t message;
+
+    if (database.GetMessages())
+        statistics.SetDatabase(&database);
+    fprintf(stderr, "\nPress ^C to abort.\n\n");
+    fprintf(stdout, "\033[2J");
+    while(running) {
+        if (ReadMessage(message, STATISTICS_TIMEOUT) == CCanApi::NoError) {
+            if (idFilter.IsIncluded(message))
+                statistics.Update(message);
         }
-        if (*end == ',') {
-            if (last != -1) {
-                while (last != id) {
-                    if (last < id)
-                        last++;
-                    else
-                        last--;
-                    can_id[last] = 0;
-                }
-                last = -1;
-            }
+        if (timer.Timeout()) {
+            statistics.Draw(stdout);
+            (void)timer.Restart((uint64_t)interval * CTimer::MSEC);
         }
-        else if (*end == '-')
-            last = id;
-        else
-            return 0;
-
-        val = ++end;
-    }
-    if (inv) {
-        for (i = 0; i < MAX_ID; i++)
-            can_id[i] = can_id[i] ? 0 : 1;
     }
-    can_id_xtd = inv ? 0 : 1;
-    return 1;
+    statistics.Draw(stdout);
+    statistics.Summary(stdout);
+    fprintf(stdout, "\n");
+    return statistics.GetFrames();
 }
 
 /*  Signal handler to catch Ctrl+C:
@@ -781,7 +877,8 @@ static int get_exclusion(const char* arg)
 static void sigterm(int signo)
 {
     //fprintf(stderr, "%s: got signal %d\n", __FILE__, signo);
-    (void)canDevice.SignalChannel();
+    for (int i = 0; i < numDevices; i++)
+        (void)canDevice[i].SignalChannel();
     running = 0;
     (void)signo;
 }
@@ -0,0 +1,291 @@
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  SerialCAN Daemon for CAN-over-Serial-Line Interfaces (CAN API V3)
+//
+//  Copyright (c) 2024 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "SerialCAN.h"
+#include "SerialCAN_Defines.h"
+#include "can_btr.h"
+#include "shmem.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include <thread>
+#include <atomic>
+
+#define RX_BATCH  64U  // max. number of messages published at once
+#define TX_BATCH  64U  // max. number of messages fetched at once
+#define RX_WAIT  100U  // time to wait for a message (in [ms])
+#define TX_WAIT  100U  // time to wait for a posted message (in [ms])
+#define TX_TIMEOUT  10U  // time to wait for the transmitter (in [ms])
+#define TX_RETRIES  10  // max. number of retries when the transmitter is busy
+#define INFO_CYCLE  100U  // update cycle of the daemon status (in [ms])
+
+static void sigterm(int signo);
+static void transmitter(void);
+static uint64_t time_ms(void);
+static void usage(FILE *stream, const char *program);
+
+static std::atomic<bool> running(true);
+
+static CSerialCAN canDevice = CSerialCAN();  // global due to SignalChannel() in sigterm()
+static shmem_t shm = NULL;                   // global due to shmem_signal() in sigterm()
+static std::atomic<uint64_t> txCounter(0U);  // number of messages transmitted for the clients
+static std::atomic<uint64_t> txFailed(0U);   // number of messages of the clients not transmitted
+
+int main(int argc, char *argv[]) {
+    CANAPI_OpMode_t opMode = {};
+    CANAPI_Bitrate_t bitrate = {};
+    CANAPI_Message_t message[RX_BATCH];
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    can_sio_attr_t sioAttr;
+    can_sio_shared_t info;
+    char name[SHMEM_MAX_NAME];
+    unsigned long ringSize = CANSIO_SHM_RING_SIZE;
+    unsigned long postSize = CANSIO_SHM_POST_SIZE;
+    unsigned long accessMode = 0U;
+    long index = CANBTR_INDEX_250K;
+    uint64_t rxCounter = 0U, errCounter = 0U, next = 0U;
+    uint16_t btr0btr1 = 0x0000U;
+    char *endptr;
+    size_t n;
+    int opt;
+
+    static struct option long_options[] = {
+        {"baudrate", required_argument, 0, 'b'},
+        {"protocol", required_argument, 0, 'z'},
+        {"sio-baudrate", required_argument, 0, 's'},
+        {"ring-size", required_argument, 0, 'r'},
+        {"post-size", required_argument, 0, 'p'},
+        {"mode", required_argument, 0, 'm'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    /* serial line attributes */
+    sioAttr.protocol = CANSIO_SLCAN;
+    sioAttr.baudrate = CANSIO_BD57600;
+    sioAttr.bytesize = CANSIO_8DATABITS;
+    sioAttr.parity = CANSIO_NOPARITY;
+    sioAttr.stopbits = CANSIO_1STOPBIT;
+    opMode.byte = CANMODE_DEFAULT;
+    /* scan command-line */
+    while ((opt = getopt_long(argc, argv, "b:z:s:r:p:m:h", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'b':  /* option '--baudrate=<index>' (-b) */
+            index = strtol(optarg, NULL, 10);
+            if ((index < 0) || (index > 8)) {
+                fprintf(stderr, "%s: illegal argument for option `--baudrate' (%c)\n", argv[0], opt);
+                return 1;
+            }
+            index = -index;  // note: CiA indexes are negative numbers or zero
+            break;
+        case 'z':  /* option '--protocol=(Lawicel|CANable|WeAct)' (-z) */
+            if (!strcasecmp(optarg, "Lawicel") || !strcasecmp(optarg, "default") || !strcasecmp(optarg, "SLCAN"))
+                sioAttr.protocol = CANSIO_LAWICEL;
+            else if (!strcasecmp(optarg, "CANable"))
+                sioAttr.protocol = CANSIO_CANABLE;
+            else if (!strcasecmp(optarg, "WeAct"))
+                sioAttr.protocol = CANSIO_WEACT;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--protocol' (%c)\n", argv[0], opt);
+                return 1;
+            }
+            break;
+        case 's':  /* option '--sio-baudrate=<bps>' (-s) */
+            sioAttr.baudrate = (uint32_t)strtoul(optarg, NULL, 10);
+            if (!sioAttr.baudrate) {
+                fprintf(stderr, "%s: illegal argument for option `--sio-baudrate' (%c)\n", argv[0], opt);
+                return 1;
+            }
+            break;
+        case 'r':  /* option '--ring-size=<number>' (-r) */
+            ringSize = strtoul(optarg, NULL, 10);
+            if (!ringSize) {
+                fprintf(stderr, "%s: illegal argument for option `--ring-size' (%c)\n", argv[0], opt);
+                return 1;
+            }
+            break;
+        case 'p':  /* option '--post-size=<number>' (-p) */
+            postSize = strtoul(optarg, NULL, 10);
+            if (!postSize) {
+                fprintf(stderr, "%s: illegal argument for option `--post-size' (%c)\n", argv[0], opt);
+                return 1;
+            }
+            break;
+        case 'm':  /* option '--mode=<octal>' (-m) */
+            accessMode = strtoul(optarg, &endptr, 8);
+            if ((*endptr != '\0') || !accessMode || (accessMode > 0777U)) {
+                fprintf(stderr, "%s: illegal argument for option `--mode' (%c)\n", argv[0], opt);
+                return 1;
+            }
+            break;
+        case 'h':
+            usage(stdout, argv[0]);
+            return 0;
+        default:
+            usage(stderr, argv[0]);
+            return 1;
+        }
+    }
+    if (optind + 1 != argc) {
+        usage(stderr, argv[0]);
+        return 1;
+    }
+    /* signal handler */
+    if ((signal(SIGINT, sigterm) == SIG_ERR) ||
+        (signal(SIGHUP, sigterm) == SIG_ERR) ||
+        (signal(SIGTERM, sigterm) == SIG_ERR)) {
+        perror("+++ error");
+        return errno;
+    }
+    /* - initialize interface */
+    fprintf(stdout, "Hardware=%s...", argv[optind]);
+    fflush(stdout);
+    retVal = canDevice.InitializeChannel(argv[optind], opMode, sioAttr);
+    if (retVal != CCanApi::NoError) {
+        fprintf(stdout, "FAILED!\n");
+        fprintf(stderr, "+++ error: interface could not be initialized (%i)\n", retVal);
+        return 1;
+    }
+    fprintf(stdout, "OK!\n");
+    /* - start communication */
+    bitrate.index = (int32_t)index;
+    (void)btr_index2sja1000(bitrate.index, &btr0btr1);
+    fprintf(stdout, "Bit-rate=%s...", (index == CANBTR_INDEX_1M) ? "1Mbps" :
+        (index == CANBTR_INDEX_800K) ? "800kbps" : (index == CANBTR_INDEX_500K) ? "500kbps" :
+        (index == CANBTR_INDEX_250K) ? "250kbps" : (index == CANBTR_INDEX_125K) ? "125kbps" :
+        (index == CANBTR_INDEX_100K) ? "100kbps" : (index == CANBTR_INDEX_50K) ? "50kbps" :
+        (index == CANBTR_INDEX_20K) ? "20kbps" : "10kbps");
+    fflush(stdout);
+    retVal = canDevice.StartController(bitrate);
+    if (retVal != CCanApi::NoError) {
+        fprintf(stdout, "FAILED!\n");
+        fprintf(stderr, "+++ error: CAN controller could not be started (%i)\n", retVal);
+        (void)canDevice.TeardownChannel();
+        return 1;
+    }
+    fprintf(stdout, "OK!\n");
+    /* - create the shared-memory object */
+    if ((shmem_name(name, CANSIO_SHM_PREFIX, argv[optind]) < 0) ||
+        ((shm = shmem_create(name, (size_t)ringSize, (size_t)postSize, sizeof(CANAPI_Message_t), (unsigned int)accessMode)) == NULL)) {
+        fprintf(stderr, "+++ error: shared memory could not be created (%s)\n", strerror(errno));
+        (void)canDevice.TeardownChannel();
+        return 1;
+    }
+    memset(&info, 0, sizeof(can_sio_shared_t));
+    info.pid = (int32_t)getpid();
+    info.btr0btr1 = btr0btr1;
+    info.protocol = sioAttr.protocol;
+    (void)shmem_info_write(shm, &info, sizeof(can_sio_shared_t));
+    fprintf(stdout, "Shared memory=%s (press ^C to stop)\n", name);
+    fflush(stdout);
+    /* - transmit the messages posted by the clients */
+    std::thread thread(transmitter);
+    /* - publish the received messages */
+    while (running) {
+        n = 0U;
+        while ((n < RX_BATCH) &&
+               (canDevice.ReadMessage(message[n], (n == 0U) ? RX_WAIT : 0U) == CCanApi::NoError)) {
+            if (!message[n].sts)
+                rxCounter++;
+            else
+                errCounter++;
+            n++;
+        }
+        if (n > 0U)
+            (void)shmem_publish(shm, message, n);
+        /* update the daemon status (not per message) */
+        if (time_ms() >= next) {
+            (void)canDevice.GetStatus(status);
+            info.status = status.byte;
+            info.rx = rxCounter;
+            info.err = errCounter;
+            info.tx = txCounter;
+            info.failed = txFailed;
+            (void)shmem_info_write(shm, &info, sizeof(can_sio_shared_t));
+            next = time_ms() + INFO_CYCLE;
+        }
+    }
+    thread.join();
+    /* - teardown the interface */
+    fprintf(stdout, "\n");
+    (void)shmem_destroy(shm);
+    (void)canDevice.TeardownChannel();
+    fprintf(stdout, "Received=%" PRIu64 " Transmitted=%" PRIu64 " Failed=%" PRIu64 "\n", rxCounter, (uint64_t)txCounter, (uint64_t)txFailed);
+    return 0;
+}
+
+static void transmitter(void) {
+    CANAPI_Message_t message[TX_BATCH];
+    CANAPI_Return_t retVal;
+    int i, n, retries;
+
+    while (running) {
+        /* note: the messages are taken in the order of the posting */
+        if ((n = shmem_fetch(shm, message, TX_BATCH, TX_WAIT)) <= 0)
+            continue;
+        for (i = 0; i < n; i++) {
+            retries = 0;
+            while (((retVal = canDevice.WriteMessage(message[i], TX_TIMEOUT)) == CCanApi::TransmitterBusy) &&
+                   running && (retries++ < TX_RETRIES));
+            if (retVal == CCanApi::NoError)
+                txCounter++;
+            else
+                txFailed++;
+        }
+    }
+}
+
+static uint64_t time_ms(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000U) + ((uint64_t)now.tv_nsec / 1000000U);
+}
+
+static void usage(FILE *stream, const char *program) {
+    fprintf(stream, "Usage: %s <interface> [<option>...]\n", program);
+    fprintf(stream, "Options:\n");
+    fprintf(stream, " -b, --baudrate=<index>               CAN bit-rate index 0..8 (default=3, 250kbps)\n");
+    fprintf(stream, " -z, --protocol=(Lawicel|CANable|WeAct) select SLCAN protocol (default=Lawicel)\n");
+    fprintf(stream, " -s, --sio-baudrate=<bps>             baud rate of the serial line (default=57600)\n");
+    fprintf(stream, " -r, --ring-size=<number>             size of the receive ring (default=%u)\n", CANSIO_SHM_RING_SIZE);
+    fprintf(stream, " -p, --post-size=<number>             size of the transmit ring (default=%u)\n", CANSIO_SHM_POST_SIZE);
+    fprintf(stream, " -m, --mode=<octal>                   access mode of the shared memory (default=0660 and umask)\n");
+    fprintf(stream, " -h, --help                           display this help screen and exit\n");
+    fprintf(stream, "Clients open the interface with protocol CANSIO_SHARED (e.g. can_moni --protocol=Shared).\n");
+    fprintf(stream, "They need read and write access to the shared memory (e.g. by group membership).\n");
+}
+
+static void sigterm(int signo) {
+    running = false;
+    (void)canDevice.SignalChannel();
+    if (shm)
+        (void)shmem_signal(shm);
+    (void)signo;
+}